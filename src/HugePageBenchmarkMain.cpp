@@ -0,0 +1,157 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+
+#include "./engine/Engine.h"
+#include "./engine/Join.h"
+#include "./util/Timer.h"
+
+// Benchmark for the sort and the join of large `IdTable`s whose memory is
+// backed by pages of the default size or by huge pages (see the option
+// `--huge-pages` of the `ServerMain`). Reports the time and the number of
+// data TLB misses of all the threads of the process.
+
+namespace {
+// Counts the data TLB misses of the loads of the thread that creates it and
+// of the threads that are started later (e.g. the threads of the pool).
+class TlbMissCounter {
+ public:
+  TlbMissCounter() {
+    perf_event_attr attributes{};
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HW_CACHE;
+    attributes.config = PERF_COUNT_HW_CACHE_DTLB |
+                        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    _fd = static_cast<int>(
+        syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+  }
+  ~TlbMissCounter() {
+    if (_fd >= 0) {
+      close(_fd);
+    }
+  }
+
+  // Empty if the counter is not available, e.g. in a virtual machine or
+  // because of `/proc/sys/kernel/perf_event_paranoid`.
+  std::optional<uint64_t> read() const {
+    uint64_t value = 0;
+    if (_fd < 0 || ::read(_fd, &value, sizeof(value)) != sizeof(value)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+ private:
+  int _fd;
+};
+
+// A table with `numRows` rows and two columns, the first column contains
+// random values from [0, numRows).
+IdTable createRandomTable(size_t numRows,
+                          const ad_utility::AllocatorWithLimit<Id>& allocator,
+                          std::mt19937_64& rng) {
+  std::uniform_int_distribution<Id> distribution{0, numRows - 1};
+  IdTable result{2, allocator};
+  for (size_t i = 0; i < numRows; ++i) {
+    result.push_back({distribution(rng), i});
+  }
+  return result;
+}
+
+// Call `prepare()` (not measured) and then `function(prepare())`
+// `numRepetitions` times and print the average time and TLB misses.
+template <typename Prepare, typename Function>
+void measure(const std::string& name, const TlbMissCounter& counter,
+             size_t numRepetitions, const Prepare& prepare,
+             const Function& function) {
+  ad_utility::Timer timer;
+  uint64_t tlbMisses = 0;
+  for (size_t i = 0; i < numRepetitions; ++i) {
+    auto input = prepare();
+    const auto missesBefore = counter.read();
+    timer.cont();
+    function(input);
+    timer.stop();
+    const auto missesAfter = counter.read();
+    if (missesBefore && missesAfter) {
+      tlbMisses += *missesAfter - *missesBefore;
+    }
+  }
+  std::cout << name << ": "
+            << static_cast<double>(timer.msecs()) / numRepetitions
+            << " ms per run";
+  if (counter.read()) {
+    std::cout << ", " << tlbMisses / numRepetitions << " dTLB load misses";
+  }
+  std::cout << '\n';
+}
+}  // namespace
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr
+        << "Usage: ./HugePageBenchmarkMain [<num rows> [<repetitions>]]\n";
+    exit(1);
+  }
+  const size_t numRows = argc > 1 ? std::stoul(argv[1]) : 20'000'000;
+  const size_t numRepetitions = argc > 2 ? std::stoul(argv[2]) : 3;
+
+  // Created first, so that it also counts the threads of the sort and join.
+  const TlbMissCounter counter;
+  if (!counter.read()) {
+    std::cout << "The number of TLB misses is not available, check "
+                 "/proc/sys/kernel/perf_event_paranoid\n";
+  }
+  std::cout << "Sorting and joining tables with " << numRows
+            << " rows and two columns\n";
+
+  using ad_utility::HugePageMode;
+  for (auto mode : {HugePageMode::None, HugePageMode::Transparent,
+                    HugePageMode::Explicit}) {
+    const ad_utility::AllocatorWithLimit<Id> allocator{
+        ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+            std::numeric_limits<size_t>::max()),
+        ad_utility::noClearOnAllocation, mode};
+    const std::string prefix =
+        "Huge pages \"" + std::string{toString(mode)} + "\", ";
+    std::mt19937_64 rng{42};
+
+    measure(
+        prefix + "sort", counter, numRepetitions,
+        [&]() { return createRandomTable(numRows, allocator, rng); },
+        [](IdTable& table) { Engine::sort<2>(&table, 0); });
+
+    measure(
+        prefix + "join", counter, numRepetitions,
+        [&]() {
+          std::array<IdTable, 2> inputs{
+              createRandomTable(numRows, allocator, rng),
+              createRandomTable(numRows, allocator, rng)};
+          for (auto& input : inputs) {
+            Engine::sort<2>(&input, 0);
+          }
+          return inputs;
+        },
+        [&](const std::array<IdTable, 2>& inputs) {
+          Join join{Join::InvalidOnlyForTestingJoinTag{}};
+          IdTable result{3, allocator};
+          join.join<2, 2, 3>(inputs[0], 0, inputs[1], 0, &result);
+        });
+  }
+}
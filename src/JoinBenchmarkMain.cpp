@@ -0,0 +1,188 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./engine/ColumnKernels.h"
+#include "./engine/Join.h"
+#include "./util/Timer.h"
+
+// Microbenchmark for the join of a small with a large input (e.g. a type
+// filter against a big relation), which QLever computes with the galloping
+// join. Compares the vectorized galloping join with the previous scalar
+// implementation (exponential search and `std::lower_bound`).
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+// A sorted table with `numRows` rows and two columns, the first column
+// contains random values from [0, maxValue).
+IdTable createSortedTable(size_t numRows, Id maxValue, std::mt19937_64& rng) {
+  std::uniform_int_distribution<Id> distribution{0, maxValue - 1};
+  IdTable result{2, allocator()};
+  for (size_t i = 0; i < numRows; ++i) {
+    result.push_back({distribution(rng), i});
+  }
+  std::sort(result.begin(), result.end(),
+            [](const auto& a, const auto& b) { return a[0] < b[0]; });
+  return result;
+}
+
+// The galloping join as it was implemented before the vectorized search:
+// exponential search followed by `std::lower_bound` in the last step.
+void scalarGallopJoin(const IdTableView<2>& small, const IdTableView<2>& large,
+                      IdTableStatic<3>* result) {
+  size_t j = 0;
+  for (size_t i = 0; i < small.size() && j < large.size(); ++i) {
+    const Id value = small(i, 0);
+    size_t last = j;
+    size_t step = 1;
+    while (j < large.size() && large(j, 0) < value) {
+      last = j;
+      j += step;
+      step *= 2;
+    }
+    j = std::lower_bound(
+            large.begin() + last, large.begin() + std::min(j, large.size()),
+            value, [](const auto& row, Id v) { return row[0] < v; }) -
+        large.begin();
+    for (size_t k = j; k < large.size() && large(k, 0) == value; ++k) {
+      result->push_back({value, small(i, 1), large(k, 1)});
+    }
+  }
+}
+
+// For each of the sorted `values`, find the first row of the sorted `column`
+// that is not less than the value (exponential search followed by a binary
+// search, like the previous scalar galloping join). Returns the sum of the
+// rows.
+size_t scalarGallopSearch(const std::vector<Id>& values,
+                          const columnKernels::ColumnView& column) {
+  size_t sum = 0;
+  size_t j = 0;
+  for (Id value : values) {
+    size_t last = j;
+    size_t step = 1;
+    while (j < column.size() && column[j] < value) {
+      last = j;
+      j += step;
+      step *= 2;
+    }
+    size_t high = std::min(j, column.size());
+    j = last;
+    while (j < high) {
+      size_t mid = j + (high - j) / 2;
+      if (column[mid] < value) {
+        j = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    sum += j;
+  }
+  return sum;
+}
+
+// The same search with `columnKernels::gallopLowerBound`.
+size_t vectorizedGallopSearch(const std::vector<Id>& values,
+                              const columnKernels::ColumnView& column) {
+  size_t sum = 0;
+  size_t j = 0;
+  for (Id value : values) {
+    j = columnKernels::gallopLowerBound(column, j, column.size(), value);
+    sum += j;
+  }
+  return sum;
+}
+
+// Run `function()` `numRepetitions` times and print the average time and the
+// return value of the last call.
+template <typename Function>
+void measure(const std::string& name, size_t numRepetitions,
+             const Function& function) {
+  // One untimed run, such that all measurements start with warm caches.
+  function();
+  ad_utility::Timer timer;
+  size_t resultSize = 0;
+  timer.start();
+  for (size_t i = 0; i < numRepetitions; ++i) {
+    // Keep the compiler from computing the result of a pure `function` only
+    // once for all repetitions.
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    resultSize = function();
+  }
+  timer.stop();
+  std::cout << name << ": "
+            << static_cast<double>(timer.usecs()) / numRepetitions
+            << " µs per run, result " << resultSize << '\n';
+}
+}  // namespace
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 4) {
+    std::cerr << "Usage: ./JoinBenchmarkMain [<small size> [<large size> "
+                 "[<repetitions>]]]\n";
+    exit(1);
+  }
+  const size_t smallSize = argc > 1 ? std::stoul(argv[1]) : 1'000;
+  const size_t largeSize = argc > 2 ? std::stoul(argv[2]) : 10'000'000;
+  const size_t numRepetitions = argc > 3 ? std::stoul(argv[3]) : 20;
+
+  std::mt19937_64 rng{42};
+  const IdTable small = createSortedTable(smallSize, largeSize, rng);
+  const IdTable large = createSortedTable(largeSize, largeSize, rng);
+  const auto smallView = small.asStaticView<2>();
+  const auto largeView = large.asStaticView<2>();
+  std::cout << "Joining " << smallSize << " with " << largeSize << " rows\n";
+
+  measure("Galloping join (vectorized)", numRepetitions, [&]() {
+    IdTableStatic<3> result{3, allocator()};
+    Join::doGallopInnerJoin(Join::RightLargerTag{}, smallView, 0, largeView, 0,
+                            &result);
+    return result.size();
+  });
+  measure("Galloping join (scalar)", numRepetitions, [&]() {
+    IdTableStatic<3> result{3, allocator()};
+    scalarGallopJoin(smallView, largeView, &result);
+    return result.size();
+  });
+
+  std::vector<Id> values;
+  for (size_t i = 0; i < small.size(); ++i) {
+    values.push_back(small(i, 0));
+  }
+  // The join column of the row-major `IdTable` is strided, the galloping
+  // search scans it with gather instructions when the galloping ends in a
+  // small window. This is the common case when the small input is not much
+  // smaller than the large one (e.g. 1'000'000 with 10'000'000 rows).
+  std::cout << "Searching " << smallSize << " values in a strided column of "
+            << largeSize << " values\n";
+  const auto strided = columnKernels::getColumn(large, 0);
+  measure("Galloping search, strided (vectorized)", numRepetitions,
+          [&]() { return vectorizedGallopSearch(values, strided); });
+  measure("Galloping search, strided (scalar)", numRepetitions,
+          [&]() { return scalarGallopSearch(values, strided); });
+
+  std::cout << "Searching " << smallSize << " values in a contiguous column of "
+            << largeSize << " values\n";
+  std::vector<Id> column;
+  for (size_t i = 0; i < large.size(); ++i) {
+    column.push_back(large(i, 0));
+  }
+  const columnKernels::ColumnView contiguous{column.data(), column.size(), 1};
+  measure("Galloping search, contiguous (vectorized)", numRepetitions,
+          [&]() { return vectorizedGallopSearch(values, contiguous); });
+  measure("Galloping search, contiguous (scalar)", numRepetitions,
+          [&]() { return scalarGallopSearch(values, contiguous); });
+}
@@ -4,6 +4,7 @@
 
 #include <boost/program_options.hpp>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -48,6 +49,13 @@ int main(int argc, char** argv) {
   bool onlyPsoAndPosPermutations;
 
   NonNegative memoryMaxSizeGb;
+  string cacheEvictionPolicy;
+  string cacheDiskDir;
+  NonNegative cacheDiskMaxSizeGb;
+  string warmUpQueriesFile;
+  bool warmUpInBackground;
+  std::vector<std::string> apiKeyPriorities;
+  string hugePages;
 
   ad_utility::ParameterToProgramOptionFactory optionFactory{
       &RuntimeParameters()};
@@ -71,6 +79,13 @@ int main(int argc, char** argv) {
       "Limit on the total amount of memory (in GB) that can be used for "
       "query processing and caching. If exceeded, query will return with "
       "an error, but the engine will not crash.");
+  add("query-max-memory-gb",
+      optionFactory.getProgramOption<"query-max-memory-gb">(),
+      "Limit on the memory (in GB) that a single query can use, as part of "
+      "--memory-max-size-gb. 0 means no limit beyond --memory-max-size-gb. "
+      "Queries also wait until the memory that they are estimated to need "
+      "(at most this limit) is not used by other queries, for at most "
+      "`query-max-queue-wait-ms`.");
   add("cache-max-size-gb,c",
       optionFactory.getProgramOption<"cache-max-size-gb">(),
       "Maximum memory size in GB for all cache entries (pinned and "
@@ -83,9 +98,58 @@ int main(int argc, char** argv) {
   add("cache-max-num-entries,k",
       optionFactory.getProgramOption<"cache-max-num-entries">(),
       "Maximum number of entries in the cache. If exceeded, remove "
-      "least-recently used non-pinned entries from the cache. Note that "
+      "non-pinned entries from the cache according to "
+      "--cache-eviction-policy. Note that "
       "this condition and the size limit specified via --cache-max-size-gb "
       "both have to hold (logical AND).");
+  add("cache-eviction-policy",
+      po::value<std::string>(&cacheEvictionPolicy)->default_value("lru"),
+      "The policy that chooses the non-pinned entry that is removed from the "
+      "cache when it is full. \"lru\" removes the least recently used entry, "
+      "\"gdsf\" (Greedy-Dual-Size-Frequency) prefers to keep results that "
+      "were expensive to compute, are small, and are used often.");
+  add("cache-disk-dir",
+      po::value<std::string>(&cacheDiskDir)->default_value(""),
+      "A directory for a second tier of the cache on disk, which survives a "
+      "restart of the server. Pinned results and results whose computation "
+      "took at least `cache-disk-min-compute-time-ms` are written there and "
+      "read again when they are not in the cache in memory. Empty (the "
+      "default) disables this tier.");
+  add("cache-disk-max-size-gb",
+      po::value<NonNegative>(&cacheDiskMaxSizeGb)->default_value(100),
+      "Maximum total size in GB of the (compressed) results in "
+      "--cache-disk-dir. If exceeded, the least recently used results are "
+      "deleted.");
+  add("warmup-queries",
+      po::value<std::string>(&warmUpQueriesFile)->default_value(""),
+      "A file with one SPARQL query per line (empty lines are ignored). The "
+      "queries are computed with pinned subtrees and results when the server "
+      "starts, in parallel with --num-simultaneous-queries threads and "
+      "within --memory-max-size-gb. A report with the time and size of each "
+      "query is logged and available via `cmd=warmup-report`.");
+  add("warmup-in-background", po::bool_switch(&warmUpInBackground),
+      "Compute the --warmup-queries while the server already processes "
+      "other queries. By default, the server is only ready when all of them "
+      "have been computed.");
+  add("api-key-priority",
+      po::value<std::vector<std::string>>(&apiKeyPriorities)->composing(),
+      "A pair `<key>=<priority>`, can be given multiple times. Queries with "
+      "the parameter `api-key=<key>` have the <priority> (\"batch\", "
+      "\"normal\", or \"interactive\") unless they specify another one with "
+      "the parameter `priority`. Queries without a priority are interactive "
+      "if the cost estimate of their plan is at most "
+      "`query-interactive-max-cost`, else normal. When all threads are busy, "
+      "the threads are shared fairly between the API keys and priorities, in "
+      "proportion to the priorities.");
+  add("huge-pages", po::value<std::string>(&hugePages)->default_value("none"),
+      "Back the large intermediate results (of at least 2 MB) by huge pages, "
+      "which reduces the TLB misses of joins and sorts. \"transparent\" "
+      "uses transparent huge pages (they must be enabled with \"always\" or "
+      "\"madvise\" in /sys/kernel/mm/transparent_hugepage/enabled), "
+      "\"explicit\" uses the huge pages reserved via "
+      "/proc/sys/vm/nr_hugepages and transparent huge pages when these are "
+      "used up. The memory mappings of the index are also advised to use "
+      "huge pages.");
   add("no-patterns,P", po::bool_switch(&noPatterns),
       "Disable the use of patterns. If disabled, the special predicate "
       "`ql:has-predicate` is not available.");
@@ -112,6 +176,18 @@ int main(int argc, char** argv) {
     }
 
     po::notify(optionsMap);
+    // Fail early for an unknown policy.
+    ad_utility::evictionPolicyFromString(cacheEvictionPolicy);
+    ad_utility::hugePageModeFromString(hugePages);
+    for (const auto& keyAndPriority : apiKeyPriorities) {
+      auto pos = keyAndPriority.rfind('=');
+      if (pos == std::string::npos) {
+        throw std::runtime_error("The --api-key-priority \"" +
+                                 keyAndPriority +
+                                 "\" is not of the form <key>=<priority>");
+      }
+      queryPriorityFromString(keyAndPriority.substr(pos + 1));
+    }
   } catch (const std::exception& e) {
     std::cerr << "Error in command-line Argument: " << e.what() << '\n';
     std::cerr << options << '\n';
@@ -122,8 +198,30 @@ int main(int argc, char** argv) {
             << __TIME__ << EMPH_OFF << std::endl;
 
   try {
+    // Before the allocator of the server is created.
+    ad_utility::defaultHugePageMode() =
+        ad_utility::hugePageModeFromString(hugePages);
     Server server(port, static_cast<int>(numSimultaneousQueries),
-                  memoryMaxSizeGb);
+                  memoryMaxSizeGb,
+                  ad_utility::evictionPolicyFromString(cacheEvictionPolicy),
+                  cacheDiskDir, cacheDiskMaxSizeGb);
+    if (!warmUpQueriesFile.empty()) {
+      std::ifstream file{warmUpQueriesFile};
+      if (!file) {
+        throw std::runtime_error("Could not open the file with the warm-up "
+                                 "queries \"" +
+                                 warmUpQueriesFile + "\"");
+      }
+      server.setWarmUpQueries(Server::readWarmUpQueries(file),
+                              warmUpInBackground);
+    }
+    ad_utility::HashMap<std::string, QueryPriority> priorities;
+    for (const auto& keyAndPriority : apiKeyPriorities) {
+      auto pos = keyAndPriority.rfind('=');
+      priorities[keyAndPriority.substr(0, pos)] =
+          queryPriorityFromString(keyAndPriority.substr(pos + 1));
+    }
+    server.setApiKeyPriorities(std::move(priorities));
     server.run(indexBasename, text, !noPatterns, !noPatternTrick,
                !onlyPsoAndPosPermutations);
   } catch (const std::exception& e) {
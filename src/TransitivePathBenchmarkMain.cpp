@@ -0,0 +1,149 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./engine/TransitivePath.h"
+#include "./util/HashMap.h"
+#include "./util/HashSet.h"
+#include "./util/Timer.h"
+
+// Microbenchmark for the transitive closure of a class hierarchy like the
+// subclass relation `wdt:P279` of Wikidata, as in the property paths
+// `?x wdt:P279* ?y` (all paths) and `?x wdt:P279* wd:Q35120` (all subclasses
+// of one class). Compares the BFS of `TransitivePath` on a graph in
+// compressed sparse row format with the previous implementation (a depth
+// first search on a hash map of hash sets).
+
+namespace {
+using namespace std::string_literals;
+
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+// A hierarchy with `numClasses` classes, each class except the root class 0
+// has one or two superclasses with a smaller id. The first column of the
+// result is the subclass, the second column the superclass.
+IdTable createHierarchy(size_t numClasses, std::mt19937_64& rng) {
+  IdTable result{2, allocator()};
+  for (Id cls = 1; cls < numClasses; ++cls) {
+    const size_t numSuperclasses = 1 + rng() % 2;
+    for (size_t i = 0; i < numSuperclasses; ++i) {
+      result.push_back({cls, rng() % cls});
+    }
+  }
+  return result;
+}
+
+// The previous implementation of the transitive path: the successors of each
+// node in a hash set, and a depth first search with a hash set of the
+// visited nodes for each of the `startNodes`. If `reverse` is true, the edges
+// are followed from the second to the first column. Returns the number of
+// paths, which are written to an `IdTable` like in the `TransitivePath`.
+size_t hashSetTransitivePath(const IdTable& edges,
+                             const std::vector<Id>& startNodes, bool reverse) {
+  IdTableStatic<2> result{2, allocator()};
+  ad_utility::HashMap<Id, ad_utility::HashSet<Id>> successors;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    successors[edges(i, reverse ? 1 : 0)].insert(edges(i, reverse ? 0 : 1));
+  }
+  ad_utility::HashSet<Id> marks;
+  std::vector<Id> stack;
+  for (Id start : startNodes) {
+    marks.clear();
+    stack.push_back(start);
+    while (!stack.empty()) {
+      Id node = stack.back();
+      stack.pop_back();
+      auto it = successors.find(node);
+      if (it == successors.end()) {
+        continue;
+      }
+      for (Id child : it->second) {
+        if (marks.insert(child).second) {
+          if (reverse) {
+            result.push_back({child, start});
+          } else {
+            result.push_back({start, child});
+          }
+          stack.push_back(child);
+        }
+      }
+    }
+  }
+  return result.size();
+}
+
+// Run `function()` `numRepetitions` times and print the average time and the
+// return value of the last call.
+template <typename Function>
+void measure(const std::string& name, size_t numRepetitions,
+             const Function& function) {
+  ad_utility::Timer timer;
+  size_t resultSize = 0;
+  timer.start();
+  for (size_t i = 0; i < numRepetitions; ++i) {
+    resultSize = function();
+  }
+  timer.stop();
+  std::cout << name << ": "
+            << static_cast<double>(timer.msecs()) / numRepetitions
+            << " ms per run, result " << resultSize << '\n';
+}
+}  // namespace
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "Usage: ./TransitivePathBenchmarkMain [<number of classes> "
+                 "[<repetitions>]]\n";
+    exit(1);
+  }
+  const size_t numClasses = argc > 1 ? std::stoul(argv[1]) : 10'000;
+  const size_t numRepetitions = argc > 2 ? std::stoul(argv[2]) : 5;
+
+  std::mt19937_64 rng{42};
+  const IdTable hierarchy = createHierarchy(numClasses, rng);
+  std::cout << "Transitive paths in a hierarchy of " << numClasses
+            << " classes with " << hierarchy.size() << " subclass edges\n";
+
+  // Both sides are variables, so that the descriptor for the timeout checks
+  // can be computed without an index.
+  TransitivePath transitivePath(nullptr, nullptr, true, true, 0, 0, 0, 0,
+                                "?x"s, "?y"s, 1,
+                                std::numeric_limits<size_t>::max());
+  auto computeTransitivePath = [&](bool rightIsVar, Id rightValue) {
+    IdTable result{2, allocator()};
+    transitivePath.computeTransitivePath<2>(
+        &result, hierarchy, true, rightIsVar, 0, 1, 0, rightValue, 1,
+        std::numeric_limits<size_t>::max());
+    return result.size();
+  };
+
+  // ?x wdt:P279* ?y
+  std::vector<Id> allClasses;
+  for (size_t i = 0; i < hierarchy.size(); ++i) {
+    if (allClasses.empty() || allClasses.back() != hierarchy(i, 0)) {
+      allClasses.push_back(hierarchy(i, 0));
+    }
+  }
+  measure("All paths (CSR graph, BFS)", numRepetitions,
+          [&]() { return computeTransitivePath(true, 0); });
+  measure("All paths (hash sets, DFS)", numRepetitions, [&]() {
+    return hashSetTransitivePath(hierarchy, allClasses, false);
+  });
+
+  // ?x wdt:P279* <root>
+  measure("Subclasses of the root class (CSR graph, BFS)", numRepetitions,
+          [&]() { return computeTransitivePath(false, 0); });
+  measure("Subclasses of the root class (hash sets, DFS)", numRepetitions,
+          [&]() { return hashSetTransitivePath(hierarchy, {0}, true); });
+}
@@ -0,0 +1,104 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./AdmissionController.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../global/Constants.h"
+#include "../util/Exception.h"
+
+// _____________________________________________________________________________
+AdmissionController::Reservation::Reservation(Reservation&& other) noexcept
+    : _controller{std::exchange(other._controller, nullptr)},
+      _numBytes{std::exchange(other._numBytes, 0)},
+      _waitTime{other._waitTime} {}
+
+// _____________________________________________________________________________
+AdmissionController::Reservation& AdmissionController::Reservation::operator=(
+    Reservation&& other) noexcept {
+  if (_controller) {
+    _controller->release(_numBytes);
+  }
+  _controller = std::exchange(other._controller, nullptr);
+  _numBytes = std::exchange(other._numBytes, 0);
+  _waitTime = other._waitTime;
+  return *this;
+}
+
+// _____________________________________________________________________________
+AdmissionController::Reservation::~Reservation() {
+  if (_controller) {
+    _controller->release(_numBytes);
+  }
+}
+
+// _____________________________________________________________________________
+void AdmissionController::Reservation::resize(size_t numBytes) {
+  AD_CHECK(_controller);
+  _numBytes = _controller->replaceReservation(_numBytes, numBytes);
+}
+
+// _____________________________________________________________________________
+std::optional<AdmissionController::Reservation> AdmissionController::admit(
+    size_t numBytes, std::chrono::milliseconds maxWait) {
+  // A query that is larger than the budget can still run, but only alone.
+  numBytes = std::min(numBytes, _budget);
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock lock{_mutex};
+  auto position = _queue.insert(_queue.end(), 0);
+  const bool admitted = _admissionChanged.wait_for(lock, maxWait, [&]() {
+    return _numReservedBytes + numBytes <= _budget &&
+           std::all_of(_queue.begin(), position, [](size_t numOvertakes) {
+             return numOvertakes < ADMISSION_MAX_NUM_OVERTAKES;
+           });
+  });
+  if (admitted) {
+    _numReservedBytes += numBytes;
+    std::for_each(_queue.begin(), position,
+                  [](size_t& numOvertakes) { ++numOvertakes; });
+  }
+  _queue.erase(position);
+  // The next query in the queue might be allowed to start now.
+  _admissionChanged.notify_all();
+  if (!admitted) {
+    return std::nullopt;
+  }
+  return Reservation{this, numBytes,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - start)};
+}
+
+// _____________________________________________________________________________
+void AdmissionController::release(size_t numBytes) {
+  {
+    std::lock_guard lock{_mutex};
+    _numReservedBytes -= numBytes;
+  }
+  _admissionChanged.notify_all();
+}
+
+// _____________________________________________________________________________
+size_t AdmissionController::replaceReservation(size_t oldNumBytes,
+                                               size_t numBytes) {
+  numBytes = std::min(numBytes, _budget);
+  {
+    std::lock_guard lock{_mutex};
+    _numReservedBytes = _numReservedBytes - oldNumBytes + numBytes;
+  }
+  _admissionChanged.notify_all();
+  return numBytes;
+}
+
+// _____________________________________________________________________________
+size_t AdmissionController::numReservedBytes() const {
+  std::lock_guard lock{_mutex};
+  return _numReservedBytes;
+}
+
+// _____________________________________________________________________________
+size_t AdmissionController::numWaitingQueries() const {
+  std::lock_guard lock{_mutex};
+  return _queue.size();
+}
@@ -0,0 +1,75 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <optional>
+
+// Decides when a query may start, based on an estimate of the memory that it
+// will need. Each query reserves its estimate of a fixed budget before it is
+// executed and releases it when it is done. A query whose estimate doesn't fit
+// into the part of the budget that is not reserved waits in a queue. A query
+// that fits may overtake the waiting queries that arrived earlier, but each
+// waiting query is overtaken at most `ADMISSION_MAX_NUM_OVERTAKES` times, so
+// that large queries are not starved by a stream of small ones.
+//
+// This class is threadsafe.
+class AdmissionController {
+ public:
+  // Releases the reserved bytes when it is destroyed.
+  class Reservation {
+   public:
+    Reservation() = default;
+    Reservation(Reservation&& other) noexcept;
+    Reservation& operator=(Reservation&& other) noexcept;
+    ~Reservation();
+
+    size_t numBytes() const { return _numBytes; }
+    // Change the number of reserved bytes, e.g. to the actual size of a
+    // result that is kept after its query. The new size is reserved without
+    // waiting, even if it exceeds the budget.
+    void resize(size_t numBytes);
+    // How long the query waited in the queue.
+    std::chrono::milliseconds waitTime() const { return _waitTime; }
+
+   private:
+    friend class AdmissionController;
+    Reservation(AdmissionController* controller, size_t numBytes,
+                std::chrono::milliseconds waitTime)
+        : _controller{controller}, _numBytes{numBytes}, _waitTime{waitTime} {}
+
+    AdmissionController* _controller = nullptr;
+    size_t _numBytes = 0;
+    std::chrono::milliseconds _waitTime{0};
+  };
+
+  explicit AdmissionController(size_t budgetInBytes)
+      : _budget{budgetInBytes} {}
+
+  // Wait until `numBytes` (at most the complete budget) are not reserved and
+  // none of the queries that arrived earlier and still wait has been
+  // overtaken too often, then reserve them. Return `std::nullopt` if that
+  // takes longer than `maxWait`.
+  std::optional<Reservation> admit(size_t numBytes,
+                                   std::chrono::milliseconds maxWait);
+
+  size_t numReservedBytes() const;
+  size_t numWaitingQueries() const;
+
+ private:
+  void release(size_t numBytes);
+  // Return the number of bytes that are reserved instead of `numBytes`.
+  size_t replaceReservation(size_t oldNumBytes, size_t numBytes);
+
+  const size_t _budget;
+  mutable std::mutex _mutex;
+  std::condition_variable _admissionChanged;
+  size_t _numReservedBytes = 0;
+  // The number of times that each of the waiting queries was overtaken, in
+  // the order of their arrival.
+  std::list<size_t> _queue;
+};
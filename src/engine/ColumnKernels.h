@@ -0,0 +1,291 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "../global/Id.h"
+#include "./IdTable.h"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Kernels that operate on a single column of an `IdTable` (compare a column
+// against constants, create a selection vector of the matching rows, gather
+// the rows from such a selection vector, and search sorted columns). They are
+// vectorized with AVX-512 or AVX2 if the compiler targets these instruction
+// sets (e.g. when building with `-DUSE_CPU_SPECIFIC_INSTRUCTIONS=ON`) and fall
+// back to plain loops otherwise.
+namespace columnKernels {
+
+// A read-only view of a single column. For the row-major `IdTable`s the
+// `stride` is the number of columns, for contiguous column data it is 1.
+class ColumnView {
+ private:
+  const Id* _data;
+  size_t _size;
+  size_t _stride;
+
+ public:
+  ColumnView(const Id* data, size_t size, size_t stride)
+      : _data{data}, _size{size}, _stride{stride} {}
+
+  const Id& operator[](size_t row) const { return _data[row * _stride]; }
+  [[nodiscard]] const Id* data() const { return _data; }
+  [[nodiscard]] size_t size() const { return _size; }
+  [[nodiscard]] size_t stride() const { return _stride; }
+  [[nodiscard]] bool isContiguous() const { return _stride == 1; }
+};
+
+// Get a view of the column `col` of an `IdTable`, `IdTableStatic` or
+// `IdTableView`.
+template <typename Table>
+ColumnView getColumn(const Table& table, size_t col) {
+  AD_CHECK(col < table.cols());
+  return ColumnView{table.data() + col, table.size(), table.cols()};
+}
+
+// The (sorted) indices of the selected rows of a (block of a) column.
+using SelectionVector = std::vector<size_t>;
+
+namespace detail {
+// Append `offset + i` to `selection` for each bit `i` that is set in `mask`.
+inline void appendSetBits(uint64_t mask, size_t offset,
+                          SelectionVector* selection) {
+  while (mask != 0) {
+    selection->push_back(offset + std::countr_zero(mask));
+    mask &= mask - 1;
+  }
+}
+}  // namespace detail
+
+// Append the indices of all rows in [begin, end) of `column` with
+// `lower <= column[row] <= upper` to `selection`. If `inverse` is true, select
+// the rows outside of this range instead. The values are compared as unsigned
+// integers (which is the order of the `Id`s). An empty range (`lower > upper`)
+// selects no rows (or all rows if `inverse` is true).
+inline void selectInRange(const ColumnView& column, size_t begin, size_t end,
+                          Id lower, Id upper, bool inverse,
+                          SelectionVector* selection) {
+  AD_CHECK(end <= column.size());
+  size_t row = begin;
+  const Id* data = column.data();
+  const auto stride = static_cast<int64_t>(column.stride());
+#if defined(__AVX512F__)
+  const __m512i lowerVec = _mm512_set1_epi64(static_cast<int64_t>(lower));
+  const __m512i upperVec = _mm512_set1_epi64(static_cast<int64_t>(upper));
+  const __m512i offsets =
+      _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride,
+                       3 * stride, 2 * stride, stride, 0);
+  for (; row + 8 <= end; row += 8) {
+    __m512i values;
+    if (column.isContiguous()) {
+      values = _mm512_loadu_si512(data + row);
+    } else {
+      values = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF,
+                                             offsets, data + row * stride, 8);
+    }
+    uint64_t mask = _mm512_cmpge_epu64_mask(values, lowerVec) &
+                    _mm512_cmple_epu64_mask(values, upperVec);
+    if (inverse) {
+      mask = ~mask & 0xFF;
+    }
+    detail::appendSetBits(mask, row, selection);
+  }
+#elif defined(__AVX2__)
+  // AVX2 only has signed 64-bit comparisons. Flipping the sign bit maps the
+  // unsigned order to the signed order.
+  const __m256i signBit =
+      _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m256i lowerVec = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(lower)), signBit);
+  const __m256i upperVec = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(upper)), signBit);
+  const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+  for (; row + 4 <= end; row += 4) {
+    __m256i values;
+    if (column.isContiguous()) {
+      values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + row));
+    } else {
+      values = _mm256_i64gather_epi64(
+          reinterpret_cast<const long long*>(data + row * stride), offsets, 8);
+    }
+    values = _mm256_xor_si256(values, signBit);
+    __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(lowerVec, values),
+                                      _mm256_cmpgt_epi64(values, upperVec));
+    uint64_t mask = static_cast<uint64_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(outside)));
+    if (!inverse) {
+      mask = ~mask & 0xF;
+    }
+    detail::appendSetBits(mask, row, selection);
+  }
+#else
+  (void)data;
+  (void)stride;
+#endif
+  for (; row < end; ++row) {
+    bool inRange = lower <= column[row] && column[row] <= upper;
+    if (inRange != inverse) {
+      selection->push_back(row);
+    }
+  }
+}
+
+// Copy the rows [begin, end) of `column` to `target`, which must have space
+// for `end - begin` values. The values of a strided column are gathered with
+// vector instructions.
+inline void copyColumn(const ColumnView& column, size_t begin, size_t end,
+                       Id* target) {
+  AD_CHECK(begin <= end && end <= column.size());
+  const Id* data = column.data();
+  if (column.isContiguous()) {
+    std::copy(data + begin, data + end, target);
+    return;
+  }
+  size_t row = begin;
+  const auto stride = static_cast<int64_t>(column.stride());
+#if defined(__AVX512F__)
+  const __m512i offsets =
+      _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride,
+                       3 * stride, 2 * stride, stride, 0);
+  for (; row + 8 <= end; row += 8, target += 8) {
+    const __m512i values =
+        _mm512_i64gather_epi64(offsets, data + row * stride, 8);
+    _mm512_storeu_si512(target, values);
+  }
+#elif defined(__AVX2__)
+  const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+  for (; row + 4 <= end; row += 4, target += 4) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(target),
+        _mm256_i64gather_epi64(
+            reinterpret_cast<const long long*>(data + row * stride), offsets,
+            8));
+  }
+#else
+  (void)stride;
+#endif
+  for (; row < end; ++row) {
+    *target++ = column[row];
+  }
+}
+
+// Return the number of rows in [begin, end) of `column` with
+// `column[row] < value`.
+inline size_t countLess(const ColumnView& column, size_t begin, size_t end,
+                        Id value) {
+  size_t row = begin;
+  size_t count = 0;
+  const Id* data = column.data();
+  const auto stride = static_cast<int64_t>(column.stride());
+#if defined(__AVX512F__)
+  const __m512i valueVec = _mm512_set1_epi64(static_cast<int64_t>(value));
+  const __m512i offsets =
+      _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride,
+                       3 * stride, 2 * stride, stride, 0);
+  for (; row + 8 <= end; row += 8) {
+    __m512i values;
+    if (column.isContiguous()) {
+      values = _mm512_loadu_si512(data + row);
+    } else {
+      values = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF,
+                                             offsets, data + row * stride, 8);
+    }
+    count += std::popcount(
+        static_cast<unsigned>(_mm512_cmplt_epu64_mask(values, valueVec)));
+  }
+#elif defined(__AVX2__)
+  const __m256i signBit =
+      _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m256i valueVec = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(value)), signBit);
+  const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+  for (; row + 4 <= end; row += 4) {
+    __m256i values;
+    if (column.isContiguous()) {
+      values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + row));
+    } else {
+      values = _mm256_i64gather_epi64(
+          reinterpret_cast<const long long*>(data + row * stride), offsets, 8);
+    }
+    values = _mm256_xor_si256(values, signBit);
+    count += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(valueVec, values)))));
+  }
+#else
+  (void)data;
+  (void)stride;
+#endif
+  for (; row < end; ++row) {
+    count += column[row] < value;
+  }
+  return count;
+}
+
+// Windows with at most this many rows are scanned by `gallopLowerBound`
+// instead of being bisected further.
+static constexpr size_t GALLOP_LINEAR_SCAN_SIZE = 16;
+
+// Return the first row in [begin, end) of the sorted `column` with
+// `column[row] >= value` (or `end` if there is no such row). The search
+// gallops (exponential search) from `begin`, so it is fast when the result
+// is close to `begin`, which is the typical case when intersecting a small
+// with a large sorted column. The window found by the galloping is bisected
+// until it is small and then scanned with `countLess`. For a strided column
+// (the join column of a row-major `IdTable`) the window is scanned with
+// gathers only if the galloping itself already ended in a small window,
+// which is the common case for dense intersections.
+inline size_t gallopLowerBound(const ColumnView& column, size_t begin,
+                               size_t end, Id value) {
+  if (begin >= end || column[begin] >= value) {
+    return begin;
+  }
+  // After the galloping, `column[last] < value` and the result is in
+  // (last, high].
+  size_t last = begin;
+  size_t step = 1;
+  size_t high = begin + step;
+  while (high < end && column[high] < value) {
+    last = high;
+    step *= 2;
+    high = last + step;
+  }
+  size_t low = last + 1;
+  high = std::min(high, end);
+  // Gathering the values of a strided column pays off for the small windows
+  // of a short gallop, but not after bisecting a large window, which has
+  // already loaded the cache lines of the final rows.
+  const size_t scanSize =
+      column.isContiguous() || high - low <= GALLOP_LINEAR_SCAN_SIZE
+          ? GALLOP_LINEAR_SCAN_SIZE
+          : 0;
+  while (high - low > scanSize) {
+    size_t mid = low + (high - low) / 2;
+    if (column[mid] < value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low + countLess(column, low, high, value);
+}
+
+// Append the rows of `input` whose indices are stored in `selection` to
+// `result`.
+template <int WIDTH>
+void gatherRows(const IdTableView<WIDTH>& input,
+                const SelectionVector& selection,
+                IdTableStatic<WIDTH>* result) {
+  result->reserve(result->size() + selection.size());
+  for (size_t row : selection) {
+    result->push_back(input, row);
+  }
+}
+}  // namespace columnKernels
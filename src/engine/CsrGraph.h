@@ -0,0 +1,157 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "../global/Id.h"
+#include "../util/Exception.h"
+
+namespace csrGraph {
+
+// A directed graph in compressed sparse row (CSR) format. The nodes are the
+// distinct ids of the edges, numbered densely in ascending order of their ids.
+// The successors of the node `n` are `_targets[_offsets[n]]` to
+// `_targets[_offsets[n + 1] - 1]`, sorted and without duplicates. Compared to
+// a hash map of hash sets, this needs only three allocations, and the
+// successors of a node are contiguous in memory.
+class Graph {
+ public:
+  static constexpr size_t NO_NODE = std::numeric_limits<size_t>::max();
+
+  // The graph with the `numEdges` edges from `from(i)` to `to(i)`.
+  template <typename From, typename To>
+  Graph(size_t numEdges, const From& from, const To& to) {
+    _ids.reserve(2 * numEdges);
+    for (size_t i = 0; i < numEdges; ++i) {
+      _ids.push_back(from(i));
+      _ids.push_back(to(i));
+    }
+    std::sort(_ids.begin(), _ids.end());
+    _ids.erase(std::unique(_ids.begin(), _ids.end()), _ids.end());
+
+    // Count the edges per source node, then place them with a counting sort.
+    std::vector<size_t> sources(numEdges);
+    _offsets.assign(_ids.size() + 1, 0);
+    for (size_t i = 0; i < numEdges; ++i) {
+      sources[i] = node(from(i));
+      ++_offsets[sources[i] + 1];
+    }
+    for (size_t n = 0; n < _ids.size(); ++n) {
+      _offsets[n + 1] += _offsets[n];
+    }
+    _targets.resize(numEdges);
+    std::vector<size_t> insertPositions(_offsets.begin(), _offsets.end() - 1);
+    for (size_t i = 0; i < numEdges; ++i) {
+      _targets[insertPositions[sources[i]]++] = node(to(i));
+    }
+
+    // Sort the successors of each node and remove duplicate edges.
+    size_t numUniqueTargets = 0;
+    size_t begin = 0;
+    for (size_t n = 0; n < _ids.size(); ++n) {
+      const size_t end = _offsets[n + 1];
+      std::sort(_targets.begin() + begin, _targets.begin() + end);
+      auto last = std::unique(_targets.begin() + begin, _targets.begin() + end);
+      _offsets[n] = numUniqueTargets;
+      numUniqueTargets = std::copy(_targets.begin() + begin, last,
+                                   _targets.begin() + numUniqueTargets) -
+                         _targets.begin();
+      begin = end;
+    }
+    _offsets.back() = numUniqueTargets;
+    _targets.resize(numUniqueTargets);
+    _targets.shrink_to_fit();
+  }
+
+  size_t numNodes() const { return _ids.size(); }
+
+  // The node with the `id`, `NO_NODE` if the id is not part of any edge.
+  size_t node(Id id) const {
+    auto it = std::lower_bound(_ids.begin(), _ids.end(), id);
+    return it != _ids.end() && *it == id ? it - _ids.begin() : NO_NODE;
+  }
+
+  Id id(size_t node) const { return _ids[node]; }
+
+  const size_t* successorsBegin(size_t node) const {
+    return _targets.data() + _offsets[node];
+  }
+  const size_t* successorsEnd(size_t node) const {
+    return _targets.data() + _offsets[node + 1];
+  }
+  bool hasSuccessors(size_t node) const {
+    return _offsets[node + 1] > _offsets[node];
+  }
+
+ private:
+  std::vector<Id> _ids;
+  std::vector<size_t> _offsets;
+  std::vector<size_t> _targets;
+};
+
+// A breadth-first traversal of a `Graph`. The visited nodes are marked with an
+// epoch number instead of booleans, so the marks don't have to be reset
+// between the traversals from different start nodes. One `Traversal` must only
+// be used by one thread at a time.
+class Traversal {
+ public:
+  explicit Traversal(const Graph& graph)
+      : _graph{graph},
+        _emitted(graph.numNodes(), 0),
+        _onLevel(graph.numNodes(), 0) {}
+
+  // Call `emit(node)` once for each node that can be reached from the
+  // `start` node via a path of at least `minDist` and at most `maxDist` edges,
+  // in the order of their distance from `start`. `checkTimeout(n)` is called
+  // after each `n` processed edges.
+  template <typename Emit, typename CheckTimeout>
+  void reachableNodes(size_t start, size_t minDist, size_t maxDist,
+                      const Emit& emit, CheckTimeout& checkTimeout) {
+    AD_CHECK_LT(start, _graph.numNodes());
+    const size_t emittedEpoch = ++_epoch;
+    _frontier.clear();
+    _frontier.push_back(start);
+    for (size_t dist = 1; dist <= maxDist && !_frontier.empty(); ++dist) {
+      // On the levels below `minDist`, the frontier contains the nodes at the
+      // end of a path of exactly `dist` edges, since a node might be reached
+      // on a shorter path and on a path that is long enough. From then on, the
+      // successors of a node have to be visited only once, from the lowest
+      // level on which it is emitted.
+      const bool isEmittingLevel = dist >= minDist;
+      const size_t levelEpoch = ++_epoch;
+      _next.clear();
+      for (size_t node : _frontier) {
+        const size_t* begin = _graph.successorsBegin(node);
+        const size_t* end = _graph.successorsEnd(node);
+        checkTimeout(end - begin);
+        for (const size_t* it = begin; it != end; ++it) {
+          const size_t successor = *it;
+          if (isEmittingLevel) {
+            if (_emitted[successor] != emittedEpoch) {
+              _emitted[successor] = emittedEpoch;
+              emit(successor);
+              _next.push_back(successor);
+            }
+          } else if (_onLevel[successor] != levelEpoch) {
+            _onLevel[successor] = levelEpoch;
+            _next.push_back(successor);
+          }
+        }
+      }
+      std::swap(_frontier, _next);
+    }
+  }
+
+ private:
+  const Graph& _graph;
+  std::vector<size_t> _emitted;
+  std::vector<size_t> _onLevel;
+  size_t _epoch = 0;
+  std::vector<size_t> _frontier;
+  std::vector<size_t> _next;
+};
+}  // namespace csrGraph
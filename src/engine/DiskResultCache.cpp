@@ -0,0 +1,400 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./DiskResultCache.h"
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "../global/Constants.h"
+#include "../util/File.h"
+#include "../util/Log.h"
+#include "../util/Serializer/SerializeString.h"
+#include "../util/Serializer/SerializeVector.h"
+#include "../util/Serializer/Serializer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+// Part of the hash of each file name, change it when the format of the files
+// changes.
+constexpr uint64_t FILE_FORMAT_VERSION = 2;
+constexpr std::string_view FILE_EXTENSION = ".result";
+
+// A 64-bit FNV-1a hash of the `strings`. Unlike `std::hash` it is stable
+// across runs and platforms, which is required for the file names.
+uint64_t stableHash(std::initializer_list<std::string_view> strings) {
+  uint64_t hash = 14695981039346656037ull ^ FILE_FORMAT_VERSION;
+  for (std::string_view s : strings) {
+    for (char c : s) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    // Separate the strings, so that "ab", "c" and "a", "bc" differ.
+    hash = (hash ^ 0xFF) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// The header of a file (everything except the rows) is read into memory, a
+// larger header size means that the file is corrupt.
+constexpr size_t MAX_HEADER_SIZE = 1ull << 32;
+
+// Throw if the return value `code` of a zstd function is an error code.
+size_t checkZstd(size_t code) {
+  if (ZSTD_isError(code)) {
+    throw std::runtime_error(std::string{"zstd error: "} +
+                             ZSTD_getErrorName(code));
+  }
+  return code;
+}
+
+// Compress the concatenation of the `parts` into a single zstd frame and
+// write it to the `file` in chunks, so that neither the uncompressed nor the
+// compressed data is ever copied as a whole. Stop and return false as soon as
+// more than `maxSize` bytes have been written.
+bool compressToFile(std::initializer_list<std::string_view> parts,
+                    ad_utility::File* file, size_t maxSize) {
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context{
+      ZSTD_createCCtx(), &ZSTD_freeCCtx};
+  AD_CHECK(context);
+  checkZstd(ZSTD_CCtx_setParameter(context.get(), ZSTD_c_checksumFlag, 1));
+  std::vector<char> buffer(ZSTD_CStreamOutSize());
+  size_t numBytesWritten = 0;
+  for (auto part = parts.begin(); part != parts.end(); ++part) {
+    const bool isLastPart = part + 1 == parts.end();
+    ZSTD_inBuffer input{part->data(), part->size(), 0};
+    bool isFinished = false;
+    while (!isFinished) {
+      ZSTD_outBuffer output{buffer.data(), buffer.size(), 0};
+      const size_t remaining = checkZstd(ZSTD_compressStream2(
+          context.get(), &output, &input,
+          isLastPart ? ZSTD_e_end : ZSTD_e_continue));
+      AD_CHECK(file->write(buffer.data(), output.pos) == output.pos);
+      numBytesWritten += output.pos;
+      if (numBytesWritten > maxSize) {
+        return false;
+      }
+      isFinished = isLastPart ? remaining == 0 : input.pos == input.size;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+// Reads a zstd frame from a file in chunks and decompresses it piece by piece
+// into given targets.
+class DiskResultCache::Decompressor {
+ public:
+  explicit Decompressor(ad_utility::File* file)
+      : _file{file},
+        _context{ZSTD_createDCtx(), &ZSTD_freeDCtx},
+        _buffer(ZSTD_DStreamInSize()) {
+    AD_CHECK(_context);
+  }
+
+  // Decompress the next `size` bytes to the `target`.
+  void decompressTo(char* target, size_t size) {
+    ZSTD_outBuffer output{target, size, 0};
+    while (output.pos < output.size) {
+      const size_t outputPos = output.pos;
+      const bool isInputEmpty = _input.pos == _input.size && !readInput();
+      _remaining =
+          checkZstd(ZSTD_decompressStream(_context.get(), &output, &_input));
+      if (isInputEmpty && output.pos == outputPos) {
+        throw std::runtime_error("Unexpected end of the compressed data");
+      }
+    }
+  }
+
+  // Check that the frame (including its checksum) is complete and is
+  // followed by the end of the file.
+  void checkEnd() {
+    while (_remaining != 0) {
+      ZSTD_outBuffer output{nullptr, 0, 0};
+      const bool isInputEmpty = _input.pos == _input.size && !readInput();
+      const size_t inputPos = _input.pos;
+      _remaining =
+          checkZstd(ZSTD_decompressStream(_context.get(), &output, &_input));
+      if (isInputEmpty && _input.pos == inputPos && _remaining != 0) {
+        throw std::runtime_error("Unexpected end of the compressed data");
+      }
+    }
+    if (_input.pos != _input.size || readInput()) {
+      throw std::runtime_error("Unexpected data after the result");
+    }
+  }
+
+ private:
+  // Read the next chunk of the file into the `_input`, return false at the
+  // end of the file.
+  bool readInput() {
+    _input = {_buffer.data(), _file->read(_buffer.data(), _buffer.size()), 0};
+    return _input.size > 0;
+  }
+
+  ad_utility::File* _file;
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> _context;
+  std::vector<char> _buffer;
+  ZSTD_inBuffer _input{nullptr, 0, 0};
+  // The last return value of `ZSTD_decompressStream`, which is 0 when the
+  // frame is complete.
+  size_t _remaining = 1;
+};
+
+// _____________________________________________________________________________
+DiskResultCache::DiskResultCache(std::string directory, size_t maxSizeInBytes,
+                                 std::string indexIdentity)
+    : _directory{std::move(directory)},
+      _maxSize{maxSizeInBytes},
+      _indexIdentity{std::move(indexIdentity)} {
+  fs::create_directories(_directory);
+  // Register the files of earlier runs, ordered by their last access, and
+  // delete incomplete files of interrupted writes.
+  std::vector<std::tuple<fs::file_time_type, std::string, size_t>> files;
+  for (const auto& file : fs::directory_iterator(_directory)) {
+    if (!file.is_regular_file()) {
+      continue;
+    }
+    if (file.path().extension() == FILE_EXTENSION) {
+      files.emplace_back(file.last_write_time(),
+                         file.path().filename().string(), file.file_size());
+    } else if (file.path().extension() == ".tmp") {
+      ad_utility::deleteFile(file.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  auto catalog = _catalog.wlock();
+  for (auto& [time, name, size] : files) {
+    catalog->_entries[std::move(name)] = {size, catalog->_accessCounter++};
+    catalog->_totalSize += size;
+  }
+  makeRoom(&*catalog, 0);
+  LOG(INFO) << "Disk cache in \"" << _directory << "\" contains "
+            << catalog->_entries.size() << " results of total size "
+            << catalog->_totalSize / (1ull << 20) << " MB" << std::endl;
+}
+
+// _____________________________________________________________________________
+std::string DiskResultCache::fileName(const std::string& key) const {
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx",
+           static_cast<unsigned long long>(stableHash({_indexIdentity, key})));
+  return std::string{hex} + std::string{FILE_EXTENSION};
+}
+
+// _____________________________________________________________________________
+std::string DiskResultCache::indexIdentity(const std::string& indexBasename) {
+  const std::string pso = indexBasename + ".index.pso";
+  std::error_code error;
+  auto size = fs::file_size(pso, error);
+  auto time = fs::last_write_time(pso, error);
+  return indexBasename + " " + std::to_string(error ? 0 : size) + " " +
+         std::to_string(error ? 0 : time.time_since_epoch().count());
+}
+
+// _____________________________________________________________________________
+bool DiskResultCache::makeRoom(Catalog* catalog, size_t size) {
+  if (size > _maxSize) {
+    return false;
+  }
+  while (!catalog->_entries.empty() &&
+         catalog->_totalSize + size > _maxSize) {
+    auto leastRecentlyUsed = std::min_element(
+        catalog->_entries.begin(), catalog->_entries.end(),
+        [](const auto& a, const auto& b) {
+          return a.second._lastAccess < b.second._lastAccess;
+        });
+    std::error_code error;
+    fs::remove(fs::path{_directory} / leastRecentlyUsed->first, error);
+    catalog->_totalSize -= leastRecentlyUsed->second._size;
+    catalog->_entries.erase(leastRecentlyUsed);
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+void DiskResultCache::write(const std::string& key, const ResultTable& result,
+                            double computeTimeInMs) {
+  const std::string name = fileName(key);
+  if (_catalog.rlock()->_entries.contains(name)) {
+    return;
+  }
+
+  // Everything except the rows of the result. The identity of the index and
+  // the key are stored as well, to detect collisions of the hash in the file
+  // name.
+  ad_utility::serialization::ByteBufferWriteSerializer writer;
+  writer << _indexIdentity;
+  writer << key;
+  writer << computeTimeInMs;
+  writer << result._sortedBy;
+  std::vector<int> resultTypes;
+  for (auto type : result._resultTypes) {
+    resultTypes.push_back(static_cast<int>(type));
+  }
+  writer << resultTypes;
+  writer << (result._localVocab ? *result._localVocab
+                                : ResultTable::LocalVocab{});
+  writer << result._idTable.cols();
+  writer << result._idTable.size();
+  const auto header = std::move(writer).data();
+  const size_t headerSize = header.size();
+
+  // Write to a temporary file that is only renamed when it is complete, so
+  // that readers never see partial files. The rows are compressed directly
+  // from the `IdTable`.
+  static std::atomic<size_t> tmpCounter = 0;
+  const fs::path path = fs::path{_directory} / name;
+  const fs::path tmpPath = fs::path{_directory} /
+                           (name + "." + std::to_string(tmpCounter++) + ".tmp");
+  bool fitsIntoQuota;
+  {
+    ad_utility::File file{tmpPath.string(), "w"};
+    fitsIntoQuota = compressToFile(
+        {{reinterpret_cast<const char*>(&headerSize), sizeof(headerSize)},
+         {header.data(), headerSize},
+         {reinterpret_cast<const char*>(result._idTable.data()),
+          result._idTable.size() * result._idTable.cols() * sizeof(Id)}},
+        &file, _maxSize);
+  }
+  const size_t fileSize = fs::file_size(tmpPath);
+
+  auto catalog = _catalog.wlock();
+  if (!fitsIntoQuota || catalog->_entries.contains(name) ||
+      !makeRoom(&*catalog, fileSize)) {
+    ad_utility::deleteFile(tmpPath);
+    return;
+  }
+  fs::rename(tmpPath, path);
+  catalog->_entries[name] = {fileSize, catalog->_accessCounter++};
+  catalog->_totalSize += fileSize;
+}
+
+// _____________________________________________________________________________
+void DiskResultCache::writeInBackground(
+    std::string key, std::shared_ptr<const ResultTable> result,
+    double computeTimeInMs) {
+  {
+    std::lock_guard lock{_pendingWritesMutex};
+    if (_numPendingWrites >= DISK_CACHE_MAX_PENDING_WRITES) {
+      LOG(DEBUG) << "Too many pending writes, the result is not written to "
+                    "the disk cache"
+                 << std::endl;
+      return;
+    }
+    ++_numPendingWrites;
+  }
+  _writeQueue.push([this, key = std::move(key), result = std::move(result),
+                    computeTimeInMs]() {
+    try {
+      write(key, *result, computeTimeInMs);
+    } catch (const std::exception& e) {
+      LOG(WARN) << "Could not write a result to the disk cache: " << e.what()
+                << std::endl;
+    }
+    std::lock_guard lock{_pendingWritesMutex};
+    --_numPendingWrites;
+    _pendingWritesFinished.notify_all();
+  });
+}
+
+// _____________________________________________________________________________
+void DiskResultCache::waitForBackgroundWrites() {
+  std::unique_lock lock{_pendingWritesMutex};
+  _pendingWritesFinished.wait(lock, [this] { return _numPendingWrites == 0; });
+}
+
+// _____________________________________________________________________________
+std::optional<double> DiskResultCache::read(const std::string& key,
+                                            ResultTable* result) {
+  const std::string name = fileName(key);
+  const fs::path path = fs::path{_directory} / name;
+  {
+    auto catalog = _catalog.wlock();
+    auto it = catalog->_entries.find(name);
+    if (it == catalog->_entries.end()) {
+      return std::nullopt;
+    }
+    it->second._lastAccess = catalog->_accessCounter++;
+  }
+  // Keep the order of the accesses for the next run.
+  std::error_code ignored;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ignored);
+
+  try {
+    ad_utility::File file{path.string(), "r"};
+    Decompressor decompressor{&file};
+    size_t headerSize;
+    decompressor.decompressTo(reinterpret_cast<char*>(&headerSize),
+                              sizeof(headerSize));
+    AD_CHECK(headerSize <= MAX_HEADER_SIZE);
+    std::vector<char> header(headerSize);
+    decompressor.decompressTo(header.data(), headerSize);
+    ad_utility::serialization::ByteBufferReadSerializer reader{
+        std::move(header)};
+    std::string indexIdentity;
+    std::string storedKey;
+    reader >> indexIdentity;
+    reader >> storedKey;
+    if (indexIdentity != _indexIdentity || storedKey != key) {
+      return std::nullopt;
+    }
+    double computeTimeInMs;
+    reader >> computeTimeInMs;
+    reader >> result->_sortedBy;
+    std::vector<int> resultTypes;
+    reader >> resultTypes;
+    result->_resultTypes.clear();
+    for (int type : resultTypes) {
+      result->_resultTypes.push_back(static_cast<qlever::ResultType>(type));
+    }
+    result->_localVocab = std::make_shared<ResultTable::LocalVocab>();
+    reader >> *result->_localVocab;
+    size_t numColumns;
+    size_t numRows;
+    reader >> numColumns;
+    reader >> numRows;
+    // The rows are decompressed directly into the `IdTable`, whose memory is
+    // taken from the allocator of the query.
+    result->_idTable.setCols(numColumns);
+    result->_idTable.resize(numRows);
+    decompressor.decompressTo(reinterpret_cast<char*>(result->_idTable.data()),
+                              numRows * numColumns * sizeof(Id));
+    decompressor.checkEnd();
+    return computeTimeInMs;
+  } catch (const ad_utility::detail::AllocationExceedsLimitException&) {
+    // Not a problem of the file, the result can be read again later.
+    result->_idTable.clear();
+    throw;
+  } catch (const std::exception& e) {
+    LOG(WARN) << "Could not read the result from the disk cache file " << path
+              << ", deleting it: " << e.what() << std::endl;
+    auto catalog = _catalog.wlock();
+    if (auto it = catalog->_entries.find(name); it != catalog->_entries.end()) {
+      fs::remove(path, ignored);
+      catalog->_totalSize -= it->second._size;
+      catalog->_entries.erase(it);
+    }
+    result->_idTable.clear();
+    return std::nullopt;
+  }
+}
+
+// _____________________________________________________________________________
+void DiskResultCache::clear() {
+  auto catalog = _catalog.wlock();
+  std::error_code ignored;
+  for (const auto& [name, entry] : catalog->_entries) {
+    fs::remove(fs::path{_directory} / name, ignored);
+  }
+  catalog->_entries.clear();
+  catalog->_totalSize = 0;
+}
@@ -0,0 +1,113 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+
+#include "../global/Constants.h"
+#include "../util/HashMap.h"
+#include "../util/Synchronized.h"
+#include "../util/TaskQueue.h"
+#include "./ResultTable.h"
+
+// A second tier of the `QueryResultCache` that stores results in a directory
+// on disk, so that they survive a restart of the server. Each result is stored
+// zstd-compressed in its own file, together with its local vocabulary and the
+// time that its computation took. The rows are compressed and decompressed as
+// a stream directly from and to the `IdTable`. A result is therefore read
+// completely when it is requested and is not mapped into memory lazily: the
+// compressed files cannot be mapped, and an uncompressed file would take
+// several times as much of the quota. The file name is a hash of the
+// cache key and the identity of the index (see `indexIdentity`), so results
+// that were computed on a different index are never read. When the total size
+// of the files exceeds the quota, the least recently used files are deleted.
+//
+// This class is threadsafe.
+class DiskResultCache {
+ public:
+  // Use the `directory` (created if it doesn't exist) and keep the total size
+  // of the files in it at most `maxSizeInBytes`. Files from earlier runs are
+  // kept and can be read if the `indexIdentity` is the same.
+  DiskResultCache(std::string directory, size_t maxSizeInBytes,
+                  std::string indexIdentity);
+
+  // Store the `result` of a computation that took `computeTimeInMs` under the
+  // `key`. Does nothing if there already is a result with this key or if the
+  // compressed result is larger than the quota.
+  void write(const std::string& key, const ResultTable& result,
+             double computeTimeInMs);
+
+  // Like `write`, but in a background thread, so that the computation of a
+  // query doesn't wait for the disk. The `result` is kept alive until it is
+  // written. If `DISK_CACHE_MAX_PENDING_WRITES` results are already waiting to
+  // be written, the `result` is not written.
+  void writeInBackground(std::string key,
+                         std::shared_ptr<const ResultTable> result,
+                         double computeTimeInMs);
+
+  // Block until all the writes from `writeInBackground` are finished.
+  void waitForBackgroundWrites();
+
+  // Read the result with the `key` into the `result`, which must be empty, and
+  // return the time that its computation took. Return `std::nullopt` if there
+  // is no result with this key.
+  std::optional<double> read(const std::string& key, ResultTable* result);
+
+  // Delete all the results.
+  void clear();
+
+  size_t numEntries() const { return _catalog.rlock()->_entries.size(); }
+
+  // The total size of the files in bytes.
+  size_t size() const { return _catalog.rlock()->_totalSize; }
+
+  // An identity of the index with the `indexBasename` that changes when the
+  // index is rebuilt: its basename and the size and modification time of its
+  // PSO permutation.
+  static std::string indexIdentity(const std::string& indexBasename);
+
+ private:
+  struct Entry {
+    size_t _size;
+    // Files with a lower value were used less recently.
+    uint64_t _lastAccess;
+  };
+
+  // The files in the `_directory` by their name.
+  struct Catalog {
+    ad_utility::HashMap<std::string, Entry> _entries;
+    size_t _totalSize = 0;
+    uint64_t _accessCounter = 0;
+  };
+
+  // The name of the file for the `key`, relative to the `_directory`.
+  std::string fileName(const std::string& key) const;
+
+  // Delete the least recently used files until a file of size `size` fits
+  // into the quota. Return false if it doesn't fit even into an empty cache.
+  bool makeRoom(Catalog* catalog, size_t size);
+
+  class Decompressor;
+
+  std::string _directory;
+  size_t _maxSize;
+  std::string _indexIdentity;
+  ad_utility::Synchronized<Catalog, std::shared_mutex> _catalog;
+
+  // The number of results that were passed to `writeInBackground` and are not
+  // written yet.
+  size_t _numPendingWrites = 0;
+  std::mutex _pendingWritesMutex;
+  std::condition_variable _pendingWritesFinished;
+  // Declared last, so that the pending writes are finished before the other
+  // members are destroyed.
+  ad_utility::TaskQueue<> _writeQueue{DISK_CACHE_MAX_PENDING_WRITES, 1,
+                                      "DiskResultCache"};
+};
@@ -12,11 +12,16 @@
 #include "../global/Id.h"
 #include "../util/Exception.h"
 #include "../util/Log.h"
+#include "./ColumnKernels.h"
 #include "./IndexSequence.h"
 #include "IdTable.h"
 
 class Engine {
  public:
+  // The number of rows for which `filterRange` computes a selection vector at
+  // once.
+  static constexpr size_t FILTER_BLOCK_SIZE = 1 << 16;
+
   template <typename Comp, int WIDTH>
   static void filter(const IdTableView<WIDTH>& v, const Comp& comp,
                      IdTableStatic<WIDTH>* result) {
@@ -31,6 +36,29 @@ class Engine {
     LOG(DEBUG) << "Filter done, size now: " << result->size() << " elements.\n";
   }
 
+  // Append all rows of `input` with `lower <= input(row, col) <= upper` to
+  // `result` (or all other rows if `inverse` is true). Uses the vectorized
+  // column kernels, the input is processed in blocks to keep the selection
+  // vector small.
+  template <int WIDTH>
+  static void filterRange(const IdTableView<WIDTH>& input, size_t col,
+                          Id lower, Id upper, bool inverse,
+                          IdTableStatic<WIDTH>* result) {
+    AD_CHECK(result);
+    LOG(DEBUG) << "Filtering " << input.size() << " elements by range.\n";
+    const auto column = columnKernels::getColumn(input, col);
+    columnKernels::SelectionVector selection;
+    selection.reserve(FILTER_BLOCK_SIZE);
+    for (size_t begin = 0; begin < input.size(); begin += FILTER_BLOCK_SIZE) {
+      size_t end = std::min(begin + FILTER_BLOCK_SIZE, input.size());
+      selection.clear();
+      columnKernels::selectInRange(column, begin, end, lower, upper, inverse,
+                                   &selection);
+      columnKernels::gatherRows(input, selection, result);
+    }
+    LOG(DEBUG) << "Filter done, size now: " << result->size() << " elements.\n";
+  }
+
   template <int IN_WIDTH, int FILTER_WIDTH>
   static void filter(const IdTable& dynV, size_t fc1, size_t fc2,
                      const IdTable& dynFilter, IdTable* dynResult) {
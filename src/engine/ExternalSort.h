@@ -0,0 +1,243 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "../global/Constants.h"
+#include "../util/CompressionUsingZstd/ZstdWrapper.h"
+#include "../util/File.h"
+#include "../util/Log.h"
+#include "../util/Random.h"
+#include "./Engine.h"
+#include "./QueryExecutionContext.h"
+#include "./ResultTable.h"
+
+// Sorting of results that do not fit into memory twice. `Sort` and `OrderBy`
+// copy their input and sort the copy, so they need twice the memory of the
+// input. When the `AllocatorWithLimit` doesn't have that much memory left, the
+// input is sorted with an external merge sort instead: it is split into runs
+// of at most `spill-run-size-mb` (and of at most the memory that is left) that
+// are sorted and written zstd-compressed to temporary files in the
+// `spill-directory`. Then the input is released, and the runs are merged into
+// the result, which only needs one block of `SPILL_BLOCK_SIZE_IN_BYTES` per
+// run in memory.
+namespace externalSort {
+
+namespace detail {
+// A sorted run in a temporary file, which is deleted with the run. The rows
+// are stored in separately compressed blocks, so that they can be read one
+// block at a time.
+class SpilledRun {
+ public:
+  explicit SpilledRun(const std::string& directory) {
+    thread_local FastRandomIntGenerator<uint64_t> randomSuffix;
+    static std::atomic<size_t> counter = 0;
+    _filename = (std::filesystem::path{directory} /
+                 ("qlever-spill-" + std::to_string(counter++) + "-" +
+                  std::to_string(randomSuffix()) + ".tmp"))
+                    .string();
+    _file.open(_filename, "w+");
+  }
+  ~SpilledRun() {
+    _file.close();
+    ad_utility::deleteFile(_filename);
+  }
+  SpilledRun(const SpilledRun&) = delete;
+  SpilledRun& operator=(const SpilledRun&) = delete;
+
+  // Append the `numRows` rows with `numColumns` columns at `rows`, in blocks
+  // of `rowsPerBlock` rows.
+  void write(const Id* rows, size_t numRows, size_t numColumns,
+             size_t rowsPerBlock) {
+    for (size_t begin = 0; begin < numRows; begin += rowsPerBlock) {
+      const size_t blockSize = std::min(rowsPerBlock, numRows - begin);
+      auto compressed = ZstdWrapper::compress(
+          const_cast<Id*>(rows + begin * numColumns),
+          blockSize * numColumns * sizeof(Id));
+      _file.write(compressed.data(), compressed.size());
+      _blocks.push_back({_fileSize, compressed.size(), blockSize});
+      _fileSize += compressed.size();
+    }
+    // The blocks are read with `pread`, which bypasses the buffer of the file.
+    _file.flush();
+  }
+
+  size_t numBlocks() const { return _blocks.size(); }
+
+  // Decompress the `i`-th block into the `buffer` and return its number of
+  // rows.
+  size_t readBlock(size_t i, size_t numColumns, std::vector<Id>* buffer) {
+    const Block& block = _blocks[i];
+    std::vector<char> compressed(block._compressedSize);
+    AD_CHECK(_file.read(compressed.data(), compressed.size(),
+                        block._offset) ==
+             static_cast<ssize_t>(compressed.size()));
+    buffer->resize(block._numRows * numColumns);
+    ZstdWrapper::decompressToBuffer(compressed.data(), compressed.size(),
+                                    buffer->data(),
+                                    buffer->size() * sizeof(Id));
+    return block._numRows;
+  }
+
+ private:
+  struct Block {
+    off_t _offset;
+    size_t _compressedSize;
+    size_t _numRows;
+  };
+  std::string _filename;
+  ad_utility::File _file;
+  std::vector<Block> _blocks;
+  off_t _fileSize = 0;
+};
+}  // namespace detail
+
+// Sort the rows of the `input` with the `comparator` into the (empty)
+// `result` with an external merge sort, using runs of at most `rowsPerRun`
+// rows in the `directory`. The `input` is released before the `result` is
+// allocated, and `makeRoom(numIds)` is called right before with the size of
+// the result, so that memory that is held elsewhere (e.g. by the cache) can be
+// freed. The `comparator` has to accept the rows of an `IdTableStatic<WIDTH>`
+// as well as pointers to the first `Id` of a row. `checkTimeout` is called
+// after each run and regularly during the merge.
+template <int WIDTH, typename Comparator, typename MakeRoom>
+void externalSort(std::shared_ptr<const ResultTable> input, IdTable* result,
+                  Comparator comparator, const std::string& directory,
+                  size_t rowsPerRun, MakeRoom makeRoom,
+                  const std::function<void()>& checkTimeout = []() {}) {
+  const size_t numColumns = input->_idTable.cols();
+  const size_t numRows = input->_idTable.size();
+  rowsPerRun = std::max(rowsPerRun, size_t{1});
+  const size_t rowsPerBlock =
+      std::max(SPILL_BLOCK_SIZE_IN_BYTES /
+                   (std::max(numColumns, size_t{1}) * sizeof(Id)),
+               size_t{1});
+  LOG(INFO) << "Sorting " << numRows << " rows externally in runs of "
+            << rowsPerRun << " rows in \"" << directory << "\"" << std::endl;
+
+  std::vector<std::unique_ptr<detail::SpilledRun>> runs;
+  {
+    IdTable run{numColumns, result->getAllocator()};
+    for (size_t begin = 0; begin < numRows; begin += rowsPerRun) {
+      const size_t runSize = std::min(rowsPerRun, numRows - begin);
+      run.resize(runSize);
+      std::memcpy(run.data(), input->_idTable.data() + begin * numColumns,
+                  runSize * numColumns * sizeof(Id));
+      Engine::sort<WIDTH>(&run, comparator);
+      runs.push_back(std::make_unique<detail::SpilledRun>(directory));
+      runs.back()->write(run.data(), runSize, numColumns, rowsPerBlock);
+      run.clear();
+      checkTimeout();
+    }
+  }
+  input.reset();
+  makeRoom(numRows * numColumns);
+
+  // Merge the runs with a heap of their current rows.
+  result->setCols(numColumns);
+  result->resize(numRows);
+  struct Position {
+    std::vector<Id> _block;
+    size_t _blockIndex = 0;
+    size_t _row = 0;
+    size_t _numRows = 0;
+  };
+  std::vector<Position> positions(runs.size());
+  auto currentRow = [&](size_t run) -> const Id* {
+    return positions[run]._block.data() + positions[run]._row * numColumns;
+  };
+  auto isGreater = [&](size_t a, size_t b) {
+    return comparator(currentRow(b), currentRow(a));
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(isGreater)> heap{
+      isGreater};
+  for (size_t i = 0; i < runs.size(); ++i) {
+    positions[i]._numRows =
+        runs[i]->readBlock(0, numColumns, &positions[i]._block);
+    heap.push(i);
+  }
+  Id* target = result->data();
+  size_t numMergedRows = 0;
+  while (!heap.empty()) {
+    if (++numMergedRows % NUM_OPERATIONS_BETWEEN_TIMEOUT_CHECKS == 0) {
+      checkTimeout();
+    }
+    const size_t run = heap.top();
+    heap.pop();
+    std::memcpy(target, currentRow(run), numColumns * sizeof(Id));
+    target += numColumns;
+    Position& position = positions[run];
+    if (++position._row == position._numRows) {
+      if (++position._blockIndex == runs[run]->numBlocks()) {
+        // Delete the file as soon as possible.
+        runs[run].reset();
+        position._block = {};
+        continue;
+      }
+      position._numRows = runs[run]->readBlock(position._blockIndex,
+                                               numColumns, &position._block);
+      position._row = 0;
+    }
+    heap.push(run);
+  }
+  LOG(INFO) << "Merged " << runs.size() << " sorted runs" << std::endl;
+}
+
+// Sort the rows of the `input` with the `comparator` into the (empty)
+// `result`. Copy the input and sort the copy in memory if the memory that is
+// left suffices for the copy, else use `externalSort`. The sort in memory
+// can't be interrupted (it might run on several threads), so `checkTimeout`
+// is only called before and after it.
+template <int WIDTH, typename Comparator>
+void sortInMemoryOrExternally(std::shared_ptr<const ResultTable> input,
+                              IdTable* result, Comparator comparator,
+                              QueryExecutionContext* qec,
+                              const std::function<void()>& checkTimeout) {
+  const size_t numBytes =
+      input->_idTable.size() * input->_idTable.cols() * sizeof(Id);
+  if (numBytes <= result->getAllocator().numFreeBytes()) {
+    try {
+      IdTable copy{input->_idTable.cols(), result->getAllocator()};
+      copy.insert(copy.end(), input->_idTable.begin(), input->_idTable.end());
+      checkTimeout();
+      Engine::sort<WIDTH>(&copy, comparator);
+      checkTimeout();
+      *result = std::move(copy);
+      return;
+    } catch (const ad_utility::detail::AllocationExceedsLimitException&) {
+      // Another query took the memory in the meantime.
+      LOG(INFO) << "Not enough memory left to sort in memory" << std::endl;
+    }
+  }
+  std::string directory = RuntimeParameters().get<"spill-directory">();
+  if (directory.empty()) {
+    directory = std::filesystem::temp_directory_path().string();
+  }
+  auto makeRoom = [qec](size_t numIds) {
+    qec->getQueryTreeCache().makeRoomAsMuchAsPossible(numIds);
+  };
+  // The runs are sorted in memory of the same allocator, which just didn't
+  // have enough memory left for the copy. So make the runs at most as large
+  // as the memory that is left after making room for them, but at least one
+  // block.
+  const size_t runSizeInBytes =
+      std::min(numBytes, RuntimeParameters().get<"spill-run-size-mb">() << 20);
+  makeRoom(runSizeInBytes / sizeof(Id));
+  const size_t rowsPerRun =
+      std::max(std::min(runSizeInBytes, result->getAllocator().numFreeBytes()),
+               SPILL_BLOCK_SIZE_IN_BYTES) /
+      (std::max(input->_idTable.cols(), size_t{1}) * sizeof(Id));
+  externalSort<WIDTH>(std::move(input), result, std::move(comparator),
+                      directory, rowsPerRun, makeRoom, checkTimeout);
+}
+}  // namespace externalSort
@@ -294,6 +294,14 @@ void Filter::computeFilterRange(IdTableStatic<WIDTH>* res, size_t lhs,
       res->insert(res->end(), input.begin(), lower);
       res->insert(res->end(), upper, res->end());
     }
+  } else if constexpr (T != ResultTable::ResultType::FLOAT) {
+    // The values are ordered like the Ids, so the vectorized range filter can
+    // be used. The range [rhs_lower, rhs_upper) is empty if rhs_upper == 0.
+    if (rhs_upper > 0) {
+      Engine::filterRange(input, lhs, rhs_lower, rhs_upper - 1, INVERSE, res);
+    } else if constexpr (INVERSE) {
+      res->insert(res->end(), input.begin(), input.end());
+    }
   } else {
     const auto inv = [&](const bool b) { return INVERSE ? !b : b; };
     getEngine().filter(
@@ -338,8 +346,7 @@ void Filter::computeFilterFixedValue(
           res->insert(res->end(), lower, upper);
         }
       } else {
-        getEngine().filter(
-            input, [lhs, rhs](const auto& e) { return e[lhs] == rhs; }, res);
+        Engine::filterRange(input, lhs, rhs, rhs, false, res);
       }
       break;
     case SparqlFilter::NE:
@@ -366,8 +373,7 @@ void Filter::computeFilterFixedValue(
           res->insert(res->end(), input.begin(), input.end());
         }
       } else {
-        getEngine().filter(
-            input, [lhs, rhs](const auto& e) { return e[lhs] != rhs; }, res);
+        Engine::filterRange(input, lhs, rhs, rhs, true, res);
       }
       break;
     case SparqlFilter::LT:
@@ -381,6 +387,11 @@ void Filter::computeFilterFixedValue(
               return ValueReader<T>::get(l[lhs]) < ValueReader<T>::get(r[lhs]);
             });
         res->insert(res->end(), input.begin(), lower);
+      } else if constexpr (T != ResultTable::ResultType::FLOAT) {
+        // The values are ordered like the Ids, use the vectorized filter.
+        if (rhs > 0) {
+          Engine::filterRange(input, lhs, 0, rhs - 1, false, res);
+        }
       } else {
         getEngine().filter(
             input,
@@ -401,6 +412,9 @@ void Filter::computeFilterFixedValue(
               return ValueReader<T>::get(l[lhs]) < ValueReader<T>::get(r[lhs]);
             });
         res->insert(res->end(), input.begin(), upper);
+      } else if constexpr (T != ResultTable::ResultType::FLOAT) {
+        // The values are ordered like the Ids, use the vectorized filter.
+        Engine::filterRange(input, lhs, 0, rhs, false, res);
       } else {
         getEngine().filter(
             input,
@@ -422,6 +436,12 @@ void Filter::computeFilterFixedValue(
             });
         // an element equal to rhs exists in the vector
         res->insert(res->end(), upper, input.end());
+      } else if constexpr (T != ResultTable::ResultType::FLOAT) {
+        // The values are ordered like the Ids, use the vectorized filter.
+        if (rhs < std::numeric_limits<Id>::max()) {
+          Engine::filterRange(input, lhs, rhs + 1,
+                              std::numeric_limits<Id>::max(), false, res);
+        }
       } else {
         getEngine().filter(
             input,
@@ -443,6 +463,10 @@ void Filter::computeFilterFixedValue(
             });
         // an element equal to rhs exists in the vector
         res->insert(res->end(), lower, input.end());
+      } else if constexpr (T != ResultTable::ResultType::FLOAT) {
+        // The values are ordered like the Ids, use the vectorized filter.
+        Engine::filterRange(input, lhs, rhs, std::numeric_limits<Id>::max(),
+                            false, res);
       } else {
         getEngine().filter(
             input,
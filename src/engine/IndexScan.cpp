@@ -7,6 +7,8 @@
 #include <sstream>
 #include <string>
 
+#include "./SemiJoinFilter.h"
+
 using std::string;
 
 // _____________________________________________________________________________
@@ -265,6 +267,40 @@ void IndexScan::computeResult(ResultTable* result) {
   LOG(DEBUG) << "IndexScan result computation done.\n";
 }
 
+// _____________________________________________________________________________
+bool IndexScan::applySemiJoinFilter(
+    size_t col, const std::shared_ptr<const SemiJoinFilter>& filter) {
+  // The first column of these scans is the second column of the permutation,
+  // whose range in each block is stored in the block meta data.
+  bool isSortedByFilteredColumn = _type == PSO_FREE_S || _type == POS_FREE_O ||
+                                  _type == SPO_FREE_P || _type == SOP_FREE_O ||
+                                  _type == OPS_FREE_P || _type == OSP_FREE_S;
+  if (col != 0 || !isSortedByFilteredColumn) {
+    return false;
+  }
+  // Several joins on the same variable restrict the scan further.
+  _semiJoinFilter = _semiJoinFilter ? std::make_shared<const SemiJoinFilter>(
+                                          _semiJoinFilter->intersect(*filter))
+                                    : filter;
+  return true;
+}
+
+// _____________________________________________________________________________
+template <class Permutation>
+void IndexScan::scanRelation(const string& key, const Permutation& permutation,
+                             ResultTable* result) {
+  const auto& idx = _executionContext->getIndex();
+  if (!_semiJoinFilter) {
+    idx.scan(key, &result->_idTable, permutation, _timeoutTimer);
+    return;
+  }
+  size_t numSkippedBlocks = idx.scan(key, &result->_idTable, permutation,
+                                     *_semiJoinFilter, _timeoutTimer);
+  getRuntimeInfo().addDetail("semiJoinFilterSize", _semiJoinFilter->size());
+  getRuntimeInfo().addDetail("numBlocksSkippedBySemiJoinFilter",
+                             numSkippedBlocks);
+}
+
 // _____________________________________________________________________________
 void IndexScan::computePSOboundS(ResultTable* result) const {
   result->_idTable.setCols(1);
@@ -275,13 +311,13 @@ void IndexScan::computePSOboundS(ResultTable* result) const {
 }
 
 // _____________________________________________________________________________
-void IndexScan::computePSOfreeS(ResultTable* result) const {
+void IndexScan::computePSOfreeS(ResultTable* result) {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_sortedBy = {0, 1};
   const auto& idx = _executionContext->getIndex();
-  idx.scan(_predicate, &result->_idTable, idx._PSO, _timeoutTimer);
+  scanRelation(_predicate, idx._PSO, result);
 }
 
 // _____________________________________________________________________________
@@ -294,13 +330,13 @@ void IndexScan::computePOSboundO(ResultTable* result) const {
 }
 
 // _____________________________________________________________________________
-void IndexScan::computePOSfreeO(ResultTable* result) const {
+void IndexScan::computePOSfreeO(ResultTable* result) {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_sortedBy = {0, 1};
   const auto& idx = _executionContext->getIndex();
-  idx.scan(_predicate, &result->_idTable, idx._POS, _timeoutTimer);
+  scanRelation(_predicate, idx._POS, result);
 }
 
 // _____________________________________________________________________________
@@ -332,13 +368,13 @@ size_t IndexScan::computeSizeEstimate() {
 }
 
 // _____________________________________________________________________________
-void IndexScan::computeSPOfreeP(ResultTable* result) const {
+void IndexScan::computeSPOfreeP(ResultTable* result) {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_sortedBy = {0, 1};
   const auto& idx = _executionContext->getIndex();
-  idx.scan(_subject, &result->_idTable, idx._SPO, _timeoutTimer);
+  scanRelation(_subject, idx._SPO, result);
 }
 
 // _____________________________________________________________________________
@@ -351,33 +387,33 @@ void IndexScan::computeSOPboundO(ResultTable* result) const {
 }
 
 // _____________________________________________________________________________
-void IndexScan::computeSOPfreeO(ResultTable* result) const {
+void IndexScan::computeSOPfreeO(ResultTable* result) {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_sortedBy = {0, 1};
   const auto& idx = _executionContext->getIndex();
-  idx.scan(_subject, &result->_idTable, idx._SOP, _timeoutTimer);
+  scanRelation(_subject, idx._SOP, result);
 }
 
 // _____________________________________________________________________________
-void IndexScan::computeOPSfreeP(ResultTable* result) const {
+void IndexScan::computeOPSfreeP(ResultTable* result) {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_sortedBy = {0, 1};
   const auto& idx = _executionContext->getIndex();
-  idx.scan(_object, &result->_idTable, idx._OPS, _timeoutTimer);
+  scanRelation(_object, idx._OPS, result);
 }
 
 // _____________________________________________________________________________
-void IndexScan::computeOSPfreeS(ResultTable* result) const {
+void IndexScan::computeOSPfreeS(ResultTable* result) {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_sortedBy = {0, 1};
   const auto& idx = _executionContext->getIndex();
-  idx.scan(_object, &result->_idTable, idx._OSP, _timeoutTimer);
+  scanRelation(_object, idx._OSP, result);
 }
 
 // _____________________________________________________________________________
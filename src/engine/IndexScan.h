@@ -97,28 +97,46 @@ class IndexScan : public Operation {
   string _object;
   size_t _sizeEstimate;
   vector<float> _multiplicity;
+  // Restricts the values of the first column of the result (see
+  // `Operation::addSemiJoinFilter`), nullptr if there is no restriction.
+  std::shared_ptr<const SemiJoinFilter> _semiJoinFilter;
 
   virtual void computeResult(ResultTable* result) override;
 
+  // Scans with one fixed and two free variables can skip the blocks of the
+  // permutation that don't contain a value of the filter in their first
+  // column.
+  bool applySemiJoinFilter(
+      size_t col,
+      const std::shared_ptr<const SemiJoinFilter>& filter) override;
+
+  void resetSemiJoinFilter() override { _semiJoinFilter = nullptr; }
+
+  // Scan the relation `key` of the `permutation` into the `result`. Use the
+  // semi-join filter if there is one.
+  template <class Permutation>
+  void scanRelation(const string& key, const Permutation& permutation,
+                    ResultTable* result);
+
   vector<QueryExecutionTree*> getChildren() override { return {}; }
 
   void computePSOboundS(ResultTable* result) const;
 
-  void computePSOfreeS(ResultTable* result) const;
+  void computePSOfreeS(ResultTable* result);
 
   void computePOSboundO(ResultTable* result) const;
 
-  void computePOSfreeO(ResultTable* result) const;
+  void computePOSfreeO(ResultTable* result);
 
-  void computeSPOfreeP(ResultTable* result) const;
+  void computeSPOfreeP(ResultTable* result);
 
   void computeSOPboundO(ResultTable* result) const;
 
-  void computeSOPfreeO(ResultTable* result) const;
+  void computeSOPfreeO(ResultTable* result);
 
-  void computeOPSfreeP(ResultTable* result) const;
+  void computeOPSfreeP(ResultTable* result);
 
-  void computeOSPfreeS(ResultTable* result) const;
+  void computeOSPfreeS(ResultTable* result);
 
   size_t computeSizeEstimate();
 };
@@ -9,8 +9,12 @@
 #include <type_traits>
 #include <unordered_set>
 
+#include "../util/OnDestruction.h"
+#include "./ColumnKernels.h"
 #include "./QueryExecutionTree.h"
 #include "CallFixedSize.h"
+#include "PartitionedJoin.h"
+#include "SemiJoinFilter.h"
 
 using std::string;
 
@@ -95,28 +99,45 @@ void Join::computeResult(ResultTable* result) {
     return;
   }
 
-  LOG(TRACE) << "Computing left side..." << endl;
-  shared_ptr<const ResultTable> leftRes = _left->getResult();
-  runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
-
-  // TODO<joka921> Currently the _resultTypes are set incorrectly in case
-  // of early stopping. For now, early stopping is thus disabled.
-  // TODO: Implement getting the result types without calculating the result;
-  // Check if we can stop early.
-  /*
-  if (leftRes->size() == 0) {
-    LOG(TRACE) << "Left side empty thus join result is empty" << endl;
-    runtimeInfo.addDetail("The left side was empty", "");
-    size_t resWidth = leftWidth + rightWidth - 1;
-    result->_data.setCols(resWidth);
-    result->_resultTypes.resize(result->_data.cols());
-    result->_sortedBy = {_leftJoinCol};
-    return;
+  // When one side is expected to be much smaller than the other, compute it
+  // first, its join column might then restrict the computation of the other
+  // side (see `passSemiJoinFilter`). Otherwise, compute both sides
+  // concurrently.
+  const size_t leftSizeEstimate = _left->getSizeEstimate();
+  const size_t rightSizeEstimate = _right->getSizeEstimate();
+  const bool leftIsSmaller = leftSizeEstimate <= rightSizeEstimate;
+  const size_t smallerSizeEstimate =
+      std::min(leftSizeEstimate, rightSizeEstimate);
+  const bool semiJoinFilterMightPayOff =
+      smallerSizeEstimate <= MAX_SEMI_JOIN_FILTER_SIZE &&
+      smallerSizeEstimate * MIN_SIZE_RATIO_FOR_SEMI_JOIN_FILTER <=
+          std::max(leftSizeEstimate, rightSizeEstimate);
+  shared_ptr<const ResultTable> leftRes;
+  shared_ptr<const ResultTable> rightRes;
+  if (semiJoinFilterMightPayOff) {
+    LOG(TRACE) << "Computing " << (leftIsSmaller ? "left" : "right")
+               << " side..." << endl;
+    shared_ptr<const ResultTable> smallerRes =
+        leftIsSmaller ? _left->getResult() : _right->getResult();
+    passSemiJoinFilter(leftIsSmaller, *smallerRes);
+    // The filter only applies to this computation of the larger side.
+    const auto& largerTree = leftIsSmaller ? _right : _left;
+    ad_utility::OnDestruction clearFilters{[&largerTree]() noexcept {
+      largerTree->getRootOperation()->clearSemiJoinFilters();
+    }};
+
+    LOG(TRACE) << "Computing " << (leftIsSmaller ? "right" : "left")
+               << " side..." << endl;
+    shared_ptr<const ResultTable> largerRes = largerTree->getResult();
+    leftRes = leftIsSmaller ? smallerRes : largerRes;
+    rightRes = leftIsSmaller ? largerRes : smallerRes;
+  } else {
+    LOG(TRACE) << "Computing both sides concurrently..." << endl;
+    auto results = computeChildrenConcurrently({_left.get(), _right.get()});
+    leftRes = std::move(results[0]);
+    rightRes = std::move(results[1]);
   }
-   */
-
-  LOG(TRACE) << "Computing right side..." << endl;
-  shared_ptr<const ResultTable> rightRes = _right->getResult();
+  runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
   runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
 
   LOG(DEBUG) << "Computing Join result..." << endl;
@@ -145,6 +166,62 @@ void Join::computeResult(ResultTable* result) {
   LOG(DEBUG) << "Join result computation done." << endl;
 }
 
+// _____________________________________________________________________________
+void Join::passSemiJoinFilter(bool leftIsSmaller,
+                              const ResultTable& smallerRes) {
+  const auto& smallerTree = leftIsSmaller ? _left : _right;
+  const auto& largerTree = leftIsSmaller ? _right : _left;
+  size_t smallerJoinCol = leftIsSmaller ? _leftJoinCol : _rightJoinCol;
+  size_t largerJoinCol = leftIsSmaller ? _rightJoinCol : _leftJoinCol;
+  // The filter only pays off if it is small compared to the other side, and
+  // we must not replace an already cached result of the other side by a
+  // filtered recomputation.
+  if (smallerRes.size() > MAX_SEMI_JOIN_FILTER_SIZE ||
+      smallerRes.size() * MIN_SIZE_RATIO_FOR_SEMI_JOIN_FILTER >
+          largerTree->getSizeEstimate() ||
+      smallerRes._sortedBy.empty() ||
+      smallerRes._sortedBy[0] != smallerJoinCol ||
+      _executionContext->getQueryTreeCache().cacheContains(
+          largerTree->asString())) {
+    return;
+  }
+  auto filter = std::make_shared<const SemiJoinFilter>(
+      SemiJoinFilter::fromSortedColumn(
+          smallerRes._idTable, smallerJoinCol,
+          "column " + std::to_string(smallerJoinCol) + " of {" +
+              smallerTree->asString() + "}"));
+  if (largerTree->getRootOperation()->addSemiJoinFilter(largerJoinCol,
+                                                        filter)) {
+    getRuntimeInfo().addDetail("semiJoinFilterSize", filter->size());
+  }
+}
+
+// _____________________________________________________________________________
+bool Join::applySemiJoinFilter(
+    size_t col, const std::shared_ptr<const SemiJoinFilter>& filter) {
+  if (isFullScanDummy(_left) || isFullScanDummy(_right)) {
+    return false;
+  }
+  // The result consists of the columns of the left side followed by the
+  // columns of the right side without its join column.
+  size_t leftWidth = _left->getResultWidth();
+  if (col == _leftJoinCol) {
+    bool appliedLeft =
+        _left->getRootOperation()->addSemiJoinFilter(_leftJoinCol, filter);
+    bool appliedRight =
+        _right->getRootOperation()->addSemiJoinFilter(_rightJoinCol, filter);
+    return appliedLeft || appliedRight;
+  }
+  if (col < leftWidth) {
+    return _left->getRootOperation()->addSemiJoinFilter(col, filter);
+  }
+  size_t rightCol = col - leftWidth;
+  if (rightCol >= _rightJoinCol) {
+    ++rightCol;
+  }
+  return _right->getRootOperation()->addSemiJoinFilter(rightCol, filter);
+}
+
 // _____________________________________________________________________________
 ad_utility::HashMap<string, size_t> Join::getVariableColumns() const {
   ad_utility::HashMap<string, size_t> retVal;
@@ -533,81 +610,38 @@ void Join::join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
   IdTableStatic<OUT_WIDTH> result = dynRes->moveToStatic<OUT_WIDTH>();
   // Cannot just switch l1 and l2 around because the order of
   // items in the result tuples is important.
+  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
+  auto checkTimeout = [&checkTimeoutAfterNCalls]() {
+    checkTimeoutAfterNCalls();
+  };
   if (a.size() / b.size() > GALLOP_THRESHOLD) {
-    doGallopInnerJoin(LeftLargerTag{}, a, jc1, b, jc2, &result);
+    doGallopInnerJoin(LeftLargerTag{}, a, jc1, b, jc2, &result, checkTimeout);
   } else if (b.size() / a.size() > GALLOP_THRESHOLD) {
-    doGallopInnerJoin(RightLargerTag{}, a, jc1, b, jc2, &result);
+    doGallopInnerJoin(RightLargerTag{}, a, jc1, b, jc2, &result,
+                      checkTimeout);
   } else {
-    auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
-    // Intersect both lists.
-    size_t i = 0;
-    size_t j = 0;
-    // while (a(i, jc1) < sent1) {
-    while (i < a.size() && j < b.size()) {
-      while (a(i, jc1) < b(j, jc2)) {
-        ++i;
-        checkTimeoutAfterNCalls();
-        if (i >= a.size()) {
-          goto finish;
-        }
-      }
-
-      while (b(j, jc2) < a(i, jc1)) {
-        ++j;
-        checkTimeoutAfterNCalls();
-        if (j >= b.size()) {
-          goto finish;
-        }
-      }
-
-      while (a(i, jc1) == b(j, jc2)) {
-        // In case of match, create cross-product
-        // Always fix a and go through b.
-        size_t keepJ = j;
-        while (a(i, jc1) == b(j, jc2)) {
-          result.push_back();
-          const size_t backIndex = result.size() - 1;
-          for (size_t h = 0; h < a.cols(); h++) {
-            result(backIndex, h) = a(i, h);
-          }
-
-          // Copy bs columns before the join column
-          for (size_t h = 0; h < jc2; h++) {
-            result(backIndex, h + a.cols()) = b(j, h);
-          }
-
-          // Copy bs columns after the join column
-          for (size_t h = jc2 + 1; h < b.cols(); h++) {
-            result(backIndex, h + a.cols() - 1) = b(j, h);
-          }
-
-          ++j;
-          checkTimeoutAfterNCalls();
-          if (j >= b.size()) {
-            // The next i might still match
-            break;
-          }
-        }
-        ++i;
-        checkTimeoutAfterNCalls();
-        if (i >= a.size()) {
-          goto finish;
-        }
-        // If the next i is still the same, reset j.
-        if (a(i, jc1) == b(keepJ, jc2)) {
-          j = keepJ;
-        } else if (j >= b.size()) {
-          // this check is needed because otherwise we might leak an out of
-          // bounds value for j into the next loop which does not check it. this
-          // fixes a bug that was not discovered by testing due to 0
-          // initialization of IdTables used for testing and should not occur in
-          // typical use cases but it is still wrong.
-          goto finish;
-        }
-      }
+    size_t numPartitions =
+        partitionedJoin::getNumPartitions(a.size(), b.size());
+    if (numPartitions <= 1) {
+      doMergeJoin(a, jc1, {0, a.size(), 0, b.size()}, b, jc2, &result);
+    } else {
+      // Split both inputs by join column values and join the parts
+      // concurrently. The concatenation of the partial results is still
+      // sorted by the join column.
+      auto partitions = partitionedJoin::computePartitions(
+          a.size(), b.size(), [&a, jc1](size_t i) { return a(i, jc1); },
+          [&b, jc2](size_t i) { return b(i, jc2); }, numPartitions);
+      LOG(DEBUG) << "Computing the join in " << partitions.size()
+                 << " partitions.\n";
+      partitionedJoin::joinPartitionsInParallel(
+          partitions,
+          [&](const partitionedJoin::JoinPartition& partition,
+              IdTableStatic<OUT_WIDTH>* partialResult) {
+            doMergeJoin(a, jc1, partition, b, jc2, partialResult);
+          },
+          &result, makeTaskGroup());
     }
   }
-finish:
   *dynRes = result.moveToDynamic();
 
   LOG(DEBUG) << "Join done.\n";
@@ -616,123 +650,75 @@ finish:
 }
 
 // _____________________________________________________________________________
-template <typename TagType, int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
-void Join::doGallopInnerJoin(const TagType, const IdTableView<L_WIDTH>& l1,
-                             const size_t jc1, const IdTableView<R_WIDTH>& l2,
-                             const size_t jc2,
-                             IdTableStatic<OUT_WIDTH>* result) {
-  LOG(DEBUG) << "Galloping case.\n";
-  size_t i = 0;
-  size_t j = 0;
-  while (i < l1.size() && j < l2.size()) {
-    if constexpr (std::is_same<TagType, RightLargerTag>::value) {
-      while (l1(i, jc1) < l2(j, jc2)) {
-        ++i;
-        if (i >= l1.size()) {
-          return;
-        }
-      }
-      size_t step = 1;
-      size_t last = j;
-      while (l1(i, jc1) > l2(j, jc2)) {
-        last = j;
-        j += step;
-        step *= 2;
-        if (j >= l2.size()) {
-          j = l2.size() - 1;
-          if (l1(i, jc1) > l2(j, jc2)) {
-            return;
-          }
-        }
-      }
-      if (l1(i, jc1) == l2(j, jc2)) {
-        // We stepped into a block where l1 and l2 are equal. We need to
-        // find the beginning of this block
-        while (j > 0 && l1(i, jc1) == l2(j - 1, jc2)) {
-          j--;
-        }
-      } else if (l1(i, jc1) < l2(j, jc2)) {
-        // We stepped over the location where l1 and l2 may be equal.
-        // Use binary search to locate that spot
-        const Id needle = l1(i, jc1);
-        j = std::lower_bound(l2.begin() + last, l2.begin() + j, needle,
-                             [jc2](const auto& l, const Id needle) -> bool {
-                               return l[jc2] < needle;
-                             }) -
-            l2.begin();
-      }
-    } else {
-      size_t step = 1;
-      size_t last = j;
-      while (l2(j, jc2) > l1(i, jc1)) {
-        last = i;
-        i += step;
-        step *= 2;
-        if (i >= l1.size()) {
-          i = l1.size() - 1;
-          if (l2(j, jc2) > l1(i, jc1)) {
-            return;
-          }
-        }
-      }
-      if (l2(j, jc2) == l1(i, jc1)) {
-        // We stepped into a block where l1 and l2 are equal. We need to
-        // find the beginning of this block
-        while (i > 0 && l1(i - 1, jc1) == l2(j, jc2)) {
-          i--;
-        }
-      } else if (l2(j, jc2) < l1(i, jc1)) {
-        // We stepped over the location where l1 and l2 may be equal.
-        // Use binary search to locate that spot
-        const Id needle = l2(j, jc2);
-        i = std::lower_bound(l1.begin() + last, l1.begin() + i, needle,
-                             [jc1](const auto& l, const Id needle) -> bool {
-                               return l[jc1] < needle;
-                             }) -
-            l1.begin();
+template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+void Join::doMergeJoin(const IdTableView<L_WIDTH>& a, size_t jc1,
+                       const partitionedJoin::JoinPartition& partition,
+                       const IdTableView<R_WIDTH>& b, size_t jc2,
+                       IdTableStatic<OUT_WIDTH>* resultPtr) const {
+  auto& result = *resultPtr;
+  const size_t aEnd = partition._leftEnd;
+  const size_t bEnd = partition._rightEnd;
+  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
+  // Intersect both lists.
+  size_t i = partition._leftBegin;
+  size_t j = partition._rightBegin;
+  while (i < aEnd && j < bEnd) {
+    while (a(i, jc1) < b(j, jc2)) {
+      ++i;
+      checkTimeoutAfterNCalls();
+      if (i >= aEnd) {
+        return;
       }
-      while (l1(i, jc1) > l2(j, jc2)) {
-        ++j;
-        if (j >= l2.size()) {
-          return;
-        }
+    }
+
+    while (b(j, jc2) < a(i, jc1)) {
+      ++j;
+      checkTimeoutAfterNCalls();
+      if (j >= bEnd) {
+        return;
       }
     }
-    while (l1(i, jc1) == l2(j, jc2)) {
+
+    while (a(i, jc1) == b(j, jc2)) {
       // In case of match, create cross-product
-      // Always fix l1 and go through l2.
-      const size_t keepJ = j;
-      while (l1(i, jc1) == l2(j, jc2)) {
-        size_t rowIndex = result->size();
-        result->push_back();
-        for (size_t h = 0; h < l1.cols(); h++) {
-          (*result)(rowIndex, h) = l1(i, h);
+      // Always fix a and go through b.
+      size_t keepJ = j;
+      while (a(i, jc1) == b(j, jc2)) {
+        result.push_back();
+        const size_t backIndex = result.size() - 1;
+        for (size_t h = 0; h < a.cols(); h++) {
+          result(backIndex, h) = a(i, h);
         }
-        // Copy l2s columns before the join column
+
+        // Copy bs columns before the join column
         for (size_t h = 0; h < jc2; h++) {
-          (*result)(rowIndex, h + l1.cols()) = l2(j, h);
+          result(backIndex, h + a.cols()) = b(j, h);
         }
 
-        // Copy l2s columns after the join column
-        for (size_t h = jc2 + 1; h < l2.cols(); h++) {
-          (*result)(rowIndex, h + l1.cols() - 1) = l2(j, h);
+        // Copy bs columns after the join column
+        for (size_t h = jc2 + 1; h < b.cols(); h++) {
+          result(backIndex, h + a.cols() - 1) = b(j, h);
         }
+
         ++j;
-        if (j >= l2.size()) {
+        checkTimeoutAfterNCalls();
+        if (j >= bEnd) {
+          // The next i might still match
           break;
         }
       }
       ++i;
-      if (i >= l1.size()) {
+      checkTimeoutAfterNCalls();
+      if (i >= aEnd) {
         return;
       }
       // If the next i is still the same, reset j.
-      if (l1(i, jc1) == l2(keepJ, jc2)) {
+      if (a(i, jc1) == b(keepJ, jc2)) {
         j = keepJ;
-      } else if (j >= l2.size()) {
-        // this check is needed because otherwise we might leak an out of bounds
-        // value for j into the next loop which does not check it.
-        // this fixes a bug that was not discovered by testing due to 0
+      } else if (j >= bEnd) {
+        // this check is needed because otherwise we might leak an out of
+        // bounds value for j into the next loop which does not check it. this
+        // fixes a bug that was not discovered by testing due to 0
         // initialization of IdTables used for testing and should not occur in
         // typical use cases but it is still wrong.
         return;
@@ -740,3 +726,74 @@ void Join::doGallopInnerJoin(const TagType, const IdTableView<L_WIDTH>& l1,
     }
   }
 }
+
+// _____________________________________________________________________________
+template <typename TagType, int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+void Join::doGallopInnerJoin(const TagType, const IdTableView<L_WIDTH>& l1,
+                             const size_t jc1, const IdTableView<R_WIDTH>& l2,
+                             const size_t jc2, IdTableStatic<OUT_WIDTH>* result,
+                             const std::function<void()>& checkTimeout) {
+  LOG(DEBUG) << "Galloping case.\n";
+  // The smaller input is traversed row by row, the next matching row of the
+  // larger input is located with a galloping search that scans the final
+  // window with vector instructions.
+  const auto col1 = columnKernels::getColumn(l1, jc1);
+  const auto col2 = columnKernels::getColumn(l2, jc2);
+  auto addRow = [&](size_t i, size_t j) {
+    size_t rowIndex = result->size();
+    result->push_back();
+    for (size_t h = 0; h < l1.cols(); h++) {
+      (*result)(rowIndex, h) = l1(i, h);
+    }
+    // Copy l2s columns before the join column
+    for (size_t h = 0; h < jc2; h++) {
+      (*result)(rowIndex, h + l1.cols()) = l2(j, h);
+    }
+
+    // Copy l2s columns after the join column
+    for (size_t h = jc2 + 1; h < l2.cols(); h++) {
+      (*result)(rowIndex, h + l1.cols() - 1) = l2(j, h);
+    }
+  };
+
+  size_t i = 0;
+  size_t j = 0;
+  if constexpr (std::is_same<TagType, RightLargerTag>::value) {
+    for (; i < l1.size(); ++i) {
+      checkTimeout();
+      j = columnKernels::gallopLowerBound(col2, j, l2.size(), col1[i]);
+      if (j >= l2.size()) {
+        return;
+      }
+      // In case of match, create the cross-product. Equal values in l1 find
+      // the same j again.
+      for (size_t k = j; k < l2.size() && col2[k] == col1[i]; ++k) {
+        addRow(i, k);
+      }
+    }
+  } else {
+    for (; j < l2.size(); ++j) {
+      checkTimeout();
+      i = columnKernels::gallopLowerBound(col1, i, l1.size(), col2[j]);
+      if (i >= l1.size()) {
+        return;
+      }
+      if (col1[i] != col2[j]) {
+        continue;
+      }
+      // In case of match, create the cross-product of the blocks of equal
+      // values. Always fix l1 and go through l2.
+      const Id value = col2[j];
+      size_t jEnd = j + 1;
+      while (jEnd < l2.size() && col2[jEnd] == value) {
+        ++jEnd;
+      }
+      for (; i < l1.size() && col1[i] == value; ++i) {
+        for (size_t k = j; k < jEnd; ++k) {
+          addRow(i, k);
+        }
+      }
+      j = jEnd - 1;
+    }
+  }
+}
@@ -3,12 +3,14 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 #pragma once
 
+#include <functional>
 #include <list>
 
 #include "../util/HashMap.h"
 #include "../util/HashSet.h"
 #include "./IndexScan.h"
 #include "./Operation.h"
+#include "./PartitionedJoin.h"
 #include "./QueryExecutionTree.h"
 
 using std::list;
@@ -74,12 +76,26 @@ class Join : public Operation {
   void join(const IdTable& dynA, size_t jc1, const IdTable& dynB, size_t jc2,
             IdTable* dynRes);
 
+  /**
+   * @brief Merge join of the rows of a and b in the given partition (which
+   * are sorted by the join columns jc1 and jc2). Appends the cross products
+   * of the matching rows to result.
+   **/
+  template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+  void doMergeJoin(const IdTableView<L_WIDTH>& a, size_t jc1,
+                   const partitionedJoin::JoinPartition& partition,
+                   const IdTableView<R_WIDTH>& b, size_t jc2,
+                   IdTableStatic<OUT_WIDTH>* result) const;
+
   class RightLargerTag {};
   class LeftLargerTag {};
+  // `checkTimeout` is called for each row of the smaller input.
   template <typename TagType, int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
-  static void doGallopInnerJoin(TagType, const IdTableView<L_WIDTH>& l1,
-                                size_t jc1, const IdTableView<R_WIDTH>& l2,
-                                size_t jc2, IdTableStatic<OUT_WIDTH>* result);
+  static void doGallopInnerJoin(
+      TagType, const IdTableView<L_WIDTH>& l1, size_t jc1,
+      const IdTableView<R_WIDTH>& l2, size_t jc2,
+      IdTableStatic<OUT_WIDTH>* result,
+      const std::function<void()>& checkTimeout = []() {});
 
  private:
   std::shared_ptr<QueryExecutionTree> _left;
@@ -97,6 +113,16 @@ class Join : public Operation {
 
   virtual void computeResult(ResultTable* result) override;
 
+  // Pass the distinct values of the join column of the already computed
+  // smaller side as a semi-join filter to the other side, if this is expected
+  // to make the computation of the other side cheaper.
+  void passSemiJoinFilter(bool leftIsSmaller, const ResultTable& smallerRes);
+
+  // A filter on the join column is passed to both children, filters on other
+  // columns to the child that contains the column.
+  bool applySemiJoinFilter(
+      size_t col, const std::shared_ptr<const SemiJoinFilter>& filter) override;
+
  public:
   static bool isFullScanDummy(std::shared_ptr<QueryExecutionTree> tree) {
     return tree->getType() == QueryExecutionTree::SCAN &&
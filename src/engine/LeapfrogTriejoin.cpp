@@ -0,0 +1,419 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "LeapfrogTriejoin.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "./ColumnKernels.h"
+
+using std::string;
+
+namespace {
+// A sorted `IdTable` viewed as a trie: level `d` of the trie consists of the
+// distinct values in column `d` among the rows that share the values of the
+// columns [0, d) that were fixed by `open()`. All positioning operations use
+// the galloping search, so skipping large parts of an input is cheap.
+class TrieIterator {
+ private:
+  struct Level {
+    size_t _pos;
+    size_t _end;
+  };
+  const IdTable& _table;
+  std::vector<columnKernels::ColumnView> _columns;
+  // The levels that are currently open, `_levels.back()` is the current one.
+  std::vector<Level> _levels;
+
+ public:
+  explicit TrieIterator(const IdTable& table) : _table{table} {
+    for (size_t col = 0; col < table.cols(); ++col) {
+      _columns.push_back(columnKernels::getColumn(table, col));
+    }
+  }
+
+  [[nodiscard]] Id key() const {
+    return _columns[_levels.size() - 1][_levels.back()._pos];
+  }
+
+  [[nodiscard]] bool atEnd() const {
+    return _levels.back()._pos == _levels.back()._end;
+  }
+
+  // Descend to the first value of the next level below the current key.
+  void open() {
+    if (_levels.empty()) {
+      _levels.push_back({0, _table.size()});
+      return;
+    }
+    const Level& level = _levels.back();
+    _levels.push_back({level._pos, endOfCurrentKey()});
+  }
+
+  // Return to the level above, the position on that level is unchanged.
+  void up() { _levels.pop_back(); }
+
+  // Move to the next distinct value on the current level.
+  void next() {
+    Level& level = _levels.back();
+    level._pos = endOfCurrentKey();
+  }
+
+  // Move to the first value on the current level that is >= `value`.
+  void seek(Id value) {
+    Level& level = _levels.back();
+    level._pos = columnKernels::gallopLowerBound(
+        _columns[_levels.size() - 1], level._pos, level._end, value);
+  }
+
+ private:
+  // The first position on the current level after the rows with the current
+  // key.
+  [[nodiscard]] size_t endOfCurrentKey() const {
+    const Level& level = _levels.back();
+    const Id currentKey = key();
+    if (currentKey == std::numeric_limits<Id>::max()) {
+      return level._end;
+    }
+    return columnKernels::gallopLowerBound(_columns[_levels.size() - 1],
+                                           level._pos, level._end,
+                                           currentKey + 1);
+  }
+};
+
+// Position all `iterators` (which are on the level of the same variable) on
+// the smallest value >= their current keys that all of them contain. Return
+// false if there is no such value.
+bool leapfrogSearch(const std::vector<TrieIterator*>& iterators,
+                    const std::function<void()>& checkTimeout) {
+  while (true) {
+    checkTimeout();
+    Id maxKey = 0;
+    for (const TrieIterator* it : iterators) {
+      if (it->atEnd()) {
+        return false;
+      }
+      maxKey = std::max(maxKey, it->key());
+    }
+    bool allEqual = true;
+    for (TrieIterator* it : iterators) {
+      if (it->key() < maxKey) {
+        it->seek(maxKey);
+        if (it->atEnd()) {
+          return false;
+        }
+        allEqual &= it->key() == maxKey;
+      }
+    }
+    if (allEqual) {
+      return true;
+    }
+  }
+}
+
+// Bind the variables [variable, numVariables) one after the other and append
+// a row to `result` for each complete binding. `iteratorsPerVariable[v]` are
+// the iterators of the inputs that contain the variable `v`.
+void leapfrogTriejoin(
+    size_t variable,
+    const std::vector<std::vector<TrieIterator*>>& iteratorsPerVariable,
+    std::vector<Id>* binding, IdTable* result,
+    const std::function<void()>& checkTimeout) {
+  if (variable == binding->size()) {
+    result->emplace_back();
+    for (size_t col = 0; col < binding->size(); ++col) {
+      (*result)(result->size() - 1, col) = (*binding)[col];
+    }
+    return;
+  }
+  const auto& iterators = iteratorsPerVariable[variable];
+  for (TrieIterator* it : iterators) {
+    it->open();
+  }
+  while (leapfrogSearch(iterators, checkTimeout)) {
+    (*binding)[variable] = iterators[0]->key();
+    leapfrogTriejoin(variable + 1, iteratorsPerVariable, binding, result,
+                     checkTimeout);
+    // Advancing one of the iterators suffices, the search aligns the others.
+    iterators[0]->next();
+  }
+  for (TrieIterator* it : iterators) {
+    it->up();
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+LeapfrogTriejoin::LeapfrogTriejoin(
+    QueryExecutionContext* qec,
+    std::vector<std::shared_ptr<QueryExecutionTree>> children,
+    std::vector<std::string> variableOrder)
+    : Operation(qec),
+      _children(std::move(children)),
+      _variableOrder(std::move(variableOrder)) {
+  AD_CHECK_GE(_children.size(), 2u);
+  // Order the children so that identical queries can be identified.
+  std::sort(_children.begin(), _children.end(),
+            [](const auto& a, const auto& b) {
+              return a->asString() < b->asString();
+            });
+  std::vector<bool> isCovered(_variableOrder.size(), false);
+  for (const auto& child : _children) {
+    std::vector<size_t> variables(child->getResultWidth());
+    std::vector<bool> hasVariable(child->getResultWidth(), false);
+    for (const auto& [var, col] : child->getVariableColumns()) {
+      auto it = std::find(_variableOrder.begin(), _variableOrder.end(), var);
+      if (it == _variableOrder.end()) {
+        AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+                 "Variable " + var +
+                     " of an input of the LeapfrogTriejoin is not part of the "
+                     "variable order.");
+      }
+      variables[col] = it - _variableOrder.begin();
+      hasVariable[col] = true;
+      isCovered[variables[col]] = true;
+    }
+    for (size_t col = 0; col < variables.size(); ++col) {
+      if (!hasVariable[col] ||
+          (col > 0 && variables[col - 1] >= variables[col])) {
+        AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+                 "The columns of each input of the LeapfrogTriejoin have to be "
+                 "distinct variables in the order of the join.");
+      }
+    }
+    auto sortedOn = child->resultSortedOn();
+    bool isSortedByAllColumns = sortedOn.size() >= variables.size();
+    for (size_t col = 0; isSortedByAllColumns && col < variables.size();
+         ++col) {
+      isSortedByAllColumns = sortedOn[col] == col;
+    }
+    if (!isSortedByAllColumns) {
+      AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+               "The inputs of the LeapfrogTriejoin have to be sorted by all "
+               "their columns.");
+    }
+    _childVariables.push_back(std::move(variables));
+  }
+  if (std::find(isCovered.begin(), isCovered.end(), false) !=
+      isCovered.end()) {
+    AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+             "Each variable of the LeapfrogTriejoin has to occur in one of its "
+             "inputs.");
+  }
+}
+
+// _____________________________________________________________________________
+string LeapfrogTriejoin::asString(size_t indent) const {
+  std::ostringstream os;
+  for (size_t i = 0; i < indent; ++i) {
+    os << " ";
+  }
+  os << "LEAPFROG_TRIEJOIN on";
+  for (const auto& var : _variableOrder) {
+    os << " " << var;
+  }
+  os << "\n";
+  for (size_t i = 0; i < _children.size(); ++i) {
+    if (i > 0) {
+      os << "\n";
+      for (size_t j = 0; j < indent; ++j) {
+        os << " ";
+      }
+      os << "|X|\n";
+    }
+    os << _children[i]->asString(indent);
+  }
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string LeapfrogTriejoin::getDescriptor() const {
+  std::string joinVars = "";
+  for (const auto& var : _variableOrder) {
+    joinVars += var + " ";
+  }
+  return "LeapfrogTriejoin on " + joinVars;
+}
+
+// _____________________________________________________________________________
+size_t LeapfrogTriejoin::getResultWidth() const {
+  return _variableOrder.size();
+}
+
+// _____________________________________________________________________________
+vector<size_t> LeapfrogTriejoin::resultSortedOn() const {
+  // The variables are bound one after the other, so the result is sorted by
+  // all columns.
+  vector<size_t> sortedOn;
+  for (size_t col = 0; col < _variableOrder.size(); ++col) {
+    sortedOn.push_back(col);
+  }
+  return sortedOn;
+}
+
+// _____________________________________________________________________________
+ad_utility::HashMap<string, size_t> LeapfrogTriejoin::getVariableColumns()
+    const {
+  ad_utility::HashMap<string, size_t> result;
+  for (size_t col = 0; col < _variableOrder.size(); ++col) {
+    result[_variableOrder[col]] = col;
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+bool LeapfrogTriejoin::knownEmptyResult() {
+  for (auto& child : _children) {
+    if (child->knownEmptyResult()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+float LeapfrogTriejoin::getMultiplicity(size_t col) {
+  if (!_sizeEstimateComputed) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return _multiplicities[col];
+}
+
+// _____________________________________________________________________________
+size_t LeapfrogTriejoin::getSizeEstimate() {
+  if (!_sizeEstimateComputed) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return _sizeEstimate;
+}
+
+// _____________________________________________________________________________
+size_t LeapfrogTriejoin::getCostEstimate() {
+  // Each input is read at most once, but the galloping searches are more
+  // expensive than the linear scans of a binary merge join.
+  size_t costEstimate = getSizeEstimate();
+  size_t childCosts = 0;
+  for (auto& child : _children) {
+    costEstimate += child->getSizeEstimate();
+    childCosts += child->getCostEstimate();
+  }
+  costEstimate *= 2;
+  return childCosts + costEstimate;
+}
+
+// _____________________________________________________________________________
+void LeapfrogTriejoin::computeSizeEstimateAndMultiplicities() {
+  // The number of distinct values of a variable is at most the minimum of the
+  // numbers of distinct values in the inputs that contain it.
+  const size_t numVariables = _variableOrder.size();
+  std::vector<double> numDistinct(numVariables,
+                                  std::numeric_limits<double>::max());
+  std::vector<size_t> numOccurrences(numVariables, 0);
+  for (size_t i = 0; i < _children.size(); ++i) {
+    for (size_t col = 0; col < _childVariables[i].size(); ++col) {
+      size_t var = _childVariables[i][col];
+      double distinct = std::max(1.0, _children[i]->getSizeEstimate() /
+                                          double{_children[i]->getMultiplicity(
+                                              col)});
+      numDistinct[var] = std::min(numDistinct[var], distinct);
+      ++numOccurrences[var];
+    }
+  }
+
+  // The classic estimate that assumes independent join columns: the product
+  // of the input sizes divided by the number of distinct values of a variable
+  // for each additional input that contains it.
+  double independentEstimate = 1;
+  for (auto& child : _children) {
+    independentEstimate *= child->getSizeEstimate();
+  }
+  for (size_t var = 0; var < numVariables; ++var) {
+    independentEstimate /= std::pow(numDistinct[var], numOccurrences[var] - 1);
+  }
+
+  // The AGM bound (the worst-case size of the result) for the fractional edge
+  // cover that assigns the weight 1/2 to the inputs whose variables all occur
+  // in another input as well and the weight 1 to all other inputs.
+  double agmBound = 1;
+  for (size_t i = 0; i < _children.size(); ++i) {
+    bool allVariablesShared = std::all_of(
+        _childVariables[i].begin(), _childVariables[i].end(),
+        [&](size_t var) { return numOccurrences[var] >= 2; });
+    double size = _children[i]->getSizeEstimate();
+    agmBound *= allVariablesShared ? std::sqrt(size) : size;
+  }
+
+  double estimate = std::min(independentEstimate, agmBound);
+  // Don't estimate 0 since then some parent operations
+  // (in particular joins) using isKnownEmpty() will
+  // will assume the size to be exactly zero
+  constexpr double maxEstimate = std::numeric_limits<size_t>::max() / 2;
+  _sizeEstimate = static_cast<size_t>(std::min(estimate, maxEstimate)) + 1;
+
+  _multiplicities.clear();
+  for (size_t var = 0; var < numVariables; ++var) {
+    double distinct = std::min(numDistinct[var], double(_sizeEstimate));
+    _multiplicities.push_back(
+        static_cast<float>(std::max(1.0, _sizeEstimate / distinct)));
+  }
+  _sizeEstimateComputed = true;
+}
+
+// _____________________________________________________________________________
+void LeapfrogTriejoin::computeResult(ResultTable* result) {
+  AD_CHECK(result);
+  LOG(DEBUG) << "LeapfrogTriejoin result computation..." << endl;
+
+  RuntimeInformation& runtimeInfo = getRuntimeInfo();
+  result->_sortedBy = resultSortedOn();
+  result->_idTable.setCols(getResultWidth());
+  result->_resultTypes.resize(getResultWidth(), ResultTable::ResultType::KB);
+
+  std::vector<std::shared_ptr<const ResultTable>> childResults;
+  std::vector<const IdTable*> inputs;
+  for (auto& child : _children) {
+    childResults.push_back(child->getResult());
+    inputs.push_back(&childResults.back()->_idTable);
+    runtimeInfo.addChild(child->getRootOperation()->getRuntimeInfo());
+  }
+  LOG(DEBUG) << "LeapfrogTriejoin subresult computation done." << std::endl;
+
+  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
+  computeLeapfrogTriejoin(inputs, _childVariables, _variableOrder.size(),
+                          &result->_idTable,
+                          [&]() { checkTimeoutAfterNCalls(); });
+  LOG(DEBUG) << "LeapfrogTriejoin result computation done." << endl;
+}
+
+// _____________________________________________________________________________
+void LeapfrogTriejoin::computeLeapfrogTriejoin(
+    const std::vector<const IdTable*>& inputs,
+    const std::vector<std::vector<size_t>>& inputVariables,
+    size_t numVariables, IdTable* result,
+    const std::function<void()>& checkTimeout) {
+  AD_CHECK_EQ(inputs.size(), inputVariables.size());
+  AD_CHECK_EQ(result->cols(), numVariables);
+  for (const IdTable* input : inputs) {
+    if (input->size() == 0) {
+      return;
+    }
+  }
+  std::vector<TrieIterator> iterators;
+  iterators.reserve(inputs.size());
+  std::vector<std::vector<TrieIterator*>> iteratorsPerVariable(numVariables);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    AD_CHECK_EQ(inputs[i]->cols(), inputVariables[i].size());
+    iterators.emplace_back(*inputs[i]);
+    for (size_t var : inputVariables[i]) {
+      AD_CHECK_LT(var, numVariables);
+      iteratorsPerVariable[var].push_back(&iterators.back());
+    }
+  }
+  for (const auto& iteratorsForVariable : iteratorsPerVariable) {
+    AD_CHECK(!iteratorsForVariable.empty());
+  }
+  std::vector<Id> binding(numVariables);
+  leapfrogTriejoin(0, iteratorsPerVariable, &binding, result, checkTimeout);
+}
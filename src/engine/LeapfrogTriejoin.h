@@ -0,0 +1,91 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./Operation.h"
+#include "./QueryExecutionTree.h"
+
+// A worst-case optimal multiway join (Leapfrog Triejoin, Veldhuizen 2014).
+// Instead of joining the inputs pairwise, the join binds one variable after
+// the other (in `variableOrder`) and intersects the candidate values of all
+// inputs that contain the current variable. For cyclic patterns (e.g. the
+// triangle `?x <p> ?y . ?y <q> ?z . ?z <r> ?x`) this avoids the huge
+// intermediate results of binary join plans.
+//
+// The inputs act as tries: all their columns have to be variables from
+// `variableOrder`, the columns have to appear in the same order as in
+// `variableOrder`, and the inputs have to be sorted lexicographically by all
+// columns and must not contain duplicate rows (which is the case for index
+// scans with two variables). The result has one column per variable in
+// `variableOrder` and is sorted lexicographically.
+class LeapfrogTriejoin : public Operation {
+ public:
+  LeapfrogTriejoin(QueryExecutionContext* qec,
+                   std::vector<std::shared_ptr<QueryExecutionTree>> children,
+                   std::vector<std::string> variableOrder);
+
+  virtual string asString(size_t indent = 0) const override;
+
+  virtual string getDescriptor() const override;
+
+  virtual size_t getResultWidth() const override;
+
+  virtual vector<size_t> resultSortedOn() const override;
+
+  ad_utility::HashMap<string, size_t> getVariableColumns() const override;
+
+  virtual void setTextLimit(size_t limit) override {
+    for (auto& child : _children) {
+      child->setTextLimit(limit);
+    }
+  }
+
+  virtual bool knownEmptyResult() override;
+
+  virtual float getMultiplicity(size_t col) override;
+
+  virtual size_t getSizeEstimate() override;
+
+  virtual size_t getCostEstimate() override;
+
+  vector<QueryExecutionTree*> getChildren() override {
+    vector<QueryExecutionTree*> result;
+    for (auto& child : _children) {
+      result.push_back(child.get());
+    }
+    return result;
+  }
+
+  /**
+   * @brief Compute the Leapfrog Triejoin of the `inputs`. The columns of
+   * `inputs[i]` belong to the variables `inputVariables[i]` (indices into the
+   * variable order, strictly increasing). Each of the `numVariables` variables
+   * has to occur in at least one input. The result has one column per
+   * variable. `checkTimeout` is called regularly during the computation.
+   * This method is made public here for unit testing purposes.
+   **/
+  static void computeLeapfrogTriejoin(
+      const std::vector<const IdTable*>& inputs,
+      const std::vector<std::vector<size_t>>& inputVariables,
+      size_t numVariables, IdTable* result,
+      const std::function<void()>& checkTimeout = []() {});
+
+ private:
+  std::vector<std::shared_ptr<QueryExecutionTree>> _children;
+  std::vector<std::string> _variableOrder;
+  // For each child the indices of its columns' variables in `_variableOrder`.
+  std::vector<std::vector<size_t>> _childVariables;
+
+  bool _sizeEstimateComputed = false;
+  size_t _sizeEstimate = 0;
+  vector<float> _multiplicities;
+
+  virtual void computeResult(ResultTable* result) override;
+
+  void computeSizeEstimateAndMultiplicities();
+};
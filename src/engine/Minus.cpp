@@ -52,8 +52,10 @@ void Minus::computeResult(ResultTable* result) {
   result->_sortedBy = resultSortedOn();
   result->_idTable.setCols(getResultWidth());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  // The two sides are independent of each other.
+  const auto results = computeChildrenConcurrently({_left.get(), _right.get()});
+  const auto& leftResult = results[0];
+  const auto& rightResult = results[1];
 
   runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
   runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
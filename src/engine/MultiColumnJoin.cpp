@@ -81,8 +81,10 @@ void MultiColumnJoin::computeResult(ResultTable* result) {
 
   AD_CHECK_GE(result->_idTable.cols(), _joinColumns.size());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  // The two sides are independent of each other.
+  const auto results = computeChildrenConcurrently({_left.get(), _right.get()});
+  const auto& leftResult = results[0];
+  const auto& rightResult = results[1];
 
   runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
   runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
@@ -115,7 +117,7 @@ void MultiColumnJoin::computeResult(ResultTable* result) {
   int resWidth = result->_idTable.cols();
   CALL_FIXED_SIZE_3(leftWidth, rightWidth, resWidth, computeMultiColumnJoin,
                     leftResult->_idTable, rightResult->_idTable, _joinColumns,
-                    &result->_idTable);
+                    &result->_idTable, makeTaskGroup());
   LOG(DEBUG) << "MultiColumnJoin result computation done." << endl;
 }
 
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "./Operation.h"
+#include "./PartitionedJoin.h"
 #include "./QueryExecutionTree.h"
 
 class MultiColumnJoin : public Operation {
@@ -50,13 +51,25 @@ class MultiColumnJoin : public Operation {
    *        result in result. R should have width resultWidth (or be a vector
    *        that should have resultWidth entries).
    *        This method is made public here for unit testing purposes.
+   *        Large inputs are joined in partitions, as tasks of the taskGroup.
    **/
   template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
-  static void computeMultiColumnJoin(const IdTable& a, const IdTable& b,
-                                     const vector<array<Id, 2>>& joinColumns,
-                                     IdTable* result);
+  static void computeMultiColumnJoin(
+      const IdTable& a, const IdTable& b,
+      const vector<array<Id, 2>>& joinColumns, IdTable* result,
+      ad_utility::TaskGroup taskGroup =
+          ad_utility::TaskGroup{ad_utility::WorkStealingThreadPool::global()});
 
  private:
+  // Compute the multi column join of the rows of a and b in the given
+  // partition and append it to result.
+  template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
+  static void computeMultiColumnJoinForPartition(
+      const IdTableView<A_WIDTH>& a, const IdTableView<B_WIDTH>& b,
+      const vector<array<Id, 2>>& joinColumns,
+      const partitionedJoin::JoinPartition& partition,
+      IdTableStatic<OUT_WIDTH>* result);
+
   void computeSizeEstimateAndMultiplicities();
 
   std::shared_ptr<QueryExecutionTree> _left;
@@ -74,12 +87,51 @@ class MultiColumnJoin : public Operation {
 template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
 void MultiColumnJoin::computeMultiColumnJoin(
     const IdTable& dynA, const IdTable& dynB,
-    const vector<array<Id, 2>>& joinColumns, IdTable* dynResult) {
+    const vector<array<Id, 2>>& joinColumns, IdTable* dynResult,
+    ad_utility::TaskGroup taskGroup) {
   // check for trivial cases
   if (dynA.size() == 0 || dynB.size() == 0) {
     return;
   }
 
+  IdTableView<A_WIDTH> a = dynA.asStaticView<A_WIDTH>();
+  IdTableView<B_WIDTH> b = dynB.asStaticView<B_WIDTH>();
+  IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
+
+  size_t numPartitions = partitionedJoin::getNumPartitions(a.size(), b.size());
+  if (numPartitions <= 1) {
+    computeMultiColumnJoinForPartition(a, b, joinColumns,
+                                       {0, a.size(), 0, b.size()}, &result);
+  } else {
+    // Both inputs are sorted by the join columns, so they are in particular
+    // sorted by the primary join column and can be partitioned by its values.
+    const size_t jcA = joinColumns[0][0];
+    const size_t jcB = joinColumns[0][1];
+    auto partitions = partitionedJoin::computePartitions(
+        a.size(), b.size(), [&a, jcA](size_t i) { return a(i, jcA); },
+        [&b, jcB](size_t i) { return b(i, jcB); }, numPartitions);
+    partitionedJoin::joinPartitionsInParallel(
+        partitions,
+        [&](const partitionedJoin::JoinPartition& partition,
+            IdTableStatic<OUT_WIDTH>* partialResult) {
+          computeMultiColumnJoinForPartition(a, b, joinColumns, partition,
+                                             partialResult);
+        },
+        &result, std::move(taskGroup));
+  }
+  *dynResult = result.moveToDynamic();
+}
+
+template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
+void MultiColumnJoin::computeMultiColumnJoinForPartition(
+    const IdTableView<A_WIDTH>& a, const IdTableView<B_WIDTH>& b,
+    const vector<array<Id, 2>>& joinColumns,
+    const partitionedJoin::JoinPartition& partition,
+    IdTableStatic<OUT_WIDTH>* resultPtr) {
+  auto& result = *resultPtr;
+  const size_t aEnd = partition._leftEnd;
+  const size_t bEnd = partition._rightEnd;
+
   // Marks the columns in b that are join columns. Used to skip these
   // when computing the result of the join
   int joinColumnBitmap_b = 0;
@@ -87,24 +139,20 @@ void MultiColumnJoin::computeMultiColumnJoin(
     joinColumnBitmap_b |= (1 << jc[1]);
   }
 
-  IdTableView<A_WIDTH> a = dynA.asStaticView<A_WIDTH>();
-  IdTableView<B_WIDTH> b = dynB.asStaticView<B_WIDTH>();
-  IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
-
   bool matched = false;
-  size_t ia = 0, ib = 0;
-  while (ia < a.size() && ib < b.size()) {
+  size_t ia = partition._leftBegin, ib = partition._rightBegin;
+  while (ia < aEnd && ib < bEnd) {
     // Join columns 0 are the primary sort columns
     while (a(ia, joinColumns[0][0]) < b(ib, joinColumns[0][1])) {
       ia++;
-      if (ia >= a.size()) {
-        goto finish;
+      if (ia >= aEnd) {
+        return;
       }
     }
     while (b(ib, joinColumns[0][1]) < a(ia, joinColumns[0][0])) {
       ib++;
-      if (ib >= b.size()) {
-        goto finish;
+      if (ib >= bEnd) {
+        return;
       }
     }
 
@@ -127,7 +175,7 @@ void MultiColumnJoin::computeMultiColumnJoin(
 
     // Compute the cross product of the row in a and all matching
     // rows in b.
-    while (matched && ia < a.size() && ib < b.size()) {
+    while (matched && ia < aEnd && ib < bEnd) {
       // used to reset ib if another cross product needs to be computed
       size_t initIb = ib;
 
@@ -152,7 +200,7 @@ void MultiColumnJoin::computeMultiColumnJoin(
 
         // do the rows still match?
         for (const array<Id, 2>& jc : joinColumns) {
-          if (ib >= b.size() || a(ia, jc[0]) != b(ib, jc[1])) {
+          if (ib >= bEnd || a(ia, jc[0]) != b(ib, jc[1])) {
             matched = false;
             break;
           }
@@ -162,7 +210,7 @@ void MultiColumnJoin::computeMultiColumnJoin(
       // Check if the next row in a also matches the initial row in b
       matched = true;
       for (const array<Id, 2>& jc : joinColumns) {
-        if (ia >= a.size() || a(ia, jc[0]) != b(initIb, jc[1])) {
+        if (ia >= aEnd || a(ia, jc[0]) != b(initIb, jc[1])) {
           matched = false;
           break;
         }
@@ -173,6 +221,4 @@ void MultiColumnJoin::computeMultiColumnJoin(
       }
     }
   }
-finish:
-  *dynResult = result.moveToDynamic();
 }
@@ -0,0 +1,321 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "MultiwayJoin.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "./ColumnKernels.h"
+
+using std::string;
+
+// _____________________________________________________________________________
+MultiwayJoin::MultiwayJoin(
+    QueryExecutionContext* qec,
+    std::vector<std::shared_ptr<QueryExecutionTree>> children,
+    std::string joinVariable)
+    : Operation(qec),
+      _children(std::move(children)),
+      _joinVariable(std::move(joinVariable)) {
+  AD_CHECK_GE(_children.size(), 2u);
+  // Order the children so that identical queries can be identified.
+  std::sort(_children.begin(), _children.end(),
+            [](const auto& a, const auto& b) {
+              return a->asString() < b->asString();
+            });
+  ad_utility::HashSet<string> variables{_joinVariable};
+  for (const auto& child : _children) {
+    const auto variableColumns = child->getVariableColumns();
+    auto it = variableColumns.find(_joinVariable);
+    if (it == variableColumns.end()) {
+      AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+               "Each input of the MultiwayJoin has to contain the join "
+               "variable " +
+                   _joinVariable + ".");
+    }
+    auto sortedOn = child->resultSortedOn();
+    if (sortedOn.empty() || sortedOn[0] != it->second) {
+      AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+               "The inputs of the MultiwayJoin have to be sorted by their join "
+               "column.");
+    }
+    for (const auto& [var, col] : variableColumns) {
+      if (var != _joinVariable && !variables.insert(var).second) {
+        AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+                 "The inputs of the MultiwayJoin must not share variables "
+                 "other than the join variable, but " +
+                     var + " occurs in several inputs.");
+      }
+    }
+    _joinColumns.push_back(it->second);
+  }
+}
+
+// _____________________________________________________________________________
+string MultiwayJoin::asString(size_t indent) const {
+  std::ostringstream os;
+  for (size_t i = 0; i < indent; ++i) {
+    os << " ";
+  }
+  os << "MULTIWAY_JOIN on " << _joinVariable << "\n";
+  for (size_t i = 0; i < _children.size(); ++i) {
+    if (i > 0) {
+      os << "\n";
+      for (size_t j = 0; j < indent; ++j) {
+        os << " ";
+      }
+      os << "|X|\n";
+    }
+    os << _children[i]->asString(indent);
+  }
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string MultiwayJoin::getDescriptor() const {
+  return "MultiwayJoin on " + _joinVariable;
+}
+
+// _____________________________________________________________________________
+size_t MultiwayJoin::getResultWidth() const {
+  size_t width = 1;
+  for (const auto& child : _children) {
+    width += child->getResultWidth() - 1;
+  }
+  return width;
+}
+
+// _____________________________________________________________________________
+vector<size_t> MultiwayJoin::resultSortedOn() const { return {0}; }
+
+// _____________________________________________________________________________
+ad_utility::HashMap<string, size_t> MultiwayJoin::getVariableColumns() const {
+  ad_utility::HashMap<string, size_t> result;
+  result[_joinVariable] = 0;
+  size_t offset = 1;
+  for (size_t i = 0; i < _children.size(); ++i) {
+    for (const auto& [var, col] : _children[i]->getVariableColumns()) {
+      if (col != _joinColumns[i]) {
+        result[var] = offset + (col < _joinColumns[i] ? col : col - 1);
+      }
+    }
+    offset += _children[i]->getResultWidth() - 1;
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+bool MultiwayJoin::knownEmptyResult() {
+  for (auto& child : _children) {
+    if (child->knownEmptyResult()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+float MultiwayJoin::getMultiplicity(size_t col) {
+  if (!_sizeEstimateComputed) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return _multiplicities[col];
+}
+
+// _____________________________________________________________________________
+size_t MultiwayJoin::getSizeEstimate() {
+  if (!_sizeEstimateComputed) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return _sizeEstimate;
+}
+
+// _____________________________________________________________________________
+size_t MultiwayJoin::getCostEstimate() {
+  // Like a binary join, but each input is read once and there are no
+  // intermediate results.
+  size_t costEstimate = getSizeEstimate();
+  for (auto& child : _children) {
+    costEstimate += child->getSizeEstimate() + child->getCostEstimate();
+  }
+  return costEstimate;
+}
+
+// _____________________________________________________________________________
+void MultiwayJoin::computeSizeEstimateAndMultiplicities() {
+  // The same estimate as for a chain of binary joins: the number of distinct
+  // values of the join column is the minimum over all inputs, and each of them
+  // occurs with the product of the multiplicities of the inputs.
+  double corrFactor =
+      _executionContext
+          ? _executionContext->getCostFactor(
+                "JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR")
+          : 1;
+  std::vector<double> numDistinct;
+  double distinctInResult = std::numeric_limits<double>::max();
+  double joinColumnMultiplicity = 1;
+  bool isEmpty = false;
+  for (size_t i = 0; i < _children.size(); ++i) {
+    double size = _children[i]->getSizeEstimate();
+    double multiplicity = _children[i]->getMultiplicity(_joinColumns[i]);
+    isEmpty |= size == 0;
+    numDistinct.push_back(std::max(1.0, size / multiplicity));
+    distinctInResult = std::min(distinctInResult, numDistinct.back());
+    joinColumnMultiplicity *= multiplicity;
+  }
+  double estimate = std::pow(corrFactor, _children.size() - 1) *
+                    joinColumnMultiplicity * distinctInResult;
+  constexpr double maxEstimate = std::numeric_limits<size_t>::max() / 2;
+  _sizeEstimate = std::max(
+      size_t(1), static_cast<size_t>(std::min(estimate, maxEstimate)));
+
+  _multiplicities.assign(getResultWidth(), 1);
+  if (isEmpty) {
+    _sizeEstimateComputed = true;
+    return;
+  }
+  _multiplicities[0] =
+      static_cast<float>(std::max(1.0, _sizeEstimate / distinctInResult));
+  size_t offset = 1;
+  for (size_t i = 0; i < _children.size(); ++i) {
+    // The rows of this input whose join column doesn't occur in all other
+    // inputs are dropped, which might reduce the number of distinct values in
+    // its other columns.
+    double size = _children[i]->getSizeEstimate();
+    double remainingSize = size * (distinctInResult / numDistinct[i]);
+    for (size_t col = 0; col < _children[i]->getResultWidth(); ++col) {
+      if (col == _joinColumns[i]) {
+        continue;
+      }
+      double oldDistinct = size / _children[i]->getMultiplicity(col);
+      double newDistinct = std::max(1.0, std::min(oldDistinct, remainingSize));
+      _multiplicities[offset + (col < _joinColumns[i] ? col : col - 1)] =
+          static_cast<float>(std::max(1.0, _sizeEstimate / newDistinct));
+    }
+    offset += _children[i]->getResultWidth() - 1;
+  }
+  _sizeEstimateComputed = true;
+}
+
+// _____________________________________________________________________________
+void MultiwayJoin::computeResult(ResultTable* result) {
+  AD_CHECK(result);
+  LOG(DEBUG) << "MultiwayJoin result computation..." << endl;
+
+  RuntimeInformation& runtimeInfo = getRuntimeInfo();
+  result->_sortedBy = resultSortedOn();
+  result->_idTable.setCols(getResultWidth());
+
+  std::vector<std::shared_ptr<const ResultTable>> childResults;
+  std::vector<const IdTable*> inputs;
+  for (auto& child : _children) {
+    childResults.push_back(child->getResult());
+    inputs.push_back(&childResults.back()->_idTable);
+    runtimeInfo.addChild(child->getRootOperation()->getRuntimeInfo());
+  }
+  LOG(DEBUG) << "MultiwayJoin subresult computation done." << std::endl;
+
+  result->_resultTypes.push_back(
+      childResults[0]->getResultType(_joinColumns[0]));
+  for (size_t i = 0; i < childResults.size(); ++i) {
+    for (size_t col = 0; col < inputs[i]->cols(); ++col) {
+      if (col != _joinColumns[i]) {
+        result->_resultTypes.push_back(childResults[i]->getResultType(col));
+      }
+    }
+  }
+
+  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
+  computeMultiwayJoin(inputs, _joinColumns, &result->_idTable,
+                      [&]() { checkTimeoutAfterNCalls(); });
+  LOG(DEBUG) << "MultiwayJoin result computation done." << endl;
+}
+
+// _____________________________________________________________________________
+void MultiwayJoin::computeMultiwayJoin(
+    const std::vector<const IdTable*>& inputs,
+    const std::vector<size_t>& joinColumns, IdTable* result,
+    const std::function<void()>& checkTimeout) {
+  AD_CHECK_EQ(inputs.size(), joinColumns.size());
+  size_t resultWidth = 1;
+  std::vector<columnKernels::ColumnView> columns;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    AD_CHECK_LT(joinColumns[i], inputs[i]->cols());
+    resultWidth += inputs[i]->cols() - 1;
+    columns.push_back(columnKernels::getColumn(*inputs[i], joinColumns[i]));
+    if (inputs[i]->size() == 0) {
+      return;
+    }
+  }
+  AD_CHECK_EQ(result->cols(), resultWidth);
+
+  // For each input the range of rows with the current value of the join
+  // column is [begin, end).
+  const size_t numInputs = inputs.size();
+  std::vector<size_t> begin(numInputs, 0);
+  std::vector<size_t> end(numInputs, 0);
+  std::vector<size_t> current(numInputs, 0);
+  while (true) {
+    checkTimeout();
+    // Seek all inputs to the largest current value of the join column until
+    // all of them contain it.
+    Id maxKey = 0;
+    for (size_t i = 0; i < numInputs; ++i) {
+      maxKey = std::max(maxKey, columns[i][begin[i]]);
+    }
+    bool allEqual = true;
+    for (size_t i = 0; i < numInputs; ++i) {
+      if (columns[i][begin[i]] < maxKey) {
+        begin[i] = columnKernels::gallopLowerBound(columns[i], begin[i],
+                                                   columns[i].size(), maxKey);
+        if (begin[i] == columns[i].size()) {
+          return;
+        }
+        allEqual &= columns[i][begin[i]] == maxKey;
+      }
+    }
+    if (!allEqual) {
+      continue;
+    }
+
+    for (size_t i = 0; i < numInputs; ++i) {
+      end[i] = maxKey == std::numeric_limits<Id>::max()
+                   ? columns[i].size()
+                   : columnKernels::gallopLowerBound(
+                         columns[i], begin[i], columns[i].size(), maxKey + 1);
+    }
+    // Append the cross product of the ranges, the last input varies fastest.
+    current = begin;
+    while (true) {
+      checkTimeout();
+      result->emplace_back();
+      size_t row = result->size() - 1;
+      (*result)(row, 0) = maxKey;
+      size_t resultCol = 1;
+      for (size_t i = 0; i < numInputs; ++i) {
+        for (size_t col = 0; col < inputs[i]->cols(); ++col) {
+          if (col != joinColumns[i]) {
+            (*result)(row, resultCol++) = (*inputs[i])(current[i], col);
+          }
+        }
+      }
+      size_t i = numInputs;
+      while (i > 0 && ++current[i - 1] == end[i - 1]) {
+        current[i - 1] = begin[i - 1];
+        --i;
+      }
+      if (i == 0) {
+        break;
+      }
+    }
+
+    for (size_t i = 0; i < numInputs; ++i) {
+      begin[i] = end[i];
+      if (begin[i] == columns[i].size()) {
+        return;
+      }
+    }
+  }
+}
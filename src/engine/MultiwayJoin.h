@@ -0,0 +1,85 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./Operation.h"
+#include "./QueryExecutionTree.h"
+
+// An n-ary merge join of inputs that share a single join variable, e.g. the
+// star `?s <p1> ?o1 . ?s <p2> ?o2 . ... . ?s <pk> ?ok`. All inputs have to be
+// sorted by their join column. Instead of a chain of binary joins, each of
+// which materializes its result, the inputs are advanced together with
+// galloping (leapfrog) seeks to the next value of the join column that all of
+// them contain, and the cross product of their rows with this value is
+// appended to the result.
+//
+// The first column of the result is the join variable, followed by the other
+// columns of each input (in the order of the inputs). The result is sorted by
+// the join column.
+class MultiwayJoin : public Operation {
+ public:
+  MultiwayJoin(QueryExecutionContext* qec,
+               std::vector<std::shared_ptr<QueryExecutionTree>> children,
+               std::string joinVariable);
+
+  virtual string asString(size_t indent = 0) const override;
+
+  virtual string getDescriptor() const override;
+
+  virtual size_t getResultWidth() const override;
+
+  virtual vector<size_t> resultSortedOn() const override;
+
+  ad_utility::HashMap<string, size_t> getVariableColumns() const override;
+
+  virtual void setTextLimit(size_t limit) override {
+    for (auto& child : _children) {
+      child->setTextLimit(limit);
+    }
+  }
+
+  virtual bool knownEmptyResult() override;
+
+  virtual float getMultiplicity(size_t col) override;
+
+  virtual size_t getSizeEstimate() override;
+
+  virtual size_t getCostEstimate() override;
+
+  vector<QueryExecutionTree*> getChildren() override {
+    vector<QueryExecutionTree*> result;
+    for (auto& child : _children) {
+      result.push_back(child.get());
+    }
+    return result;
+  }
+
+  /**
+   * @brief Join the `inputs` on the columns `joinColumns` (one per input, the
+   * inputs have to be sorted by them). The result has the layout described
+   * above. `checkTimeout` is called regularly during the computation.
+   * This method is made public here for unit testing purposes.
+   **/
+  static void computeMultiwayJoin(
+      const std::vector<const IdTable*>& inputs,
+      const std::vector<size_t>& joinColumns, IdTable* result,
+      const std::function<void()>& checkTimeout = []() {});
+
+ private:
+  std::vector<std::shared_ptr<QueryExecutionTree>> _children;
+  std::string _joinVariable;
+  std::vector<size_t> _joinColumns;
+
+  bool _sizeEstimateComputed = false;
+  size_t _sizeEstimate = 0;
+  vector<float> _multiplicities;
+
+  virtual void computeResult(ResultTable* result) override;
+
+  void computeSizeEstimateAndMultiplicities();
+};
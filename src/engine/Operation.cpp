@@ -5,6 +5,7 @@
 #include "Operation.h"
 
 #include "QueryExecutionTree.h"
+#include "SemiJoinFilter.h"
 
 template <typename F>
 void Operation::forAllDescendants(F f) {
@@ -56,6 +57,31 @@ void Operation::recursivelySetTimeoutTimer(
   }
 }
 
+// ________________________________________________________________________
+bool Operation::addSemiJoinFilter(
+    size_t col, const std::shared_ptr<const SemiJoinFilter>& filter) {
+  if (!applySemiJoinFilter(col, filter)) {
+    return false;
+  }
+  _semiJoinFiltersAsString += "\nSEMI-JOIN FILTER on column " +
+                              std::to_string(col) + ": " + filter->asString();
+  return true;
+}
+
+// ________________________________________________________________________
+void Operation::clearSemiJoinFilters() {
+  if (_semiJoinFiltersAsString.empty()) {
+    return;
+  }
+  _semiJoinFiltersAsString.clear();
+  resetSemiJoinFilter();
+  for (auto child : getChildren()) {
+    if (child) {
+      child->getRootOperation()->clearSemiJoinFilters();
+    }
+  }
+}
+
 // Get the result for the subtree rooted at this element.
 // Use existing results if they are already available, otherwise
 // trigger computation.
@@ -63,7 +89,7 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
   ad_utility::Timer timer;
   timer.start();
   auto& cache = _executionContext->getQueryTreeCache();
-  const string cacheKey = asString();
+  const string cacheKey = asString() + _semiJoinFiltersAsString;
   const bool pinFinalResultButNotSubtrees =
       _executionContext->_pinResult && isRoot;
   const bool pinResult =
@@ -90,14 +116,33 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
   }
 
   try {
-    auto computeLambda = [this] {
+    // The result is written to the disk cache only after it was published in
+    // the cache, so that other queries don't wait for the disk.
+    std::optional<double> writeToDiskCacheWithTime;
+    auto computeLambda = [this, &cache, &cacheKey, pinResult,
+                          &writeToDiskCacheWithTime] {
+      ad_utility::Timer computeTimer;
+      computeTimer.start();
       CacheValue val(getExecutionContext()->getAllocator());
+      if (_timeoutTimer->wlock()->isCancelled()) {
+        checkTimeout();
+      }
       if (_timeoutTimer->wlock()->hasTimedOut()) {
         throw ad_utility::TimeoutException(
             "Timeout in operation with no or insufficient timeout "
             "functionality, before " +
             getDescriptor());
       }
+      DiskResultCache* diskCache = cache.diskCache();
+      if (diskCache) {
+        if (auto originalTime =
+                diskCache->read(cacheKey, val._resultTable.get())) {
+          LOG(DEBUG) << "Read the result from the disk cache" << endl;
+          val._runtimeInfo = getRuntimeInfo();
+          val._runtimeInfo.setTime(originalTime.value());
+          return val;
+        }
+      }
       computeResult(val._resultTable.get());
       if (_timeoutTimer->wlock()->hasTimedOut()) {
         throw ad_utility::TimeoutException(
@@ -106,11 +151,28 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
             "which indicates insufficient timeout functionality.");
       }
       val._runtimeInfo = getRuntimeInfo();
+      // The time of the computation is the cost of recomputing the result
+      // once it is evicted from the cache (see `CacheValueCostGetter`).
+      computeTimer.stop();
+      const double computeTime =
+          static_cast<double>(computeTimer.usecs()) / 1000;
+      val._runtimeInfo.setTime(computeTime);
+      if (diskCache &&
+          (pinResult ||
+           computeTime >=
+               RuntimeParameters().get<"cache-disk-min-compute-time-ms">())) {
+        writeToDiskCacheWithTime = computeTime;
+      }
       return val;
     };
 
     auto result = (pinResult) ? cache.computeOncePinned(cacheKey, computeLambda)
                               : cache.computeOnce(cacheKey, computeLambda);
+    if (writeToDiskCacheWithTime.has_value()) {
+      cache.diskCache()->writeInBackground(cacheKey,
+                                           result._resultPointer->_resultTable,
+                                           writeToDiskCacheWithTime.value());
+    }
 
     timer.stop();
     createRuntimeInformation(result, timer.msecs());
@@ -145,9 +207,26 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
   }
 }
 
+// ______________________________________________________________________
+std::vector<shared_ptr<const ResultTable>>
+Operation::computeChildrenConcurrently(
+    const std::vector<QueryExecutionTree*>& children) const {
+  std::vector<shared_ptr<const ResultTable>> results(children.size());
+  ad_utility::TaskGroup taskGroup = makeTaskGroup();
+  for (size_t i = 0; i < children.size(); ++i) {
+    taskGroup.run([child = children[i], result = &results[i]]() {
+      *result = child->getResult();
+    });
+  }
+  taskGroup.wait();
+  return results;
+}
+
 // ______________________________________________________________________
 void Operation::checkTimeout() const {
-  if (_timeoutTimer->wlock()->hasTimedOut()) {
-    throw ad_utility::TimeoutException("Timeout in " + getDescriptor());
+  auto timer = _timeoutTimer->wlock();
+  // The descriptor is only needed for the message of the exception.
+  if (timer->hasTimedOut()) {
+    timer->checkTimeoutAndThrow("Timeout in " + getDescriptor() + ": ");
   }
 }
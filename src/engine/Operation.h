@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "../util/Exception.h"
@@ -21,6 +22,7 @@ using std::shared_ptr;
 
 // forward declaration needed to break dependencies
 class QueryExecutionTree;
+class SemiJoinFilter;
 
 class Operation {
  public:
@@ -89,6 +91,27 @@ class Operation {
   // trigger computation.
   shared_ptr<const ResultTable> getResult(bool isRoot = false);
 
+  // Allow this operation to drop the rows of its result whose entry in column
+  // `col` is not contained in the `filter`, because a join that consumes the
+  // result would drop them anyway (sideways information passing). Return false
+  // if the operation can't make use of the filter. The filter becomes part of
+  // the cache key of the result, so it has to be added before the result is
+  // computed. It applies until `clearSemiJoinFilters` is called.
+  bool addSemiJoinFilter(size_t col,
+                         const std::shared_ptr<const SemiJoinFilter>& filter);
+
+  // Remove the semi-join filters of this operation and all its descendants.
+  // The join that added them calls this as soon as the filtered result is
+  // computed, such that the filters don't restrict later computations of the
+  // operations, e.g. in another plan of the adaptive query planner.
+  void clearSemiJoinFilters();
+
+  // The time the query planner needed to create the tree with this operation
+  // as its root. It is reported in the runtime information of the operation.
+  void setPlanningTime(size_t timeInMilliseconds) {
+    _planningTimeInMilliseconds = timeInMilliseconds;
+  }
+
   // Use the same timeout timer for all children of an operation (= query plan
   // rooted at that operation). As soon as one child times out, the whole
   // operation times out.
@@ -125,11 +148,32 @@ class Operation {
     return _warnings;
   }
 
-  // Check if there is still time left and throw a TimeoutException otherwise.
+  // Check if there is still time left (and the query was not cancelled) and
+  // throw a TimeoutException otherwise.
   // This will be called at strategic places on code that potentially can take a
   // (too) long time.
   void checkTimeout() const;
 
+  // A group of tasks on the thread pool that is shared by all queries, with
+  // at most as many tasks running at the same time as this query may use
+  // threads (see `QueryExecutionContext::getMaxParallelism`). The tasks are
+  // not started anymore when the query has timed out or was cancelled.
+  ad_utility::TaskGroup makeTaskGroup() const {
+    return ad_utility::TaskGroup{
+        ad_utility::WorkStealingThreadPool::global(),
+        _executionContext ? _executionContext->getMaxParallelism()
+                          : ad_utility::TaskGroup::UNBOUNDED,
+        [this]() { checkTimeout(); }};
+  }
+
+  // Compute the results of the `children`, which must be independent
+  // subtrees of this operation, concurrently as tasks of a `makeTaskGroup`
+  // and return them in the same order. A subtree that another thread already
+  // computes (e.g. the same subtree in another query) is computed only once,
+  // see `ConcurrentCache::computeOnce`.
+  std::vector<shared_ptr<const ResultTable>> computeChildrenConcurrently(
+      const std::vector<QueryExecutionTree*>& children) const;
+
   // Handles the timeout of this operation.
   ad_utility::SharedConcurrentTimeoutTimer _timeoutTimer =
       std::make_shared<ad_utility::ConcurrentTimeoutTimer>(
@@ -147,8 +191,11 @@ class Operation {
             this](size_t countIncrease = 1) mutable {
       i += countIncrease;
       if (i >= numOperationsBetweenTimeoutChecks) {
-        _timeoutTimer->wlock()->checkTimeoutAndThrow("Timeout in "s +
-                                                     getDescriptor());
+        auto timer = _timeoutTimer->wlock();
+        // The descriptor is only needed for the message of the exception.
+        if (timer->hasTimedOut()) {
+          timer->checkTimeoutAndThrow("Timeout in "s + getDescriptor() + ": ");
+        }
         i = 0;
       }
     };
@@ -159,11 +206,22 @@ class Operation {
   //! Computes both, an EntityList and a HitList.
   virtual void computeResult(ResultTable* result) = 0;
 
+  // Operations that support semi-join filters (see `addSemiJoinFilter`)
+  // override this function and return true if they use the `filter`.
+  virtual bool applySemiJoinFilter(
+      [[maybe_unused]] size_t col,
+      [[maybe_unused]] const std::shared_ptr<const SemiJoinFilter>& filter) {
+    return false;
+  }
+
+  // Remove the filters that `applySemiJoinFilter` has stored.
+  virtual void resetSemiJoinFilter() {}
+
   // Create and store the complete runtime Information for this operation.
   // All data that was previously stored in the runtime information will be
   // deleted.
   virtual void createRuntimeInformation(
-      const ConcurrentLruCache ::ResultAndCacheStatus& resultAndCacheStatus,
+      const ConcurrentResultCache::ResultAndCacheStatus& resultAndCacheStatus,
       size_t timeInMilliseconds) final {
     // reset
     _runtimeInfo = RuntimeInformation();
@@ -178,6 +236,9 @@ class Operation {
     // the correct information about the children computations.
     _runtimeInfo.children() =
         resultAndCacheStatus._resultPointer->_runtimeInfo.children();
+    // The same holds for the details that the computation added.
+    _runtimeInfo.details() =
+        resultAndCacheStatus._resultPointer->_runtimeInfo.details();
 
     _runtimeInfo.setTime(timeInMilliseconds);
     _runtimeInfo.setRows(
@@ -189,11 +250,21 @@ class Operation {
     _runtimeInfo.addDetail(
         "original_operation_time",
         resultAndCacheStatus._resultPointer->_runtimeInfo.getOperationTime());
+    if (_planningTimeInMilliseconds.has_value()) {
+      _runtimeInfo.addDetail("planning_time",
+                             _planningTimeInMilliseconds.value());
+    }
   }
 
   vector<size_t> _resultSortedColumns;
   RuntimeInformation _runtimeInfo;
 
+  // Describes the semi-join filters that were applied to this operation, it is
+  // appended to the cache key of the result.
+  string _semiJoinFiltersAsString;
+
+  std::optional<size_t> _planningTimeInMilliseconds;
+
   bool _hasComputedSortColumns;
 
   /// collect all the warnings that were created during the creation or
@@ -85,8 +85,10 @@ void OptionalJoin::computeResult(ResultTable* result) {
 
   AD_CHECK_GE(result->_idTable.cols(), _joinColumns.size());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  // The two sides are independent of each other.
+  const auto results = computeChildrenConcurrently({_left.get(), _right.get()});
+  const auto& leftResult = results[0];
+  const auto& rightResult = results[1];
 
   runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
   runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
@@ -8,6 +8,7 @@
 
 #include "CallFixedSize.h"
 #include "Comparators.h"
+#include "ExternalSort.h"
 #include "QueryExecutionTree.h"
 
 using std::string;
@@ -103,23 +104,23 @@ void OrderBy::computeResult(ResultTable* result) {
                               subRes->_resultTypes.begin(),
                               subRes->_resultTypes.end());
   result->_localVocab = subRes->_localVocab;
-  result->_idTable.insert(result->_idTable.end(), subRes->_idTable.begin(),
-                          subRes->_idTable.end());
 
   int width = result->_idTable.cols();
   // TODO(florian): Check if the lambda is a performance problem
-  CALL_FIXED_SIZE_1(width, getEngine().sort, &result->_idTable,
-                    [this](const auto& a, const auto& b) {
-                      for (auto& entry : _sortIndices) {
-                        if (a[entry.first] < b[entry.first]) {
-                          return !entry.second;
-                        }
-                        if (a[entry.first] > b[entry.first]) {
-                          return entry.second;
-                        }
-                      }
-                      return a[0] < b[0];
-                    });
+  auto comparator = [this](const auto& a, const auto& b) {
+    for (auto& entry : _sortIndices) {
+      if (a[entry.first] < b[entry.first]) {
+        return !entry.second;
+      }
+      if (a[entry.first] > b[entry.first]) {
+        return entry.second;
+      }
+    }
+    return a[0] < b[0];
+  };
+  CALL_FIXED_SIZE_1(width, externalSort::sortInMemoryOrExternally,
+                    std::move(subRes), &result->_idTable, comparator,
+                    getExecutionContext(), [this]() { checkTimeout(); });
   result->_sortedBy = resultSortedOn();
 
   LOG(DEBUG) << "OrderBy result computation done." << endl;
@@ -0,0 +1,125 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "../global/Constants.h"
+#include "../util/WorkStealingThreadPool.h"
+#include "./IdTable.h"
+
+namespace partitionedJoin {
+
+// A pair of row ranges [_leftBegin, _leftEnd) and [_rightBegin, _rightEnd) of
+// the two inputs of a merge join. The partitions are disjoint with respect to
+// the join column values, so they can be joined independently of each other.
+struct JoinPartition {
+  size_t _leftBegin;
+  size_t _leftEnd;
+  size_t _rightBegin;
+  size_t _rightEnd;
+};
+
+// Return the number of partitions into which a join of two inputs with the
+// given sizes should be split according to the runtime parameters
+// `join-num-threads` and `join-min-rows-per-thread`. A return value of 1 means
+// that the join should be computed single-threaded.
+inline size_t getNumPartitions(size_t leftSize, size_t rightSize) {
+  const size_t numThreads = RuntimeParameters().get<"join-num-threads">();
+  const size_t minRowsPerThread =
+      std::max(size_t{1}, RuntimeParameters().get<"join-min-rows-per-thread">());
+  return std::max(size_t{1}, std::min(numThreads, (leftSize + rightSize) /
+                                                      minRowsPerThread));
+}
+
+// Split two inputs that are sorted by their join column into at most
+// `numPartitions` partitions. `leftKey(i)` and `rightKey(i)` have to return the
+// join column value of the i-th row of the respective input. The splitters are
+// taken at equidistant positions from the larger input and located in both
+// inputs via binary search, so all rows with the same join column value end up
+// in the same partition. Partitions where one of the sides is empty cannot
+// produce any result and are omitted.
+template <typename LeftKey, typename RightKey>
+std::vector<JoinPartition> computePartitions(size_t leftSize, size_t rightSize,
+                                             const LeftKey& leftKey,
+                                             const RightKey& rightKey,
+                                             size_t numPartitions) {
+  // The first position in [0, size) whose key is not less than `value`.
+  auto lowerBound = [](size_t size, const auto& key, Id value) {
+    size_t low = 0;
+    size_t high = size;
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (key(mid) < value) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  };
+
+  std::vector<JoinPartition> result;
+  size_t leftBegin = 0;
+  size_t rightBegin = 0;
+  auto addPartition = [&](size_t leftEnd, size_t rightEnd) {
+    if (leftEnd > leftBegin && rightEnd > rightBegin) {
+      result.push_back({leftBegin, leftEnd, rightBegin, rightEnd});
+    }
+    leftBegin = leftEnd;
+    rightBegin = rightEnd;
+  };
+
+  const bool leftIsLarger = leftSize >= rightSize;
+  const size_t largerSize = leftIsLarger ? leftSize : rightSize;
+  for (size_t i = 1; i < numPartitions; ++i) {
+    size_t splitRow = i * largerSize / numPartitions;
+    Id splitter = leftIsLarger ? leftKey(splitRow) : rightKey(splitRow);
+    size_t leftEnd = lowerBound(leftSize, leftKey, splitter);
+    size_t rightEnd = lowerBound(rightSize, rightKey, splitter);
+    // Identical splitters (many rows with the same join column value) would
+    // lead to empty partitions, skip them.
+    if (leftEnd <= leftBegin && rightEnd <= rightBegin) {
+      continue;
+    }
+    addPartition(std::max(leftEnd, leftBegin), std::max(rightEnd, rightBegin));
+  }
+  addPartition(leftSize, rightSize);
+  return result;
+}
+
+// Call `joinPartition(partition, &partialResult)` for each of the
+// `partitions` as a task of the `taskGroup`, each with its own empty
+// `partialResult` that uses the allocator of `result`. Then append all the
+// partial results to `result` in the order of the `partitions`. Exceptions
+// (e.g. timeouts) from the individual partitions are propagated to the caller.
+template <int OUT_WIDTH, typename JoinPartitionFunction>
+void joinPartitionsInParallel(const std::vector<JoinPartition>& partitions,
+                              const JoinPartitionFunction& joinPartition,
+                              IdTableStatic<OUT_WIDTH>* result,
+                              ad_utility::TaskGroup taskGroup) {
+  std::vector<IdTableStatic<OUT_WIDTH>> partialResults;
+  partialResults.reserve(partitions.size());
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    partialResults.emplace_back(result->cols(), result->getAllocator());
+  }
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    taskGroup.run([&joinPartition, &partition = partitions[i],
+                   partialResult = &partialResults[i]]() {
+      joinPartition(partition, partialResult);
+    });
+  }
+  taskGroup.wait();
+
+  size_t totalSize = result->size();
+  for (const auto& partialResult : partialResults) {
+    totalSize += partialResult.size();
+  }
+  result->reserve(totalSize);
+  for (const auto& partialResult : partialResults) {
+    result->insert(result->end(), partialResult.begin(), partialResult.end());
+  }
+}
+}  // namespace partitionedJoin
@@ -14,7 +14,10 @@
 #include "../util/Cache.h"
 #include "../util/ConcurrentCache.h"
 #include "../util/Log.h"
+#include "../util/MonotonicArena.h"
 #include "../util/Synchronized.h"
+#include "../util/WorkStealingThreadPool.h"
+#include "./DiskResultCache.h"
 #include "./Engine.h"
 #include "./ResultTable.h"
 #include "./SortPerformanceEstimator.h"
@@ -36,28 +39,54 @@ struct CacheValue {
   }
 };
 
-// Threadsafe LRU cache for (partial) query results, that
+// The cost of recomputing a cached value for `EvictionPolicy::GDSF`, the time
+// in milliseconds that its computation took.
+struct CacheValueCostGetter {
+  double operator()(const CacheValue& value) const {
+    return value._runtimeInfo.getTime();
+  }
+};
+
+// Threadsafe cache for (partial) query results, that
 // checks on insertion, if the result is currently being computed
 // by another query.
-using ConcurrentLruCache =
-    ad_utility::ConcurrentCache<ad_utility::LRUCache<string, CacheValue>>;
+using ConcurrentResultCache = ad_utility::ConcurrentCache<
+    ad_utility::PolicyCache<string, CacheValue, CacheValueCostGetter>>;
 using PinnedSizes =
     ad_utility::Synchronized<ad_utility::HashMap<std::string, size_t>,
                              std::shared_mutex>;
-class QueryResultCache : public ConcurrentLruCache {
+class QueryResultCache : public ConcurrentResultCache {
  private:
   PinnedSizes _pinnedSizes;
+  ad_utility::EvictionPolicy _evictionPolicy;
+  std::unique_ptr<DiskResultCache> _diskCache;
 
  public:
+  explicit QueryResultCache(ad_utility::EvictionPolicy evictionPolicy =
+                                ad_utility::EvictionPolicy::LRU)
+      : ConcurrentResultCache{evictionPolicy},
+        _evictionPolicy{evictionPolicy} {}
+
   void clearAll() override {
     // The _pinnedSizes are not part of the (otherwise threadsafe) _cache
     // and thus have to be manually locked.
     auto lock = _pinnedSizes.wlock();
-    ConcurrentLruCache::clearAll();
+    ConcurrentResultCache::clearAll();
     lock->clear();
+    if (_diskCache) {
+      _diskCache->clear();
+    }
+  }
+  ad_utility::EvictionPolicy evictionPolicy() const { return _evictionPolicy; }
+
+  // The second tier of the cache on disk, nullptr if there is none. Results
+  // that are not in this cache are looked up there before they are computed.
+  // Must be set before any queries are processed.
+  DiskResultCache* diskCache() { return _diskCache.get(); }
+  const DiskResultCache* diskCache() const { return _diskCache.get(); }
+  void setDiskCache(std::unique_ptr<DiskResultCache> diskCache) {
+    _diskCache = std::move(diskCache);
   }
-  // Inherit the constructor.
-  using ConcurrentLruCache::ConcurrentLruCache;
   const PinnedSizes& pinnedSizes() const { return _pinnedSizes; }
   PinnedSizes& pinnedSizes() { return _pinnedSizes; }
   std::optional<size_t> getPinnedSize(const std::string& key) {
@@ -112,6 +141,21 @@ class QueryExecutionContext {
 
   ad_utility::AllocatorWithLimit<Id> getAllocator() { return _allocator; }
 
+  // For the small temporary objects of the operations, e.g. with an
+  // `ad_utility::ArenaHashSet`. Its memory counts towards the memory of the
+  // query and is released when the context is destroyed at the end of the
+  // query. It must therefore not be used for the results, which may be
+  // cached beyond the query.
+  ad_utility::MonotonicArena& getArena() const { return _arena; }
+
+  // The number of threads of the shared thread pool that the operations of
+  // this query may use at the same time (see `Operation::makeTaskGroup`). By
+  // default all of them.
+  [[nodiscard]] size_t getMaxParallelism() const { return _maxParallelism; }
+  void setMaxParallelism(size_t maxParallelism) {
+    _maxParallelism = maxParallelism;
+  }
+
   const bool _pinSubtrees;
   const bool _pinResult;
 
@@ -123,4 +167,6 @@ class QueryExecutionContext {
   ad_utility::AllocatorWithLimit<Id> _allocator;
   QueryPlanningCostFactors _costFactors;
   SortPerformanceEstimator _sortPerformanceEstimator;
+  mutable ad_utility::MonotonicArena _arena{_allocator, QUERY_ARENA_BLOCK_SIZE};
+  size_t _maxParallelism = ad_utility::TaskGroup::UNBOUNDED;
 };
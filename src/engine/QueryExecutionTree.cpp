@@ -12,6 +12,9 @@
 #include <utility>
 
 #include "../parser/RdfEscaping.h"
+#include "../util/ArrowIpc.h"
+#include "../util/HashMap.h"
+#include "../util/JsonString.h"
 #include "./OrderBy.h"
 #include "./Sort.h"
 
@@ -114,7 +117,8 @@ QueryExecutionTree::selectedVariablesToColumnIndices(
 }
 
 // _____________________________________________________________________________
-nlohmann::json QueryExecutionTree::writeResultAsQLeverJson(
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeResultAsQLeverJson(
     const SelectedVarsOrAsterisk& selectedVarsOrAsterisk, size_t limit,
     size_t offset, shared_ptr<const ResultTable> resultTable) const {
   // They may trigger computation (but does not have to).
@@ -124,20 +128,62 @@ nlohmann::json QueryExecutionTree::writeResultAsQLeverJson(
   LOG(DEBUG) << "Resolving strings for finished binary result...\n";
   ColumnIndicesAndTypes validIndices =
       selectedVariablesToColumnIndices(selectedVarsOrAsterisk, *resultTable);
-  if (validIndices.empty()) {
-    return {std::vector<std::string>()};
-  }
-
-  return writeQLeverJsonTable(offset, limit, validIndices,
+  return writeQLeverJsonTable(offset, limit, std::move(validIndices),
                               std::move(resultTable));
 }
 
+namespace {
+// The SPARQL JSON of a single value, which is a string from the vocabulary
+// (an IRI or a literal) if the `_xsdType` is null.
+struct SparqlJsonBinding {
+  std::string_view _value;
+  const char* _xsdType;
+
+  friend std::ostream& operator<<(std::ostream& stream,
+                                  const SparqlJsonBinding& binding) {
+    using ad_utility::JsonString;
+    std::string_view value = binding._value;
+    if (binding._xsdType) {
+      return stream << R"({"value":)" << JsonString{value}
+                    << R"(,"type":"literal","datatype":)"
+                    << JsonString{binding._xsdType} << '}';
+    }
+    if (value.starts_with('<') && value.ends_with('>')) {
+      // Strip the <> surrounding the iri.
+      return stream << R"({"value":)"
+                    << JsonString{value.substr(1, value.size() - 2)}
+                    << R"(,"type":"iri"})";
+    }
+    size_t quotePos = value.rfind('"');
+    if (quotePos == std::string_view::npos || quotePos == 0) {
+      // TEXT entries are currently not surrounded by quotes.
+      return stream << R"({"value":)" << JsonString{value}
+                    << R"(,"type":"literal"})";
+    }
+    stream << R"({"value":)" << JsonString{value.substr(1, quotePos - 1)}
+           << R"(,"type":"literal")";
+    // Look for a language tag or type.
+    std::string_view suffix = value.substr(quotePos + 1);
+    if (suffix.starts_with('@')) {
+      stream << R"(,"xml:lang":)" << JsonString{suffix.substr(1)};
+    } else if (suffix.starts_with("^^")) {
+      std::string_view datatype = suffix.substr(2);
+      // Remove the <angle brackets> around the datatype IRI.
+      if (datatype.starts_with('<') && datatype.ends_with('>')) {
+        datatype = datatype.substr(1, datatype.size() - 2);
+      }
+      stream << R"(,"datatype":)" << JsonString{datatype};
+    }
+    return stream << '}';
+  }
+};
+}  // namespace
+
 // _____________________________________________________________________________
-nlohmann::json QueryExecutionTree::writeResultAsSparqlJson(
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeResultAsSparqlJson(
     const SelectedVarsOrAsterisk& selectedVarsOrAsterisk, size_t limit,
     size_t offset, shared_ptr<const ResultTable> resultTable) const {
-  using nlohmann::json;
-
   // This might trigger the actual query processing.
   if (!resultTable) {
     resultTable = getResult();
@@ -149,85 +195,161 @@ nlohmann::json QueryExecutionTree::writeResultAsSparqlJson(
 
   std::erase(columns, std::nullopt);
 
+  return writeSparqlJsonBindings(
+      selectedVarsOrAsterisk.getSelectedVariables(), std::move(columns), limit,
+      offset, std::move(resultTable));
+}
+
+// _____________________________________________________________________________
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeSparqlJsonBindings(
+    std::vector<std::string> variables, ColumnIndicesAndTypes columns,
+    size_t limit, size_t offset,
+    std::shared_ptr<const ResultTable> resultTable) const {
+  using ad_utility::JsonString;
   if (columns.empty()) {
-    return {std::vector<std::string>()};
+    co_yield "[[]]";
+    co_return;
   }
 
-  const IdTable& idTable = resultTable->_idTable;
-
-  json result;
-  result["head"]["vars"] = selectedVarsOrAsterisk.getSelectedVariables();
-
-  json bindings = json::array();
+  co_yield R"({"head":{"vars":[)";
+  for (size_t i = 0; i < variables.size(); ++i) {
+    co_yield(i > 0 ? "," : "");
+    co_yield JsonString{variables[i]};
+  }
+  co_yield R"(]},"results":{"bindings":[)";
 
+  const IdTable& idTable = resultTable->_idTable;
   const auto upperBound = std::min(idTable.size(), limit + offset);
-
-  // Take a string from the vocabulary, deduce the type and
-  // return a json dict that describes the binding
-  auto stringToBinding = [](const std::string& entitystr) -> nlohmann::json {
-    nlohmann::ordered_json b;
-    // The string is an iri or literal
-    if (entitystr[0] == '<') {
-      // Strip the <> surrounding the iri
-      b["value"] = entitystr.substr(1, entitystr.size() - 2);
-      b["type"] = "iri";
-    } else {
-      size_t quote_pos = entitystr.rfind('"');
-      if (quote_pos == std::string::npos) {
-        // TEXT entries are currently not surrounded by quotes
-        b["value"] = entitystr;
-        b["type"] = "literal";
-      } else {
-        b["value"] = entitystr.substr(1, quote_pos - 1);
-        b["type"] = "literal";
-        // Look for a language tag or type.
-        if (quote_pos < entitystr.size() - 1 &&
-            entitystr[quote_pos + 1] == '@') {
-          b["xml:lang"] = entitystr.substr(quote_pos + 2);
-        } else if (quote_pos < entitystr.size() - 2 &&
-                   entitystr[quote_pos + 1] == '^') {
-          AD_CHECK(entitystr[quote_pos + 2] == '^');
-          std::string_view datatype{entitystr};
-          // remove the < angledBrackets> around the datatype IRI
-          AD_CHECK(datatype.size() >= quote_pos + 5);
-          datatype.remove_prefix(quote_pos + 4);
-          datatype.remove_suffix(1);
-          b["datatype"] = datatype;
-          ;
-        }
-      }
-    }
-    return b;
-  };
-
   for (size_t rowIndex = offset; rowIndex < upperBound; ++rowIndex) {
-    // TODO: ordered_json` entries are ordered alphabetically, but insertion
-    // order would be preferable.
-    nlohmann::ordered_json binding;
+    co_yield(rowIndex > offset ? ",{" : "{");
+    bool isFirstBinding = true;
     for (const auto& column : columns) {
       const auto& currentId = idTable(rowIndex, column->_columnIndex);
-      const auto& optionalValue =
+      const auto optionalValue =
           toStringAndXsdType(currentId, column->_resultType, *resultTable);
       if (!optionalValue.has_value()) {
         continue;
       }
-      const auto& [stringValue, xsdType] = optionalValue.value();
-      nlohmann::ordered_json b;
-      if (!xsdType) {
-        // no xsdType, this means that `stringValue` is a plain string literal
-        // or entity
-        b = stringToBinding(stringValue);
-      } else {
-        b["value"] = stringValue;
-        b["type"] = "literal";
-        b["datatype"] = xsdType;
-      }
-      binding[column->_variable] = std::move(b);
+      co_yield(isFirstBinding ? "" : ",");
+      isFirstBinding = false;
+      co_yield JsonString{column->_variable};
+      co_yield ':';
+      co_yield SparqlJsonBinding{optionalValue->first, optionalValue->second};
+    }
+    co_yield '}';
+  }
+  co_yield "]}}";
+}
+
+// _____________________________________________________________________________
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeResultAsArrow(
+    const SelectedVarsOrAsterisk& selectedVarsOrAsterisk, size_t limit,
+    size_t offset, shared_ptr<const ResultTable> resultTable) const {
+  ColumnIndicesAndTypes columns =
+      selectedVariablesToColumnIndices(selectedVarsOrAsterisk, *resultTable);
+  return writeArrowBatches(selectedVarsOrAsterisk.getSelectedVariables(),
+                           std::move(columns), limit, offset,
+                           std::move(resultTable));
+}
+
+// _____________________________________________________________________________
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeArrowBatches(
+    std::vector<std::string> variables, ColumnIndicesAndTypes columns,
+    size_t limit, size_t offset,
+    std::shared_ptr<const ResultTable> resultTable, size_t batchSize) const {
+  namespace arrow = ad_utility::arrow;
+  using ResultType = ResultTable::ResultType;
+  AD_CHECK(batchSize > 0);
+  const IdTable& data = resultTable->_idTable;
+  const size_t begin = std::min(offset, data.size());
+  const size_t end = begin + std::min(limit, data.size() - begin);
+
+  // A selected variable that is not in the result has only nulls.
+  std::vector<arrow::Field> fields;
+  for (size_t j = 0; j < columns.size(); ++j) {
+    const auto& column = columns[j];
+    arrow::ColumnType type = arrow::ColumnType::Utf8Dictionary;
+    if (column && column->_resultType == ResultType::VERBATIM) {
+      type = arrow::ColumnType::Int64;
+    } else if (column && column->_resultType == ResultType::FLOAT) {
+      type = arrow::ColumnType::Float32;
     }
-    bindings.emplace_back(std::move(binding));
+    fields.push_back({variables[j], type});
+  }
+  co_yield arrow::schemaMessage(fields);
+
+  // The index in the dictionary of each `Id` of a column, -1 if the `Id` has
+  // no value.
+  std::vector<ad_utility::HashMap<Id, int32_t>> indices(columns.size());
+  std::vector<int32_t> dictionarySizes(columns.size(), 0);
+  // The values that were added to the dictionaries in the current batch.
+  std::vector<arrow::DictionaryValues> newValues(columns.size());
+  std::vector<arrow::Column> batch;
+  for (const auto& field : fields) {
+    batch.emplace_back(field._type);
   }
-  result["results"]["bindings"] = std::move(bindings);
-  return result;
+
+  // An empty result also has a (single) batch, which sends the dictionaries.
+  size_t batchBegin = begin;
+  do {
+    const size_t batchEnd = std::min(end, batchBegin + batchSize);
+    for (size_t j = 0; j < columns.size(); ++j) {
+      arrow::Column& column = batch[j];
+      column.clear();
+      newValues[j].clear();
+      for (size_t i = batchBegin; i < batchEnd; ++i) {
+        if (!columns[j]) {
+          column.appendNull();
+          continue;
+        }
+        const Id id = data(i, columns[j]->_columnIndex);
+        const ResultType type = columns[j]->_resultType;
+        if (id == ID_NO_VALUE) {
+          column.appendNull();
+        } else if (type == ResultType::VERBATIM) {
+          column.append(static_cast<int64_t>(id));
+        } else if (type == ResultType::FLOAT) {
+          float f;
+          std::memcpy(&f, &id, sizeof(float));
+          column.append(f);
+        } else {
+          auto it = indices[j].find(id);
+          if (it == indices[j].end()) {
+            const auto value = toStringAndXsdType(id, type, *resultTable);
+            int32_t index = -1;
+            if (value.has_value()) {
+              const auto& [stringValue, xsdType] = value.value();
+              index = dictionarySizes[j]++;
+              newValues[j].append(
+                  xsdType ? '"' + stringValue + "\"^^<" + xsdType + '>'
+                          : stringValue);
+            }
+            it = indices[j].emplace(id, index).first;
+          }
+          if (it->second < 0) {
+            column.appendNull();
+          } else {
+            column.append(it->second);
+          }
+        }
+      }
+    }
+    // The first dictionary of each column is sent even if it is empty, the
+    // following ones are deltas.
+    const bool isFirstBatch = batchBegin == begin;
+    for (size_t j = 0; j < columns.size(); ++j) {
+      if (fields[j]._type == arrow::ColumnType::Utf8Dictionary &&
+          (isFirstBatch || newValues[j].size() > 0)) {
+        co_yield arrow::dictionaryBatchMessage(j, newValues[j], !isFirstBatch);
+      }
+    }
+    co_yield arrow::recordBatchMessage(batch);
+    batchBegin = batchEnd;
+  } while (batchBegin < end);
+  co_yield arrow::END_OF_STREAM;
 }
 
 // _____________________________________________________________________________
@@ -323,41 +445,47 @@ QueryExecutionTree::toStringAndXsdType(Id id, ResultTable::ResultType type,
 }
 
 // __________________________________________________________________________________________________________
-nlohmann::json QueryExecutionTree::writeQLeverJsonTable(
-    size_t from, size_t limit, const ColumnIndicesAndTypes& columns,
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeQLeverJsonTable(
+    size_t from, size_t limit, ColumnIndicesAndTypes columns,
     shared_ptr<const ResultTable> resultTable) const {
-  if (!resultTable) {
-    resultTable = getResult();
+  using ad_utility::JsonString;
+  if (columns.empty()) {
+    co_yield "[[]]";
+    co_return;
   }
   const IdTable& data = resultTable->_idTable;
-  nlohmann::json json = nlohmann::json::array();
-
   const auto upperBound = std::min(data.size(), limit + from);
 
+  co_yield '[';
   for (size_t rowIndex = from; rowIndex < upperBound; ++rowIndex) {
-    json.emplace_back();
-    auto& row = json.back();
-    for (const auto& opt : columns) {
+    co_yield(rowIndex > from ? ",[" : "[");
+    for (size_t i = 0; i < columns.size(); ++i) {
+      co_yield(i > 0 ? "," : "");
+      const auto& opt = columns[i];
       if (!opt) {
-        row.emplace_back(nullptr);
+        co_yield "null";
         continue;
       }
       const auto& currentId = data(rowIndex, opt->_columnIndex);
-      const auto& optionalStringAndXsdType =
+      const auto optionalStringAndXsdType =
           toStringAndXsdType(currentId, opt->_resultType, *resultTable);
       if (!optionalStringAndXsdType.has_value()) {
-        row.emplace_back(nullptr);
+        co_yield "null";
         continue;
       }
       const auto& [stringValue, xsdType] = optionalStringAndXsdType.value();
       if (xsdType) {
-        row.emplace_back('"' + stringValue + "\"^^<" + xsdType + '>');
+        const std::string literal =
+            '"' + stringValue + "\"^^<" + xsdType + '>';
+        co_yield JsonString{literal};
       } else {
-        row.emplace_back(stringValue);
+        co_yield JsonString{stringValue};
       }
     }
+    co_yield ']';
   }
-  return json;
+  co_yield ']';
 }
 
 // _____________________________________________________________________________
@@ -551,16 +679,28 @@ template ad_utility::stream_generator::stream_generator QueryExecutionTree::
         size_t offset, std::shared_ptr<const ResultTable> res) const;
 
 // _____________________________________________________________________________
-nlohmann::json QueryExecutionTree::writeRdfGraphJson(
+ad_utility::stream_generator::stream_generator
+QueryExecutionTree::writeRdfGraphJson(
     const ad_utility::sparql_types::Triples& constructTriples, size_t limit,
-    size_t offset, std::shared_ptr<const ResultTable> res) const {
+    size_t offset, std::shared_ptr<const ResultTable> res,
+    size_t* numTriples) const {
+  using ad_utility::JsonString;
   auto generator =
       generateRdfGraph(constructTriples, limit, offset, std::move(res));
-  std::vector<std::array<std::string, 3>> jsonArray;
-  for (auto& triple : generator) {
-    jsonArray.push_back({std::move(triple._subject),
-                         std::move(triple._predicate),
-                         std::move(triple._object)});
+  size_t numWritten = 0;
+  co_yield '[';
+  for (const auto& triple : generator) {
+    co_yield(numWritten > 0 ? ",[" : "[");
+    co_yield JsonString{triple._subject};
+    co_yield ',';
+    co_yield JsonString{triple._predicate};
+    co_yield ',';
+    co_yield JsonString{triple._object};
+    co_yield ']';
+    ++numWritten;
+  }
+  co_yield ']';
+  if (numTriples) {
+    *numTriples = numWritten;
   }
-  return jsonArray;
 }
@@ -3,6 +3,8 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 #pragma once
 
+#include <gtest/gtest.h>
+
 #include <memory>
 #include <optional>
 #include <string>
@@ -51,7 +53,9 @@ class QueryExecutionTree {
     TRANSITIVE_PATH = 17,
     VALUES = 18,
     BIND = 19,
-    MINUS = 20
+    MINUS = 20,
+    LEAPFROG_TRIEJOIN = 21,
+    MULTIWAY_JOIN = 22
   };
 
   enum class ExportSubFormat { CSV, TSV, BINARY };
@@ -128,20 +132,38 @@ class QueryExecutionTree {
       const ad_utility::sparql_types::Triples& constructTriples, size_t limit,
       size_t offset, std::shared_ptr<const ResultTable> res) const;
 
-  // Generate an RDF graph in json format for a CONSTRUCT query.
-  nlohmann::json writeRdfGraphJson(
+  // The JSON writers below produce the JSON piece by piece while it is read
+  // from the returned generator, so only a few rows are in memory at once.
+
+  // Generate an RDF graph in json format for a CONSTRUCT query. If
+  // `numTriples` is not null, it is set to the number of written triples
+  // when the generator is done.
+  ad_utility::stream_generator::stream_generator writeRdfGraphJson(
       const ad_utility::sparql_types::Triples& constructTriples, size_t limit,
-      size_t offset, std::shared_ptr<const ResultTable> res) const;
+      size_t offset, std::shared_ptr<const ResultTable> res,
+      size_t* numTriples = nullptr) const;
 
-  nlohmann::json writeResultAsQLeverJson(
+  // The rows of the result as a JSON array, the "res" of the qlever JSON.
+  ad_utility::stream_generator::stream_generator writeResultAsQLeverJson(
       const SelectedVarsOrAsterisk& selectedVarsOrAsterisk, size_t limit,
       size_t offset, shared_ptr<const ResultTable> resultTable = nullptr) const;
 
-  nlohmann::json writeResultAsSparqlJson(
+  // The SPARQL JSON of the result (the complete document).
+  ad_utility::stream_generator::stream_generator writeResultAsSparqlJson(
       const SelectedVarsOrAsterisk& selectedVarsOrAsterisk, size_t limit,
       size_t offset,
       shared_ptr<const ResultTable> preComputedResult = nullptr) const;
 
+  // The result in the Apache Arrow IPC stream format (see `ArrowIpc.h`), in
+  // record batches of `ARROW_BATCH_SIZE` rows. The `limit` may be
+  // `std::numeric_limits<size_t>::max()`. Integers and floats that are
+  // not in the vocabulary become `int64` and `float` columns, all other values
+  // (IRIs, literals, text excerpts) are dictionary-encoded by their `Id`, so
+  // each distinct value is only resolved and sent once per column.
+  ad_utility::stream_generator::stream_generator writeResultAsArrow(
+      const SelectedVarsOrAsterisk& selectedVarsOrAsterisk, size_t limit,
+      size_t offset, shared_ptr<const ResultTable> resultTable) const;
+
   const std::vector<size_t>& resultSortedOn() const {
     return _rootOperation->getResultSortedOn();
   }
@@ -182,6 +204,14 @@ class QueryExecutionTree {
   // to zero. Currently multiplicities are not affected
   void readFromCache();
 
+  // Use the `result` of this tree, which has just been computed, like a result
+  // that was read from the cache: it is kept alive, the size estimate becomes
+  // exact and the cost estimate zero.
+  void setMaterializedResult(std::shared_ptr<const ResultTable> result) {
+    _cachedResult = std::move(result);
+    _sizeEstimate = std::numeric_limits<size_t>::max();
+  }
+
   // recursively get all warnings from descendant operations
   vector<string> collectWarnings() const {
     return _rootOperation->collectWarnings();
@@ -251,16 +281,35 @@ class QueryExecutionTree {
 
   /**
    * @brief Convert an IdTable (typically from a query result) to a json array
-   * @param data the IdTable from which we read
    * @param from the first <from> entries of the idTable are skipped
    * @param limit at most <limit> entries are written, starting at <from>
    * @param columns each pair of <columnInIdTable, correspondingType> tells
    * us which columns are to be serialized in which order
+   * @param resultTable the result whose IdTable is read
    * @return a 2D-Json array corresponding to the IdTable given the arguments
    */
-  nlohmann::json writeQLeverJsonTable(
-      size_t from, size_t limit, const ColumnIndicesAndTypes& columns,
-      std::shared_ptr<const ResultTable> resultTable = nullptr) const;
+  ad_utility::stream_generator::stream_generator writeQLeverJsonTable(
+      size_t from, size_t limit, ColumnIndicesAndTypes columns,
+      std::shared_ptr<const ResultTable> resultTable) const;
+  FRIEND_TEST(JsonExportTest, qleverJsonTable);
+
+  // The SPARQL JSON of the rows [offset, offset + limit) of the `resultTable`
+  // with the `variables` and their `columns` (without `std::nullopt`).
+  ad_utility::stream_generator::stream_generator writeSparqlJsonBindings(
+      std::vector<std::string> variables, ColumnIndicesAndTypes columns,
+      size_t limit, size_t offset,
+      std::shared_ptr<const ResultTable> resultTable) const;
+  FRIEND_TEST(JsonExportTest, sparqlJsonBindings);
+
+  // The Arrow stream of the rows [offset, offset + limit) of the
+  // `resultTable` with the `variables` and their `columns`, in record batches
+  // of `batchSize` rows.
+  ad_utility::stream_generator::stream_generator writeArrowBatches(
+      std::vector<std::string> variables, ColumnIndicesAndTypes columns,
+      size_t limit, size_t offset,
+      std::shared_ptr<const ResultTable> resultTable,
+      size_t batchSize = ARROW_BATCH_SIZE) const;
+  FRIEND_TEST(ArrowExportTest, multipleBatches);
 
   [[nodiscard]] std::optional<std::pair<std::string, const char*>>
   toStringAndXsdType(Id id, ResultTable::ResultType type,
@@ -0,0 +1,208 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./QueryPlanCache.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "../util/Exception.h"
+
+namespace {
+bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+
+bool isNameChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+}  // namespace
+
+// _____________________________________________________________________________
+size_t QueryPlanCache::endOfIriOrLiteral(std::string_view query, size_t pos) {
+  const char c = query[pos];
+  if (c == '<') {
+    // IRIs must not contain whitespace and some special characters, so a
+    // comparison like `?x < 3 && ?y > 5` is not mistaken for an IRI.
+    for (size_t i = pos + 1; i < query.size(); ++i) {
+      if (query[i] == '>') {
+        return i + 1;
+      }
+      if (isSpace(query[i]) ||
+          std::string_view{"<\"{}|^`\\"}.find(query[i]) !=
+              std::string_view::npos) {
+        return pos;
+      }
+    }
+    return pos;
+  }
+  if (c != '"' && c != '\'') {
+    return pos;
+  }
+  const std::string_view quote =
+      query.substr(pos, 3) == std::string(3, c) ? query.substr(pos, 3)
+                                                : query.substr(pos, 1);
+  for (size_t i = pos + quote.size(); i < query.size(); ++i) {
+    if (query[i] == '\\') {
+      ++i;
+    } else if (query.substr(i, quote.size()) == quote) {
+      return i + quote.size();
+    }
+  }
+  // An unterminated literal, the parser will complain about it.
+  return pos;
+}
+
+// _____________________________________________________________________________
+std::string QueryPlanCache::normalize(std::string_view query) {
+  std::string result;
+  result.reserve(query.size());
+  bool separate = false;
+  size_t pos = 0;
+  while (pos < query.size()) {
+    if (isSpace(query[pos])) {
+      separate = true;
+      ++pos;
+      continue;
+    }
+    if (query[pos] == '#') {
+      pos = std::min(query.find('\n', pos), query.size());
+      separate = true;
+      continue;
+    }
+    if (separate && !result.empty()) {
+      result += ' ';
+    }
+    separate = false;
+    const size_t end = std::max(endOfIriOrLiteral(query, pos), pos + 1);
+    result.append(query.substr(pos, end - pos));
+    pos = end;
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+std::pair<std::string, QueryPlanCache::LimitAndOffset>
+QueryPlanCache::splitLimitAndOffset(std::string_view query) {
+  LimitAndOffset limitAndOffset;
+  auto equalsIgnoringCase = [](std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+             return std::toupper(static_cast<unsigned char>(x)) == y;
+           });
+  };
+  // Each iteration removes a trailing ` LIMIT <n>` or ` OFFSET <n>`. In a
+  // normalized query, the tokens are separated by single spaces.
+  while (true) {
+    const size_t numberStart = query.rfind(' ') + 1;
+    if (numberStart == 0) {
+      break;
+    }
+    std::string_view number = query.substr(numberStart);
+    // At most 18 digits, so that the value fits into a `size_t`.
+    if (number.empty() || number.size() > 18 ||
+        !std::all_of(number.begin(), number.end(), [](char c) {
+          return std::isdigit(static_cast<unsigned char>(c));
+        })) {
+      break;
+    }
+    const size_t keywordStart = query.rfind(' ', numberStart - 2) + 1;
+    if (keywordStart == 0) {
+      break;
+    }
+    std::string_view keyword =
+        query.substr(keywordStart, numberStart - 1 - keywordStart);
+    std::optional<size_t>* value = nullptr;
+    if (equalsIgnoringCase(keyword, "LIMIT")) {
+      value = &limitAndOffset._limit;
+    } else if (equalsIgnoringCase(keyword, "OFFSET")) {
+      value = &limitAndOffset._offset;
+    }
+    // A repeated LIMIT or OFFSET is an error that the parser reports.
+    if (value == nullptr || value->has_value()) {
+      break;
+    }
+    *value = std::stoull(std::string{number});
+    query = query.substr(0, keywordStart - 1);
+  }
+  return {std::string{query}, limitAndOffset};
+}
+
+// _____________________________________________________________________________
+std::string QueryPlanCache::bindPlaceholders(
+    std::string_view query,
+    const ad_utility::HashMap<std::string, std::string>& values) {
+  std::string result;
+  result.reserve(query.size());
+  size_t pos = 0;
+  while (pos < query.size()) {
+    if (query.substr(pos, 2) == "${") {
+      size_t nameEnd = pos + 2;
+      while (nameEnd < query.size() && isNameChar(query[nameEnd])) {
+        ++nameEnd;
+      }
+      if (nameEnd > pos + 2 && nameEnd < query.size() &&
+          query[nameEnd] == '}') {
+        std::string name{query.substr(pos + 2, nameEnd - pos - 2)};
+        auto it = values.find(name);
+        if (it == values.end()) {
+          AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+                   "No value was given for the placeholder ${" + name + "}.");
+        }
+        if (!isSingleRdfTerm(it->second)) {
+          AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+                   "The value \"" + it->second + "\" for the placeholder ${" +
+                       name +
+                       "} is not a single IRI, literal, prefixed name or "
+                       "number.");
+        }
+        result += it->second;
+        pos = nameEnd + 1;
+        continue;
+      }
+    }
+    const size_t end = std::max(endOfIriOrLiteral(query, pos), pos + 1);
+    result.append(query.substr(pos, end - pos));
+    pos = end;
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+bool QueryPlanCache::isSingleRdfTerm(std::string_view value) {
+  if (value.empty()) {
+    return false;
+  }
+  auto isPrefixedNameOrNumber = [](std::string_view s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) {
+      return isNameChar(c) || c == ':' || c == '.' || c == '-' || c == '+';
+    });
+  };
+  const size_t end = endOfIriOrLiteral(value, 0);
+  if (value[0] == '<') {
+    return end == value.size();
+  }
+  if (value[0] != '"' && value[0] != '\'') {
+    return isPrefixedNameOrNumber(value);
+  }
+  // A literal, optionally with a language tag or a datatype.
+  if (end == 0) {
+    return false;
+  }
+  if (end == value.size()) {
+    return true;
+  }
+  std::string_view suffix = value.substr(end);
+  if (suffix[0] == '@') {
+    return suffix.size() > 1 &&
+           std::all_of(suffix.begin() + 1, suffix.end(), [](char c) {
+             return std::isalnum(static_cast<unsigned char>(c)) || c == '-';
+           });
+  }
+  if (suffix.substr(0, 2) == "^^") {
+    std::string_view datatype = suffix.substr(2);
+    return !datatype.empty() &&
+           (datatype[0] == '<'
+                ? endOfIriOrLiteral(datatype, 0) == datatype.size()
+                : isPrefixedNameOrNumber(datatype));
+  }
+  return false;
+}
@@ -0,0 +1,92 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../parser/ParsedQuery.h"
+#include "../util/Cache.h"
+#include "../util/HashMap.h"
+#include "../util/Synchronized.h"
+#include "./QueryPlanner.h"
+
+// A cache for the parsing and planning of queries that are issued repeatedly,
+// keyed by the normalized query text (see `normalize`). Queries that differ
+// only in their LIMIT and OFFSET, like the pages of a result, share an entry
+// (see `splitLimitAndOffset`).
+//
+// A query text may contain placeholders `${name}` in places where an IRI, a
+// literal or a number is expected (prepared queries). They are bound to the
+// values of the current request by `bindPlaceholders`. The join orders that
+// the query planner chose for the first query of such a template are reused
+// for all queries with the same template, no matter which values are bound.
+class QueryPlanCache {
+ public:
+  struct Entry {
+    // The parsed query (with expanded prefixes) before query planning. Only
+    // set for templates without placeholders, other queries have to be parsed
+    // again after their placeholders have been bound.
+    std::optional<ParsedQuery> _parsedQuery;
+    QueryPlanner::JoinOrders _joinOrders;
+  };
+
+  // The LIMIT and OFFSET at the end of a query.
+  struct LimitAndOffset {
+    std::optional<size_t> _limit;
+    std::optional<size_t> _offset;
+  };
+
+  explicit QueryPlanCache(size_t maxNumEntries) : _cache{maxNumEntries} {}
+
+  // The entry for the normalized `query`, nullptr if there is none.
+  std::shared_ptr<const Entry> get(const std::string& query) {
+    return (*_cache.wlock())[query];
+  }
+
+  // Insert the `entry` for the normalized `query`, unless there already is an
+  // entry (which might have been inserted by a concurrent request).
+  void insert(const std::string& query, Entry entry) {
+    auto cache = _cache.wlock();
+    if (!cache->contains(query)) {
+      cache->insert(query, std::move(entry));
+    }
+  }
+
+  size_t numEntries() const { return _cache.wlock()->numNonPinnedEntries(); }
+
+  void clear() { _cache.wlock()->clearAll(); }
+
+  // Remove the comments from the `query` and replace each sequence of
+  // whitespace by a single space, except inside IRIs and literals. Queries
+  // that differ only in this respect are equivalent.
+  static std::string normalize(std::string_view query);
+
+  // Split the normalized `query` into the query without the LIMIT and OFFSET
+  // at its end and their values. LIMITs and OFFSETs of subqueries are not at
+  // the end (but followed by a `}`), so they stay part of the query.
+  static std::pair<std::string, LimitAndOffset> splitLimitAndOffset(
+      std::string_view query);
+
+  // Replace each placeholder `${name}` (outside of IRIs and literals) in the
+  // `query` by `values.at("name")`. Throws if there is no value for a
+  // placeholder, or if a value is not a single IRI, literal, prefixed name or
+  // number (which protects against injections of other SPARQL code).
+  static std::string bindPlaceholders(
+      std::string_view query,
+      const ad_utility::HashMap<std::string, std::string>& values);
+
+ private:
+  mutable ad_utility::Synchronized<ad_utility::LRUCache<std::string, Entry>>
+      _cache;
+
+  // If an IRI or a (terminated) literal starts at `query[pos]`, return the
+  // position after its end, else return `pos`.
+  static size_t endOfIriOrLiteral(std::string_view query, size_t pos);
+
+  static bool isSingleRdfTerm(std::string_view value);
+};
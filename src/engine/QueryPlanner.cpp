@@ -5,6 +5,7 @@
 #include "./QueryPlanner.h"
 
 #include <algorithm>
+#include <bit>
 #include <ctime>
 
 #include "Bind.h"
@@ -15,8 +16,10 @@
 #include "HasPredicateScan.h"
 #include "IndexScan.h"
 #include "Join.h"
+#include "LeapfrogTriejoin.h"
 #include "Minus.h"
 #include "MultiColumnJoin.h"
+#include "MultiwayJoin.h"
 #include "OptionalJoin.h"
 #include "OrderBy.h"
 #include "Sort.h"
@@ -29,10 +32,15 @@
 
 // _____________________________________________________________________________
 QueryPlanner::QueryPlanner(QueryExecutionContext* qec)
-    : _qec(qec), _internalVarCount(0), _enablePatternTrick(true) {}
+    : _qec(qec),
+      _internalVarCount(0),
+      _enablePatternTrick(true),
+      _enableAdaptiveReoptimization(false) {}
 
 // _____________________________________________________________________________
 QueryExecutionTree QueryPlanner::createExecutionTree(ParsedQuery& pq) {
+  _planningTimer.start();
+  _joinOrders.clear();
   // Look for ql:has-predicate to determine if the pattern trick should be used.
   // If the pattern trick is used the ql:has-predicate triple will be removed
   // from the list of where clause triples. Otherwise the ql:has-relation triple
@@ -101,7 +109,10 @@ QueryExecutionTree QueryPlanner::createExecutionTree(ParsedQuery& pq) {
   SubtreePlan final = lastRow[minInd];
   final._qet->setTextLimit(getTextLimit(pq._textLimit));
 
-  LOG(DEBUG) << "Done creating execution plan.\n";
+  _planningTimer.stop();
+  final._qet->getRootOperation()->setPlanningTime(_planningTimer.msecs());
+  LOG(DEBUG) << "Done creating execution plan in " << _planningTimer.msecs()
+             << "ms.\n";
   return *final._qet;
 }
 
@@ -139,7 +150,7 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
     // carefully checked and I currently see no benefit.
     // TODO<joka921> In fact, for the case of REGEX filters, it could be
     // beneficial to postpone them if possible
-    return fillDpTab(tg, filters, plans).back();
+    return optimizeCommutativeJoins(tg, filters, plans);
   };
 
   // find a single best candidate for a given graph pattern
@@ -414,7 +425,8 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::optimize(
     LOG(TRACE) << "Collapse text cliques..." << std::endl;
     tg.collapseTextCliques();
     LOG(TRACE) << "Collapse text cliques done." << std::endl;
-    auto lastRow = fillDpTab(tg, rootPattern->_filters, candidatePlans).back();
+    auto lastRow =
+        optimizeCommutativeJoins(tg, rootPattern->_filters, candidatePlans);
     candidateTriples._whereClauseTriples.clear();
     candidatePlans.clear();
     candidatePlans.push_back(std::move(lastRow));
@@ -1513,6 +1525,211 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::seedWithScansAndText(
   return seeds;
 }
 
+// _____________________________________________________________________________
+vector<QueryPlanner::SubtreePlan> QueryPlanner::createLeapfrogTriejoinPlans(
+    const QueryPlanner::TripleGraph& tg) const {
+  // The triples that can be read as a sorted trie with two levels.
+  vector<size_t> candidates;
+  for (size_t i = 0; i < tg._nodeMap.size(); ++i) {
+    const TripleGraph::Node& node = *tg._nodeMap.find(i)->second;
+    if (node._cvar.empty() && node._variables.size() == 2 &&
+        node._triple._p._operation == PropertyPath::Operation::IRI &&
+        !isVariable(node._triple._p._iri) &&
+        node._triple._p._iri != HAS_PREDICATE_PREDICATE) {
+      candidates.push_back(i);
+    }
+  }
+
+  // Remove the triples with a variable that no other triple contains until
+  // only the cyclic parts of the graph (and the paths between them) are left.
+  bool removedTriple = true;
+  while (removedTriple) {
+    ad_utility::HashMap<string, size_t> numOccurrences;
+    for (size_t i : candidates) {
+      for (const auto& var : tg._nodeMap.find(i)->second->_variables) {
+        ++numOccurrences[var];
+      }
+    }
+    auto it = std::remove_if(
+        candidates.begin(), candidates.end(), [&](size_t i) {
+          const auto& variables = tg._nodeMap.find(i)->second->_variables;
+          return std::any_of(variables.begin(), variables.end(),
+                             [&](const auto& var) {
+                               return numOccurrences[var] < 2;
+                             });
+        });
+    removedTriple = it != candidates.end();
+    candidates.erase(it, candidates.end());
+  }
+
+  // Split the remaining triples into connected components.
+  vector<vector<size_t>> components;
+  vector<bool> isAssigned(candidates.size(), false);
+  for (size_t start = 0; start < candidates.size(); ++start) {
+    if (isAssigned[start]) {
+      continue;
+    }
+    vector<size_t> component{candidates[start]};
+    isAssigned[start] = true;
+    for (size_t next = 0; next < component.size(); ++next) {
+      const auto& variables =
+          tg._nodeMap.find(component[next])->second->_variables;
+      for (size_t j = 0; j < candidates.size(); ++j) {
+        const auto& otherVariables =
+            tg._nodeMap.find(candidates[j])->second->_variables;
+        if (!isAssigned[j] &&
+            std::any_of(variables.begin(), variables.end(),
+                        [&](const auto& var) {
+                          return otherVariables.count(var) > 0;
+                        })) {
+          isAssigned[j] = true;
+          component.push_back(candidates[j]);
+        }
+      }
+    }
+    std::sort(component.begin(), component.end());
+    components.push_back(std::move(component));
+  }
+
+  vector<SubtreePlan> plans;
+  for (const auto& component : components) {
+    // Bind the variables that occur in the most triples first, they restrict
+    // the result the most. Ties are broken by the order in the query.
+    vector<string> variableOrder;
+    ad_utility::HashMap<string, size_t> numOccurrences;
+    for (size_t i : component) {
+      const auto& triple = tg._nodeMap.find(i)->second->_triple;
+      for (const auto& var : {triple._s, triple._o}) {
+        if (numOccurrences[var]++ == 0) {
+          variableOrder.push_back(var);
+        }
+      }
+    }
+    if (component.size() < 3 || variableOrder.size() < 3) {
+      continue;
+    }
+    std::stable_sort(variableOrder.begin(), variableOrder.end(),
+                     [&](const string& a, const string& b) {
+                       return numOccurrences[a] > numOccurrences[b];
+                     });
+    auto position = [&variableOrder](const string& var) {
+      return std::find(variableOrder.begin(), variableOrder.end(), var) -
+             variableOrder.begin();
+    };
+
+    // Scan each triple in the permutation whose first column is the variable
+    // that is bound first.
+    SubtreePlan plan(_qec);
+    vector<std::shared_ptr<QueryExecutionTree>> children;
+    for (size_t i : component) {
+      const auto& triple = tg._nodeMap.find(i)->second->_triple;
+      plan._idsOfIncludedNodes |= (uint64_t(1) << i);
+      bool subjectFirst = position(triple._s) < position(triple._o);
+      auto scanTree = std::make_shared<QueryExecutionTree>(_qec);
+      auto scan = std::make_shared<IndexScan>(
+          _qec, subjectFirst ? IndexScan::ScanType::PSO_FREE_S
+                             : IndexScan::ScanType::POS_FREE_O);
+      scan->setSubject(triple._s);
+      scan->setPredicate(triple._p._iri);
+      scan->setObject(triple._o);
+      scan->precomputeSizeEstimate();
+      scanTree->setOperation(QueryExecutionTree::OperationType::SCAN, scan);
+      scanTree->setVariableColumn(triple._s, subjectFirst ? 0 : 1);
+      scanTree->setVariableColumn(triple._o, subjectFirst ? 1 : 0);
+      children.push_back(std::move(scanTree));
+    }
+    auto join = std::make_shared<LeapfrogTriejoin>(_qec, std::move(children),
+                                                   std::move(variableOrder));
+    auto& tree = *plan._qet;
+    tree.setVariableColumns(join->getVariableColumns());
+    tree.setOperation(QueryExecutionTree::OperationType::LEAPFROG_TRIEJOIN,
+                      join);
+    plans.push_back(std::move(plan));
+  }
+  return plans;
+}
+
+// _____________________________________________________________________________
+vector<QueryPlanner::SubtreePlan> QueryPlanner::createMultiwayJoinPlans(
+    const QueryPlanner::TripleGraph& tg) const {
+  // For each variable the triples with a fixed predicate that contain it
+  // either as subject or as object.
+  ad_utility::HashMap<string, vector<size_t>> triplesPerVariable;
+  vector<string> centers;
+  for (size_t i = 0; i < tg._nodeMap.size(); ++i) {
+    const TripleGraph::Node& node = *tg._nodeMap.find(i)->second;
+    const auto& triple = node._triple;
+    if (!node._cvar.empty() ||
+        triple._p._operation != PropertyPath::Operation::IRI ||
+        isVariable(triple._p._iri) ||
+        triple._p._iri == HAS_PREDICATE_PREDICATE || triple._s == triple._o) {
+      continue;
+    }
+    for (const auto& var : node._variables) {
+      auto& triples = triplesPerVariable[var];
+      if (triples.empty()) {
+        centers.push_back(var);
+      }
+      triples.push_back(i);
+    }
+  }
+
+  vector<SubtreePlan> plans;
+  for (const auto& center : centers) {
+    // The other variables of the triples must be distinct, the multiway join
+    // only joins on the center.
+    ad_utility::HashSet<string> otherVariables;
+    vector<size_t> star;
+    for (size_t i : triplesPerVariable[center]) {
+      const auto& triple = tg._nodeMap.find(i)->second->_triple;
+      const string& other = triple._s == center ? triple._o : triple._s;
+      if (!isVariable(other) || otherVariables.insert(other).second) {
+        star.push_back(i);
+      }
+    }
+    if (star.size() < 3) {
+      continue;
+    }
+
+    // Scan each triple in the permutation whose first column is the center.
+    SubtreePlan plan(_qec);
+    vector<std::shared_ptr<QueryExecutionTree>> children;
+    for (size_t i : star) {
+      const auto& triple = tg._nodeMap.find(i)->second->_triple;
+      plan._idsOfIncludedNodes |= (uint64_t(1) << i);
+      bool centerIsSubject = triple._s == center;
+      const string& other = centerIsSubject ? triple._o : triple._s;
+      IndexScan::ScanType type;
+      if (isVariable(other)) {
+        type = centerIsSubject ? IndexScan::ScanType::PSO_FREE_S
+                               : IndexScan::ScanType::POS_FREE_O;
+      } else {
+        type = centerIsSubject ? IndexScan::ScanType::POS_BOUND_O
+                               : IndexScan::ScanType::PSO_BOUND_S;
+      }
+      auto scanTree = std::make_shared<QueryExecutionTree>(_qec);
+      auto scan = std::make_shared<IndexScan>(_qec, type);
+      scan->setSubject(triple._s);
+      scan->setPredicate(triple._p._iri);
+      scan->setObject(triple._o);
+      scan->precomputeSizeEstimate();
+      scanTree->setOperation(QueryExecutionTree::OperationType::SCAN, scan);
+      scanTree->setVariableColumn(center, 0);
+      if (isVariable(other)) {
+        scanTree->setVariableColumn(other, 1);
+      }
+      children.push_back(std::move(scanTree));
+    }
+    auto join =
+        std::make_shared<MultiwayJoin>(_qec, std::move(children), center);
+    auto& tree = *plan._qet;
+    tree.setVariableColumns(join->getVariableColumns());
+    tree.setOperation(QueryExecutionTree::OperationType::MULTIWAY_JOIN, join);
+    plans.push_back(std::move(plan));
+  }
+  return plans;
+}
+
 // _____________________________________________________________________________
 vector<QueryPlanner::SubtreePlan> QueryPlanner::seedFromPropertyPathTriple(
     const SparqlTriple& triple) {
@@ -2296,7 +2513,8 @@ std::shared_ptr<Operation> QueryPlanner::createFilterOperation(
 // _____________________________________________________________________________
 vector<vector<QueryPlanner::SubtreePlan>> QueryPlanner::fillDpTab(
     const QueryPlanner::TripleGraph& tg, const vector<SparqlFilter>& filters,
-    const vector<vector<QueryPlanner::SubtreePlan>>& children) {
+    const vector<vector<QueryPlanner::SubtreePlan>>& children,
+    const std::vector<uint64_t>* joinOrderHint) {
   size_t numSeeds = tg._nodeMap.size() + children.size();
 
   if (filters.size() > 64) {
@@ -2305,34 +2523,204 @@ vector<vector<QueryPlanner::SubtreePlan>> QueryPlanner::fillDpTab(
   }
   LOG(TRACE) << "Fill DP table... (there are " << numSeeds
              << " operations to join)" << std::endl;
+  const size_t idpBlockSize = std::max(
+      size_t{2}, RuntimeParameters().get<"query-planner-idp-block-size">());
   vector<vector<SubtreePlan>> dpTab;
   dpTab.emplace_back(seedWithScansAndText(tg, children));
   applyFiltersIfPossible(dpTab.back(), filters, numSeeds == 1);
+  // The worst-case optimal joins of cyclic parts of the graph and the n-ary
+  // joins of its stars enter the table in the row of their number of triples
+  // and compete with the binary joins.
+  auto naryJoinPlans = createLeapfrogTriejoinPlans(tg);
+  auto multiwayJoinPlans = createMultiwayJoinPlans(tg);
+  naryJoinPlans.insert(naryJoinPlans.end(), multiwayJoinPlans.begin(),
+                       multiwayJoinPlans.end());
+  auto removePlansNotInHint = [joinOrderHint](vector<SubtreePlan>& plans) {
+    if (joinOrderHint) {
+      std::erase_if(plans, [joinOrderHint](const SubtreePlan& plan) {
+        return !std::binary_search(joinOrderHint->begin(),
+                                   joinOrderHint->end(),
+                                   plan._idsOfIncludedNodes);
+      });
+    }
+  };
+  removePlansNotInHint(naryJoinPlans);
 
   for (size_t k = 2; k <= numSeeds; ++k) {
     LOG(TRACE) << "Producing plans that unite " << k << " triples."
                << std::endl;
     dpTab.emplace_back(vector<SubtreePlan>());
+    for (auto& plan : naryJoinPlans) {
+      if (static_cast<size_t>(std::popcount(plan._idsOfIncludedNodes)) == k) {
+        dpTab.back().push_back(std::move(plan));
+      }
+    }
+    bool appliedFilters = false;
     for (size_t i = 1; i * 2 <= k; ++i) {
       auto newPlans = merge(dpTab[i - 1], dpTab[k - i - 1], tg);
+      removePlansNotInHint(newPlans);
       if (newPlans.size() == 0) {
         continue;
       }
       dpTab[k - 1].insert(dpTab[k - 1].end(), newPlans.begin(), newPlans.end());
       applyFiltersIfPossible(dpTab.back(), filters, numSeeds == k);
+      appliedFilters = true;
     }
-    if (dpTab[k - 1].size() == 0) {
+    // A row can consist of n-ary joins only (e.g. the last row with a hint
+    // for a plan whose root is a multiway join).
+    if (!appliedFilters && !dpTab[k - 1].empty()) {
+      applyFiltersIfPossible(dpTab.back(), filters, numSeeds == k);
+    }
+    // With a hint, the rows between the seeds and the n-ary or bushy joins of
+    // the hinted plan stay empty.
+    if (dpTab[k - 1].size() == 0 && !joinOrderHint) {
       AD_THROW(ad_semsearch::Exception::BAD_QUERY,
                "Could not find a suitable execution tree. "
                "Likely cause: Queries that require joins of the full "
                "index with itself are not supported at the moment.");
     }
+    if (!joinOrderHint && k < numSeeds &&
+        (k >= idpBlockSize || planningBudgetIsExhausted())) {
+      LOG(DEBUG) << "Stopped filling the DP table after the plans that unite "
+                 << k << " of " << numSeeds << " operations." << std::endl;
+      break;
+    }
   }
 
+  if (joinOrderHint && dpTab.back().empty()) {
+    return {};
+  }
   LOG(TRACE) << "Fill DP table done." << std::endl;
   return dpTab;
 }
 
+// _____________________________________________________________________________
+vector<QueryPlanner::SubtreePlan> QueryPlanner::optimizeCommutativeJoins(
+    const QueryPlanner::TripleGraph& tg, const vector<SparqlFilter>& fs,
+    const vector<vector<QueryPlanner::SubtreePlan>>& children) {
+  const size_t callIndex = _joinOrders.size();
+  _joinOrders.emplace_back();
+  const std::vector<uint64_t>* hint = nullptr;
+  if (callIndex < _joinOrderHints.size() && _joinOrderHints[callIndex]) {
+    hint = &_joinOrderHints[callIndex].value();
+  }
+  auto dpTab = fillDpTab(tg, fs, children, hint);
+  if (dpTab.empty()) {
+    LOG(DEBUG) << "The join order hint does not fit the query, filling the "
+                  "complete dp table"
+               << std::endl;
+    ++_numIgnoredJoinOrderHints;
+    dpTab = fillDpTab(tg, fs, children);
+  }
+  const auto& lastRow = dpTab.back();
+  if (dpTab.size() < tg._nodeMap.size() + children.size()) {
+    return optimizeCommutativeJoinsWithFixedPlan(
+        tg, fs, children, lastRow[findCheapestExecutionTree(lastRow)]);
+  }
+  auto subtrees = getJoinedSubtreesOfCheapestPlan(dpTab);
+  std::vector<uint64_t> joinOrder{lastRow[0]._idsOfIncludedNodes};
+  for (const SubtreePlan* subtree : subtrees) {
+    joinOrder.push_back(subtree->_idsOfIncludedNodes);
+  }
+  std::sort(joinOrder.begin(), joinOrder.end());
+  joinOrder.erase(std::unique(joinOrder.begin(), joinOrder.end()),
+                  joinOrder.end());
+  _joinOrders[callIndex] = std::move(joinOrder);
+
+  // With less than three seeds, there is nothing left to reorder once the
+  // first join has been computed.
+  if (!_enableAdaptiveReoptimization || !_qec || dpTab.size() < 3) {
+    return dpTab.back();
+  }
+  const double factor =
+      RuntimeParameters().get<"adaptive-reoptimization-factor">();
+
+  for (const SubtreePlan* subtree : subtrees) {
+    QueryExecutionTree& qet = *subtree->_qet;
+    size_t estimate = qet.getSizeEstimate();
+    qet.recursivelySetTimeoutTimer(_adaptiveReoptimizationTimer);
+    auto result = qet.getResult();
+    size_t actual = qet.getRootOperation()->getRuntimeInfo().getRows();
+    // From now on, the planner uses the actual size of the subtree.
+    qet.setMaterializedResult(std::move(result));
+    double ratio = std::max(actual, size_t(1)) /
+                   static_cast<double>(std::max(estimate, size_t(1)));
+    if (ratio <= factor && ratio * factor >= 1) {
+      continue;
+    }
+    LOG(INFO) << "Estimated size " << estimate << " but computed " << actual
+              << " rows for " << qet.getRootOperation()->getDescriptor()
+              << ", planning the remaining joins again" << std::endl;
+    return optimizeCommutativeJoinsWithFixedPlan(tg, fs, children, *subtree);
+  }
+  return dpTab.back();
+}
+
+// _____________________________________________________________________________
+vector<const QueryPlanner::SubtreePlan*>
+QueryPlanner::getJoinedSubtreesOfCheapestPlan(
+    const vector<vector<QueryPlanner::SubtreePlan>>& dpTab) const {
+  // The subtrees of the cheapest plan that are plans of the dp table (and thus
+  // know the triples and children they cover). In the reverse preorder, each
+  // subtree comes after its descendants.
+  ad_utility::HashMap<const QueryExecutionTree*, const SubtreePlan*> dpPlans;
+  for (const auto& row : dpTab) {
+    for (const auto& plan : row) {
+      dpPlans[plan._qet.get()] = &plan;
+    }
+  }
+  const auto& lastRow = dpTab.back();
+  const SubtreePlan& best = lastRow[findCheapestExecutionTree(lastRow)];
+  vector<const SubtreePlan*> subtrees;
+  best._qet->forAllDescendants([&](QueryExecutionTree* tree) {
+    auto it = dpPlans.find(tree);
+    if (it != dpPlans.end() &&
+        std::popcount(it->second->_idsOfIncludedNodes) >= 2) {
+      subtrees.push_back(it->second);
+    }
+  });
+  std::reverse(subtrees.begin(), subtrees.end());
+  return subtrees;
+}
+
+// _____________________________________________________________________________
+vector<QueryPlanner::SubtreePlan>
+QueryPlanner::optimizeCommutativeJoinsWithFixedPlan(
+    const QueryPlanner::TripleGraph& tg, const vector<SparqlFilter>& fs,
+    const vector<vector<QueryPlanner::SubtreePlan>>& children,
+    const QueryPlanner::SubtreePlan& fixedPlan) {
+  vector<size_t> remainingNodes;
+  for (size_t i = 0; i < tg._nodeMap.size(); ++i) {
+    if (!((fixedPlan._idsOfIncludedNodes >> i) & 1)) {
+      remainingNodes.push_back(i);
+    }
+  }
+  vector<vector<SubtreePlan>> remainingChildren;
+  for (size_t i = 0; i < children.size(); ++i) {
+    if (!((fixedPlan._idsOfIncludedNodes >> (tg._nodeMap.size() + i)) & 1)) {
+      remainingChildren.push_back(children[i]);
+    }
+  }
+  remainingChildren.push_back({fixedPlan});
+  // The filters that were already applied must not be applied again.
+  vector<SparqlFilter> remainingFilters;
+  for (size_t i = 0; i < fs.size(); ++i) {
+    if (!((fixedPlan._idsOfIncludedFilters >> i) & 1)) {
+      remainingFilters.push_back(fs[i]);
+    }
+  }
+  return optimizeCommutativeJoins(TripleGraph(tg, remainingNodes),
+                                  remainingFilters, remainingChildren);
+}
+
+// _____________________________________________________________________________
+bool QueryPlanner::planningBudgetIsExhausted() {
+  _planningTimer.stop();
+  _planningTimer.cont();
+  return static_cast<size_t>(_planningTimer.msecs()) >
+         RuntimeParameters().get<"query-planner-time-budget-ms">();
+}
+
 // _____________________________________________________________________________
 size_t QueryPlanner::getTextLimit(const string& textLimitString) const {
   if (textLimitString.empty()) {
@@ -2782,6 +3170,14 @@ void QueryPlanner::setEnablePatternTrick(bool enablePatternTrick) {
   _enablePatternTrick = enablePatternTrick;
 }
 
+// _____________________________________________________________________________
+void QueryPlanner::setEnableAdaptiveReoptimization(
+    bool enableAdaptiveReoptimization,
+    ad_utility::SharedConcurrentTimeoutTimer timer) {
+  _enableAdaptiveReoptimization = enableAdaptiveReoptimization;
+  _adaptiveReoptimizationTimer = std::move(timer);
+}
+
 // _________________________________________________________________________________
 size_t QueryPlanner::findCheapestExecutionTree(
     const std::vector<SubtreePlan>& lastRow) const {
@@ -3,6 +3,7 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 #pragma once
 
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -181,6 +182,44 @@ class QueryPlanner {
 
   void setEnablePatternTrick(bool enablePatternTrick);
 
+  // In the adaptive mode, the planner computes the subtrees of the chosen plan
+  // for each set of commutative joins bottom-up while planning. If the size of
+  // such a subtree differs from its estimate by more than the runtime parameter
+  // `adaptive-reoptimization-factor`, the remaining joins are planned again
+  // with the computed result as a leaf. The `timer` is used for these
+  // computations.
+  void setEnableAdaptiveReoptimization(
+      bool enableAdaptiveReoptimization,
+      ad_utility::SharedConcurrentTimeoutTimer timer =
+          std::make_shared<ad_utility::ConcurrentTimeoutTimer>(
+              ad_utility::TimeoutTimer::unlimited()));
+
+  // For each call of `optimizeCommutativeJoins` (in the order of the calls),
+  // the sets of triples and children (as bitmasks, see
+  // `SubtreePlan::_idsOfIncludedNodes`) that are joined by the subtrees of the
+  // cheapest plan, sorted. `std::nullopt` if the dp table of the call was not
+  // filled completely.
+  using JoinOrders = std::vector<std::optional<std::vector<uint64_t>>>;
+
+  // The join orders that were chosen by the last call to
+  // `createExecutionTree`.
+  const JoinOrders& getJoinOrders() const { return _joinOrders; }
+
+  // Restrict the dp tables of the next call to `createExecutionTree` to the
+  // plans that join one of the sets of the `joinOrders` (typically the join
+  // orders of a previous query of the same shape). This makes planning
+  // linear in the number of triples. If the join orders do not fit the
+  // query, the planner silently falls back to the complete dp table.
+  void setJoinOrderHints(JoinOrders joinOrders) {
+    _joinOrderHints = std::move(joinOrders);
+  }
+
+  // The number of join order hints that did not fit the query, so that the
+  // complete dp table had to be filled.
+  size_t getNumIgnoredJoinOrderHints() const {
+    return _numIgnoredJoinOrderHints;
+  }
+
  private:
   QueryExecutionContext* _qec;
 
@@ -190,6 +229,17 @@ class QueryPlanner {
 
   bool _enablePatternTrick;
 
+  bool _enableAdaptiveReoptimization;
+  ad_utility::SharedConcurrentTimeoutTimer _adaptiveReoptimizationTimer;
+
+  // Measures the time spent in `createExecutionTree`, see
+  // `planningBudgetIsExhausted`.
+  ad_utility::Timer _planningTimer;
+
+  JoinOrders _joinOrders;
+  JoinOrders _joinOrderHints;
+  size_t _numIgnoredJoinOrderHints = 0;
+
   std::vector<QueryPlanner::SubtreePlan> optimize(
       ParsedQuery::GraphPattern* rootPattern);
 
@@ -212,6 +262,25 @@ class QueryPlanner {
       const TripleGraph& tg,
       const vector<vector<QueryPlanner::SubtreePlan>>& children);
 
+  /**
+   * @brief Create a LeapfrogTriejoin plan for each cyclic part of the triple
+   * graph. Only triples with a fixed predicate and two variables are
+   * considered; the triples whose variables do not occur in any other of these
+   * triples are removed repeatedly, and each remaining connected component
+   * with at least three triples and three variables yields one plan. The plans
+   * compete with the binary join plans of the same triples in the dp table.
+   */
+  vector<SubtreePlan> createLeapfrogTriejoinPlans(const TripleGraph& tg) const;
+
+  /**
+   * @brief Create a MultiwayJoin plan for each star in the triple graph: a
+   * variable that occurs (as subject or object) in at least three triples with
+   * a fixed predicate, whose other terms are constants or variables that occur
+   * in no other triple of the star. The plans compete with the chains of
+   * binary joins of the same triples in the dp table.
+   */
+  vector<SubtreePlan> createMultiwayJoinPlans(const TripleGraph& tg) const;
+
   /**
    * @brief Returns a subtree plan that will compute the values for the
    * variables in this single triple. Depending on the triple's PropertyPath
@@ -358,11 +427,62 @@ class QueryPlanner {
    * and will filter on one variable.
    * Cycles have to be avoided (by previously removing a triple and using
    * it as a filter later on).
+   *
+   * For large sets of seeds, the table is only filled up to the row of the
+   * runtime parameter `query-planner-idp-block-size` or up to the row during
+   * which the planning budget was exhausted, see `optimizeCommutativeJoins`.
+   *
+   * If `joinOrderHint` is not null, only the plans that join one of its
+   * (sorted) sets of seeds are kept, and the table is always filled
+   * completely. Rows below the last one may stay empty (the hinted plan
+   * might use n-ary or bushy joins), if the last row is empty, an empty table
+   * is returned.
    */
   vector<vector<SubtreePlan>> fillDpTab(
       const TripleGraph& graph, const vector<SparqlFilter>& fs,
+      const vector<vector<SubtreePlan>>& children,
+      const std::vector<uint64_t>* joinOrderHint = nullptr);
+
+  // The plans of the `dpTab` that are proper subtrees of the cheapest plan of
+  // its last row and join at least two seeds. Each subtree comes after its
+  // descendants.
+  vector<const SubtreePlan*> getJoinedSubtreesOfCheapestPlan(
+      const vector<vector<SubtreePlan>>& dpTab) const;
+
+  // True iff the time spent in `createExecutionTree` so far exceeds the
+  // runtime parameter `query-planner-time-budget-ms`.
+  bool planningBudgetIsExhausted();
+
+  /**
+   * @brief Return the last row of the dp table for the triples of `tg`, the
+   * `children` and the filters `fs`. In the adaptive mode (see
+   * `setEnableAdaptiveReoptimization`), the subtrees of the cheapest plan are
+   * computed in the order of their execution. As soon as the actual size of
+   * one of them is off from its estimate by more than the configured factor,
+   * the triples and children that it does not cover are planned again (by a
+   * recursive call), with the computed subtree as an additional child.
+   *
+   * If the dp table could not be filled completely (there are too many seeds
+   * or the planning budget is exhausted), iterative dynamic programming (IDP)
+   * is used: the cheapest plan of the last row is fixed as a single seed and
+   * the remaining joins are planned again.
+   *
+   * The sets of seeds that the cheapest plan joins are appended to the
+   * `_joinOrders`, and the corresponding entry of the `_joinOrderHints` (if
+   * any) restricts the dp table, see `setJoinOrderHints`.
+   */
+  vector<SubtreePlan> optimizeCommutativeJoins(
+      const TripleGraph& tg, const vector<SparqlFilter>& fs,
       const vector<vector<SubtreePlan>>& children);
 
+  // Plan the joins of `optimizeCommutativeJoins` again, after the triples,
+  // children and filters that the `fixedPlan` covers have been replaced by the
+  // `fixedPlan` as an additional child.
+  vector<SubtreePlan> optimizeCommutativeJoinsWithFixedPlan(
+      const TripleGraph& tg, const vector<SparqlFilter>& fs,
+      const vector<vector<SubtreePlan>>& children,
+      const SubtreePlan& fixedPlan);
+
   size_t getTextLimit(const string& textLimitString) const;
 
   SubtreePlan getTextLeafPlan(const TripleGraph::Node& node) const;
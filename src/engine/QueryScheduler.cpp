@@ -0,0 +1,106 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./QueryScheduler.h"
+
+#include <algorithm>
+
+// _____________________________________________________________________________
+QueryScheduler::Slot::Slot(Slot&& other) noexcept
+    : _scheduler{std::exchange(other._scheduler, nullptr)},
+      _waitTime{other._waitTime} {}
+
+// _____________________________________________________________________________
+QueryScheduler::Slot& QueryScheduler::Slot::operator=(Slot&& other) noexcept {
+  if (_scheduler) {
+    _scheduler->release();
+  }
+  _scheduler = std::exchange(other._scheduler, nullptr);
+  _waitTime = other._waitTime;
+  return *this;
+}
+
+// _____________________________________________________________________________
+QueryScheduler::Slot::~Slot() {
+  if (_scheduler) {
+    _scheduler->release();
+  }
+}
+
+// _____________________________________________________________________________
+double QueryScheduler::weight(QueryPriority priority) {
+  switch (priority) {
+    case QueryPriority::BATCH:
+      return 1.0;
+    case QueryPriority::NORMAL:
+      return 4.0;
+    case QueryPriority::INTERACTIVE:
+      return 16.0;
+  }
+  return 1.0;
+}
+
+// _____________________________________________________________________________
+size_t QueryScheduler::maxParallelism(QueryPriority priority,
+                                      size_t numThreads) {
+  const double share =
+      weight(priority) / weight(QueryPriority::INTERACTIVE) *
+      static_cast<double>(numThreads);
+  return std::max(size_t{1}, static_cast<size_t>(share));
+}
+
+// _____________________________________________________________________________
+QueryScheduler::Slot QueryScheduler::acquire(const Request& request) {
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock lock{_mutex};
+  double& lastFinishTag =
+      _lastFinishTags[request._client + '\0' +
+                      std::string{toString(request._priority)}];
+  const double startTag = std::max(_virtualTime, lastFinishTag);
+  // Also queries with a cost of zero advance the tags of their flow.
+  lastFinishTag = startTag + (std::max(request._cost, 0.0) + 1.0) /
+                                 weight(request._priority);
+  const auto position = _queue.emplace(lastFinishTag, _nextTicket++).first;
+  _queueChanged.wait(lock, [&]() {
+    return _numRunning < _numSlots && _queue.begin() == position;
+  });
+  _queue.erase(position);
+  ++_numRunning;
+  _virtualTime = std::max(_virtualTime, startTag);
+  // The tags of flows without waiting queries that are not later than the
+  // virtual time have no effect anymore.
+  if (_queue.empty()) {
+    for (auto it = _lastFinishTags.begin(); it != _lastFinishTags.end();) {
+      if (it->second <= _virtualTime) {
+        _lastFinishTags.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // The next query might also find a free thread.
+  _queueChanged.notify_all();
+  return Slot{this, std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start)};
+}
+
+// _____________________________________________________________________________
+void QueryScheduler::release() {
+  {
+    std::lock_guard lock{_mutex};
+    --_numRunning;
+  }
+  _queueChanged.notify_all();
+}
+
+// _____________________________________________________________________________
+size_t QueryScheduler::numRunningQueries() const {
+  std::lock_guard lock{_mutex};
+  return _numRunning;
+}
+
+// _____________________________________________________________________________
+size_t QueryScheduler::numWaitingQueries() const {
+  std::lock_guard lock{_mutex};
+  return _queue.size();
+}
@@ -0,0 +1,125 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../util/HashMap.h"
+
+/// The priority classes of queries. When queries of several classes wait,
+/// each class gets a share of the threads that is proportional to its
+/// `QueryScheduler::weight`.
+enum class QueryPriority { BATCH, NORMAL, INTERACTIVE };
+
+/// The name of the `priority` as used in the requests to the server.
+inline std::string_view toString(QueryPriority priority) {
+  switch (priority) {
+    case QueryPriority::BATCH:
+      return "batch";
+    case QueryPriority::NORMAL:
+      return "normal";
+    case QueryPriority::INTERACTIVE:
+      return "interactive";
+  }
+  return "normal";
+}
+
+/// The priority with the given `name` (see `toString`), throws if there is
+/// none.
+inline QueryPriority queryPriorityFromString(std::string_view name) {
+  for (auto priority : {QueryPriority::BATCH, QueryPriority::NORMAL,
+                        QueryPriority::INTERACTIVE}) {
+    if (name == toString(priority)) {
+      return priority;
+    }
+  }
+  throw std::runtime_error("Unknown query priority \"" + std::string{name} +
+                           "\", supported are \"batch\", \"normal\" and "
+                           "\"interactive\"");
+}
+
+// Decides which of the waiting queries gets the next of a fixed number of
+// threads, with weighted fair queueing: the queries of the same client and
+// priority class form a flow. Each query gets a finish tag, which is the tag
+// of the previous query of its flow (or the current virtual time if that is
+// later) plus its cost divided by the weight of its class, and the query with
+// the smallest tag starts next. So a flow with many expensive queries (e.g.
+// bulk exports) cannot delay cheap queries of other flows for long, and the
+// classes share the threads in proportion to their weights.
+//
+// This class is threadsafe.
+class QueryScheduler {
+ public:
+  struct Request {
+    // The queries of the same client (e.g. the same API key) and priority
+    // share a flow. Empty for anonymous clients.
+    std::string _client;
+    QueryPriority _priority = QueryPriority::NORMAL;
+    // The estimated cost of the query, e.g. the cost estimate of its plan.
+    double _cost = 0;
+  };
+
+  // Releases the thread when it is destroyed.
+  class Slot {
+   public:
+    Slot() = default;
+    Slot(Slot&& other) noexcept;
+    Slot& operator=(Slot&& other) noexcept;
+    ~Slot();
+
+    // How long the query waited in the queue.
+    std::chrono::milliseconds waitTime() const { return _waitTime; }
+
+   private:
+    friend class QueryScheduler;
+    Slot(QueryScheduler* scheduler, std::chrono::milliseconds waitTime)
+        : _scheduler{scheduler}, _waitTime{waitTime} {}
+
+    QueryScheduler* _scheduler = nullptr;
+    std::chrono::milliseconds _waitTime{0};
+  };
+
+  explicit QueryScheduler(size_t numSlots) : _numSlots{numSlots} {}
+
+  // The share of the threads of a class relative to the other classes.
+  static double weight(QueryPriority priority);
+
+  // How many of the `numThreads` threads of the shared thread pool a single
+  // query of the `priority` may use at the same time for its parallel parts:
+  // all of them for interactive queries, otherwise a share that is
+  // proportional to the weight of the class, but at least one. So a few
+  // batch queries cannot occupy the whole pool.
+  static size_t maxParallelism(QueryPriority priority, size_t numThreads);
+
+  // Wait until one of the threads is free and it is the turn of the
+  // `request`, then occupy the thread until the returned `Slot` is destroyed.
+  Slot acquire(const Request& request);
+
+  size_t numRunningQueries() const;
+  size_t numWaitingQueries() const;
+
+ private:
+  void release();
+
+  const size_t _numSlots;
+  mutable std::mutex _mutex;
+  std::condition_variable _queueChanged;
+  size_t _numRunning = 0;
+  // The waiting queries by their finish tag and, for equal tags, their
+  // arrival. The first one starts next.
+  std::set<std::pair<double, uint64_t>> _queue;
+  uint64_t _nextTicket = 0;
+  // The start tag of the query that was started last.
+  double _virtualTime = 0;
+  // The finish tag of the last query of each flow.
+  ad_utility::HashMap<std::string, double> _lastFinishTags;
+};
@@ -149,6 +149,10 @@ class RuntimeInformation {
     _details[key] = value;
   }
 
+  // direct access to the details
+  nlohmann::json& details() { return _details; }
+  [[nodiscard]] const nlohmann::json& details() const { return _details; }
+
  private:
   static std::string indentStr(size_t indent) {
     std::string ind;
@@ -0,0 +1,102 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../global/Id.h"
+#include "./ColumnKernels.h"
+#include "./IdTable.h"
+
+// The distinct values of the join column of one side of a join. The filter is
+// passed to the other side of the join (sideways information passing), which
+// may then drop all rows whose join column does not contain one of the values,
+// because the join would drop them anyway. The values are kept sorted, so that
+// index scans can skip whole blocks with a range check and filter the (sorted)
+// rows of the remaining blocks with galloping searches and without any false
+// positives.
+class SemiJoinFilter {
+ private:
+  std::vector<Id> _values;
+  // Uniquely describes the values of the filter, it is part of the cache keys
+  // of the filtered results.
+  std::string _description;
+
+ public:
+  // `values` must be sorted, duplicates are removed.
+  SemiJoinFilter(std::vector<Id> values, std::string description)
+      : _values{std::move(values)}, _description{std::move(description)} {
+    AD_CHECK(std::is_sorted(_values.begin(), _values.end()));
+    _values.erase(std::unique(_values.begin(), _values.end()), _values.end());
+  }
+
+  // The filter with the values of the column `col` of the `table`, which must
+  // be sorted by this column.
+  static SemiJoinFilter fromSortedColumn(const IdTable& table, size_t col,
+                                         std::string description) {
+    auto column = columnKernels::getColumn(table, col);
+    std::vector<Id> values;
+    values.reserve(table.size());
+    for (size_t row = 0; row < column.size(); ++row) {
+      if (values.empty() || values.back() != column[row]) {
+        values.push_back(column[row]);
+      }
+    }
+    return SemiJoinFilter{std::move(values), std::move(description)};
+  }
+
+  // The filter with the values that are contained in both filters.
+  [[nodiscard]] SemiJoinFilter intersect(const SemiJoinFilter& other) const {
+    std::vector<Id> values;
+    std::set_intersection(_values.begin(), _values.end(),
+                          other._values.begin(), other._values.end(),
+                          std::back_inserter(values));
+    return SemiJoinFilter{std::move(values),
+                          _description + " AND " + other._description};
+  }
+
+  [[nodiscard]] const std::vector<Id>& values() const { return _values; }
+  [[nodiscard]] size_t size() const { return _values.size(); }
+  [[nodiscard]] const std::string& asString() const { return _description; }
+
+  // Return true iff one of the values is in [first, last].
+  [[nodiscard]] bool containsValueInRange(Id first, Id last) const {
+    auto it = std::lower_bound(_values.begin(), _values.end(), first);
+    return it != _values.end() && *it <= last;
+  }
+
+  // Append the rows in [begin, end), which must be sorted by their first
+  // entry, whose first entry is one of the values to `result`.
+  template <size_t WIDTH>
+  void filterSortedRows(const std::array<Id, WIDTH>* begin,
+                        const std::array<Id, WIDTH>* end,
+                        std::vector<std::array<Id, WIDTH>>* result) const {
+    const size_t numRows = end - begin;
+    if (numRows == 0) {
+      return;
+    }
+    columnKernels::ColumnView rows{begin->data(), numRows, WIDTH};
+    columnKernels::ColumnView values{_values.data(), _values.size(), 1};
+    size_t row = 0;
+    size_t value = 0;
+    // Leapfrog between the rows and the values, both sides skip the entries
+    // that are smaller than the current entry of the other side.
+    while (row < numRows && value < values.size()) {
+      if (rows[row] < values[value]) {
+        row = columnKernels::gallopLowerBound(rows, row, numRows,
+                                              values[value]);
+      } else if (values[value] < rows[row]) {
+        value = columnKernels::gallopLowerBound(values, value, values.size(),
+                                                rows[row]);
+      } else {
+        result->push_back(begin[row]);
+        ++row;
+      }
+    }
+  }
+};
@@ -4,11 +4,16 @@
 
 #include "./Server.h"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cstring>
+#include <future>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "../util/Random.h"
 #include "QueryPlanner.h"
 
 template <typename T>
@@ -30,10 +35,36 @@ void Server::initialize(const string& indexBaseName, bool useText,
     _index.addTextFromOnDiskIndex();
   }
 
+  // The results on disk can only be reused if they were computed on the same
+  // index.
+  if (!_cacheDiskDir.empty()) {
+    _cache.setDiskCache(std::make_unique<DiskResultCache>(
+        _cacheDiskDir, _cacheDiskMaxSizeGB * (1ull << 30u),
+        DiskResultCache::indexIdentity(indexBaseName)));
+  }
+
   _sortPerformanceEstimator.computeEstimatesExpensively(
       _allocator,
       _index.getNofTriples() * PERCENTAGE_OF_TRIPLES_FOR_SORT_ESTIMATE / 100);
 
+  if (!_warmUpQueries.empty()) {
+    *_warmUpReport.wlock() = json{{"status", "running"}};
+    auto warmUp = [this]() {
+      json report = warmUpCache(_warmUpQueries);
+      LOG(INFO) << "Warm-up finished: " << report.dump() << std::endl;
+      *_warmUpReport.wlock() = std::move(report);
+    };
+    if (_warmUpInBackground) {
+      LOG(INFO) << "Warming up the cache in the background with "
+                << _warmUpQueries.size() << " queries ..." << std::endl;
+      _warmUpThread = ad_utility::JThread{std::move(warmUp)};
+    } else {
+      LOG(INFO) << "Warming up the cache with " << _warmUpQueries.size()
+                << " queries ..." << std::endl;
+      warmUp();
+    }
+  }
+
   // Set flag.
   _initialized = true;
   LOG(INFO) << "The server is ready" << std::endl;
@@ -45,8 +76,10 @@ void Server::run(const string& indexBaseName, bool useText, bool usePatterns,
   // First set up the HTTP server, so that it binds to the socket, and
   // the "socket already in use" error appears quickly.
   auto httpSessionHandler =
-      [this](auto request, auto&& send) -> boost::asio::awaitable<void> {
-    co_await process(std::move(request), send);
+      [this](auto request, auto&& send,
+             std::function<void()>& onClientDisconnect)
+      -> boost::asio::awaitable<void> {
+    co_await process(std::move(request), send, onClientDisconnect);
   };
   auto httpServer = HttpServer{static_cast<unsigned short>(_port), "0.0.0.0",
                                _numThreads, std::move(httpSessionHandler)};
@@ -61,7 +94,8 @@ void Server::run(const string& indexBaseName, bool useText, bool usePatterns,
 
 // _____________________________________________________________________________
 Awaitable<void> Server::process(
-    const ad_utility::httpUtils::HttpRequest auto& request, auto&& send) {
+    const ad_utility::httpUtils::HttpRequest auto& request, auto&& send,
+    std::function<void()>& onClientDisconnect) {
   using namespace ad_utility::httpUtils;
   ad_utility::Timer requestTimer;
   requestTimer.start();
@@ -78,6 +112,7 @@ Awaitable<void> Server::process(
   // query, track if there is such a command but no query and still send
   // a useful response.
   std::optional<http::response<http::string_body>> responseFromCommand;
+  closeIdleCursors();
   if (params.contains("cmd")) {
     const auto& cmd = params.at("cmd");
     if (cmd == "stats") {
@@ -91,14 +126,57 @@ Awaitable<void> Server::process(
     } else if (cmd == "clear-cache") {
       LOG(INFO) << "Clearing the cache, unpinned elements only" << std::endl;
       _cache.clearUnpinnedOnly();
+      _queryPlanCache.clear();
       responseFromCommand =
           createJsonResponse(composeCacheStatsJson(), request);
     } else if (cmd == "clear-cache-complete") {
       LOG(INFO) << "Clearing the cache completely, including unpinned elements"
                 << std::endl;
       _cache.clearAll();
+      _queryPlanCache.clear();
       responseFromCommand =
           createJsonResponse(composeCacheStatsJson(), request);
+    } else if (cmd == "close-cursor") {
+      if (!params.contains("cursor")) {
+        co_return co_await sendWithCors(createBadRequestResponse(
+            R"(The command "close-cursor" requires a parameter "cursor")",
+            request));
+      }
+      const auto& id = params.at("cursor");
+      // The cursor is destroyed after the lock is released.
+      std::shared_ptr<const Cursor> closedCursor;
+      _cursors.withWriteLock([&](auto& cursors) {
+        if (auto it = cursors.find(id); it != cursors.end()) {
+          closedCursor = std::move(it->second._cursor);
+          cursors.erase(it);
+        }
+      });
+      responseFromCommand = createJsonResponse(
+          json{{"cursor", id}, {"closed", closedCursor != nullptr}}, request);
+    } else if (cmd == "cancel") {
+      if (!params.contains("id")) {
+        co_return co_await sendWithCors(createBadRequestResponse(
+            R"(The command "cancel" requires a parameter "id")", request));
+      }
+      const auto& id = params.at("id");
+      ad_utility::SharedConcurrentTimeoutTimer timer;
+      {
+        auto runningQueries = _runningQueries.wlock();
+        if (auto it = runningQueries->find(id); it != runningQueries->end()) {
+          timer = it->second;
+        }
+      }
+      if (timer) {
+        LOG(INFO) << "Cancelling query " << id << std::endl;
+        timer->wlock()->cancel(
+            R"(The query was cancelled with "cmd=cancel".)");
+      }
+      json response{{"id", id}, {"cancelled", timer != nullptr}};
+      co_return co_await sendWithCors(createJsonResponse(response, request));
+    } else if (cmd == "warmup-report") {
+      LOG(INFO) << "Supplying the warm-up report..." << std::endl;
+      json report = *_warmUpReport.wlock();
+      co_return co_await sendWithCors(createJsonResponse(report, request));
     } else if (cmd == "get-settings") {
       LOG(INFO) << "Supplying settings..." << std::endl;
       json settingsJson = RuntimeParameters().toMap();
@@ -134,7 +212,44 @@ Awaitable<void> Server::process(
     }
 
     co_return co_await processQuery(params, requestTimer, std::move(request),
-                                    sendWithCors);
+                                    sendWithCors, onClientDisconnect);
+  } else if (params.contains("cursor") && !params.contains("cmd")) {
+    // The next page of a result that was computed by an earlier request.
+    const auto& id = params.at("cursor");
+    size_t offset = 0;
+    size_t maxSend = MAX_NOF_ROWS_IN_RESULT;
+    for (const auto& [name, value] :
+         {std::pair{"offset", &offset}, {"send", &maxSend}}) {
+      if (!params.contains(name)) {
+        continue;
+      }
+      auto parsed = parseSize(params.at(name));
+      if (!parsed.has_value()) {
+        co_return co_await sendWithCors(createBadRequestResponse(
+            "The parameter \"" + std::string{name} +
+                "\" must be a non-negative integer, but is \"" +
+                params.at(name) + '"',
+            request));
+      }
+      *value = parsed.value();
+    }
+    std::shared_ptr<const Cursor> cursor;
+    {
+      auto cursors = _cursors.wlock();
+      if (auto it = cursors->find(id); it != cursors->end()) {
+        cursor = it->second._cursor;
+        it->second._lastAccess = std::chrono::steady_clock::now();
+      }
+    }
+    if (!cursor) {
+      co_return co_await sendWithCors(createBadRequestResponse(
+          "There is no open cursor \"" + id + "\"", request));
+    }
+    std::string page = co_await computeInNewThread([&] {
+      return composeCursorPageJson(*cursor, id, offset, maxSend, requestTimer);
+    });
+    co_return co_await sendWithCors(
+        createJsonResponse(std::move(page), request));
   } else if (responseFromCommand.has_value()) {
     co_return co_await sendWithCors(std::move(responseFromCommand.value()));
   }
@@ -148,88 +263,130 @@ Awaitable<void> Server::process(
 }
 
 // _____________________________________________________________________________
-Awaitable<json> Server::composeResponseQleverJson(
+Awaitable<ad_utility::stream_generator::stream_generator>
+Server::composeResponseQleverJson(
     const ParsedQuery& query, const QueryExecutionTree& qet,
-    ad_utility::Timer& requestTimer, size_t maxSend) const {
-  auto compute = [&, maxSend] {
+    ad_utility::Timer& requestTimer,
+    const QueryScheduler::Request& schedulingRequest,
+    std::chrono::milliseconds queueWait, size_t maxSend) const {
+  auto compute = [&, maxSend, queueWait] {
     shared_ptr<const ResultTable> resultTable = qet.getResult();
     requestTimer.stop();
     off_t compResultUsecs = requestTimer.usecs();
-    size_t resultSize = resultTable->size();
+    return writeQLeverJson(query, qet, std::move(resultTable), maxSend,
+                           compResultUsecs, queueWait, requestTimer);
+  };
+  return computeInNewThread(compute, schedulingRequest);
+}
 
-    nlohmann::json j;
+// _____________________________________________________________________________
+ad_utility::stream_generator::stream_generator Server::writeQLeverJson(
+    const ParsedQuery& query, const QueryExecutionTree& qet,
+    std::shared_ptr<const ResultTable> resultTable, size_t maxSend,
+    off_t computeResultUsecs, std::chrono::milliseconds queueWait,
+    ad_utility::Timer& requestTimer) {
+  requestTimer.cont();
+  // The members that don't depend on the rows are written first.
+  nlohmann::json j;
 
-    j["query"] = query._originalString;
-    j["status"] = "OK";
-    j["warnings"] = qet.collectWarnings();
-    if (query.hasSelectClause()) {
-      j["selected"] =
-          query.selectClause()._varsOrAsterisk.getSelectedVariables();
-    } else {
-      j["selected"] =
-          std::vector<std::string>{"?subject", "?predicate", "?object"};
-    }
+  j["query"] = query._originalString;
+  j["status"] = "OK";
+  j["warnings"] = qet.collectWarnings();
+  if (query.hasSelectClause()) {
+    j["selected"] = query.selectClause()._varsOrAsterisk.getSelectedVariables();
+  } else {
+    j["selected"] =
+        std::vector<std::string>{"?subject", "?predicate", "?object"};
+  }
 
-    j["runtimeInformation"] = RuntimeInformation::ordered_json(
-        qet.getRootOperation()->getRuntimeInfo());
+  j["runtimeInformation"] = RuntimeInformation::ordered_json(
+      qet.getRootOperation()->getRuntimeInfo());
 
-    {
-      size_t limit =
-          std::min(query._limit.value_or(MAX_NOF_ROWS_IN_RESULT), maxSend);
-      size_t offset = query._offset.value_or(0);
-      requestTimer.cont();
-      j["res"] = query.hasSelectClause()
-                     ? qet.writeResultAsQLeverJson(
-                           query.selectClause()._varsOrAsterisk, limit, offset,
-                           std::move(resultTable))
-                     : qet.writeRdfGraphJson(query.constructClause(), limit,
-                                             offset, std::move(resultTable));
-      requestTimer.stop();
-    }
-    j["resultsize"] = query.hasSelectClause() ? resultSize : j["res"].size();
+  std::string head = j.dump();
+  // Remove the closing brace, the object is continued with the rows.
+  head.pop_back();
+  co_yield head;
 
-    requestTimer.stop();
-    j["time"]["total"] =
-        std::to_string(static_cast<double>(requestTimer.usecs()) / 1000.0) +
-        "ms";
-    j["time"]["computeResult"] =
-        std::to_string(static_cast<double>(compResultUsecs) / 1000.0) + "ms";
+  size_t limit =
+      std::min(query._limit.value_or(MAX_NOF_ROWS_IN_RESULT), maxSend);
+  size_t offset = query._offset.value_or(0);
+  size_t resultSize = resultTable->size();
+  // For a CONSTRUCT query, the result size is the number of triples.
+  auto rows = query.hasSelectClause()
+                  ? qet.writeResultAsQLeverJson(
+                        query.selectClause()._varsOrAsterisk, limit, offset,
+                        std::move(resultTable))
+                  : qet.writeRdfGraphJson(query.constructClause(), limit,
+                                          offset, std::move(resultTable),
+                                          &resultSize);
+  co_yield R"(,"res":)";
+  while (rows.hasNext()) {
+    co_yield rows.next();
+  }
 
-    return j;
-  };
-  return computeInNewThread(compute);
+  requestTimer.stop();
+  nlohmann::json time;
+  time["total"] =
+      std::to_string(static_cast<double>(requestTimer.usecs()) / 1000.0) +
+      "ms";
+  time["computeResult"] =
+      std::to_string(static_cast<double>(computeResultUsecs) / 1000.0) + "ms";
+  time["queueWait"] = std::to_string(queueWait.count()) + "ms";
+  co_yield R"(,"resultsize":)";
+  co_yield resultSize;
+  co_yield R"(,"time":)";
+  const std::string timeString = time.dump();
+  co_yield timeString;
+  co_yield '}';
 }
 
 // _____________________________________________________________________________
-Awaitable<json> Server::composeResponseSparqlJson(
+Awaitable<ad_utility::stream_generator::stream_generator>
+Server::composeResponseSparqlJson(
     const ParsedQuery& query, const QueryExecutionTree& qet,
-    ad_utility::Timer& requestTimer, size_t maxSend) const {
+    const QueryScheduler::Request& schedulingRequest, size_t maxSend) const {
   if (!query.hasSelectClause()) {
     throw std::runtime_error{
         "SPARQL-compliant JSON format is only supported for SELECT queries"};
   }
   auto compute = [&, maxSend] {
     shared_ptr<const ResultTable> resultTable = qet.getResult();
-    requestTimer.stop();
-    nlohmann::json j;
     size_t limit =
         std::min(query._limit.value_or(MAX_NOF_ROWS_IN_RESULT), maxSend);
     size_t offset = query._offset.value_or(0);
-    requestTimer.cont();
-    j = qet.writeResultAsSparqlJson(query.selectClause()._varsOrAsterisk, limit,
-                                    offset, std::move(resultTable));
+    return qet.writeResultAsSparqlJson(query.selectClause()._varsOrAsterisk,
+                                       limit, offset, std::move(resultTable));
+  };
+  return computeInNewThread(compute, schedulingRequest);
+}
 
-    requestTimer.stop();
-    return j;
+// _____________________________________________________________________________
+Awaitable<ad_utility::stream_generator::stream_generator>
+Server::composeResponseArrow(
+    const ParsedQuery& query, const QueryExecutionTree& qet,
+    const QueryScheduler::Request& schedulingRequest) const {
+  if (!query.hasSelectClause()) {
+    throw std::runtime_error{
+        "The Apache Arrow format is only supported for SELECT queries"};
+  }
+  auto compute = [&] {
+    shared_ptr<const ResultTable> resultTable = qet.getResult();
+    // The Arrow export is meant for reading complete results, so unlike the
+    // JSON formats it has no default limit.
+    size_t limit = query._limit.value_or(std::numeric_limits<size_t>::max());
+    size_t offset = query._offset.value_or(0);
+    return qet.writeResultAsArrow(query.selectClause()._varsOrAsterisk, limit,
+                                  offset, std::move(resultTable));
   };
-  return computeInNewThread(compute);
+  return computeInNewThread(compute, schedulingRequest);
 }
 
 // _____________________________________________________________________________
 template <QueryExecutionTree::ExportSubFormat format>
 Awaitable<ad_utility::stream_generator::stream_generator>
-Server::composeResponseSepValues(const ParsedQuery& query,
-                                 const QueryExecutionTree& qet) const {
+Server::composeResponseSepValues(
+    const ParsedQuery& query, const QueryExecutionTree& qet,
+    const QueryScheduler::Request& schedulingRequest) const {
   auto compute = [&] {
     size_t limit = query._limit.value_or(MAX_NOF_ROWS_IN_RESULT);
     size_t offset = query._offset.value_or(0);
@@ -239,7 +396,7 @@ Server::composeResponseSepValues(const ParsedQuery& query,
                : qet.writeRdfGraphSeparatedValues<format>(
                      query.constructClause(), limit, offset, qet.getResult());
   };
-  return computeInNewThread(compute);
+  return computeInNewThread(compute, schedulingRequest);
 }
 
 // _____________________________________________________________________________
@@ -257,6 +414,132 @@ ad_utility::stream_generator::stream_generator Server::composeTurtleResponse(
                                  qet.getResult());
 }
 
+// _____________________________________________________________________________
+std::string Server::createCursor(std::shared_ptr<Cursor> cursor,
+                                 size_t maxSend,
+                                 std::chrono::milliseconds queueWait,
+                                 ad_utility::Timer& requestTimer) {
+  cursor->_result = cursor->_qet->getResult();
+  cursor->_reservation.resize(cursor->_result->size() *
+                              cursor->_result->width() * sizeof(Id));
+  // The IDs are random, so that clients cannot guess the cursors of others.
+  const std::string id = randomId();
+  LOG(INFO) << "Opened cursor " << id << " for a result with "
+            << cursor->_result->size() << " rows" << std::endl;
+  // Keep the cursor alive, even if it is closed by a concurrent request.
+  std::shared_ptr<const Cursor> page = cursor;
+  // Make room for the new cursor.
+  closeIdleCursors(MAX_NUM_OPEN_CURSORS - 1);
+  (*_cursors.wlock())[id] = {std::move(cursor),
+                             std::chrono::steady_clock::now()};
+  return composeCursorPageJson(*page, id, 0, maxSend, requestTimer,
+                               queueWait);
+}
+
+// _____________________________________________________________________________
+void Server::closeIdleCursors(size_t maxNumCursors) {
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::seconds idleTimeout{
+      RuntimeParameters().get<"cursor-idle-timeout-s">()};
+  // The cursors are destroyed after the lock is released.
+  std::vector<std::shared_ptr<const Cursor>> closedCursors;
+  _cursors.withWriteLock([&](auto& cursors) {
+    for (auto it = cursors.begin(); it != cursors.end();) {
+      if (now - it->second._lastAccess >= idleTimeout) {
+        LOG(INFO) << "Closing cursor " << it->first
+                  << ", which was not used for " << idleTimeout.count()
+                  << " s" << std::endl;
+        closedCursors.push_back(std::move(it->second._cursor));
+        cursors.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    while (cursors.size() > maxNumCursors) {
+      auto leastRecentlyUsed = std::min_element(
+          cursors.begin(), cursors.end(), [](const auto& a, const auto& b) {
+            return a.second._lastAccess < b.second._lastAccess;
+          });
+      closedCursors.push_back(std::move(leastRecentlyUsed->second._cursor));
+      cursors.erase(leastRecentlyUsed);
+    }
+  });
+}
+
+// _____________________________________________________________________________
+std::optional<size_t> Server::parseSize(std::string_view value) {
+  size_t result;
+  const auto [end, error] =
+      std::from_chars(value.data(), value.data() + value.size(), result);
+  if (value.empty() || error != std::errc{} ||
+      end != value.data() + value.size()) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+std::string Server::randomId() {
+  thread_local SlowRandomIntGenerator<uint64_t> generator;
+  char id[17];
+  snprintf(id, sizeof(id), "%016llx",
+           static_cast<unsigned long long>(generator()));
+  return id;
+}
+
+// _____________________________________________________________________________
+std::string Server::composeCursorPageJson(
+    const Cursor& cursor, const std::string& id, size_t offset, size_t maxSend,
+    ad_utility::Timer& requestTimer,
+    std::optional<std::chrono::milliseconds> queueWait) {
+  const ParsedQuery& query = cursor._query;
+  // The rows of the result that remain after the LIMIT and OFFSET of the
+  // query, and the rows of this page among them.
+  const size_t size = cursor._result->size();
+  const size_t begin = std::min(query._offset.value_or(0), size);
+  const size_t numRows = std::min(query._limit.value_or(size), size - begin);
+  offset = std::min(offset, numRows);
+  const size_t pageSize = std::min(maxSend, numRows - offset);
+
+  json j;
+  j["query"] = query._originalString;
+  j["status"] = "OK";
+  j["cursor"] = id;
+  j["offset"] = offset;
+  j["resultsize"] = numRows;
+  auto rows =
+      query.hasSelectClause()
+          ? cursor._qet->writeResultAsQLeverJson(
+                query.selectClause()._varsOrAsterisk, pageSize,
+                begin + offset, cursor._result)
+          : cursor._qet->writeRdfGraphJson(query.constructClause(), pageSize,
+                                           begin + offset, cursor._result);
+  std::string res;
+  while (rows.hasNext()) {
+    res += rows.next();
+  }
+  if (query.hasSelectClause()) {
+    j["selected"] = query.selectClause()._varsOrAsterisk.getSelectedVariables();
+  } else {
+    j["selected"] =
+        std::vector<std::string>{"?subject", "?predicate", "?object"};
+  }
+  requestTimer.stop();
+  j["time"]["total"] =
+      std::to_string(static_cast<double>(requestTimer.usecs()) / 1000.0) + "ms";
+  if (queueWait.has_value()) {
+    j["time"]["queueWait"] = std::to_string(queueWait->count()) + "ms";
+  }
+  // The rows are already JSON, so they are appended to the object instead of
+  // being parsed into it.
+  std::string page = j.dump();
+  page.pop_back();
+  page += R"(,"res":)";
+  page += res;
+  page += '}';
+  return page;
+}
+
 // _____________________________________________________________________________
 json Server::composeExceptionJson(const string& query, const std::exception& e,
                                   ad_utility::Timer& requestTimer) {
@@ -302,13 +585,157 @@ nlohmann::json Server::composeCacheStatsJson() const {
   result["non-pinned-size"] = _cache.nonPinnedSize();
   result["pinned-size"] = _cache.pinnedSize();
   result["num-pinned-index-scan-sizes"] = _cache.pinnedSizes().rlock()->size();
+  result["num-query-plans"] = _queryPlanCache.numEntries();
+  // The hit ratio of the eviction policy that the server was started with.
+  const size_t numHits = _cache.numHits();
+  const size_t numLookups = numHits + _cache.numMisses();
+  result["eviction-policy"] = std::string{toString(_cache.evictionPolicy())};
+  result["num-hits"] = numHits;
+  result["num-misses"] = numLookups - numHits;
+  result["hit-ratio"] =
+      numLookups > 0 ? static_cast<double>(numHits) / numLookups : 0.0;
+  if (const auto* diskCache = _cache.diskCache()) {
+    result["num-disk-entries"] = diskCache->numEntries();
+    result["disk-size"] = diskCache->size();
+  }
   return result;
 }
 
+// _____________________________________________________________________________
+std::vector<std::string> Server::readWarmUpQueries(std::istream& input) {
+  std::vector<std::string> queries;
+  for (std::string line; std::getline(input, line);) {
+    if (line.find_first_not_of(" \t\r") != std::string::npos) {
+      queries.push_back(std::move(line));
+    }
+  }
+  return queries;
+}
+
+// _____________________________________________________________________________
+ad_utility::AllocatorWithLimit<Id> Server::makeQueryAllocator() {
+  const size_t maxMemoryPerQuery =
+      RuntimeParameters().get<"query-max-memory-gb">() * (1ull << 30u);
+  return maxMemoryPerQuery > 0 ? _allocator.makeChild(maxMemoryPerQuery)
+                               : _allocator;
+}
+
+// _____________________________________________________________________________
+size_t Server::estimateQueryMemory(QueryExecutionTree& qet) {
+  // The estimate is the size of the result of the plan.
+  const size_t maxMemoryPerQuery =
+      RuntimeParameters().get<"query-max-memory-gb">() * (1ull << 30u);
+  const double estimatedBytes = static_cast<double>(qet.getSizeEstimate()) *
+                                std::max(qet.getResultWidth(), size_t{1}) *
+                                sizeof(Id);
+  return static_cast<size_t>(
+      std::min(estimatedBytes,
+               static_cast<double>(maxMemoryPerQuery > 0
+                                       ? maxMemoryPerQuery
+                                       : std::numeric_limits<size_t>::max())));
+}
+
+// _____________________________________________________________________________
+json Server::warmUpQuery(const std::string& query) {
+  ad_utility::Timer timer;
+  timer.start();
+  json report{{"query", query}};
+  try {
+    ParsedQuery pq = SparqlParser(query).parse();
+    pq.expandPrefixes();
+    // Pin the subtrees and the result, so that they survive the eviction by
+    // the results of the following queries.
+    QueryExecutionContext qec(_index, _engine, &_cache, makeQueryAllocator(),
+                              _sortPerformanceEstimator, true, true);
+    auto timeoutTimer = std::make_shared<ad_utility::ConcurrentTimeoutTimer>(
+        ad_utility::TimeoutTimer::unlimited());
+    timeoutTimer->wlock()->start();
+    QueryPlanner qp(&qec);
+    qp.setEnablePatternTrick(_enablePatternTrick);
+    QueryExecutionTree qet = qp.createExecutionTree(pq);
+    qet.isRoot() = true;  // allow pinning of the final result
+    qet.recursivelySetTimeoutTimer(timeoutTimer);
+
+    // The warm-up must not delay the regular queries, so it has the lowest
+    // priority and all warm-up queries share a flow of the scheduler.
+    QueryScheduler::Request schedulingRequest;
+    schedulingRequest._client = "warm-up";
+    schedulingRequest._priority = QueryPriority::BATCH;
+    schedulingRequest._cost = static_cast<double>(qet.getCostEstimate());
+    qec.setMaxParallelism(QueryScheduler::maxParallelism(
+        schedulingRequest._priority,
+        ad_utility::WorkStealingThreadPool::global().numThreads()));
+    const size_t reservedBytes = estimateQueryMemory(qet);
+    const std::chrono::milliseconds maxQueueWait{
+        RuntimeParameters().get<"query-max-queue-wait-ms">()};
+    std::optional<AdmissionController::Reservation> reservation =
+        _admissionController.admit(reservedBytes, maxQueueWait);
+    if (!reservation.has_value()) {
+      throw std::runtime_error{
+          "The warm-up query was not started, because the " +
+          std::to_string(reservedBytes >> 20) +
+          " MB of memory that it is estimated to need were not free within " +
+          std::to_string(maxQueueWait.count()) + " ms"};
+    }
+    QueryScheduler::Slot slot = _queryScheduler.acquire(schedulingRequest);
+    report["queue-wait-ms"] =
+        (reservation->waitTime() + slot.waitTime()).count();
+
+    auto result = qet.getResult();
+    timer.stop();
+    report["time-ms"] = timer.msecs();
+    report["num-rows"] = result->size();
+    report["num-columns"] = result->_idTable.cols();
+    report["size-bytes"] =
+        result->size() * result->_idTable.cols() * sizeof(Id);
+  } catch (const std::exception& e) {
+    timer.stop();
+    LOG(WARN) << "Warm-up query failed: " << e.what() << std::endl;
+    report["time-ms"] = timer.msecs();
+    report["error"] = e.what();
+  }
+  return report;
+}
+
+// _____________________________________________________________________________
+json Server::warmUpCache(const std::vector<std::string>& queries) {
+  ad_utility::Timer timer;
+  timer.start();
+  // Each worker repeatedly takes the next query that nobody has taken yet.
+  std::vector<json> reports(queries.size());
+  std::atomic<size_t> nextQuery = 0;
+  auto work = [&]() {
+    for (size_t i = nextQuery++; i < queries.size(); i = nextQuery++) {
+      reports[i] = warmUpQuery(queries[i]);
+    }
+  };
+  const size_t numWorkers =
+      std::min(static_cast<size_t>(std::max(_numThreads, 1)), queries.size());
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < numWorkers; ++i) {
+    workers.push_back(std::async(std::launch::async, work));
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.get();
+  }
+  timer.stop();
+
+  size_t numFailed = 0;
+  for (const auto& report : reports) {
+    numFailed += report.contains("error");
+  }
+  return json{{"status", "finished"},
+              {"total-time-ms", timer.msecs()},
+              {"num-failed", numFailed},
+              {"queries", std::move(reports)}};
+}
+
 // ____________________________________________________________________________
 boost::asio::awaitable<void> Server::processQuery(
     const ParamValueMap& params, ad_utility::Timer& requestTimer,
-    const ad_utility::httpUtils::HttpRequest auto& request, auto&& send) {
+    const ad_utility::httpUtils::HttpRequest auto& request, auto&& send,
+    std::function<void()>& onClientDisconnect) {
   using namespace ad_utility::httpUtils;
   AD_CHECK(params.contains("query"));
   const auto& query = params.at("query");
@@ -338,30 +765,216 @@ boost::asio::awaitable<void> Server::processQuery(
                                    const std::string& expected) {
       return params.contains(param) && params.at(param) == expected;
     };
-    size_t maxSend = params.contains("send") ? std::stoul(params.at("send"))
-                                             : MAX_NOF_ROWS_IN_RESULT;
+    size_t maxSend = MAX_NOF_ROWS_IN_RESULT;
+    if (params.contains("send")) {
+      auto parsed = parseSize(params.at("send"));
+      if (!parsed.has_value()) {
+        throw std::runtime_error{
+            "The parameter \"send\" must be a non-negative integer, but is "
+            "\"" +
+            params.at("send") + '"'};
+      }
+      maxSend = parsed.value();
+    }
+
+    // The query is cancelled with `cmd=cancel&id=<query-id>`, where the ID is
+    // chosen by the client or logged below, or when the client closes the
+    // connection. The operations then throw at their next timeout check.
+    const std::string queryId =
+        params.contains("query-id") ? params.at("query-id") : randomId();
+    {
+      auto runningQueries = _runningQueries.wlock();
+      if (runningQueries->contains(queryId)) {
+        throw std::runtime_error{"There already is a running query with the "
+                                 "ID \"" +
+                                 queryId + "\""};
+      }
+      (*runningQueries)[queryId] = timeoutTimer;
+    }
+    ad_utility::OnDestruction unregisterQuery{[this, &queryId]() noexcept {
+      _runningQueries.wlock()->erase(queryId);
+    }};
+    onClientDisconnect = [timeoutTimer, queryId]() {
+      LOG(INFO) << "The client of query " << queryId
+                << " closed the connection, cancelling the query" << std::endl;
+      timeoutTimer->wlock()->cancel(
+          "The query was cancelled, because the client closed the "
+          "connection.");
+    };
+
     const bool pinSubtrees = containsParam("pinsubtrees", "true");
     const bool pinResult = containsParam("pinresult", "true");
-    LOG(INFO) << "Query" << ((pinSubtrees) ? " (Cache pinned)" : "")
+    LOG(INFO) << "Query " << queryId
+              << ((pinSubtrees) ? " (Cache pinned)" : "")
               << ((pinResult) ? " (Result pinned)" : "") << ": " << query
               << '\n';
-    ParsedQuery pq = SparqlParser(query).parse();
-    pq.expandPrefixes();
+    // The placeholders `${name}` of prepared queries are bound to the values
+    // of the parameters `bind-name`.
+    ParamValueMap placeholderValues;
+    for (const auto& [key, value] : params) {
+      if (key.starts_with("bind-")) {
+        placeholderValues[key.substr(5)] = value;
+      }
+    }
+    const std::string normalizedQuery = QueryPlanCache::normalize(query);
+    const std::string boundQuery =
+        QueryPlanCache::bindPlaceholders(normalizedQuery, placeholderValues);
+    const bool isPrepared = boundQuery != normalizedQuery;
+    // Queries that only differ in their LIMIT and OFFSET share a plan. Their
+    // results are shared anyway, because LIMIT and OFFSET are only applied
+    // when the result is exported.
+    const auto [planKey, limitAndOffset] =
+        QueryPlanCache::splitLimitAndOffset(normalizedQuery);
+    // In the adaptive mode, the join orders depend on the computed results, so
+    // they must be neither reused nor cached.
+    const bool adaptive = containsParam("adaptive", "true");
+    std::shared_ptr<const QueryPlanCache::Entry> cachedPlan =
+        adaptive ? nullptr : _queryPlanCache.get(planKey);
+    ParsedQuery pq;
+    if (cachedPlan && cachedPlan->_parsedQuery.has_value()) {
+      pq = cachedPlan->_parsedQuery.value();
+      pq._originalString = query;
+      pq._limit = limitAndOffset._limit;
+      pq._offset = limitAndOffset._offset;
+    } else {
+      pq = SparqlParser(isPrepared ? boundQuery : query).parse();
+      pq.expandPrefixes();
+    }
+    // The query planner modifies the parsed query.
+    std::optional<ParsedQuery> parsedQueryToCache;
+    if (!cachedPlan && !adaptive && !isPrepared) {
+      parsedQueryToCache = pq;
+    }
 
-    QueryExecutionContext qec(_index, _engine, &_cache, _allocator,
-                              _sortPerformanceEstimator, pinSubtrees,
-                              pinResult);
+    // A query can only allocate its share of the memory. On the heap, because
+    // a cursor might keep it after this request.
+    auto qec = std::make_unique<QueryExecutionContext>(
+        _index, _engine, &_cache, makeQueryAllocator(),
+        _sortPerformanceEstimator, pinSubtrees, pinResult);
     // start the shared timeout timer here to also include
     // the query planning
     timeoutTimer->wlock()->start();
 
-    QueryPlanner qp(&qec);
+    // The adaptive planner computes subtrees of the query, so it must only run
+    // after the query was admitted and on a thread of the `_queryScheduler`
+    // (see below). Until then, the query is scheduled and admitted by the
+    // estimates of the plan without reoptimization.
+    std::optional<ParsedQuery> parsedQueryForAdaptivePlan;
+    if (adaptive) {
+      parsedQueryForAdaptivePlan = pq;
+    }
+    QueryPlanner qp(qec.get());
     qp.setEnablePatternTrick(_enablePatternTrick);
+    if (cachedPlan) {
+      qp.setJoinOrderHints(cachedPlan->_joinOrders);
+    }
     QueryExecutionTree qet = qp.createExecutionTree(pq);
+    if (!cachedPlan && !adaptive) {
+      _queryPlanCache.insert(
+          planKey, QueryPlanCache::Entry{std::move(parsedQueryToCache),
+                                         qp.getJoinOrders()});
+    }
     qet.isRoot() = true;  // allow pinning of the final result
     qet.recursivelySetTimeoutTimer(timeoutTimer);
     LOG(TRACE) << qet.asString() << std::endl;
 
+    // When all threads are busy, the next query is chosen by its priority,
+    // its cost and the earlier queries of its client (see `QueryScheduler`).
+    // The priority is the parameter `priority`, else the one of the API key.
+    // Else, cheap queries are interactive, so that they overtake expensive
+    // ones like large exports.
+    QueryScheduler::Request schedulingRequest;
+    schedulingRequest._cost = static_cast<double>(qet.getCostEstimate());
+    if (params.contains("api-key")) {
+      schedulingRequest._client = params.at("api-key");
+    }
+    if (params.contains("priority")) {
+      schedulingRequest._priority =
+          queryPriorityFromString(params.at("priority"));
+    } else if (_apiKeyPriorities.contains(schedulingRequest._client)) {
+      schedulingRequest._priority =
+          _apiKeyPriorities.at(schedulingRequest._client);
+    } else if (schedulingRequest._cost <=
+               static_cast<double>(
+                   RuntimeParameters().get<"query-interactive-max-cost">())) {
+      schedulingRequest._priority = QueryPriority::INTERACTIVE;
+    }
+    LOG(DEBUG) << "Priority of the query: "
+               << toString(schedulingRequest._priority) << std::endl;
+    // The threads of the pool that the operations use for their parallel
+    // parts are shared by the running queries according to their priority.
+    qec->setMaxParallelism(QueryScheduler::maxParallelism(
+        schedulingRequest._priority,
+        ad_utility::WorkStealingThreadPool::global().numThreads()));
+
+    // Wait until the memory that the query is estimated to need is not used by
+    // other queries.
+    const size_t reservedBytes = estimateQueryMemory(qet);
+    const std::chrono::milliseconds maxQueueWait{
+        RuntimeParameters().get<"query-max-queue-wait-ms">()};
+    // The reservation is released when this request is done.
+    std::optional<AdmissionController::Reservation> reservation =
+        co_await ad_utility::asio_helpers::async_on_external_thread(
+            [this, reservedBytes, maxQueueWait]() {
+              return _admissionController.admit(reservedBytes, maxQueueWait);
+            },
+            boost::asio::use_awaitable);
+    if (!reservation.has_value()) {
+      throw std::runtime_error{
+          "The query was not started, because the " +
+          std::to_string(reservedBytes >> 20) +
+          " MB of memory that it is estimated to need were not free within " +
+          std::to_string(maxQueueWait.count()) +
+          " ms. Please try again later."};
+    }
+    // The query might have been cancelled while it waited.
+    timeoutTimer->wlock()->checkTimeoutAndThrow();
+    const auto queueWait = reservation->waitTime();
+    if (queueWait.count() > 0) {
+      LOG(INFO) << "The query waited " << queueWait.count()
+                << " ms for its estimated memory of " << (reservedBytes >> 20)
+                << " MB" << std::endl;
+    }
+
+    if (adaptive) {
+      pq = std::move(parsedQueryForAdaptivePlan.value());
+      qet = co_await computeInNewThread(
+          [this, &qec, &pq, &timeoutTimer] {
+            QueryPlanner adaptivePlanner(qec.get());
+            adaptivePlanner.setEnablePatternTrick(_enablePatternTrick);
+            adaptivePlanner.setEnableAdaptiveReoptimization(true,
+                                                            timeoutTimer);
+            QueryExecutionTree adaptiveQet =
+                adaptivePlanner.createExecutionTree(pq);
+            adaptiveQet.isRoot() = true;
+            adaptiveQet.recursivelySetTimeoutTimer(timeoutTimer);
+            return adaptiveQet;
+          },
+          schedulingRequest);
+      LOG(TRACE) << qet.asString() << std::endl;
+    }
+
+    // The result is kept for paging through it, the response is always
+    // qlever JSON.
+    if (params.contains("cursor")) {
+      if (params.at("cursor") != "create") {
+        throw std::runtime_error{
+            R"(A query can only be sent with "cursor=create")"};
+      }
+      auto cursor = std::make_shared<Cursor>(
+          Cursor{std::move(pq), std::move(qec),
+                 std::make_unique<QueryExecutionTree>(std::move(qet)),
+                 nullptr, std::move(reservation.value())});
+      std::string response = co_await computeInNewThread(
+          [this, cursor = std::move(cursor), maxSend, queueWait,
+           &requestTimer] {
+            return createCursor(std::move(cursor), maxSend, queueWait,
+                                requestTimer);
+          },
+          schedulingRequest);
+      co_return co_await send(createJsonResponse(std::move(response), request));
+    }
+
     using ad_utility::MediaType;
     // Determine the result media type.
 
@@ -375,7 +988,8 @@ boost::asio::awaitable<void> Server::processQuery(
           ad_utility::MediaType::tsv,
           ad_utility::MediaType::csv,
           ad_utility::MediaType::turtle,
-          ad_utility::MediaType::octetStream};
+          ad_utility::MediaType::octetStream,
+          ad_utility::MediaType::arrowStream};
       return mediaTypes;
     };
 
@@ -395,6 +1009,8 @@ boost::asio::awaitable<void> Server::processQuery(
       mediaType = ad_utility::MediaType::turtle;
     } else if (containsParam("action", "binary_export")) {
       mediaType = ad_utility::MediaType::octetStream;
+    } else if (containsParam("action", "arrow_export")) {
+      mediaType = ad_utility::MediaType::arrowStream;
     }
 
     std::string_view acceptHeader = request.base()[http::field::accept];
@@ -423,7 +1039,8 @@ boost::asio::awaitable<void> Server::processQuery(
     switch (mediaType.value()) {
       case ad_utility::MediaType::csv: {
         auto responseGenerator = co_await composeResponseSepValues<
-            QueryExecutionTree::ExportSubFormat::CSV>(pq, qet);
+            QueryExecutionTree::ExportSubFormat::CSV>(pq, qet,
+                                                     schedulingRequest);
 
         auto response = createOkResponse(std::move(responseGenerator), request,
                                          ad_utility::MediaType::csv, method);
@@ -432,7 +1049,8 @@ boost::asio::awaitable<void> Server::processQuery(
       } break;
       case ad_utility::MediaType::tsv: {
         auto responseGenerator = co_await composeResponseSepValues<
-            QueryExecutionTree::ExportSubFormat::TSV>(pq, qet);
+            QueryExecutionTree::ExportSubFormat::TSV>(pq, qet,
+                                                     schedulingRequest);
 
         auto response = createOkResponse(std::move(responseGenerator), request,
                                          ad_utility::MediaType::tsv, method);
@@ -440,18 +1058,30 @@ boost::asio::awaitable<void> Server::processQuery(
       } break;
       case ad_utility::MediaType::octetStream: {
         auto responseGenerator = co_await composeResponseSepValues<
-            QueryExecutionTree::ExportSubFormat::BINARY>(pq, qet);
+            QueryExecutionTree::ExportSubFormat::BINARY>(pq, qet,
+                                                     schedulingRequest);
 
         auto response =
             createOkResponse(std::move(responseGenerator), request,
                              ad_utility::MediaType::octetStream, method);
         co_await send(std::move(response));
       } break;
+      case ad_utility::MediaType::arrowStream: {
+        auto responseGenerator =
+            co_await composeResponseArrow(pq, qet, schedulingRequest);
+
+        auto response =
+            createOkResponse(std::move(responseGenerator), request,
+                             ad_utility::MediaType::arrowStream, method);
+        co_await send(std::move(response));
+      } break;
       case ad_utility::MediaType::qleverJson: {
         // Normal case: JSON response
-        auto responseString =
-            co_await composeResponseQleverJson(pq, qet, requestTimer, maxSend);
-        co_await sendJson(std::move(responseString));
+        auto responseGenerator = co_await composeResponseQleverJson(
+            pq, qet, requestTimer, schedulingRequest, queueWait, maxSend);
+        auto response = createOkResponse(std::move(responseGenerator), request,
+                                         ad_utility::MediaType::json, method);
+        co_await send(std::move(response));
       } break;
       case ad_utility::MediaType::turtle: {
         auto responseGenerator = composeTurtleResponse(pq, qet);
@@ -461,9 +1091,11 @@ boost::asio::awaitable<void> Server::processQuery(
         co_await send(std::move(response));
       } break;
       case ad_utility::MediaType::sparqlJson: {
-        auto responseString =
-            co_await composeResponseSparqlJson(pq, qet, requestTimer, maxSend);
-        co_await sendJson(std::move(responseString));
+        auto responseGenerator = co_await composeResponseSparqlJson(
+            pq, qet, schedulingRequest, maxSend);
+        auto response = createOkResponse(std::move(responseGenerator), request,
+                                         ad_utility::MediaType::json, method);
+        co_await send(std::move(response));
       } break;
       default:
         // This should never happen, because we have carefully restricted the
@@ -5,7 +5,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <istream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../engine/Engine.h"
@@ -18,8 +23,12 @@
 #include "../util/HttpServer/streamable_body.h"
 #include "../util/Socket.h"
 #include "../util/Timer.h"
+#include "../util/jthread.h"
+#include "./AdmissionController.h"
 #include "./QueryExecutionContext.h"
 #include "./QueryExecutionTree.h"
+#include "./QueryPlanCache.h"
+#include "./QueryScheduler.h"
 #include "./SortPerformanceEstimator.h"
 
 using std::string;
@@ -30,9 +39,17 @@ using ad_utility::Socket;
 //! The HTTP Server used.
 class Server {
  public:
-  explicit Server(const int port, const int numThreads, size_t maxMemGB)
+  // If `cacheDiskDir` is not empty, the cache has a second tier in this
+  // directory on disk with a size of at most `cacheDiskMaxSizeGB`.
+  explicit Server(const int port, const int numThreads, size_t maxMemGB,
+                  ad_utility::EvictionPolicy cacheEvictionPolicy =
+                      ad_utility::EvictionPolicy::LRU,
+                  std::string cacheDiskDir = "", size_t cacheDiskMaxSizeGB = 0)
       : _numThreads(numThreads),
         _port(port),
+        _cache(cacheEvictionPolicy),
+        _cacheDiskDir(std::move(cacheDiskDir)),
+        _cacheDiskMaxSizeGB(cacheDiskMaxSizeGB),
         _allocator{ad_utility::makeAllocationMemoryLeftThreadsafeObject(
                        maxMemGB * (1ull << 30u)),
                    [this](size_t numBytesToAllocate) {
@@ -43,10 +60,12 @@ class Server {
         _sortPerformanceEstimator(),
         _index(),
         _engine(),
+        _queryPlanCache(QUERY_PLAN_CACHE_MAX_NUM_ENTRIES),
         _initialized(false),
         // The number of server threads currently also is the number of queries
         // that can be processed simultaneously.
-        _queryProcessingSemaphore(numThreads) {
+        _queryScheduler(numThreads),
+        _admissionController(maxMemGB * (1ull << 30u)) {
     // TODO<joka921> Write a strong type for KB, MB, GB etc and use it
     // in the cache and the memory limit
     // Convert a number of gigabytes to the number of Ids that find in that
@@ -87,21 +106,83 @@ class Server {
   Index& index() { return _index; }
   const Index& index() const { return _index; }
 
+  //! Compute the `queries` with pinned subtrees when the server is
+  //! initialized, before it reports to be ready, or while it already processes
+  //! other queries if `inBackground` is true. Must be called before `run`.
+  void setWarmUpQueries(std::vector<std::string> queries, bool inBackground) {
+    _warmUpQueries = std::move(queries);
+    _warmUpInBackground = inBackground;
+  }
+
+  //! The warm-up queries from the `input`, one per line. Empty lines and
+  //! lines with only whitespace are skipped.
+  static std::vector<std::string> readWarmUpQueries(std::istream& input);
+
+  //! The queries with the parameter `api-key` set to one of the keys of
+  //! `priorities` have the corresponding priority, unless they specify
+  //! another one with the parameter `priority`. Must be called before `run`.
+  void setApiKeyPriorities(
+      ad_utility::HashMap<std::string, QueryPriority> priorities) {
+    _apiKeyPriorities = std::move(priorities);
+  }
+
  private:
   const int _numThreads;
   int _port;
   QueryResultCache _cache;
+  std::string _cacheDiskDir;
+  size_t _cacheDiskMaxSizeGB;
   ad_utility::AllocatorWithLimit<Id> _allocator;
   SortPerformanceEstimator _sortPerformanceEstimator;
   Index _index;
   Engine _engine;
+  QueryPlanCache _queryPlanCache;
+
+  // The timeout timers of the queries that are currently processed, by the
+  // IDs of the queries, to cancel them with `cmd=cancel`.
+  using RunningQueries = ad_utility::HashMap<
+      std::string, ad_utility::SharedConcurrentTimeoutTimer>;
+  ad_utility::Synchronized<RunningQueries> _runningQueries;
 
   bool _initialized;
   bool _enablePatternTrick;
 
-  // Semaphore for the number of queries that can be processed at once.
-  mutable std::counting_semaphore<std::numeric_limits<int>::max()>
-      _queryProcessingSemaphore;
+  // Decides which query is processed next when all threads are busy.
+  mutable QueryScheduler _queryScheduler;
+  ad_utility::HashMap<std::string, QueryPriority> _apiKeyPriorities;
+
+  // Queues the queries until the memory that they are estimated to need is
+  // not used by other queries.
+  AdmissionController _admissionController;
+
+  // A result that was computed once for a request with `cursor=create` and is
+  // kept for later requests with `cursor=<id>`, which page through it
+  // without computing it again.
+  struct Cursor {
+    ParsedQuery _query;
+    // The `_qet` refers to the `_qec`, which therefore must not move.
+    std::unique_ptr<QueryExecutionContext> _qec;
+    std::unique_ptr<QueryExecutionTree> _qet;
+    std::shared_ptr<const ResultTable> _result;
+    // The memory of the `_result` is reserved at the `_admissionController`
+    // as long as the cursor is open.
+    AdmissionController::Reservation _reservation;
+  };
+  struct OpenCursor {
+    std::shared_ptr<const Cursor> _cursor;
+    std::chrono::steady_clock::time_point _lastAccess;
+  };
+  // The open cursors by their ID. Declared after the members that the
+  // contexts and reservations of the cursors refer to.
+  ad_utility::Synchronized<ad_utility::HashMap<std::string, OpenCursor>>
+      _cursors;
+
+  std::vector<std::string> _warmUpQueries;
+  bool _warmUpInBackground = false;
+  ad_utility::Synchronized<json> _warmUpReport{json{{"status", "none"}}};
+  // Declared last, so that it is joined before the other members are
+  // destroyed.
+  ad_utility::JThread _warmUpThread;
 
   template <typename T>
   using Awaitable = boost::asio::awaitable<T>;
@@ -112,8 +193,11 @@ class Server {
   /// \param req The HTTP request.
   /// \param send The action that sends a http:response. (see the
   ///             `HttpServer.h` for documentation).
+  /// \param onClientDisconnect Called by the `HttpServer` when the client
+  ///             closes the connection before the request is handled.
   Awaitable<void> process(const ad_utility::httpUtils::HttpRequest auto& req,
-                          auto&& send);
+                          auto&& send,
+                          std::function<void()>& onClientDisconnect);
 
   /// Handle a http request that asks for the processing of a query.
   /// \param params The key-value-pairs  sent in the HTTP GET request. When this
@@ -124,23 +208,76 @@ class Server {
   /// \param request The HTTP request.
   /// \param send The action that sends a http:response (see the
   ///             `HttpServer.h` for documentation).
+  /// \param onClientDisconnect Is set to cancel the query.
   Awaitable<void> processQuery(
       const ParamValueMap& params, ad_utility::Timer& requestTimer,
-      const ad_utility::httpUtils::HttpRequest auto& request, auto&& send);
+      const ad_utility::httpUtils::HttpRequest auto& request, auto&& send,
+      std::function<void()>& onClientDisconnect);
 
-  Awaitable<json> composeResponseQleverJson(
-      const ParsedQuery& query, const QueryExecutionTree& qet,
-      ad_utility::Timer& requestTimer,
-      size_t maxSend = MAX_NOF_ROWS_IN_RESULT) const;
-  Awaitable<json> composeResponseSparqlJson(
+  // The `schedulingRequest` of the following functions determines when the
+  // query is computed if all threads are busy (see `computeInNewThread`). The
+  // result is computed when the awaitable returns, the responses are written
+  // while they are sent.
+  Awaitable<ad_utility::stream_generator::stream_generator>
+  composeResponseQleverJson(const ParsedQuery& query,
+                            const QueryExecutionTree& qet,
+                            ad_utility::Timer& requestTimer,
+                            const QueryScheduler::Request& schedulingRequest,
+                            std::chrono::milliseconds queueWait,
+                            size_t maxSend = MAX_NOF_ROWS_IN_RESULT) const;
+  Awaitable<ad_utility::stream_generator::stream_generator>
+  composeResponseSparqlJson(const ParsedQuery& query,
+                            const QueryExecutionTree& qet,
+                            const QueryScheduler::Request& schedulingRequest,
+                            size_t maxSend = MAX_NOF_ROWS_IN_RESULT) const;
+
+  // The qlever JSON of the already computed `resultTable` of the `query`.
+  // The `requestTimer` is stopped at the end.
+  static ad_utility::stream_generator::stream_generator writeQLeverJson(
       const ParsedQuery& query, const QueryExecutionTree& qet,
-      ad_utility::Timer& requestTimer,
-      size_t maxSend = MAX_NOF_ROWS_IN_RESULT) const;
+      std::shared_ptr<const ResultTable> resultTable, size_t maxSend,
+      off_t computeResultUsecs, std::chrono::milliseconds queueWait,
+      ad_utility::Timer& requestTimer);
+
+  // The result of a SELECT query as an Apache Arrow stream, for clients that
+  // read many rows. All rows are sent unless the query has a LIMIT.
+  Awaitable<ad_utility::stream_generator::stream_generator>
+  composeResponseArrow(const ParsedQuery& query, const QueryExecutionTree& qet,
+                       const QueryScheduler::Request& schedulingRequest) const;
 
   template <QueryExecutionTree::ExportSubFormat format>
   Awaitable<ad_utility::stream_generator::stream_generator>
-  composeResponseSepValues(const ParsedQuery& query,
-                           const QueryExecutionTree& qet) const;
+  composeResponseSepValues(
+      const ParsedQuery& query, const QueryExecutionTree& qet,
+      const QueryScheduler::Request& schedulingRequest) const;
+
+  // Compute the result of the `cursor`, register it under a new ID and return
+  // its first page. The reservation of the `cursor` is changed to the size of
+  // the result.
+  std::string createCursor(std::shared_ptr<Cursor> cursor, size_t maxSend,
+                           std::chrono::milliseconds queueWait,
+                           ad_utility::Timer& requestTimer);
+
+  // The qlever JSON of the (at most `maxSend`) rows of the `cursor` with the
+  // `id` that start at `offset`. The rows are counted after the LIMIT and
+  // OFFSET of the query have been applied. The `queueWait` of the query is
+  // only reported on its first page.
+  static std::string composeCursorPageJson(
+      const Cursor& cursor, const std::string& id, size_t offset,
+      size_t maxSend, ad_utility::Timer& requestTimer,
+      std::optional<std::chrono::milliseconds> queueWait = std::nullopt);
+
+  // Close the cursors that were not used for `cursor-idle-timeout-s` seconds
+  // and then the least recently used ones until at most `maxNumCursors` are
+  // open.
+  void closeIdleCursors(size_t maxNumCursors = MAX_NUM_OPEN_CURSORS);
+
+  // The value of a parameter like `offset` or `send`, or `std::nullopt` if it
+  // is not a non-negative integer.
+  static std::optional<size_t> parseSize(std::string_view value);
+
+  // A random ID of 16 hex digits, for cursors and queries.
+  static std::string randomId();
 
   static json composeExceptionJson(const string& query, const std::exception& e,
                                    ad_utility::Timer& requestTimer);
@@ -152,21 +289,44 @@ class Server {
 
   json composeCacheStatsJson() const;
 
-  // Perform the following steps: Acquire a token from the
-  // _queryProcessingSemaphore, run `function`, and release the token. These
-  // steps are performed on a new thread (not one of the server threads).
-  // Returns an awaitable of the return value of `function`
+  // Compute the results of the `queries` with pinned subtrees, up to
+  // `_numThreads` of them concurrently, and return a report with the time
+  // and size of the result (or the error) of each query.
+  json warmUpCache(const std::vector<std::string>& queries);
+  FRIEND_TEST(ServerTest, warmUpCache);
+
+  // Compute a single query of `warmUpCache` and return its part of the
+  // report. Like a regular query, it only gets its share of the memory, waits
+  // until the memory that it is estimated to need is free, and waits for a
+  // thread of the `_queryScheduler`, with the lowest priority.
+  json warmUpQuery(const std::string& query);
+
+  // The allocator for a single query, which can only allocate its share
+  // "query-max-memory-gb" of the memory (all of it if the share is zero).
+  ad_utility::AllocatorWithLimit<Id> makeQueryAllocator();
+
+  // The memory that the `qet` is estimated to need, at most the share of a
+  // single query. This memory is reserved at the `_admissionController`.
+  static size_t estimateQueryMemory(QueryExecutionTree& qet);
+
+  // Perform the following steps: Acquire a slot from the _queryScheduler
+  // (when it is the turn of the `schedulingRequest`), run `function`, and
+  // release the slot. These steps are performed on a new thread (not one of
+  // the server threads). Returns an awaitable of the return value of
+  // `function`
   template <typename Function, typename T = std::invoke_result_t<Function>>
-  Awaitable<T> computeInNewThread(Function function) const {
-    auto acquireComputeRelease = [this, function = std::move(function)] {
+  Awaitable<T> computeInNewThread(
+      Function function,
+      QueryScheduler::Request schedulingRequest = {}) const {
+    auto acquireComputeRelease = [this, function = std::move(function),
+                                  schedulingRequest =
+                                      std::move(schedulingRequest)] {
       LOG(DEBUG) << "Acquiring new thread for query processing\n";
-      _queryProcessingSemaphore.acquire();
-      ad_utility::OnDestruction f{[this]() noexcept {
-        try {
-          _queryProcessingSemaphore.release();
-        } catch (...) {
-        }
-      }};
+      QueryScheduler::Slot slot = _queryScheduler.acquire(schedulingRequest);
+      if (slot.waitTime().count() > 0) {
+        LOG(DEBUG) << "Waited " << slot.waitTime().count()
+                   << " ms for a thread\n";
+      }
       return function();
     };
     co_return co_await ad_utility::asio_helpers::async_on_external_thread(
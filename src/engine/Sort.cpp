@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "CallFixedSize.h"
+#include "ExternalSort.h"
 #include "QueryExecutionTree.h"
 
 using std::string;
@@ -81,10 +82,13 @@ void Sort::computeResult(ResultTable* result) {
                               subRes->_resultTypes.begin(),
                               subRes->_resultTypes.end());
   result->_localVocab = subRes->_localVocab;
-  result->_idTable.insert(result->_idTable.end(), subRes->_idTable.begin(),
-                          subRes->_idTable.end());
   int width = result->_idTable.cols();
-  CALL_FIXED_SIZE_1(width, Engine::sort, &result->_idTable, _sortCol);
+  auto comparator = [sortCol = _sortCol](const auto& a, const auto& b) {
+    return a[sortCol] < b[sortCol];
+  };
+  CALL_FIXED_SIZE_1(width, externalSort::sortInMemoryOrExternally,
+                    std::move(subRes), &result->_idTable, comparator,
+                    getExecutionContext(), [this]() { checkTimeout(); });
   result->_sortedBy = resultSortedOn();
 
   LOG(DEBUG) << "Sort result computation done." << endl;
@@ -95,11 +95,11 @@ void TextOperationWithFilter::computeResult(ResultTable* result) {
   if (filterResult->_idTable.cols() == 1) {
     getExecutionContext()->getIndex().getFilteredECListForWordsWidthOne(
         _words, filterResult->_idTable, getNofVars(), _textLimit,
-        &result->_idTable);
+        &result->_idTable, _timeoutTimer);
   } else {
     getExecutionContext()->getIndex().getFilteredECListForWords(
         _words, filterResult->_idTable, _filterColumn, getNofVars(), _textLimit,
-        &result->_idTable);
+        &result->_idTable, _timeoutTimer);
   }
 
   LOG(DEBUG) << "TextOperationWithFilter result computation done." << endl;
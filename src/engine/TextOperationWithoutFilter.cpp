@@ -79,8 +79,8 @@ void TextOperationWithoutFilter::computeResultNoVar(ResultTable* result) const {
   result->_idTable.setCols(2);
   result->_resultTypes.push_back(ResultTable::ResultType::TEXT);
   result->_resultTypes.push_back(ResultTable::ResultType::VERBATIM);
-  getExecutionContext()->getIndex().getContextListForWords(_words,
-                                                           &result->_idTable);
+  getExecutionContext()->getIndex().getContextListForWords(
+      _words, &result->_idTable, _timeoutTimer);
 }
 
 // _____________________________________________________________________________
@@ -90,8 +90,8 @@ void TextOperationWithoutFilter::computeResultOneVar(
   result->_resultTypes.push_back(ResultTable::ResultType::TEXT);
   result->_resultTypes.push_back(ResultTable::ResultType::VERBATIM);
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
-  getExecutionContext()->getIndex().getECListForWordsOneVar(_words, _textLimit,
-                                                            &result->_idTable);
+  getExecutionContext()->getIndex().getECListForWordsOneVar(
+      _words, _textLimit, &result->_idTable, _timeoutTimer);
 }
 
 // _____________________________________________________________________________
@@ -105,7 +105,7 @@ void TextOperationWithoutFilter::computeResultMultVars(
     result->_resultTypes.push_back(ResultTable::ResultType::KB);
   }
   getExecutionContext()->getIndex().getECListForWords(
-      _words, getNofVars(), _textLimit, &result->_idTable);
+      _words, getNofVars(), _textLimit, &result->_idTable, _timeoutTimer);
 }
 
 // _____________________________________________________________________________
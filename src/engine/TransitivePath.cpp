@@ -8,6 +8,7 @@
 
 #include "../util/Exception.h"
 #include "CallFixedSize.h"
+#include "CsrGraph.h"
 #include "IndexScan.h"
 
 // _____________________________________________________________________________
@@ -84,7 +85,9 @@ std::string TransitivePath::getDescriptor() const {
   }
   // The predicate.
   auto scanOperation =
-      std::dynamic_pointer_cast<IndexScan>(_subtree->getRootOperation());
+      _subtree ? std::dynamic_pointer_cast<IndexScan>(
+                     _subtree->getRootOperation())
+               : nullptr;
   if (scanOperation != nullptr) {
     os << " " << scanOperation->getPredicate() << " ";
   } else {
@@ -200,9 +203,13 @@ size_t TransitivePath::getCostEstimate() {
   // We assume that the cost of computing the transitive path is proportional to
   // the result size.
   auto costEstimate = getSizeEstimate();
-  // Add the cost for the index scan of the predicate involved.
+  // Add the cost for the index scan of the predicate involved, unless the
+  // paths are read from a reachability index.
+  bool subjectIsLeft;
+  const bool usesReachabilityIndex =
+      getReachabilityIndex(&subjectIsLeft) != nullptr;
   for (auto* ptr : getChildren()) {
-    if (ptr) {
+    if (ptr && !(usesReachabilityIndex && ptr == _subtree.get())) {
       costEstimate += ptr->getCostEstimate();
     }
   }
@@ -246,6 +253,53 @@ template void TransitivePath::computeTransitivePath<2>(
     size_t leftSubCol, size_t rightSubCol, Id leftValue, Id rightValue,
     size_t minDist, size_t maxDist);
 
+namespace {
+// Split the `numStartRows` rows from which the paths start into at most
+// `transitive-path-num-threads` ranges of at least
+// MIN_ROWS_PER_THREAD_FOR_TRANSITIVE_PATH rows and call
+// `computeRange(begin, end, &partialResult)` for them as tasks of the
+// `taskGroup`. The partial results are appended to `result` in the order of
+// the ranges. Exceptions (e.g. timeouts) are propagated to the caller.
+template <int WIDTH, typename ComputeRange>
+void computeRangesInParallel(size_t numStartRows,
+                             const ComputeRange& computeRange,
+                             IdTableStatic<WIDTH>* result,
+                             ad_utility::TaskGroup taskGroup) {
+  const size_t numRanges = std::max(
+      size_t{1},
+      std::min(RuntimeParameters().get<"transitive-path-num-threads">(),
+               numStartRows / MIN_ROWS_PER_THREAD_FOR_TRANSITIVE_PATH));
+  if (numRanges == 1) {
+    computeRange(0, numStartRows, result);
+    return;
+  }
+  std::vector<IdTableStatic<WIDTH>> partialResults;
+  partialResults.reserve(numRanges);
+  for (size_t i = 0; i < numRanges; ++i) {
+    partialResults.emplace_back(result->cols(), result->getAllocator());
+  }
+  for (size_t i = 0; i < numRanges; ++i) {
+    taskGroup.run([&computeRange, begin = i * numStartRows / numRanges,
+                   end = (i + 1) * numStartRows / numRanges,
+                   partialResult = &partialResults[i]]() {
+      computeRange(begin, end, partialResult);
+    });
+  }
+  taskGroup.wait();
+  for (const auto& partialResult : partialResults) {
+    result->insert(result->end(), partialResult.begin(), partialResult.end());
+  }
+}
+
+void throwIfMinDistIsZero(size_t minDist) {
+  if (minDist == 0) {
+    AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
+             "The TransitivePath operation does not support a minimum "
+             "distance of 0 (use at least one instead).");
+  }
+}
+}  // namespace
+
 // _____________________________________________________________________________
 template <int SUB_WIDTH, bool leftIsVar, bool rightIsVar>
 void TransitivePath::computeTransitivePath(IdTable* dynRes,
@@ -254,438 +308,311 @@ void TransitivePath::computeTransitivePath(IdTable* dynRes,
                                            size_t rightSubCol, Id leftValue,
                                            Id rightValue, size_t minDist,
                                            size_t maxDist) {
-  using Map = ad_utility::HashMap<Id, std::shared_ptr<ad_utility::HashSet<Id>>>;
-  using MapIt = Map::iterator;
-
   if constexpr (!leftIsVar && !rightIsVar) {
     return;
   }
+  throwIfMinDistIsZero(minDist);
 
   const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
   IdTableStatic<2> res = dynRes->moveToStatic<2>();
 
-  // Used to map entries in the left column to entries they have connection with
-  Map edges;
-  // All nodes on the graph from which an edge leads to another node
-  std::vector<Id> nodes;
-
-  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
-  auto checkTimeoutHashSet = [&checkTimeoutAfterNCalls]() {
-    checkTimeoutAfterNCalls(NUM_OPERATIONS_HASHSET_LOOKUP);
-  };
-
-  // initialize the map from the subresult
-  if constexpr (rightIsVar) {
-    (void)rightValue;
-    if (!leftIsVar) {
-      nodes.push_back(leftValue);
-    }
-    for (size_t i = 0; i < sub.size(); i++) {
-      checkTimeoutHashSet();
-      size_t l = sub(i, leftSubCol);
-      size_t r = sub(i, rightSubCol);
-      MapIt it = edges.find(l);
-      if (it == edges.end()) {
-        if constexpr (leftIsVar) {
-          nodes.push_back(l);
-        }
-        std::shared_ptr<ad_utility::HashSet<Id>> s =
-            std::make_shared<ad_utility::HashSet<Id>>();
-        s->insert(r);
-        edges[l] = s;
-      } else {
-        // If r is not in the vector insert it
-        it->second->insert(r);
+  // If the right side is fixed, the paths are searched from the right to the
+  // left, on the inverted edges.
+  const size_t fromCol = rightIsVar ? leftSubCol : rightSubCol;
+  const size_t toCol = rightIsVar ? rightSubCol : leftSubCol;
+  const csrGraph::Graph graph{
+      sub.size(), [&sub, fromCol](size_t i) { return sub(i, fromCol); },
+      [&sub, toCol](size_t i) { return sub(i, toCol); }};
+
+  // All nodes from which an edge leads to another node, or the fixed side.
+  std::vector<size_t> startNodes;
+  if constexpr (leftIsVar && rightIsVar) {
+    for (size_t node = 0; node < graph.numNodes(); ++node) {
+      if (graph.hasSuccessors(node)) {
+        startNodes.push_back(node);
       }
     }
   } else {
-    (void)leftValue;
-    nodes.push_back(rightValue);
-    for (size_t i = 0; i < sub.size(); i++) {
-      checkTimeoutHashSet();
-      // Use the inverted edges
-      size_t l = sub(i, leftSubCol);
-      size_t r = sub(i, rightSubCol);
-      MapIt it = edges.find(r);
-      if (it == edges.end()) {
-        std::shared_ptr<ad_utility::HashSet<Id>> s =
-            std::make_shared<ad_utility::HashSet<Id>>();
-        s->insert(l);
-        edges[r] = s;
-      } else {
-        // If r is not in the vector insert it
-        it->second->insert(l);
-      }
+    size_t node = graph.node(rightIsVar ? leftValue : rightValue);
+    if (node != csrGraph::Graph::NO_NODE) {
+      startNodes.push_back(node);
     }
   }
 
-  // For every node do a dfs on the graph
-
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSet<Id> marks;
-
-  // The stack used to store the dfs' progress
-  std::vector<ad_utility::HashSet<Id>::const_iterator> positions;
-
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<std::shared_ptr<const ad_utility::HashSet<Id>>> edgeCache;
-
-  for (size_t i = 0; i < nodes.size(); i++) {
-    MapIt rootEdges = edges.find(nodes[i]);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second->begin());
-      edgeCache.push_back(rootEdges->second);
-    }
-    if (minDist == 0) {
-      AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
-               "The TransitivePath operation does not support a minimum "
-               "distance of 0 (use at least one instead).");
+  auto computeRange = [&](size_t begin, size_t end, IdTableStatic<2>* result) {
+    csrGraph::Traversal traversal{graph};
+    auto checkTimeout = checkTimeoutAfterNCallsFactory();
+    for (size_t i = begin; i < end; ++i) {
+      const Id start = graph.id(startNodes[i]);
+      traversal.reachableNodes(
+          startNodes[i], minDist, maxDist,
+          [&](size_t node) {
+            if constexpr (rightIsVar) {
+              result->push_back({start, graph.id(node)});
+            } else {
+              result->push_back({graph.id(node), start});
+            }
+          },
+          checkTimeout);
     }
+  };
+  computeRangesInParallel(startNodes.size(), computeRange, &res,
+                          makeTaskGroup());
 
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      ad_utility::HashSet<Id>::const_iterator& pos = positions[stackIndex];
-      const ad_utility::HashSet<Id>* nodeEdges = edgeCache.back().get();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
-        continue;
-      }
+  *dynRes = res.moveToDynamic();
+}
 
-      size_t child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist) {
-          marks.insert(child);
-          if constexpr (rightIsVar) {
-            res.push_back({nodes[i], child});
-          } else {
-            res.push_back({child, nodes[i]});
-          }
+// _____________________________________________________________________________
+template <int SIDE_WIDTH, int RES_WIDTH, typename MakeSearch>
+void TransitivePath::computePathsFromBoundSide(
+    IdTableStatic<RES_WIDTH>* res, const IdTableView<SIDE_WIDTH>& side,
+    size_t sideCol, bool sideIsLeft, size_t resWidth,
+    const MakeSearch& makeSearch) {
+  const size_t startCol = sideIsLeft ? 0 : 1;
+  const size_t targetCol = sideIsLeft ? 1 : 0;
+  auto computeRange = [&](size_t begin, size_t end,
+                          IdTableStatic<RES_WIDTH>* result) {
+    auto search = makeSearch();
+    auto checkTimeout = checkTimeoutAfterNCallsFactory();
+    // Append the path between `start` and `target` and the other columns of
+    // the `sideRow`.
+    auto appendRow = [&](Id start, Id target, size_t sideRow) {
+      size_t row = result->size();
+      result->emplace_back();
+      (*result)(row, startCol) = start;
+      (*result)(row, targetCol) = target;
+      size_t resultCol = 2;
+      for (size_t c = 0; c < side.cols(); ++c) {
+        if (c != sideCol) {
+          (*result)(row, resultCol++) = side(sideRow, c);
         }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second->begin());
-          edgeCache.push_back(it->second);
+      }
+    };
+
+    Id lastStart = std::numeric_limits<Id>::max();
+    size_t lastResultBegin = 0;
+    size_t lastResultEnd = 0;
+    for (size_t i = begin; i < end; ++i) {
+      checkTimeout();
+      const Id start = side(i, sideCol);
+      if (start == lastStart) {
+        // Repeat the paths of the last row.
+        checkTimeout((lastResultEnd - lastResultBegin) * resWidth);
+        for (size_t j = lastResultBegin; j < lastResultEnd; ++j) {
+          appendRow(start, (*result)(j, targetCol), i);
         }
+        continue;
       }
+      lastStart = start;
+      lastResultBegin = result->size();
+      search(
+          start, [&](Id target) { appendRow(start, target, i); },
+          checkTimeout);
+      lastResultEnd = result->size();
     }
+  };
+  computeRangesInParallel(side.size(), computeRange, res, makeTaskGroup());
+}
 
-    if (i + 1 < nodes.size()) {
-      // reset everything for the next iteration
-      marks.clear();
-    }
-  }
-
-  *dynRes = res.moveToDynamic();
+namespace {
+// Return a `makeSearch` for `TransitivePath::computePathsFromBoundSide` that
+// finds the paths in the `graph` with a length in `[minDist, maxDist]`. Only
+// the paths to the `targetValue` are found unless `targetIsVar`.
+auto makeGraphSearch(const csrGraph::Graph& graph, size_t minDist,
+                     size_t maxDist, bool targetIsVar, Id targetValue) {
+  return [&graph, minDist, maxDist, targetIsVar, targetValue]() {
+    return [&graph, minDist, maxDist, targetIsVar, targetValue,
+            traversal = csrGraph::Traversal{graph}](
+               Id start, const auto& emit, auto& checkTimeout) mutable {
+      const size_t startNode = graph.node(start);
+      if (startNode == csrGraph::Graph::NO_NODE) {
+        return;
+      }
+      traversal.reachableNodes(
+          startNode, minDist, maxDist,
+          [&](size_t node) {
+            if (targetIsVar || graph.id(node) == targetValue) {
+              emit(graph.id(node));
+            }
+          },
+          checkTimeout);
+    };
+  };
 }
+}  // namespace
 
+// _____________________________________________________________________________
 template <int SUB_WIDTH, int LEFT_WIDTH, int RES_WIDTH>
 void TransitivePath::computeTransitivePathLeftBound(
     IdTable* dynRes, const IdTable& dynSub, const IdTable& dynLeft,
     size_t leftSideCol, bool rightIsVar, size_t leftSubCol, size_t rightSubCol,
     Id rightValue, size_t minDist, size_t maxDist, size_t resWidth) {
-  using Map = ad_utility::HashMap<Id, std::shared_ptr<ad_utility::HashSet<Id>>>;
-  using MapIt = Map::iterator;
-
+  throwIfMinDistIsZero(minDist);
   const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
   const IdTableView<LEFT_WIDTH> left = dynLeft.asStaticView<LEFT_WIDTH>();
   IdTableStatic<RES_WIDTH> res = dynRes->moveToStatic<RES_WIDTH>();
 
-  // Used to map entries in the left column to entries they have connection with
-  Map edges;
-
-  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
-  auto checkTimeoutHashSet = [&checkTimeoutAfterNCalls]() {
-    checkTimeoutAfterNCalls(NUM_OPERATIONS_HASHSET_LOOKUP);
-  };
-  // initialize the map from the subresult
-  for (size_t i = 0; i < sub.size(); i++) {
-    checkTimeoutHashSet();
-    size_t l = sub(i, leftSubCol);
-    size_t r = sub(i, rightSubCol);
-    MapIt it = edges.find(l);
-    if (it == edges.end()) {
-      std::shared_ptr<ad_utility::HashSet<Id>> s =
-          std::make_shared<ad_utility::HashSet<Id>>();
-      s->insert(r);
-      edges[l] = s;
-    } else {
-      // If r is not in the vector insert it
-      it->second->insert(r);
-    }
-  }
-
-  // For every node do a dfs on the graph
-
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSet<Id> marks;
-
-  // The stack used to store the dfs' progress
-  std::vector<ad_utility::HashSet<Id>::const_iterator> positions;
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<std::shared_ptr<const ad_utility::HashSet<Id>>> edgeCache;
-
-  size_t last_elem = std::numeric_limits<size_t>::max();
-  size_t last_result_begin = 0;
-  size_t last_result_end = 0;
-  for (size_t i = 0; i < left.size(); i++) {
-    checkTimeoutHashSet();
-    if (left[i][leftSideCol] == last_elem) {
-      // We can repeat the last output
-      size_t num_new = last_result_end - last_result_begin;
-      size_t res_row = res.size();
-      res.resize(res.size() + num_new);
-      checkTimeoutAfterNCalls(num_new * resWidth);
-      for (size_t j = 0; j < num_new; j++) {
-        for (size_t c = 0; c < resWidth; c++) {
-          res(res_row + j, c) = res(last_result_begin + j, c);
-        }
-      }
-      continue;
-    }
-    last_elem = left[i][leftSideCol];
-    last_result_begin = res.size();
-    MapIt rootEdges = edges.find(last_elem);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second->begin());
-      edgeCache.push_back(rootEdges->second);
-    }
-    if (minDist == 0) {
-      AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
-               "The TransitivePath operation does not support a minimum "
-               "distance of 0 (use at least one instead).");
-    }
-
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      ad_utility::HashSet<Id>::const_iterator& pos = positions[stackIndex];
-      const ad_utility::HashSet<Id>* nodeEdges = edgeCache.back().get();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
-        continue;
-      }
-
-      size_t child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist) {
-          marks.insert(child);
-          if (rightIsVar || child == rightValue) {
-            size_t row = res.size();
-            res.emplace_back();
-            res(row, 0) = last_elem;
-            res(row, 1) = child;
-            for (size_t k = 2; k < resWidth + 1; k++) {
-              if (k - 2 < leftSideCol) {
-                res(row, k) = left(i, k - 2);
-              } else if (k - 2 > leftSideCol) {
-                res(row, k - 1) = left(i, k - 2);
-              }
-            }
-          }
-        }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second->begin());
-          edgeCache.push_back(it->second);
-        }
-      }
-    }
-
-    if (i + 1 < left.size()) {
-      // reset everything for the next iteration
-      marks.clear();
-    }
-
-    last_result_end = res.size();
-  }
+  const csrGraph::Graph graph{
+      sub.size(), [&sub, leftSubCol](size_t i) { return sub(i, leftSubCol); },
+      [&sub, rightSubCol](size_t i) { return sub(i, rightSubCol); }};
+  computePathsFromBoundSide(
+      &res, left, leftSideCol, true, resWidth,
+      makeGraphSearch(graph, minDist, maxDist, rightIsVar, rightValue));
 
   *dynRes = res.moveToDynamic();
 }
 
+// This instantiantion is needed by the unit tests
+template void TransitivePath::computeTransitivePathLeftBound<2, 2, 3>(
+    IdTable* res, const IdTable& sub, const IdTable& left, size_t leftSideCol,
+    bool rightIsVar, size_t leftSubCol, size_t rightSubCol, Id rightValue,
+    size_t minDist, size_t maxDist, size_t resWidth);
+
 // _____________________________________________________________________________
 template <int SUB_WIDTH, int LEFT_WIDTH, int RES_WIDTH>
 void TransitivePath::computeTransitivePathRightBound(
     IdTable* dynRes, const IdTable& dynSub, const IdTable& dynRight,
     size_t rightSideCol, bool leftIsVar, size_t leftSubCol, size_t rightSubCol,
     Id leftValue, size_t minDist, size_t maxDist, size_t resWidth) {
-  // Do the discovery from the right instead of the left.
-
-  using Map = ad_utility::HashMap<Id, std::shared_ptr<ad_utility::HashSet<Id>>>;
-  using MapIt = Map::iterator;
-
+  // Do the discovery from the right instead of the left, on the inverted
+  // edges.
+  throwIfMinDistIsZero(minDist);
   const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
   const IdTableView<LEFT_WIDTH> right = dynRight.asStaticView<LEFT_WIDTH>();
   IdTableStatic<RES_WIDTH> res = dynRes->moveToStatic<RES_WIDTH>();
 
-  // Used to map entries in the left column to entries they have connection with
-  Map edges;
-  auto checkTimeoutAfterNCalls = checkTimeoutAfterNCallsFactory();
-  auto checkTimeoutHashSet = [&checkTimeoutAfterNCalls]() {
-    checkTimeoutAfterNCalls(NUM_OPERATIONS_HASHSET_LOOKUP);
-  };
-
-  // initialize the map from the subresult
-  for (size_t i = 0; i < sub.size(); i++) {
-    checkTimeoutHashSet();
-    size_t l = sub(i, leftSubCol);
-    size_t r = sub(i, rightSubCol);
-    MapIt it = edges.find(r);
-    if (it == edges.end()) {
-      std::shared_ptr<ad_utility::HashSet<Id>> s =
-          std::make_shared<ad_utility::HashSet<Id>>();
-      s->insert(l);
-      edges[r] = s;
-    } else {
-      it->second->insert(l);
-    }
-  }
+  const csrGraph::Graph graph{
+      sub.size(), [&sub, rightSubCol](size_t i) { return sub(i, rightSubCol); },
+      [&sub, leftSubCol](size_t i) { return sub(i, leftSubCol); }};
+  computePathsFromBoundSide(
+      &res, right, rightSideCol, false, resWidth,
+      makeGraphSearch(graph, minDist, maxDist, leftIsVar, leftValue));
 
-  // For every node do a dfs on the graph
-
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSet<Id> marks;
-
-  // The stack used to store the dfs' progress
-  std::vector<ad_utility::HashSet<Id>::const_iterator> positions;
-
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<std::shared_ptr<const ad_utility::HashSet<Id>>> edgeCache;
-
-  size_t last_elem = std::numeric_limits<size_t>::max();
-  size_t last_result_begin = 0;
-  size_t last_result_end = 0;
-  for (size_t i = 0; i < right.size(); i++) {
-    checkTimeoutHashSet();
-    if (right[i][rightSideCol] == last_elem) {
-      // We can repeat the last output
-      size_t num_new = last_result_end - last_result_begin;
-      size_t res_row = res.size();
-      res.resize(res.size() + num_new);
-      for (size_t j = 0; j < num_new; j++) {
-        for (size_t c = 0; c < resWidth; c++) {
-          res(res_row + j, c) = res(last_result_begin + j, c);
-        }
-      }
-      checkTimeoutAfterNCalls(num_new * resWidth);
-      continue;
-    }
-    last_elem = right(i, rightSideCol);
-    last_result_begin = res.size();
-    MapIt rootEdges = edges.find(last_elem);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second->begin());
-      edgeCache.push_back(rootEdges->second);
-    }
-    if (minDist == 0) {
-      AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
-               "The TransitivePath operation does not support a minimum "
-               "distance of 0 (use at least one instead).");
-    }
+  *dynRes = res.moveToDynamic();
+}
 
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      ad_utility::HashSet<Id>::const_iterator& pos = positions[stackIndex];
-      const ad_utility::HashSet<Id>* nodeEdges = edgeCache.back().get();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
-        continue;
-      }
+// _____________________________________________________________________________
+template <int SIDE_WIDTH, int RES_WIDTH>
+void TransitivePath::computeTransitivePathBoundFromIndex(
+    IdTable* dynRes, const IdTable& dynSide, size_t sideCol, bool sideIsLeft,
+    bool targetIsVar, Id targetValue, const ReachabilityIndex& index,
+    bool subjectIsLeft, size_t resWidth) {
+  const IdTableView<SIDE_WIDTH> side = dynSide.asStaticView<SIDE_WIDTH>();
+  IdTableStatic<RES_WIDTH> res = dynRes->moveToStatic<RES_WIDTH>();
 
-      size_t child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist) {
-          marks.insert(child);
-          if (leftIsVar || child == leftValue) {
-            size_t row = res.size();
-            res.emplace_back();
-            res(row, 0) = child;
-            res(row, 1) = last_elem;
-            for (size_t k = 2; k < resWidth + 1; k++) {
-              if (k - 2 < rightSideCol) {
-                res(row, k) = right(i, k - 2);
-              } else if (k - 2 > rightSideCol) {
-                res(row, k - 1) = right(i, k - 2);
-              }
-            }
-          }
-        }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second->begin());
-          edgeCache.push_back(it->second);
-        }
-      }
+  // The paths from the bound side follow the edges forward iff they start at
+  // the subjects.
+  const bool isForward = sideIsLeft == subjectIsLeft;
+  auto search = [&](Id start, const auto& emit, auto& checkTimeout) {
+    if (targetIsVar) {
+      index.forEachReachable(start,
+                             isForward ? ReachabilityIndex::Direction::Forward
+                                       : ReachabilityIndex::Direction::Backward,
+                             [&](Id target) {
+                               checkTimeout();
+                               emit(target);
+                             });
+    } else if (isForward ? index.isReachable(start, targetValue)
+                         : index.isReachable(targetValue, start)) {
+      emit(targetValue);
     }
+  };
+  computePathsFromBoundSide(&res, side, sideCol, sideIsLeft, resWidth,
+                            [&search]() { return search; });
 
-    if (i + 1 < right.size()) {
-      // reset everything for the next iteration
-      marks.clear();
-    }
+  *dynRes = res.moveToDynamic();
+}
 
-    last_result_end = res.size();
+// _____________________________________________________________________________
+void TransitivePath::computeTransitivePathFromIndex(
+    IdTable* dynRes, const ReachabilityIndex& index, bool subjectIsLeft) {
+  IdTableStatic<2> res = dynRes->moveToStatic<2>();
+  auto checkTimeout = checkTimeoutAfterNCallsFactory();
+  const auto leftToRight = subjectIsLeft
+                               ? ReachabilityIndex::Direction::Forward
+                               : ReachabilityIndex::Direction::Backward;
+  const auto rightToLeft = subjectIsLeft
+                               ? ReachabilityIndex::Direction::Backward
+                               : ReachabilityIndex::Direction::Forward;
+  if (_leftIsVar && _rightIsVar) {
+    // The nodes are sorted, so is the result by its first column.
+    for (Id left : index.nodes()) {
+      index.forEachReachable(left, leftToRight, [&](Id right) {
+        checkTimeout();
+        res.push_back({left, right});
+      });
+    }
+  } else if (_leftIsVar) {
+    index.forEachReachable(_rightValue, rightToLeft, [&](Id left) {
+      checkTimeout();
+      res.push_back({left, _rightValue});
+    });
+  } else if (_rightIsVar) {
+    index.forEachReachable(_leftValue, leftToRight, [&](Id right) {
+      checkTimeout();
+      res.push_back({_leftValue, right});
+    });
   }
 
   *dynRes = res.moveToDynamic();
 }
 
 // _____________________________________________________________________________
-void TransitivePath::computeResult(ResultTable* result) {
-  LOG(DEBUG) << "TransitivePath result computation..." << std::endl;
-  shared_ptr<const ResultTable> subRes = _subtree->getResult();
-  LOG(DEBUG) << "TransitivePath subresult computation done." << std::endl;
+const ReachabilityIndex* TransitivePath::getReachabilityIndex(
+    bool* subjectIsLeft) const {
+  if (_executionContext == nullptr || _minDist != 1 ||
+      _maxDist != std::numeric_limits<size_t>::max()) {
+    return nullptr;
+  }
+  auto scan = std::dynamic_pointer_cast<IndexScan>(_subtree->getRootOperation());
+  if (scan == nullptr || (scan->getType() != IndexScan::PSO_FREE_S &&
+                          scan->getType() != IndexScan::POS_FREE_O)) {
+    return nullptr;
+  }
+  // The PSO scan has the subject in the first column, the POS scan in the
+  // second one.
+  const size_t subjectCol = scan->getType() == IndexScan::PSO_FREE_S ? 0 : 1;
+  *subjectIsLeft = _leftSubCol == subjectCol;
+  return getIndex().getReachabilityIndex(scan->getPredicate());
+}
 
+// _____________________________________________________________________________
+void TransitivePath::computeResult(ResultTable* result) {
   RuntimeInformation& runtimeInfo = getRuntimeInfo();
-  runtimeInfo.addChild(_subtree->getRootOperation()->getRuntimeInfo());
+  bool subjectIsLeft;
+  const ReachabilityIndex* reachabilityIndex =
+      getReachabilityIndex(&subjectIsLeft);
+  // With a reachability index, the result of the `_subtree` is not needed.
+  shared_ptr<const ResultTable> subRes;
+  if (reachabilityIndex == nullptr) {
+    LOG(DEBUG) << "TransitivePath result computation..." << std::endl;
+    subRes = _subtree->getResult();
+    LOG(DEBUG) << "TransitivePath subresult computation done." << std::endl;
+    runtimeInfo.addChild(_subtree->getRootOperation()->getRuntimeInfo());
+  } else {
+    LOG(DEBUG) << "TransitivePath result computation from the reachability "
+                  "index..."
+               << std::endl;
+    runtimeInfo.addDetail("reachability_index", true);
+  }
+  auto subResultType = [&subRes](size_t col) {
+    return subRes ? subRes->getResultType(col) : ResultTable::ResultType::KB;
+  };
 
   result->_sortedBy = resultSortedOn();
   if (_leftIsVar || _leftSideTree != nullptr) {
-    result->_resultTypes.push_back(subRes->getResultType(_leftSubCol));
+    result->_resultTypes.push_back(subResultType(_leftSubCol));
   } else {
     result->_resultTypes.push_back(ResultTable::ResultType::KB);
   }
   if (_rightIsVar || _rightSideTree != nullptr) {
-    result->_resultTypes.push_back(subRes->getResultType(_rightSubCol));
+    result->_resultTypes.push_back(subResultType(_rightSubCol));
   } else {
     result->_resultTypes.push_back(ResultTable::ResultType::KB);
   }
   result->_idTable.setCols(getResultWidth());
 
-  int subWidth = subRes->_idTable.cols();
+  int subWidth = subRes ? subRes->_idTable.cols() : 0;
   if (_leftSideTree != nullptr) {
     shared_ptr<const ResultTable> leftRes = _leftSideTree->getResult();
     for (size_t c = 0; c < leftRes->_idTable.cols(); c++) {
@@ -695,11 +622,19 @@ void TransitivePath::computeResult(ResultTable* result) {
     }
     runtimeInfo.addChild(_leftSideTree->getRootOperation()->getRuntimeInfo());
     int leftWidth = leftRes->_idTable.cols();
-    CALL_FIXED_SIZE_3(subWidth, leftWidth, _resultWidth,
-                      computeTransitivePathLeftBound, &result->_idTable,
-                      subRes->_idTable, leftRes->_idTable, _leftSideCol,
-                      _rightIsVar, _leftSubCol, _rightSubCol, _rightValue,
-                      _minDist, _maxDist, _resultWidth);
+    if (reachabilityIndex != nullptr) {
+      CALL_FIXED_SIZE_2(leftWidth, _resultWidth,
+                        computeTransitivePathBoundFromIndex, &result->_idTable,
+                        leftRes->_idTable, _leftSideCol, true, _rightIsVar,
+                        _rightValue, *reachabilityIndex, subjectIsLeft,
+                        _resultWidth);
+    } else {
+      CALL_FIXED_SIZE_3(subWidth, leftWidth, _resultWidth,
+                        computeTransitivePathLeftBound, &result->_idTable,
+                        subRes->_idTable, leftRes->_idTable, _leftSideCol,
+                        _rightIsVar, _leftSubCol, _rightSubCol, _rightValue,
+                        _minDist, _maxDist, _resultWidth);
+    }
   } else if (_rightSideTree != nullptr) {
     shared_ptr<const ResultTable> rightRes = _rightSideTree->getResult();
     for (size_t c = 0; c < rightRes->_idTable.cols(); c++) {
@@ -709,11 +644,22 @@ void TransitivePath::computeResult(ResultTable* result) {
     }
     runtimeInfo.addChild(_rightSideTree->getRootOperation()->getRuntimeInfo());
     int rightWidth = rightRes->_idTable.cols();
-    CALL_FIXED_SIZE_3(subWidth, rightWidth, _resultWidth,
-                      computeTransitivePathRightBound, &result->_idTable,
-                      subRes->_idTable, rightRes->_idTable, _rightSideCol,
-                      _leftIsVar, _leftSubCol, _rightSubCol, _leftValue,
-                      _minDist, _maxDist, _resultWidth);
+    if (reachabilityIndex != nullptr) {
+      CALL_FIXED_SIZE_2(rightWidth, _resultWidth,
+                        computeTransitivePathBoundFromIndex, &result->_idTable,
+                        rightRes->_idTable, _rightSideCol, false, _leftIsVar,
+                        _leftValue, *reachabilityIndex, subjectIsLeft,
+                        _resultWidth);
+    } else {
+      CALL_FIXED_SIZE_3(subWidth, rightWidth, _resultWidth,
+                        computeTransitivePathRightBound, &result->_idTable,
+                        subRes->_idTable, rightRes->_idTable, _rightSideCol,
+                        _leftIsVar, _leftSubCol, _rightSubCol, _leftValue,
+                        _minDist, _maxDist, _resultWidth);
+    }
+  } else if (reachabilityIndex != nullptr) {
+    computeTransitivePathFromIndex(&result->_idTable, *reachabilityIndex,
+                                   subjectIsLeft);
   } else {
     CALL_FIXED_SIZE_1(subWidth, computeTransitivePath, &result->_idTable,
                       subRes->_idTable, _leftIsVar, _rightIsVar, _leftSubCol,
@@ -111,6 +111,40 @@ class TransitivePath : public Operation {
  private:
   virtual void computeResult(ResultTable* result) override;
 
+  // The reachability index of the predicate of the `_subtree` if the paths
+  // can be read from it, else nullptr. This requires the `_subtree` to be a
+  // scan of a predicate with a reachability index and the paths to have any
+  // length of at least one. Without an execution context, there is no index.
+  // `subjectIsLeft` is set to whether the paths follow the edges from the
+  // subject to the object.
+  const ReachabilityIndex* getReachabilityIndex(bool* subjectIsLeft) const;
+
+  // Compute the paths that start at the values in column `sideCol` of the
+  // `side` table, which is the left side if `sideIsLeft`, else the right
+  // side. `makeSearch()` is called once per thread and must return a callable
+  // `search(start, emit, checkTimeout)` that calls `emit(target)` for the
+  // other end of each path from `start`.
+  template <int SIDE_WIDTH, int RES_WIDTH, typename MakeSearch>
+  void computePathsFromBoundSide(IdTableStatic<RES_WIDTH>* res,
+                                 const IdTableView<SIDE_WIDTH>& side,
+                                 size_t sideCol, bool sideIsLeft,
+                                 size_t resWidth, const MakeSearch& makeSearch);
+
+  // Like `computeTransitivePathLeftBound` and
+  // `computeTransitivePathRightBound`, but with the reachability `index`
+  // instead of the result of the `_subtree`.
+  template <int SIDE_WIDTH, int RES_WIDTH>
+  void computeTransitivePathBoundFromIndex(
+      IdTable* res, const IdTable& side, size_t sideCol, bool sideIsLeft,
+      bool targetIsVar, Id targetValue, const ReachabilityIndex& index,
+      bool subjectIsLeft, size_t resWidth);
+
+  // Like `computeTransitivePath`, but with the reachability `index` instead of
+  // the result of the `_subtree`.
+  void computeTransitivePathFromIndex(IdTable* res,
+                                      const ReachabilityIndex& index,
+                                      bool subjectIsLeft);
+
   // If this is not nullptr then the left side of all paths is within the result
   // of this tree.
   std::shared_ptr<QueryExecutionTree> _leftSideTree;
@@ -128,8 +128,10 @@ size_t Union::getCostEstimate() {
 
 void Union::computeResult(ResultTable* result) {
   LOG(DEBUG) << "Union result computation..." << std::endl;
-  shared_ptr<const ResultTable> subRes1 = _subtrees[0]->getResult();
-  shared_ptr<const ResultTable> subRes2 = _subtrees[1]->getResult();
+  const auto subResults =
+      computeChildrenConcurrently({_subtrees[0].get(), _subtrees[1].get()});
+  const shared_ptr<const ResultTable>& subRes1 = subResults[0];
+  const shared_ptr<const ResultTable>& subRes2 = subResults[1];
   LOG(DEBUG) << "Union subresult computation done." << std::endl;
 
   RuntimeInformation& runtimeInfo = getRuntimeInfo();
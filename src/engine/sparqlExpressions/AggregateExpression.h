@@ -8,6 +8,7 @@
 #ifndef QLEVER_AGGREGATEEXPRESSION_H
 #define QLEVER_AGGREGATEEXPRESSION_H
 
+#include "../../util/ArenaHashMap.h"
 #include "./SparqlExpressionGenerators.h"
 #include "SparqlExpression.h"
 namespace sparqlExpression {
@@ -134,9 +135,12 @@ class AggregateExpression : public SparqlExpression {
       using ResultType = std::decay_t<decltype(aggregateOperation._function(
           std::move(valueGetter(*it, context)), valueGetter(*it, context)))>;
       ResultType result = valueGetter(*it, context);
-      ad_utility::HashSetWithMemoryLimit<typename decltype(
-          operands)::value_type>
-          uniqueHashSet({*it}, inputSize, context->_allocator);
+      // The hash set is built anew for each group of a GROUP BY, take its
+      // memory from the arena of the query.
+      using ValueType = typename decltype(operands)::value_type;
+      ad_utility::ArenaHashSet<ValueType> uniqueHashSet(
+          {*it}, inputSize,
+          ad_utility::ArenaAllocator<ValueType>{context->_qec.getArena()});
       for (++it; it != operands.end(); ++it) {
         if (uniqueHashSet.insert(*it).second) {
           result = aggregateOperation._function(
@@ -9,6 +9,7 @@
 #define QLEVER_SPARQLEXPRESSIONGENERATORS_H
 
 #include "../../util/Generator.h"
+#include "../ColumnKernels.h"
 #include "./SparqlExpression.h"
 
 namespace sparqlExpression::detail {
@@ -35,10 +36,14 @@ void getIdsFromVariableImpl(VectorWithMemoryLimit<StrongId>& result,
   const size_t columnIndex =
       context->_variableToColumnAndResultTypeMap.at(variable._variable).first;
 
-  result.reserve(endIndex - endIndex);
-  for (size_t i = beginIndex; i < endIndex; ++i) {
-    result.push_back(StrongId{inputTable(i, columnIndex)});
-  }
+  // A `StrongId` is only a wrapper of an `Id`, so the column can be copied
+  // directly into the result.
+  static_assert(sizeof(StrongId) == sizeof(Id) &&
+                std::is_standard_layout_v<StrongId>);
+  const auto column = columnKernels::getColumn(inputTable, columnIndex);
+  result.resize(endIndex - beginIndex);
+  columnKernels::copyColumn(column, beginIndex, endIndex,
+                            reinterpret_cast<Id*>(result.data()));
 }
 
 /// Convert a variable to a vector of all the Ids it is bound to in the
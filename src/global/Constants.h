@@ -14,7 +14,14 @@ static const size_t STXXL_DISK_SIZE_INDEX_TEST = 10;
 
 static constexpr size_t DEFAULT_MEM_FOR_QUERIES_IN_GB = 4;
 
+// The maximal number of results that wait to be written to the disk cache.
+// Each of them is kept in memory until it is written.
+static const size_t DISK_CACHE_MAX_PENDING_WRITES = 4;
+
 static const size_t MAX_NOF_ROWS_IN_RESULT = 100000;
+// The number of rows of a record batch of the Arrow export. Each batch is
+// preceded by the values that are new in the dictionaries of its columns.
+static const size_t ARROW_BATCH_SIZE = 64 * 1024;
 static const size_t MIN_WORD_PREFIX_SIZE = 4;
 static const char PREFIX_CHAR = '*';
 static const size_t MAX_NOF_NODES = 64;
@@ -112,16 +119,90 @@ static constexpr size_t PERCENTAGE_OF_TRIPLES_FOR_SORT_ESTIMATE = 5;
 // times this factor.
 static constexpr double MAKE_ROOM_SLACK_FACTOR = 2;
 
+// A join passes the distinct values of the join column of its smaller side as
+// a semi-join filter to the larger side only if the smaller side has at most
+// this many rows and the larger side is expected to be at least
+// MIN_SIZE_RATIO_FOR_SEMI_JOIN_FILTER times as large.
+static constexpr size_t MAX_SEMI_JOIN_FILTER_SIZE = 1'000'000;
+static constexpr size_t MIN_SIZE_RATIO_FOR_SEMI_JOIN_FILTER = 10;
+
+// The size of the blocks of memory that the arena of a query (see
+// `QueryExecutionContext::getArena`) takes from the memory of the query.
+static constexpr size_t QUERY_ARENA_BLOCK_SIZE = 1ul << 20;
+
+// A query that waits for its estimated memory (see `AdmissionController`) is
+// overtaken by at most this many later queries that fit into the free memory.
+static constexpr size_t ADMISSION_MAX_NUM_OVERTAKES = 16;
+
+// The maximal number of query templates for which the server keeps the parsed
+// query and the join orders, see `QueryPlanCache`.
+static constexpr size_t QUERY_PLAN_CACHE_MAX_NUM_ENTRIES = 1000;
+
+// The maximal number of results that the server keeps for paging through them
+// with a cursor. When a further cursor is created, the least recently used
+// one is closed. Cursors are also closed when they were not used for
+// `cursor-idle-timeout-s` seconds.
+static constexpr size_t MAX_NUM_OPEN_CURSORS = 100;
+
+// The runs of an external sort are compressed and read in blocks of this size
+// (uncompressed), see `ExternalSort.h`.
+static constexpr size_t SPILL_BLOCK_SIZE_IN_BYTES = 1 << 20;
+
+// The TransitivePath operation searches the paths from different start nodes
+// concurrently only if each thread gets at least this many start nodes.
+static constexpr size_t MIN_ROWS_PER_THREAD_FOR_TRANSITIVE_PATH = 1000;
+
 inline auto& RuntimeParameters() {
   using ad_utility::detail::parameterShortNames::Double;
   using ad_utility::detail::parameterShortNames::SizeT;
+  using ad_utility::detail::parameterShortNames::String;
   static ad_utility::Parameters params{
       // If the time estimate for a sort operation is larger by more than this
       // factor than the remaining time, then the sort is canceled with a
       // timeout exception.
       Double<"sort-estimate-cancellation-factor">{3.0},
       SizeT<"cache-max-num-entries">{1000}, SizeT<"cache-max-size-gb">{30},
-      SizeT<"cache-max-size-gb-single-entry">{5}};
+      SizeT<"cache-max-size-gb-single-entry">{5},
+      // Results that took at least this long to compute are also written to
+      // the cache on disk (if there is one). Pinned results always are.
+      SizeT<"cache-disk-min-compute-time-ms">{1000},
+      // Merge joins of large inputs are split into at most this many
+      // partitions that are joined concurrently. Each partition contains at
+      // least `join-min-rows-per-thread` rows (summed over both inputs).
+      SizeT<"join-num-threads">{8},
+      SizeT<"join-min-rows-per-thread">{1'000'000},
+      // In the adaptive mode of the query planner, the remaining joins are
+      // planned again when the actual size of a computed subtree is larger or
+      // smaller than its estimate by more than this factor.
+      Double<"adaptive-reoptimization-factor">{100.0},
+      // Sets of commutative joins with more operations than this are planned
+      // with iterative dynamic programming: the dp table is only filled up to
+      // the plans that join this many operations, the cheapest of them is
+      // fixed and the remaining joins are planned again.
+      SizeT<"query-planner-idp-block-size">{12},
+      // Once the planning of a query took longer than this, the dp tables are
+      // filled only up to the current row (see above).
+      SizeT<"query-planner-time-budget-ms">{1000},
+      // The maximal number of threads that search the paths of a
+      // TransitivePath operation from different start nodes.
+      SizeT<"transitive-path-num-threads">{8},
+      // Sorts whose input cannot be copied within the memory limit are done
+      // externally, with sorted runs of at most this size (less if the
+      // memory that is left doesn't suffice) in this directory (the
+      // temporary directory of the system if empty).
+      String<"spill-directory">{""}, SizeT<"spill-run-size-mb">{256},
+      // The memory that a single query can allocate, 0 means the complete
+      // `memory-max-size-gb` of the server.
+      SizeT<"query-max-memory-gb">{0},
+      // Queries wait at most this long until their estimated memory is free,
+      // then they are rejected.
+      SizeT<"query-max-queue-wait-ms">{60'000},
+      // Queries whose plan has at most this cost estimate are interactive
+      // unless their priority is specified (see `QueryScheduler`).
+      SizeT<"query-interactive-max-cost">{1'000'000},
+      // Cursors that were not used for this long are closed, which frees the
+      // memory of their results.
+      SizeT<"cursor-idle-timeout-s">{600}};
   return params;
 }
 
@@ -5,6 +5,7 @@
 #include "CompressedRelation.h"
 
 #include "../engine/IdTable.h"
+#include "../engine/SemiJoinFilter.h"
 #include "../util/Cache.h"
 #include "../util/CompressionUsingZstd/ZstdWrapper.h"
 #include "../util/ConcurrentCache.h"
@@ -28,8 +29,9 @@ auto& globalBlockCache() {
 
 // ____________________________________________________________________________
 template <class Permutation, typename IdTableImpl>
-void CompressedRelationMetaData::scan(
+size_t CompressedRelationMetaData::scanImpl(
     Id col0Id, IdTableImpl* result, const Permutation& permutation,
+    const SemiJoinFilter* filter,
     ad_utility::SharedConcurrentTimeoutTimer timer) {
   if (!permutation._isLoaded) {
     throw std::runtime_error("This query requires the permutation " +
@@ -39,121 +41,161 @@ void CompressedRelationMetaData::scan(
   if constexpr (!ad_utility::isVector<IdTableImpl>) {
     AD_CHECK(result->cols() == 2);
   }
-  if (permutation._meta.col0IdExists(col0Id)) {
-    const auto& metaData = permutation._meta.getMetaData(col0Id);
-
-    // get all the blocks where _col0FirstId <= col0Id <= _col0LastId
-    struct KeyLhs {
-      size_t _col0FirstId;
-      size_t _col0LastId;
-    };
-    auto [beginBlock, endBlock] = std::equal_range(
-        permutation._meta.blockData().begin(),
-        permutation._meta.blockData().end(), KeyLhs{col0Id, col0Id},
-        [](const auto& a, const auto& b) {
-          return a._col0FirstId < b._col0FirstId &&
-                 a._col0LastId < b._col0LastId;
-        });
+  if (!permutation._meta.col0IdExists(col0Id)) {
+    return 0;
+  }
+  const auto& metaData = permutation._meta.getMetaData(col0Id);
+
+  // get all the blocks where _col0FirstId <= col0Id <= _col0LastId
+  struct KeyLhs {
+    size_t _col0FirstId;
+    size_t _col0LastId;
+  };
+  auto [beginBlock, endBlock] = std::equal_range(
+      permutation._meta.blockData().begin(),
+      permutation._meta.blockData().end(), KeyLhs{col0Id, col0Id},
+      [](const auto& a, const auto& b) {
+        return a._col0FirstId < b._col0FirstId &&
+               a._col0LastId < b._col0LastId;
+      });
+
+  // The first block might contain entries that are not part of our
+  // actual scan result.
+  bool firstBlockIsIncomplete =
+      beginBlock < endBlock &&
+      (beginBlock->_col0FirstId < col0Id || beginBlock->_col0LastId > col0Id);
+  auto lastBlock = endBlock - 1;
+
+  bool lastBlockIsIncomplete =
+      beginBlock < lastBlock &&
+      (lastBlock->_col0FirstId < col0Id || lastBlock->_col0LastId > col0Id);
+
+  // Invariant: A relation spans multiple blocks exclusively or several
+  // entities are stored completely in the same Block.
+  AD_CHECK(!firstBlockIsIncomplete || (beginBlock == lastBlock));
+  AD_CHECK(!lastBlockIsIncomplete);
+  if (firstBlockIsIncomplete) {
+    AD_CHECK(metaData._offsetInBlock != Id(-1));
+  }
 
-    // The total size of the result is now known.
+  // Without a filter, the total size of the result is known and the blocks
+  // are decompressed directly to their position in the result. With a filter,
+  // the rows of each block that pass the filter are collected first and
+  // copied to the result in the end.
+  using Rows = std::vector<std::array<Id, 2>>;
+  std::vector<Rows> filteredBlocks;
+  std::array<Id, 2>* position = nullptr;
+  if (!filter) {
     result->resize(metaData.getNofElements());
+    position = reinterpret_cast<std::array<Id, 2>*>(result->data());
+  }
 
-    // The position in the result, to which the next block is being
-    // decompressed.
-    auto* position = reinterpret_cast<std::array<Id, 2>*>(result->data());
-
-    // The number of Id Pairs for which we still have space
-    // in the result (only needed for checking of invariants).
-    size_t spaceLeft = result->size();
-
-    // The first block might contain entries that are not part of our
-    // actual scan result.
-    bool firstBlockIsIncomplete =
-        beginBlock < endBlock &&
-        (beginBlock->_col0FirstId < col0Id || beginBlock->_col0LastId > col0Id);
-    auto lastBlock = endBlock - 1;
-
-    bool lastBlockIsIncomplete =
-        beginBlock < lastBlock &&
-        (lastBlock->_col0FirstId < col0Id || lastBlock->_col0LastId > col0Id);
-
-    // Invariant: A relation spans multiple blocks exclusively or several
-    // entities are stored completely in the same Block.
-    AD_CHECK(!firstBlockIsIncomplete || (beginBlock == lastBlock));
-    AD_CHECK(!lastBlockIsIncomplete);
-    if (firstBlockIsIncomplete) {
-      AD_CHECK(metaData._offsetInBlock != Id(-1));
+  // The only incomplete block also contains other relations, so its
+  // `_col1FirstId` and `_col1LastId` don't refer to this relation. It is
+  // small and cached, just copy (or filter) the part that belongs to the
+  // relation.
+  if (firstBlockIsIncomplete) {
+    const auto& block = *beginBlock;
+    auto cacheKey =
+        permutation._readableName + std::to_string(block._offsetInFile);
+    auto uncompressedBuffer =
+        globalBlockCache()
+            .computeOnce(
+                cacheKey,
+                [&]() { return readAndDecompressBlock(block, permutation); })
+            ._resultPointer;
+    const auto* begin = uncompressedBuffer->data() + metaData._offsetInBlock;
+    const auto* end = begin + metaData._numRows;
+    if (filter) {
+      filter->filterSortedRows(begin, end, &filteredBlocks.emplace_back());
+    } else {
+      position = std::copy(begin, end, position);
     }
+    ++beginBlock;
+  }
 
-    // We have at most one block that is incomplete and thus requires trimming.
-    // Set up a lambda, that reads this block and decompresses it to
-    // the result.
-    auto readIncompleteBlock = [&](const auto& block) {
-      auto cacheKey =
-          permutation._readableName + std::to_string(block._offsetInFile);
-
-      auto uncompressedBuffer =
-          globalBlockCache()
-              .computeOnce(
-                  cacheKey,
-                  [&]() { return readAndDecompressBlock(block, permutation); })
-              ._resultPointer;
-
-      // Extract the part of the block that actually belongs to the relation
-      auto begin = uncompressedBuffer->begin() + metaData._offsetInBlock;
-      auto end = begin + metaData._numRows;
-      AD_CHECK(static_cast<size_t>(end - begin) <= spaceLeft);
-      std::copy(begin, end, position);
-      position += (end - begin);
-      spaceLeft -= (end - begin);
-    };
-
-    // Read the first block if it is incomplete
-    if (firstBlockIsIncomplete) {
-      readIncompleteBlock(*beginBlock);
-      ++beginBlock;
-      if (timer) {
-        timer->wlock()->checkTimeoutAndThrow("IndexScan :");
-      }
+  // All the other blocks belong to the relation exclusively. With a filter,
+  // only read the blocks that contain one of its values.
+  std::vector<const CompressedBlockMetaData*> blocksToRead;
+  size_t numSkippedBlocks = 0;
+  for (auto it = beginBlock; it < endBlock; ++it) {
+    if (!filter || filter->containsValueInRange(it->_col1FirstId,
+                                                it->_col1LastId)) {
+      blocksToRead.push_back(&(*it));
+    } else {
+      ++numSkippedBlocks;
     }
+  }
+  const size_t firstFilteredBlock = filteredBlocks.size();
+  if (filter) {
+    filteredBlocks.resize(firstFilteredBlock + blocksToRead.size());
+  }
 
-    // Read all the other (complete!) blocks in parallel
-    if (beginBlock < endBlock) {
+  // Read the blocks serially and decompress them in parallel.
+  if (!blocksToRead.empty()) {
 #pragma omp parallel
 #pragma omp single
-      {
-        for (; beginBlock < endBlock; ++beginBlock) {
-          const auto& block = *beginBlock;
-          // Read a block from disk (serially).
-          std::vector<char> compressedBuffer =
-              readCompressedBlockFromFile(block, permutation);
-
-          // This lambda decompresses the block that was just read to the
-          // correct position in the result.
-          auto decompressLambda = [position, &block,
-                                   compressedBuffer =
-                                       std::move(compressedBuffer)]() {
-            ad_utility::TimeBlockAndLog("Decompressing a block");
-            decompressBlock(compressedBuffer, block._numRows, position);
-          };
-
-          // The `decompressLambda` can now run in parallel
+    for (size_t i = 0; i < blocksToRead.size(); ++i) {
+      const auto& block = *blocksToRead[i];
+      std::vector<char> compressedBuffer =
+          readCompressedBlockFromFile(block, permutation);
+      auto* filteredRows =
+          filter ? &filteredBlocks[firstFilteredBlock + i] : nullptr;
+
+      auto decompressLambda = [&block, filter, position, filteredRows,
+                               compressedBuffer =
+                                   std::move(compressedBuffer)]() {
+        ad_utility::TimeBlockAndLog("Decompressing a block");
+        if (!filter) {
+          decompressBlock(compressedBuffer, block._numRows, position);
+          return;
+        }
+        Rows uncompressedBuffer =
+            decompressBlock(compressedBuffer, block._numRows);
+        filter->filterSortedRows(
+            uncompressedBuffer.data(),
+            uncompressedBuffer.data() + uncompressedBuffer.size(),
+            filteredRows);
+      };
 #pragma omp task
-          {
-            if (!timer || !timer->wlock()->hasTimedOut()) {
-              decompressLambda();
-            };
-          }
-
-          // this is again serial code, set up the correct pointers
-          // for the next block;
-          spaceLeft -= block._numRows;
-          position += block._numRows;
+      {
+        if (!timer || !timer->wlock()->hasTimedOut()) {
+          decompressLambda();
         }
-        AD_CHECK(spaceLeft == 0);
-      }  // End of omp parallel region, all the decompression was handled now.
+      }
+      if (!filter) {
+        position += block._numRows;
+      }
     }
   }
+  if (timer) {
+    timer->wlock()->checkTimeoutAndThrow("IndexScan :");
+  }
+
+  if (!filter) {
+    const auto* resultEnd =
+        reinterpret_cast<std::array<Id, 2>*>(result->data()) + result->size();
+    AD_CHECK(position == resultEnd);
+    return 0;
+  }
+  size_t totalResultSize = 0;
+  for (const auto& rows : filteredBlocks) {
+    totalResultSize += rows.size();
+  }
+  result->resize(totalResultSize);
+  position = reinterpret_cast<std::array<Id, 2>*>(result->data());
+  for (const auto& rows : filteredBlocks) {
+    position = std::copy(rows.begin(), rows.end(), position);
+  }
+  return numSkippedBlocks;
+}
+
+// ____________________________________________________________________________
+template <class Permutation, typename IdTableImpl>
+void CompressedRelationMetaData::scan(
+    Id col0Id, IdTableImpl* result, const Permutation& permutation,
+    ad_utility::SharedConcurrentTimeoutTimer timer) {
+  scanImpl(col0Id, result, permutation, nullptr, std::move(timer));
 }
 
 using V = std::vector<std::array<Id, 2>>;
@@ -196,6 +238,35 @@ template void CompressedRelationMetaData::scan<Permutation::OSP_T, V>(
     Id key, V* result, const Permutation::OSP_T& p,
     ad_utility::SharedConcurrentTimeoutTimer timer);
 
+// ____________________________________________________________________________
+template <class Permutation, typename IdTableImpl>
+size_t CompressedRelationMetaData::scan(
+    Id col0Id, IdTableImpl* result, const Permutation& permutation,
+    const SemiJoinFilter& filter,
+    ad_utility::SharedConcurrentTimeoutTimer timer) {
+  return scanImpl(col0Id, result, permutation, &filter, std::move(timer));
+}
+
+// Explicit instantiations for all six permutations
+template size_t CompressedRelationMetaData::scan<Permutation::POS_T, IdTable>(
+    Id, IdTable*, const Permutation::POS_T&, const SemiJoinFilter&,
+    ad_utility::SharedConcurrentTimeoutTimer);
+template size_t CompressedRelationMetaData::scan<Permutation::PSO_T, IdTable>(
+    Id, IdTable*, const Permutation::PSO_T&, const SemiJoinFilter&,
+    ad_utility::SharedConcurrentTimeoutTimer);
+template size_t CompressedRelationMetaData::scan<Permutation::SPO_T, IdTable>(
+    Id, IdTable*, const Permutation::SPO_T&, const SemiJoinFilter&,
+    ad_utility::SharedConcurrentTimeoutTimer);
+template size_t CompressedRelationMetaData::scan<Permutation::SOP_T, IdTable>(
+    Id, IdTable*, const Permutation::SOP_T&, const SemiJoinFilter&,
+    ad_utility::SharedConcurrentTimeoutTimer);
+template size_t CompressedRelationMetaData::scan<Permutation::OPS_T, IdTable>(
+    Id, IdTable*, const Permutation::OPS_T&, const SemiJoinFilter&,
+    ad_utility::SharedConcurrentTimeoutTimer);
+template size_t CompressedRelationMetaData::scan<Permutation::OSP_T, IdTable>(
+    Id, IdTable*, const Permutation::OSP_T&, const SemiJoinFilter&,
+    ad_utility::SharedConcurrentTimeoutTimer);
+
 // _____________________________________________________________________________
 template <class Permutation, typename IdTableImpl>
 void CompressedRelationMetaData::scan(
@@ -15,6 +15,9 @@
 #include "../util/Serializer/Serializer.h"
 #include "../util/Timer.h"
 
+// Forward declaration, the filter is only needed for the implementation.
+class SemiJoinFilter;
+
 // The meta data of a compressed block of ID triples in an index permutation.
 struct CompressedBlockMetaData {
   off_t _offsetInFile;
@@ -120,7 +123,30 @@ struct CompressedRelationMetaData {
                    const PermutationInfo& permutation,
                    ad_utility::SharedConcurrentTimeoutTimer timer = nullptr);
 
+  /**
+   * @brief For a permutation XYZ, retrieve all YZ for a given X, but only
+   * those whose Y is contained in the `filter`. Blocks that contain no Y from
+   * the `filter` (according to their `_col1FirstId` and `_col1LastId`) are not
+   * read at all, the rows of the other blocks are filtered before they are
+   * written to the result.
+   *
+   * @return The number of blocks that were skipped.
+   */
+  template <class Permutation, typename IdTableImpl>
+  static size_t scan(Id col0Id, IdTableImpl* result,
+                     const Permutation& permutation,
+                     const SemiJoinFilter& filter,
+                     ad_utility::SharedConcurrentTimeoutTimer timer = nullptr);
+
  private:
+  // The implementation of both `scan`s for a complete relation, `filter` is
+  // nullptr for the unfiltered scan.
+  template <class Permutation, typename IdTableImpl>
+  static size_t scanImpl(Id col0Id, IdTableImpl* result,
+                         const Permutation& permutation,
+                         const SemiJoinFilter* filter,
+                         ad_utility::SharedConcurrentTimeoutTimer timer);
+
   // Some helper functions for reading and decompressing blocks.
 
   template <class Permutation>
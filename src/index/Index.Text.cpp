@@ -661,8 +661,19 @@ std::string_view Index::wordIdToString(Id id) const {
 }
 
 // _____________________________________________________________________________
-void Index::getContextListForWords(const string& words,
-                                   IdTable* dynResult) const {
+namespace {
+// Throw if the `timer` (if any) has timed out or was cancelled.
+void checkTextTimeout(const ad_utility::SharedConcurrentTimeoutTimer& timer) {
+  if (timer) {
+    timer->wlock()->checkTimeoutAndThrow("Text retrieval: ");
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void Index::getContextListForWords(
+    const string& words, IdTable* dynResult,
+    ad_utility::SharedConcurrentTimeoutTimer timer) const {
   LOG(DEBUG) << "In getContextListForWords...\n";
   // TODO vector can be of type std::string_view if called functions
   //  are updated to accept std::string_view instead of const std::string&
@@ -678,6 +689,7 @@ void Index::getContextListForWords(const string& words,
       cidVecs.emplace_back();
       scoreVecs.emplace_back();
       getWordPostingsForTerm(term, cidVecs.back(), scoreVecs.back());
+      checkTextTimeout(timer);
     }
     if (cidVecs.size() == 2) {
       FTSAlgorithms::intersectTwoPostingLists(
@@ -690,6 +702,7 @@ void Index::getContextListForWords(const string& words,
   } else {
     getWordPostingsForTerm(terms[0], cids, scores);
   }
+  checkTextTimeout(timer);
 
   LOG(DEBUG) << "Packing lists into a ResultTable\n...";
   IdTableStatic<2> result = dynResult->moveToStatic<2>();
@@ -768,10 +781,10 @@ void Index::getWordPostingsForTerm(const string& term, vector<Id>& cids,
 }
 
 // _____________________________________________________________________________
-void Index::getContextEntityScoreListsForWords(const string& words,
-                                               vector<Id>& cids,
-                                               vector<Id>& eids,
-                                               vector<Score>& scores) const {
+void Index::getContextEntityScoreListsForWords(
+    const string& words, vector<Id>& cids, vector<Id>& eids,
+    vector<Score>& scores,
+    const ad_utility::SharedConcurrentTimeoutTimer& timer) const {
   LOG(DEBUG) << "In getEntityContextScoreListsForWords...\n";
   // TODO vector can be of type std::string_view if called functions
   //  are updated to accept std::string_view instead of const std::string&
@@ -798,6 +811,7 @@ void Index::getContextEntityScoreListsForWords(const string& words,
       size_t onlyWordsFrom = 1 - useElFromTerm;
       getWordPostingsForTerm(terms[onlyWordsFrom], wCids, wScores);
       getEntityPostingsForTerm(terms[useElFromTerm], eCids, eWids, eScores);
+      checkTextTimeout(timer);
       FTSAlgorithms::intersect(wCids, eCids, eWids, eScores, cids, eids,
                                scores);
     } else {
@@ -810,6 +824,7 @@ void Index::getContextEntityScoreListsForWords(const string& words,
           cidVecs.push_back(vector<Id>());
           scoreVecs.push_back(vector<Score>());
           getWordPostingsForTerm(terms[i], cidVecs.back(), scoreVecs.back());
+          checkTextTimeout(timer);
         }
       }
       cidVecs.push_back(vector<Id>());
@@ -817,6 +832,7 @@ void Index::getContextEntityScoreListsForWords(const string& words,
       vector<Id> eWids;
       getEntityPostingsForTerm(terms[useElFromTerm], cidVecs.back(), eWids,
                                scoreVecs.back());
+      checkTextTimeout(timer);
       FTSAlgorithms::intersectKWay(cidVecs, scoreVecs, &eWids, cids, eids,
                                    scores);
     }
@@ -824,18 +840,20 @@ void Index::getContextEntityScoreListsForWords(const string& words,
     // Special case: Just one word to deal with.
     getEntityPostingsForTerm(terms[0], cids, eids, scores);
   }
+  checkTextTimeout(timer);
   LOG(DEBUG) << "Done with getEntityContextScoreListsForWords. "
              << "Got " << cids.size() << " elements. \n";
 }
 
 // _____________________________________________________________________________
-void Index::getECListForWordsOneVar(const string& words, size_t limit,
-                                    IdTable* result) const {
+void Index::getECListForWordsOneVar(
+    const string& words, size_t limit, IdTable* result,
+    ad_utility::SharedConcurrentTimeoutTimer timer) const {
   LOG(DEBUG) << "In getECListForWords...\n";
   vector<Id> cids;
   vector<Id> eids;
   vector<Score> scores;
-  getContextEntityScoreListsForWords(words, cids, eids, scores);
+  getContextEntityScoreListsForWords(words, cids, eids, scores, timer);
   FTSAlgorithms::aggScoresAndTakeTopKContexts(cids, eids, scores, limit,
                                               result);
   LOG(DEBUG) << "Done with getECListForWords. Result size: " << result->size()
@@ -843,13 +861,14 @@ void Index::getECListForWordsOneVar(const string& words, size_t limit,
 }
 
 // _____________________________________________________________________________
-void Index::getECListForWords(const string& words, size_t nofVars, size_t limit,
-                              IdTable* result) const {
+void Index::getECListForWords(
+    const string& words, size_t nofVars, size_t limit, IdTable* result,
+    ad_utility::SharedConcurrentTimeoutTimer timer) const {
   LOG(DEBUG) << "In getECListForWords...\n";
   vector<Id> cids;
   vector<Id> eids;
   vector<Score> scores;
-  getContextEntityScoreListsForWords(words, cids, eids, scores);
+  getContextEntityScoreListsForWords(words, cids, eids, scores, timer);
   int width = result->cols();
   CALL_FIXED_SIZE_1(width, FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts,
                     cids, eids, scores, nofVars, limit, result);
@@ -858,10 +877,10 @@ void Index::getECListForWords(const string& words, size_t nofVars, size_t limit,
 }
 
 // _____________________________________________________________________________
-void Index::getFilteredECListForWords(const string& words,
-                                      const IdTable& filter,
-                                      size_t filterColumn, size_t nofVars,
-                                      size_t limit, IdTable* result) const {
+void Index::getFilteredECListForWords(
+    const string& words, const IdTable& filter, size_t filterColumn,
+    size_t nofVars, size_t limit, IdTable* result,
+    ad_utility::SharedConcurrentTimeoutTimer timer) const {
   LOG(DEBUG) << "In getFilteredECListForWords...\n";
   if (filter.size() > 0) {
     // Build a map filterEid->set<Rows>
@@ -878,10 +897,11 @@ void Index::getFilteredECListForWords(const string& words,
       }
       it->second.push_back(filter, i);
     }
+    checkTextTimeout(timer);
     vector<Id> cids;
     vector<Id> eids;
     vector<Score> scores;
-    getContextEntityScoreListsForWords(words, cids, eids, scores);
+    getContextEntityScoreListsForWords(words, cids, eids, scores, timer);
     int width = result->cols();
     if (nofVars == 1) {
       CALL_FIXED_SIZE_1(width,
@@ -898,10 +918,9 @@ void Index::getFilteredECListForWords(const string& words,
 }
 
 // _____________________________________________________________________________
-void Index::getFilteredECListForWordsWidthOne(const string& words,
-                                              const IdTable& filter,
-                                              size_t nofVars, size_t limit,
-                                              IdTable* result) const {
+void Index::getFilteredECListForWordsWidthOne(
+    const string& words, const IdTable& filter, size_t nofVars, size_t limit,
+    IdTable* result, ad_utility::SharedConcurrentTimeoutTimer timer) const {
   LOG(DEBUG) << "In getFilteredECListForWords...\n";
   // Build a map filterEid->set<Rows>
   using FilterSet = ad_utility::HashSet<Id>;
@@ -910,10 +929,11 @@ void Index::getFilteredECListForWordsWidthOne(const string& words,
   for (size_t i = 0; i < filter.size(); ++i) {
     fSet.insert(filter(i, 0));
   }
+  checkTextTimeout(timer);
   vector<Id> cids;
   vector<Id> eids;
   vector<Score> scores;
-  getContextEntityScoreListsForWords(words, cids, eids, scores);
+  getContextEntityScoreListsForWords(words, cids, eids, scores, timer);
   int width = result->cols();
   if (nofVars == 1) {
     FTSAlgorithms::oneVarFilterAggScoresAndTakeTopKContexts(
@@ -20,6 +20,7 @@
 #include "../util/Conversions.h"
 #include "../util/HashMap.h"
 #include "../util/Serializer/FileSerializer.h"
+#include "../util/Serializer/SerializeHashMap.h"
 #include "../util/TupleHelpers.h"
 #include "./PrefixHeuristic.h"
 #include "./VocabularyGenerator.h"
@@ -153,6 +154,10 @@ void Index::createFromFile(const string& filename) {
   }
   LOG(INFO) << "Finished writing permutations" << std::endl;
 
+  if (!_reachabilityIndexPredicates.empty()) {
+    createReachabilityIndices();
+  }
+
   // Dump the configuration again in case the permutations have added some
   // information.
   writeConfiguration();
@@ -614,6 +619,52 @@ void Index::addPatternsToExistingIndex() {
       _maxNumPatterns, langPredLowerBound, langPredUpperBound, _SPO);
 }
 
+// _____________________________________________________________________________
+void Index::createReachabilityIndices() {
+  // The vocabulary and the PSO permutation are only on disk at this point of
+  // the index build.
+  if (!_PSO._isLoaded) {
+    _vocab.readFromFile(_onDiskBase + ".vocabulary",
+                        _onDiskLiterals ? _onDiskBase + ".literals-index" : "");
+    _PSO.loadFromDisk(_onDiskBase);
+  }
+  _reachabilityIndices.clear();
+  for (const auto& predicate : _reachabilityIndexPredicates) {
+    Id predicateId;
+    if (!_vocab.getId(predicate, &predicateId)) {
+      LOG(WARN) << "The predicate " << predicate
+                << " for a reachability index does not occur in the input, "
+                   "skipping it"
+                << std::endl;
+      continue;
+    }
+    LOG(INFO) << "Building the reachability index for " << predicate << " ..."
+              << std::endl;
+    std::vector<array<Id, 2>> edges;
+    CompressedRelationMetaData::scan(predicateId, &edges, _PSO);
+    ReachabilityIndex index{edges};
+    LOG(INFO) << "Number of nodes: " << index.nodes().size()
+              << ", number of edges: " << edges.size()
+              << ", number of intervals: " << index.numIntervals()
+              << std::endl;
+    _reachabilityIndices[predicateId] = std::move(index);
+  }
+  ad_utility::serialization::FileWriteSerializer writer{_onDiskBase +
+                                                        ".index.reachability"};
+  writer << _reachabilityIndices;
+}
+
+// _____________________________________________________________________________
+const ReachabilityIndex* Index::getReachabilityIndex(
+    const string& predicate) const {
+  Id predicateId;
+  if (!_vocab.getId(predicate, &predicateId)) {
+    return nullptr;
+  }
+  auto it = _reachabilityIndices.find(predicateId);
+  return it != _reachabilityIndices.end() ? &it->second : nullptr;
+}
+
 // _____________________________________________________________________________
 void Index::createPatterns(bool isSortedSPO, VocabularyData* vocabData) {
   // The first argument means that the triples are not yet sorted according
@@ -1068,6 +1119,15 @@ void Index::createFromOnDiskIndex(const string& onDiskBase) {
       _hasPredicate.build(hasPredicateTmp);
     }
   }
+
+  if (!_reachabilityIndexPredicates.empty()) {
+    std::string reachabilityFilePath = _onDiskBase + ".index.reachability";
+    LOG(INFO) << "Reading reachability indices from file "
+              << reachabilityFilePath << " ..." << std::endl;
+    ad_utility::serialization::FileReadSerializer reachabilityLoader{
+        reachabilityFilePath};
+    reachabilityLoader >> _reachabilityIndices;
+  }
 }
 
 // _____________________________________________________________________________
@@ -1312,6 +1372,12 @@ void Index::readConfiguration() {
         _configurationJson["languages-internal"]);
   }
 
+  if (_configurationJson.count("reachability-index-predicates")) {
+    _reachabilityIndexPredicates =
+        _configurationJson["reachability-index-predicates"]
+            .get<std::vector<string>>();
+  }
+
   if (_configurationJson.find("has-all-permutations") !=
           _configurationJson.end() &&
       _configurationJson["has-all-permutations"] == false) {
@@ -1435,6 +1501,16 @@ void Index::initializeVocabularySettingsBuild() {
     }
   }
 
+  if (j.count("reachability-index-predicates")) {
+    _reachabilityIndexPredicates =
+        j["reachability-index-predicates"].get<std::vector<std::string>>();
+    _configurationJson["reachability-index-predicates"] =
+        _reachabilityIndexPredicates;
+    LOG(INFO) << "Reachability indices will be built for "
+              << _reachabilityIndexPredicates.size() << " predicate(s)"
+              << std::endl;
+  }
+
   if (j.count("num-triples-per-partial-vocab")) {
     _numTriplesPerPartialVocab = size_t{j["num-triples-per-partial-vocab"]};
     LOG(INFO)
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "../engine/ResultTable.h"
+#include "../engine/SemiJoinFilter.h"
 #include "../global/Pattern.h"
 #include "../parser/TsvParser.h"
 #include "../parser/TurtleParser.h"
@@ -28,6 +29,7 @@
 #include "./IndexBuilderTypes.h"
 #include "./IndexMetaData.h"
 #include "./Permutations.h"
+#include "./ReachabilityIndex.h"
 #include "./StxxlSortFunctors.h"
 #include "./TextMetaData.h"
 #include "./Vocabulary.h"
@@ -191,6 +193,14 @@ class Index {
    */
   size_t getHasPredicateFullSize() const;
 
+  /**
+   * @return The precomputed reachability index for the transitive closure of
+   *         the predicate, nullptr if there is none. Reachability indices are
+   *         built for the predicates listed under
+   *         "reachability-index-predicates" in the settings file.
+   */
+  const ReachabilityIndex* getReachabilityIndex(const string& predicate) const;
+
   // --------------------------------------------------------------------------
   // TEXT RETRIEVAL
   // --------------------------------------------------------------------------
@@ -198,30 +208,39 @@ class Index {
 
   size_t getSizeEstimate(const string& words) const;
 
-  void getContextListForWords(const string& words, IdTable* result) const;
+  // The following functions check the `timer` (if any) between the reading,
+  // intersecting and aggregating of the posting lists.
+  void getContextListForWords(
+      const string& words, IdTable* result,
+      ad_utility::SharedConcurrentTimeoutTimer timer = nullptr) const;
 
-  void getECListForWordsOneVar(const string& words, size_t limit,
-                               IdTable* result) const;
+  void getECListForWordsOneVar(
+      const string& words, size_t limit, IdTable* result,
+      ad_utility::SharedConcurrentTimeoutTimer timer = nullptr) const;
 
   // With two or more variables.
-  void getECListForWords(const string& words, size_t nofVars, size_t limit,
-                         IdTable* result) const;
+  void getECListForWords(
+      const string& words, size_t nofVars, size_t limit, IdTable* result,
+      ad_utility::SharedConcurrentTimeoutTimer timer = nullptr) const;
 
   // With filtering. Needs many template instantiations but
   // only nofVars truly makes a difference. Others are just data types
   // of result tables.
-  void getFilteredECListForWords(const string& words, const IdTable& filter,
-                                 size_t filterColumn, size_t nofVars,
-                                 size_t limit, IdTable* result) const;
+  void getFilteredECListForWords(
+      const string& words, const IdTable& filter, size_t filterColumn,
+      size_t nofVars, size_t limit, IdTable* result,
+      ad_utility::SharedConcurrentTimeoutTimer timer = nullptr) const;
 
   // Special cast with a width-one filter.
-  void getFilteredECListForWordsWidthOne(const string& words,
-                                         const IdTable& filter, size_t nofVars,
-                                         size_t limit, IdTable* result) const;
+  void getFilteredECListForWordsWidthOne(
+      const string& words, const IdTable& filter, size_t nofVars,
+      size_t limit, IdTable* result,
+      ad_utility::SharedConcurrentTimeoutTimer timer = nullptr) const;
 
-  void getContextEntityScoreListsForWords(const string& words, vector<Id>& cids,
-                                          vector<Id>& eids,
-                                          vector<Score>& scores) const;
+  void getContextEntityScoreListsForWords(
+      const string& words, vector<Id>& cids, vector<Id>& eids,
+      vector<Score>& scores,
+      const ad_utility::SharedConcurrentTimeoutTimer& timer = nullptr) const;
 
   template <size_t I>
   void getECListForWordsAndSingleSub(const string& words,
@@ -387,6 +406,30 @@ class Index {
     LOG(DEBUG) << "Scan done, got " << result->size() << " elements.\n";
   }
 
+  /**
+   * @brief Perform a scan for one key like above, but only retrieve the YZ
+   * whose Y is contained in the `filter`. Blocks of the permutation that
+   * contain none of these Y are skipped.
+   * @return The number of blocks that were skipped.
+   */
+  template <class Permutation>
+  size_t scan(const string& key, IdTable* result, const Permutation& p,
+              const SemiJoinFilter& filter,
+              ad_utility::SharedConcurrentTimeoutTimer timer = nullptr) const {
+    LOG(DEBUG) << "Performing " << p._readableName
+               << " scan with a semi-join filter of size " << filter.size()
+               << " for: " << key << "\n";
+    Id relId;
+    size_t numSkippedBlocks = 0;
+    if (_vocab.getId(key, &relId)) {
+      numSkippedBlocks = CompressedRelationMetaData::scan(
+          relId, result, p, filter, std::move(timer));
+    }
+    LOG(DEBUG) << "Scan done, got " << result->size() << " elements, skipped "
+               << numSkippedBlocks << " blocks.\n";
+    return numSkippedBlocks;
+  }
+
   /**
    * @brief Perform a scan for two keys i.e. retrieve all Z from the XYZ
    * permutation for specific key values of X and Y.
@@ -466,6 +509,11 @@ class Index {
    */
   CompactVectorOfStrings<Id> _hasPredicate;
 
+  // The predicates with a reachability index and their indices, by the id of
+  // the predicate.
+  std::vector<string> _reachabilityIndexPredicates;
+  ad_utility::HashMap<Id, ReachabilityIndex> _reachabilityIndices;
+
   // Create Vocabulary and directly write it to disk. Create TripleVec with all
   // the triples converted to id space. This Vec can be used for creating
   // permutations. Member _vocab will be empty after this because it is not
@@ -590,6 +638,10 @@ class Index {
   // creation
   void createPatterns(bool isSortedSPO, VocabularyData* idTriples);
 
+  // Build the reachability indices for the `_reachabilityIndexPredicates` from
+  // the PSO permutation and write them to disk.
+  void createReachabilityIndices();
+
   void createTextIndex(const string& filename, const TextVec& vec);
 
   ContextListMetaData writePostings(ad_utility::File& out,
@@ -0,0 +1,257 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./ReachabilityIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "../engine/CsrGraph.h"
+#include "../util/Exception.h"
+
+namespace {
+// The adjacency lists of the graph with `numNodes` nodes and the `edges`,
+// which must be sorted and unique (see `ReachabilityIndex::computeLabeling`).
+std::pair<std::vector<size_t>, std::vector<size_t>> adjacencyLists(
+    size_t numNodes, const std::vector<std::array<size_t, 2>>& edges) {
+  std::vector<size_t> offsets(numNodes + 1, 0);
+  std::vector<size_t> successors;
+  successors.reserve(edges.size());
+  for (const auto& [from, to] : edges) {
+    ++offsets[from + 1];
+    successors.push_back(to);
+  }
+  for (size_t n = 0; n < numNodes; ++n) {
+    offsets[n + 1] += offsets[n];
+  }
+  return {std::move(offsets), std::move(successors)};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+ReachabilityIndex::ReachabilityIndex(
+    const std::vector<std::array<Id, 2>>& edges) {
+  const csrGraph::Graph graph{edges.size(),
+                              [&edges](size_t i) { return edges[i][0]; },
+                              [&edges](size_t i) { return edges[i][1]; }};
+  const size_t numNodes = graph.numNodes();
+  _ids.reserve(numNodes);
+  for (size_t node = 0; node < numNodes; ++node) {
+    _ids.push_back(graph.id(node));
+  }
+
+  // Compute the strongly connected components with Tarjan's algorithm,
+  // without recursion because hierarchies can be deep.
+  _components.assign(numNodes, NO_NODE);
+  std::vector<size_t> discovery(numNodes, NO_NODE);
+  std::vector<size_t> lowLink(numNodes);
+  std::vector<size_t> componentStack;
+  std::vector<uint8_t> isOnStack(numNodes, false);
+  std::vector<std::pair<size_t, const size_t*>> callStack;
+  size_t numDiscovered = 0;
+  size_t numComponents = 0;
+  auto discover = [&](size_t node) {
+    discovery[node] = lowLink[node] = numDiscovered++;
+    componentStack.push_back(node);
+    isOnStack[node] = true;
+    callStack.emplace_back(node, graph.successorsBegin(node));
+  };
+  for (size_t root = 0; root < numNodes; ++root) {
+    if (discovery[root] != NO_NODE) {
+      continue;
+    }
+    discover(root);
+    while (!callStack.empty()) {
+      auto& [node, successor] = callStack.back();
+      if (successor != graph.successorsEnd(node)) {
+        const size_t next = *successor++;
+        if (discovery[next] == NO_NODE) {
+          discover(next);
+        } else if (isOnStack[next]) {
+          lowLink[node] = std::min(lowLink[node], discovery[next]);
+        }
+        continue;
+      }
+      const size_t finished = node;
+      callStack.pop_back();
+      if (lowLink[finished] == discovery[finished]) {
+        size_t member;
+        size_t size = 0;
+        do {
+          member = componentStack.back();
+          componentStack.pop_back();
+          isOnStack[member] = false;
+          _components[member] = numComponents;
+          ++size;
+        } while (member != finished);
+        _isCyclic.push_back(size > 1);
+        ++numComponents;
+      }
+      if (!callStack.empty()) {
+        const size_t parent = callStack.back().first;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[finished]);
+      }
+    }
+  }
+
+  // The edges between the components in both directions. An edge within a
+  // component only matters if it is a loop.
+  std::vector<std::array<size_t, 2>> componentEdges;
+  for (size_t node = 0; node < numNodes; ++node) {
+    const size_t from = _components[node];
+    for (const size_t* it = graph.successorsBegin(node);
+         it != graph.successorsEnd(node); ++it) {
+      const size_t to = _components[*it];
+      if (from != to) {
+        componentEdges.push_back({from, to});
+      } else if (*it == node) {
+        _isCyclic[from] = true;
+      }
+    }
+  }
+  std::sort(componentEdges.begin(), componentEdges.end());
+  componentEdges.erase(
+      std::unique(componentEdges.begin(), componentEdges.end()),
+      componentEdges.end());
+  {
+    auto [offsets, successors] = adjacencyLists(numComponents, componentEdges);
+    _forward = computeLabeling(offsets, successors);
+  }
+  for (auto& edge : componentEdges) {
+    std::swap(edge[0], edge[1]);
+  }
+  std::sort(componentEdges.begin(), componentEdges.end());
+  {
+    auto [offsets, successors] = adjacencyLists(numComponents, componentEdges);
+    _backward = computeLabeling(offsets, successors);
+  }
+}
+
+// _____________________________________________________________________________
+ReachabilityIndex::Labeling ReachabilityIndex::computeLabeling(
+    const std::vector<size_t>& offsets,
+    const std::vector<size_t>& successors) const {
+  const size_t numComponents = offsets.size() - 1;
+  Labeling labeling;
+
+  // Number the components in the postorder of a depth-first search from the
+  // components without predecessors. The subtree of a component in this
+  // spanning forest has the numbers `[firstNumber, number]`.
+  std::vector<uint8_t> hasPredecessor(numComponents, false);
+  for (size_t successor : successors) {
+    hasPredecessor[successor] = true;
+  }
+  labeling._numbers.assign(numComponents, NO_NODE);
+  std::vector<size_t> firstNumber(numComponents);
+  std::vector<size_t> componentOfNumber(numComponents);
+  std::vector<std::pair<size_t, size_t>> callStack;
+  size_t nextNumber = 0;
+  for (size_t root = 0; root < numComponents; ++root) {
+    if (hasPredecessor[root]) {
+      continue;
+    }
+    firstNumber[root] = nextNumber;
+    callStack.emplace_back(root, offsets[root]);
+    while (!callStack.empty()) {
+      auto& [component, next] = callStack.back();
+      if (next < offsets[component + 1]) {
+        const size_t successor = successors[next++];
+        // In a DAG, a component without a number is not on the stack, so it
+        // has not been visited yet.
+        if (labeling._numbers[successor] == NO_NODE) {
+          firstNumber[successor] = nextNumber;
+          callStack.emplace_back(successor, offsets[successor]);
+        }
+        continue;
+      }
+      labeling._numbers[component] = nextNumber;
+      componentOfNumber[nextNumber] = component;
+      ++nextNumber;
+      callStack.pop_back();
+    }
+  }
+  // In a DAG, every component can be reached from one without predecessors.
+  AD_CHECK_EQ(nextNumber, numComponents);
+
+  // The nodes ordered by the number of their component.
+  labeling._nodeOffsets.assign(numComponents + 1, 0);
+  for (size_t component : _components) {
+    ++labeling._nodeOffsets[labeling._numbers[component] + 1];
+  }
+  for (size_t n = 0; n < numComponents; ++n) {
+    labeling._nodeOffsets[n + 1] += labeling._nodeOffsets[n];
+  }
+  labeling._nodes.resize(_ids.size());
+  std::vector<size_t> insertPositions(labeling._nodeOffsets.begin(),
+                                      labeling._nodeOffsets.end() - 1);
+  for (size_t node = 0; node < _ids.size(); ++node) {
+    labeling._nodes[insertPositions[labeling._numbers[_components[node]]]++] =
+        _ids[node];
+  }
+
+  // All successors of a component have a lower number, so their labels are
+  // complete when the component is labeled. Its label is its subtree interval
+  // merged with the labels of its successors.
+  labeling._intervalOffsets.reserve(numComponents + 1);
+  labeling._intervalOffsets.push_back(0);
+  std::vector<std::array<size_t, 2>> intervals;
+  for (size_t number = 0; number < numComponents; ++number) {
+    const size_t component = componentOfNumber[number];
+    intervals.clear();
+    intervals.push_back({firstNumber[component], number});
+    for (size_t i = offsets[component]; i < offsets[component + 1]; ++i) {
+      const size_t successorNumber = labeling._numbers[successors[i]];
+      intervals.insert(
+          intervals.end(),
+          labeling._intervals.begin() +
+              labeling._intervalOffsets[successorNumber],
+          labeling._intervals.begin() +
+              labeling._intervalOffsets[successorNumber + 1]);
+    }
+    std::sort(intervals.begin(), intervals.end());
+    size_t numMerged = 0;
+    for (const auto& interval : intervals) {
+      if (numMerged > 0 && interval[0] <= intervals[numMerged - 1][1] + 1) {
+        intervals[numMerged - 1][1] =
+            std::max(intervals[numMerged - 1][1], interval[1]);
+      } else {
+        intervals[numMerged++] = interval;
+      }
+    }
+    labeling._intervals.insert(labeling._intervals.end(), intervals.begin(),
+                               intervals.begin() + numMerged);
+    labeling._intervalOffsets.push_back(labeling._intervals.size());
+  }
+  return labeling;
+}
+
+// _____________________________________________________________________________
+size_t ReachabilityIndex::nodeOf(Id id) const {
+  auto it = std::lower_bound(_ids.begin(), _ids.end(), id);
+  return it != _ids.end() && *it == id ? it - _ids.begin() : NO_NODE;
+}
+
+// _____________________________________________________________________________
+bool ReachabilityIndex::isReachable(Id from, Id to) const {
+  const size_t fromNode = nodeOf(from);
+  const size_t toNode = nodeOf(to);
+  if (fromNode == NO_NODE || toNode == NO_NODE) {
+    return false;
+  }
+  const size_t fromComponent = _components[fromNode];
+  if (fromComponent == _components[toNode]) {
+    return _isCyclic[fromComponent];
+  }
+  const size_t fromNumber = _forward._numbers[fromComponent];
+  const size_t toNumber = _forward._numbers[_components[toNode]];
+  auto begin =
+      _forward._intervals.begin() + _forward._intervalOffsets[fromNumber];
+  auto end =
+      _forward._intervals.begin() + _forward._intervalOffsets[fromNumber + 1];
+  // The last interval that starts at or before `toNumber`.
+  auto it = std::upper_bound(
+      begin, end, toNumber,
+      [](size_t number, const auto& interval) { return number < interval[0]; });
+  return it != begin && toNumber <= (*std::prev(it))[1];
+}
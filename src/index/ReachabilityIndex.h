@@ -0,0 +1,134 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../global/Id.h"
+#include "../util/Serializer/SerializeVector.h"
+#include "../util/Serializer/Serializer.h"
+
+// A precomputed index for the transitive closure of the edges of a single
+// predicate. It is meant for hierarchical predicates like rdfs:subClassOf or
+// wdt:P279, whose transitive closure is needed by many queries. The nodes that
+// can be reached from a node via one or more edges (in either direction) are
+// enumerated without a graph traversal.
+//
+// The strongly connected components of the graph are contracted, which leaves
+// a DAG. The components are numbered in the postorder of a spanning forest of
+// this DAG, and each component is labeled with the disjoint intervals of the
+// numbers of the components that can be reached from it (interval labeling
+// with a tree cover, Agrawal, Borgida and Jagadish, 1989). For a tree, this is
+// one interval per component, multiple inheritance adds further intervals. The
+// nodes that can be reached from a node then form a few contiguous ranges of
+// an array of all nodes. There is one such labeling for each direction of the
+// edges.
+class ReachabilityIndex {
+ public:
+  enum class Direction { Forward, Backward };
+
+  ReachabilityIndex() = default;
+
+  // Build the index for the edges from `edges[i][0]` to `edges[i][1]`.
+  explicit ReachabilityIndex(const std::vector<std::array<Id, 2>>& edges);
+
+  // Call `emit(id)` for each node that can be reached from the node with the
+  // `id` via one or more edges in the `direction`, in no particular order.
+  template <typename Emit>
+  void forEachReachable(Id id, Direction direction, const Emit& emit) const {
+    const size_t node = nodeOf(id);
+    if (node == NO_NODE) {
+      return;
+    }
+    const size_t component = _components[node];
+    const Labeling& labeling =
+        direction == Direction::Forward ? _forward : _backward;
+    const size_t number = labeling._numbers[component];
+    for (size_t i = labeling._intervalOffsets[number];
+         i < labeling._intervalOffsets[number + 1]; ++i) {
+      const auto [first, last] = labeling._intervals[i];
+      for (size_t j = labeling._nodeOffsets[first];
+           j < labeling._nodeOffsets[last + 1]; ++j) {
+        // A node only reaches itself if it is part of a cycle.
+        if (labeling._nodes[j] != id || _isCyclic[component]) {
+          emit(labeling._nodes[j]);
+        }
+      }
+    }
+  }
+
+  // True iff the node `to` can be reached from the node `from` via one or more
+  // edges in forward direction.
+  bool isReachable(Id from, Id to) const;
+
+  // All nodes that are part of an edge, in ascending order.
+  const std::vector<Id>& nodes() const { return _ids; }
+
+  // The total number of intervals of both labelings, a measure of how far the
+  // graph is from a tree.
+  size_t numIntervals() const {
+    return _forward._intervals.size() + _backward._intervals.size();
+  }
+
+  // Allow serialization via the ad_utility::serialization interface.
+  template <typename Serializer>
+  friend void serialize(Serializer& s, ReachabilityIndex& index) {
+    s | index._ids;
+    s | index._components;
+    s | index._isCyclic;
+    s | index._forward;
+    s | index._backward;
+  }
+
+ private:
+  static constexpr size_t NO_NODE = std::numeric_limits<size_t>::max();
+
+  // The interval labeling for one direction of the edges. The components are
+  // identified by their postorder number in the spanning forest.
+  struct Labeling {
+    // The postorder number of each component.
+    std::vector<size_t> _numbers;
+    // The ids of all nodes, ordered by the number of their component. The
+    // nodes of the component with number `n` are `_nodes[_nodeOffsets[n]]`
+    // to `_nodes[_nodeOffsets[n + 1] - 1]`.
+    std::vector<Id> _nodes;
+    std::vector<size_t> _nodeOffsets;
+    // The component with number `n` reaches exactly the components with a
+    // number in one of the intervals `[first, last]` from
+    // `_intervals[_intervalOffsets[n]]` to
+    // `_intervals[_intervalOffsets[n + 1] - 1]`, including itself.
+    std::vector<size_t> _intervalOffsets;
+    std::vector<std::array<size_t, 2>> _intervals;
+
+    template <typename Serializer>
+    friend void serialize(Serializer& s, Labeling& labeling) {
+      s | labeling._numbers;
+      s | labeling._nodes;
+      s | labeling._nodeOffsets;
+      s | labeling._intervalOffsets;
+      s | labeling._intervals;
+    }
+  };
+
+  // The distinct ids of the nodes in ascending order, the strongly connected
+  // component of each node, and for each component whether it contains a
+  // cycle (more than one node or an edge from a node to itself).
+  std::vector<Id> _ids;
+  std::vector<size_t> _components;
+  std::vector<uint8_t> _isCyclic;
+  Labeling _forward;
+  Labeling _backward;
+
+  // The position of the `id` in `_ids`, `NO_NODE` if it is not a node.
+  size_t nodeOf(Id id) const;
+
+  // Compute the labeling of the DAG of the components, given as adjacency
+  // lists (the successors of component `c` are `successors[offsets[c]]` to
+  // `successors[offsets[c + 1] - 1]`).
+  Labeling computeLabeling(const std::vector<size_t>& offsets,
+                           const std::vector<size_t>& successors) const;
+};
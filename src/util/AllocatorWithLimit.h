@@ -5,10 +5,12 @@
 #ifndef QLEVER_ALLOCATORWITHLIMIT_H
 #define QLEVER_ALLOCATORWITHLIMIT_H
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <memory>
 
+#include "HugePages.h"
 #include "Synchronized.h"
 
 namespace ad_utility {
@@ -74,10 +76,47 @@ class AllocationMemoryLeftThreadsafe {
   AllocationMemoryLeftThreadsafe() = delete;
   using T =
       std::shared_ptr<ad_utility::Synchronized<AllocationMemoryLeft, SpinLock>>;
-  explicit AllocationMemoryLeftThreadsafe(T ptr) : ptr_{std::move(ptr)} {}
+  // If there is a `parent`, the memory also counts towards its limit.
+  explicit AllocationMemoryLeftThreadsafe(
+      T ptr, std::shared_ptr<AllocationMemoryLeftThreadsafe> parent = nullptr)
+      : ptr_{std::move(ptr)}, parent_{std::move(parent)} {}
   T& ptr() { return ptr_; }
   const T& ptr() const { return ptr_; }
 
+  // Decrease the number of free bytes of this object and its ancestors by `n`.
+  // If one of them has less than `n` free bytes, change nothing and return
+  // false.
+  bool decrease_if_enough_left_or_return_false(size_t n) {
+    if (!ptr_->wlock()->decrease_if_enough_left_or_return_false(n)) {
+      return false;
+    }
+    if (parent_ && !parent_->decrease_if_enough_left_or_return_false(n)) {
+      ptr_->wlock()->increase(n);
+      return false;
+    }
+    return true;
+  }
+
+  void decrease_if_enough_left_or_throw(size_t n) {
+    if (!decrease_if_enough_left_or_return_false(n)) {
+      throw AllocationExceedsLimitException{n, numFreeBytes()};
+    }
+  }
+
+  void increase(size_t n) {
+    ptr_->wlock()->increase(n);
+    if (parent_) {
+      parent_->increase(n);
+    }
+  }
+
+  // The number of bytes that can be allocated, which is limited by the
+  // ancestors as well.
+  [[nodiscard]] size_t numFreeBytes() const {
+    const size_t numFree = ptr_->wlock()->numFreeBytes();
+    return parent_ ? std::min(numFree, parent_->numFreeBytes()) : numFree;
+  }
+
   friend bool operator==(const AllocationMemoryLeftThreadsafe& a,
                          const AllocationMemoryLeftThreadsafe& b) {
     return a.ptr_ == b.ptr_;
@@ -85,6 +124,7 @@ class AllocationMemoryLeftThreadsafe {
 
  private:
   T ptr_;
+  std::shared_ptr<AllocationMemoryLeftThreadsafe> parent_;
 };
 }  // namespace detail
 
@@ -104,7 +144,9 @@ inline ClearOnAllocation noClearOnAllocation = [](size_t) {};
 /**
  * @brief Class to concurrently allocate memory up to a specified limit on the
  * total amount of memory allocated. The actual allocation is done by
- * std::allocator, but only when the limit is not exceeded.
+ * std::allocator, but only when the limit is not exceeded. If the allocator
+ * has a `HugePageMode` other than `None`, allocations of at least one huge page
+ * are mapped directly and backed by huge pages.
  *
  * Memory allocated by copies of an Allocator will also count towards the limit
  * To use it, construct a first allocator by calling
@@ -142,27 +184,38 @@ class AllocatorWithLimit {
       memoryLeft_;                       // shared number of free bytes
   ClearOnAllocation clearOnAllocation_;  // TODO<joka921> comment
   std::allocator<T> allocator_;
+  HugePageMode hugePageMode_;
+
+  // Allocations of `numBytes` are backed by huge pages.
+  bool usesHugePages(size_t numBytes) const {
+    return hugePageMode_ != HugePageMode::None &&
+           numBytes >= hugePages::HUGE_PAGE_SIZE;
+  }
 
  public:
   /// obtain an AllocationMemoryLeftThreadsafe by calls to
   /// makeAllocationMemoryLeftThreadsafeObject()
   explicit AllocatorWithLimit(
       detail::AllocationMemoryLeftThreadsafe ml,
-      ClearOnAllocation clearOnAllocation = noClearOnAllocation)
+      ClearOnAllocation clearOnAllocation = noClearOnAllocation,
+      HugePageMode hugePageMode = defaultHugePageMode())
       : memoryLeft_{std::move(ml)},
-        clearOnAllocation_{std::move(clearOnAllocation)} {}
+        clearOnAllocation_{std::move(clearOnAllocation)},
+        hugePageMode_{hugePageMode} {}
 
   /// Obtain an AllocatorWithLimit<OtherType> that refers to the
   /// same limit.
   template <typename U>
   AllocatorWithLimit<U> as() {
-    return AllocatorWithLimit<U>(memoryLeft_);
+    return AllocatorWithLimit<U>(memoryLeft_, noClearOnAllocation,
+                                 hugePageMode_);
   }
   AllocatorWithLimit() = delete;
 
   template <typename U>
   AllocatorWithLimit(const AllocatorWithLimit<U>& other)
-      : memoryLeft_(other.getMemoryLeft()){};
+      : memoryLeft_(other.getMemoryLeft()),
+        hugePageMode_(other.getHugePageMode()){};
 
   // An allocator must have a function "allocate" with exactly this signature.
   // TODO<C++20> : the exact signature of allocate changes
@@ -171,43 +224,71 @@ class AllocatorWithLimit {
     // memory left. This will throw an exception if not enough memory is left.
     const auto bytesNeeded = n * sizeof(T);
     const bool wasEnoughLeft =
-        memoryLeft_.ptr()->wlock()->decrease_if_enough_left_or_return_false(
-            bytesNeeded);
+        memoryLeft_.decrease_if_enough_left_or_return_false(bytesNeeded);
     if (!wasEnoughLeft) {
       clearOnAllocation_(n);
-      memoryLeft_.ptr()->wlock()->decrease_if_enough_left_or_throw(bytesNeeded);
+      memoryLeft_.decrease_if_enough_left_or_throw(bytesNeeded);
     }
     // the actual allocation
+    if (usesHugePages(bytesNeeded)) {
+      return static_cast<T*>(hugePages::allocate(bytesNeeded, hugePageMode_));
+    }
     return allocator_.allocate(n);
   }
 
   // An allocator must have a function "deallocate" with exactly this signature.
   void deallocate(T* p, std::size_t n) {
     // free the memory
-    allocator_.deallocate(p, n);
+    if (usesHugePages(n * sizeof(T))) {
+      hugePages::deallocate(p, n * sizeof(T));
+    } else {
+      allocator_.deallocate(p, n);
+    }
     // Update the amount of memory left.
-    memoryLeft_.ptr()->wlock()->increase(n * sizeof(T));
+    memoryLeft_.increase(n * sizeof(T));
   }
 
   /// Return the number of bytes, that this allocator and all of its copies
   /// currently have available
   [[nodiscard]] size_t numFreeBytes() const {
-    // casting is ok, because the actual numFreeBytes call
-    // is const, and everything else is locking
-    return const_cast<AllocatorWithLimit*>(this)
-        ->memoryLeft_.ptr()
-        ->wlock()
-        ->numFreeBytes();
+    return memoryLeft_.numFreeBytes();
+  }
+
+  /// Return an allocator via which (and its copies) at most `limit` bytes can
+  /// be allocated, e.g. for a single query. These bytes also count towards
+  /// the limit of this allocator. The `clearOnAllocation` of this allocator
+  /// is only called when this allocator has too little memory left, not when
+  /// the `limit` of the child is exceeded, which clearing cannot change.
+  [[nodiscard]] AllocatorWithLimit makeChild(size_t limit) const {
+    auto childMemoryLeft =
+        makeAllocationMemoryLeftThreadsafeObject(limit).ptr();
+    auto parentMemoryLeft =
+        std::make_shared<detail::AllocationMemoryLeftThreadsafe>(memoryLeft_);
+    ClearOnAllocation clearParent = [childMemoryLeft, parentMemoryLeft,
+                                     clear = clearOnAllocation_](size_t n) {
+      const size_t bytesNeeded = n * sizeof(T);
+      if (childMemoryLeft->wlock()->numFreeBytes() >= bytesNeeded &&
+          parentMemoryLeft->numFreeBytes() < bytesNeeded) {
+        clear(n);
+      }
+    };
+    return AllocatorWithLimit{
+        detail::AllocationMemoryLeftThreadsafe{std::move(childMemoryLeft),
+                                               std::move(parentMemoryLeft)},
+        std::move(clearParent), hugePageMode_};
   }
 
   const auto& getMemoryLeft() const { return memoryLeft_; }
+  HugePageMode getHugePageMode() const { return hugePageMode_; }
 
   // The STL needs two allocators to be equal if and only they refer to the same
   // memory pool. For us, they are hence equal if they use the same
-  // AllocationMemoryLeft object.00
+  // AllocationMemoryLeft object (and the same `HugePageMode`, else they
+  // cannot free the memory of each other).
   template <typename V>
   bool operator==(const AllocatorWithLimit<V>& v) {
-    return memoryLeft_ == v.memoryLeft_;
+    return memoryLeft_ == v.getMemoryLeft() &&
+           hugePageMode_ == v.getHugePageMode();
   }
   template <typename V>
   bool operator!=(const AllocatorWithLimit<V>& v) {
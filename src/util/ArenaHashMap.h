@@ -0,0 +1,26 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <utility>
+
+#include "./HashMap.h"
+#include "./HashSet.h"
+#include "./MonotonicArena.h"
+
+namespace ad_utility {
+// A HashMap whose memory is allocated from a `MonotonicArena`, e.g. the arena
+// of a query (see `QueryExecutionContext::getArena`).
+template <class K, class V,
+          class HashFcn = absl::container_internal::hash_default_hash<K>,
+          class EqualKey = absl::container_internal::hash_default_eq<K>>
+using ArenaHashMap = HashMap<K, V, HashFcn, EqualKey,
+                             ArenaAllocator<std::pair<const K, V>>>;
+
+// A hash set whose memory is allocated from a `MonotonicArena`.
+template <class T,
+          class HashFct = absl::container_internal::hash_default_hash<T>,
+          class EqualElem = absl::container_internal::hash_default_eq<T>>
+using ArenaHashSet = HashSet<T, HashFct, EqualElem, ArenaAllocator<T>>;
+}  // namespace ad_utility
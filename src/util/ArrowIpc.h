@@ -0,0 +1,383 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./Exception.h"
+
+/// The messages of the Apache Arrow IPC streaming format
+/// (https://arrow.apache.org/docs/format/Columnar.html#ipc-streaming-format),
+/// which is read by the Arrow libraries (e.g. `pyarrow.ipc.open_stream`)
+/// without parsing the values. A stream is the `schemaMessage`, followed by
+/// `dictionaryBatchMessage`s and `recordBatchMessage`s and terminated by
+/// `END_OF_STREAM`. The dictionary of a column must be sent before the first
+/// record batch, later dictionary batches of the column are deltas that
+/// append to it.
+///
+/// Only the column types of query results are supported, and the metadata
+/// (FlatBuffers) is encoded directly, so no Arrow library is needed.
+namespace ad_utility::arrow {
+
+/// The type of a column. The values of a `Utf8Dictionary` column are `int32`
+/// indices into the dictionary of the column, which consists of strings.
+enum class ColumnType { Int64, Float32, Utf8Dictionary };
+
+struct Field {
+  std::string _name;
+  ColumnType _type;
+};
+
+/// The values of one column of a record batch, each can be null.
+class Column {
+ public:
+  explicit Column(ColumnType type)
+      : _valueSize{type == ColumnType::Int64 ? sizeof(int64_t)
+                                             : sizeof(int32_t)} {}
+
+  void appendNull() {
+    appendValidity(false);
+    ++_nullCount;
+    _values.append(_valueSize, '\0');
+  }
+
+  // `T` must match the `ColumnType`, that is `int64_t`, `float` or `int32_t`.
+  template <typename T>
+  void append(T value) {
+    static_assert(std::is_arithmetic_v<T>);
+    AD_CHECK(sizeof(T) == _valueSize);
+    appendValidity(true);
+    _values.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  size_t size() const { return _size; }
+  size_t nullCount() const { return _nullCount; }
+  const std::string& validity() const { return _validity; }
+  const std::string& values() const { return _values; }
+
+  void clear() {
+    _size = 0;
+    _nullCount = 0;
+    _validity.clear();
+    _values.clear();
+  }
+
+ private:
+  void appendValidity(bool isValid) {
+    if (_size % 8 == 0) {
+      _validity.push_back('\0');
+    }
+    if (isValid) {
+      _validity.back() = static_cast<char>(_validity.back() | 1 << _size % 8);
+    }
+    ++_size;
+  }
+
+  size_t _valueSize;
+  size_t _size = 0;
+  size_t _nullCount = 0;
+  // One bit per value, the least significant bit first.
+  std::string _validity;
+  std::string _values;
+};
+
+/// The strings of (a delta of) the dictionary of a column.
+class DictionaryValues {
+ public:
+  void append(std::string_view value) {
+    _data.append(value);
+    AD_CHECK(_data.size() <= static_cast<size_t>(INT32_MAX));
+    _offsets.push_back(static_cast<int32_t>(_data.size()));
+  }
+
+  size_t size() const { return _offsets.size() - 1; }
+  const std::vector<int32_t>& offsets() const { return _offsets; }
+  const std::string& data() const { return _data; }
+
+  void clear() {
+    _offsets.resize(1);
+    _data.clear();
+  }
+
+ private:
+  std::vector<int32_t> _offsets{0};
+  std::string _data;
+};
+
+namespace detail {
+// _____________________________________________________________________________
+constexpr size_t roundUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Writes a FlatBuffer from front to back: an object that is referenced by
+// another object is written after it, and the reference is `patch`ed when the
+// position of the object is known. All positions are relative to the start of
+// the buffer, which is 8-byte aligned in the message.
+class FlatBufferBuilder {
+ public:
+  // A field of a table, either a scalar with `_size` bytes or a reference
+  // (`_size` 4) that is patched later. Fields with `_size` 0 are absent.
+  struct TableField {
+    size_t _size;
+    uint64_t _value = 0;
+  };
+
+  // Reserve the reference to the root table.
+  FlatBufferBuilder() : _bytes(4, '\0') {}
+
+  // Write a table with the `fields` (in the order of their IDs in the
+  // schema), return its position and the positions of the fields.
+  std::pair<size_t, std::vector<size_t>> table(
+      const std::vector<TableField>& fields) {
+    // The inline layout: the offset to the vtable, then the fields, each at a
+    // multiple of its size.
+    std::vector<size_t> offsets(fields.size(), 0);
+    size_t tableSize = 4;
+    for (size_t size : {8, 4, 2, 1}) {
+      for (size_t i = 0; i < fields.size(); ++i) {
+        if (fields[i]._size == size) {
+          tableSize = roundUp(tableSize, size);
+          offsets[i] = tableSize;
+          tableSize += size;
+        }
+      }
+    }
+    // The vtable directly precedes the table.
+    align(2);
+    const size_t vtable = _bytes.size();
+    appendScalar<uint16_t>(4 + 2 * fields.size());
+    appendScalar<uint16_t>(tableSize);
+    for (size_t offset : offsets) {
+      appendScalar<uint16_t>(offset);
+    }
+    align(8);
+    const size_t table = _bytes.size();
+    appendScalar<int32_t>(table - vtable);
+    _bytes.resize(table + roundUp(tableSize, 4), '\0');
+    std::vector<size_t> positions(fields.size(), 0);
+    for (size_t i = 0; i < fields.size(); ++i) {
+      if (fields[i]._size > 0) {
+        positions[i] = table + offsets[i];
+        std::memcpy(_bytes.data() + positions[i], &fields[i]._value,
+                    fields[i]._size);
+      }
+    }
+    return {table, std::move(positions)};
+  }
+
+  // A vector of `size` references, return the position of the vector, the
+  // reference `i` is at `position + 4 * (i + 1)`.
+  size_t referenceVector(size_t size) {
+    align(4);
+    const size_t position = _bytes.size();
+    appendScalar<uint32_t>(size);
+    _bytes.append(4 * size, '\0');
+    return position;
+  }
+
+  // A vector of structs of two `int64_t`s (e.g. `Buffer` or `FieldNode`).
+  size_t structVector(const std::vector<std::pair<int64_t, int64_t>>& values) {
+    // The structs are 8-byte aligned, the length directly precedes them.
+    align(8);
+    _bytes.append(4, '\0');
+    const size_t position = _bytes.size();
+    appendScalar<uint32_t>(values.size());
+    for (const auto& [first, second] : values) {
+      appendScalar(first);
+      appendScalar(second);
+    }
+    return position;
+  }
+
+  // _________________________________________________________________________
+  size_t string(std::string_view value) {
+    align(4);
+    const size_t position = _bytes.size();
+    appendScalar<uint32_t>(value.size());
+    _bytes.append(value);
+    _bytes.push_back('\0');
+    return position;
+  }
+
+  // Let the reference at `position` point to the object at `target`.
+  void patch(size_t position, size_t target) {
+    AD_CHECK(target > position);
+    const auto offset = static_cast<uint32_t>(target - position);
+    std::memcpy(_bytes.data() + position, &offset, sizeof(offset));
+  }
+
+  // _________________________________________________________________________
+  std::string finish(size_t rootTable) && {
+    patch(0, rootTable);
+    return std::move(_bytes);
+  }
+
+ private:
+  void align(size_t alignment) {
+    _bytes.resize(roundUp(_bytes.size(), alignment), '\0');
+  }
+
+  template <typename T>
+  void appendScalar(T value) {
+    _bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  std::string _bytes;
+};
+
+// The values of the schema (`Message.fbs` and `Schema.fbs` of Arrow).
+constexpr uint64_t METADATA_VERSION_V5 = 4;
+enum MessageHeader : uint8_t { SCHEMA = 1, DICTIONARY_BATCH = 2, RECORD_BATCH };
+enum Type : uint8_t { INT = 2, FLOATING_POINT = 3, UTF8 = 5 };
+constexpr uint64_t PRECISION_SINGLE = 1;
+
+// The body of a record batch: the buffers of the columns, each padded to a
+// multiple of 8 bytes.
+struct Body {
+  std::string _bytes;
+  std::vector<std::pair<int64_t, int64_t>> _nodes;
+  std::vector<std::pair<int64_t, int64_t>> _buffers;
+
+  void addNode(size_t length, size_t nullCount) {
+    _nodes.emplace_back(length, nullCount);
+  }
+
+  void addBuffer(std::string_view buffer) {
+    _buffers.emplace_back(_bytes.size(), buffer.size());
+    _bytes.append(buffer);
+    _bytes.resize(roundUp(_bytes.size(), 8), '\0');
+  }
+};
+
+// Write a `RecordBatch` table with the nodes and buffers of the `body`.
+inline size_t recordBatchTable(FlatBufferBuilder& builder, size_t length,
+                               const Body& body) {
+  auto [table, fields] = builder.table({{8, length}, {4}, {4}});
+  builder.patch(fields[1], builder.structVector(body._nodes));
+  builder.patch(fields[2], builder.structVector(body._buffers));
+  return table;
+}
+
+// A message with the header that `writeHeader(builder)` writes, followed by
+// the `body`.
+template <typename WriteHeader>
+std::string message(MessageHeader headerType, const WriteHeader& writeHeader,
+                    std::string_view body) {
+  FlatBufferBuilder builder;
+  auto [table, fields] = builder.table({{2, METADATA_VERSION_V5},
+                                        {1, headerType},
+                                        {4},
+                                        {8, body.size()}});
+  builder.patch(fields[2], writeHeader(builder));
+  std::string metadata = std::move(builder).finish(table);
+  // The continuation marker and the length of the metadata precede it, the
+  // body starts at a multiple of 8 bytes.
+  metadata.resize(roundUp(metadata.size(), 8), '\0');
+  std::string result(8, '\0');
+  const uint32_t continuation = 0xFFFFFFFF;
+  const auto metadataSize = static_cast<int32_t>(metadata.size());
+  std::memcpy(result.data(), &continuation, 4);
+  std::memcpy(result.data() + 4, &metadataSize, 4);
+  result.append(metadata);
+  result.append(body);
+  return result;
+}
+
+// _____________________________________________________________________________
+inline size_t intTypeTable(FlatBufferBuilder& builder, uint64_t bitWidth) {
+  // The fields are `bitWidth` and `is_signed`.
+  return builder.table({{4, bitWidth}, {1, 1}}).first;
+}
+}  // namespace detail
+
+/// The schema of a stream with the `fields`. The dictionary of the column `i`
+/// has the ID `i`.
+inline std::string schemaMessage(const std::vector<Field>& fields) {
+  using namespace detail;
+  auto writeSchema = [&fields](FlatBufferBuilder& builder) {
+    // The fields are `endianness` (little endian by default) and `fields`.
+    auto [schema, schemaFields] = builder.table({{0}, {4}});
+    const size_t vector = builder.referenceVector(fields.size());
+    builder.patch(schemaFields[1], vector);
+    for (size_t i = 0; i < fields.size(); ++i) {
+      const ColumnType type = fields[i]._type;
+      const uint64_t typeType = type == ColumnType::Int64     ? INT
+                                : type == ColumnType::Float32 ? FLOATING_POINT
+                                                              : UTF8;
+      const bool isDictionary = type == ColumnType::Utf8Dictionary;
+      // The fields are `name`, `nullable`, `type_type`, `type`, `dictionary`
+      // and `children`.
+      auto [field, fieldFields] = builder.table(
+          {{4}, {1, 1}, {1, typeType}, {4}, {isDictionary ? 4u : 0u}, {4}});
+      builder.patch(vector + 4 * (i + 1), field);
+      builder.patch(fieldFields[0], builder.string(fields[i]._name));
+      if (type == ColumnType::Int64) {
+        builder.patch(fieldFields[3], intTypeTable(builder, 64));
+      } else if (type == ColumnType::Float32) {
+        builder.patch(fieldFields[3],
+                      builder.table({{2, PRECISION_SINGLE}}).first);
+      } else {
+        builder.patch(fieldFields[3], builder.table({}).first);
+        // The fields are `id` and `indexType`.
+        auto [dictionary, dictionaryFields] = builder.table({{8, i}, {4}});
+        builder.patch(fieldFields[4], dictionary);
+        builder.patch(dictionaryFields[1], intTypeTable(builder, 32));
+      }
+      builder.patch(fieldFields[5], builder.referenceVector(0));
+    }
+    return schema;
+  };
+  return message(SCHEMA, writeSchema, {});
+}
+
+/// The dictionary of the column `columnIndex`, or a delta of it that is
+/// appended to the previous ones.
+inline std::string dictionaryBatchMessage(size_t columnIndex,
+                                          const DictionaryValues& values,
+                                          bool isDelta) {
+  using namespace detail;
+  Body body;
+  body.addNode(values.size(), 0);
+  body.addBuffer({});
+  body.addBuffer({reinterpret_cast<const char*>(values.offsets().data()),
+                  values.offsets().size() * sizeof(int32_t)});
+  body.addBuffer(values.data());
+  auto writeDictionaryBatch = [&](FlatBufferBuilder& builder) {
+    // The fields are `id`, `data` and `isDelta`.
+    auto [batch, fields] =
+        builder.table({{8, columnIndex}, {4}, {1, isDelta}});
+    builder.patch(fields[1], recordBatchTable(builder, values.size(), body));
+    return batch;
+  };
+  return message(DICTIONARY_BATCH, writeDictionaryBatch, body._bytes);
+}
+
+/// A record batch with the `columns`, which must have the same size.
+inline std::string recordBatchMessage(const std::vector<Column>& columns) {
+  using namespace detail;
+  const size_t length = columns.empty() ? 0 : columns[0].size();
+  Body body;
+  for (const Column& column : columns) {
+    AD_CHECK(column.size() == length);
+    body.addNode(length, column.nullCount());
+    // The validity bitmap can be omitted if there are no nulls.
+    body.addBuffer(column.nullCount() > 0 ? column.validity() : "");
+    body.addBuffer(column.values());
+  }
+  auto writeRecordBatch = [&](FlatBufferBuilder& builder) {
+    return recordBatchTable(builder, length, body);
+  };
+  return message(RECORD_BATCH, writeRecordBatch, body._bytes);
+}
+
+/// The end of a stream.
+constexpr std::string_view END_OF_STREAM{"\xFF\xFF\xFF\xFF\0\0\0\0", 8};
+}  // namespace ad_utility::arrow
@@ -8,9 +8,13 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
 
 #include "./HashMap.h"
@@ -73,7 +77,8 @@ struct DefaultSizeGetter {
  * @tparam AccessUpdater function (Score, Value) -> Score. Each time a value is
  * accessed, its previous score and the value are used to calculate a new score.
  * @tparam ScoreCalculator function Value -> Score to determine the Score of a a
- * newly inserted entry
+ * newly inserted entry. If it has a member function `onEviction(Score)`, this
+ * is called with the score of each entry that is removed to make room.
  * @tparam ValueSizeGetter function Value -> size_t to determine the actual
  * "size" of a value for statistics
  */
@@ -157,7 +162,8 @@ class FlexibleCache {
 
     // Move it to the front.
     auto& handle = mapIt->second;
-    _entries.updateKey(_accessUpdater(handle.score(), handle.value()), &handle);
+    _entries.updateKey(
+        _accessUpdater(handle.score(), *handle.value().value()), &handle);
     return _accessMap[key].value().value();
   }
 
@@ -293,7 +299,7 @@ class FlexibleCache {
       return;
     }
     // the entry exists in the non-pinned part of the cache, erase it.
-    _totalSizeNonPinned -= _valueSizeGetter(*mapIt->second);
+    _totalSizeNonPinned -= _valueSizeGetter(*mapIt->second.value().value());
     _entries.erase(std::move(mapIt->second));
     _accessMap.erase(mapIt);
   }
@@ -401,6 +407,9 @@ class FlexibleCache {
   void removeOneEntry() {
     AD_CHECK(!_entries.empty());
     auto handle = _entries.pop();
+    if constexpr (requires { _scoreCalculator.onEviction(handle.score()); }) {
+      _scoreCalculator.onEviction(handle.score());
+    }
     _totalSizeNonPinned -= _valueSizeGetter(*handle.value().value());
     _accessMap.erase(handle.value().key());
   }
@@ -494,6 +503,138 @@ class TreeBasedLRUCache
              detail::timeAsScore{}, ValueSizeGetter{}) {}
 };
 
+/// The strategies of a `PolicyCache` to choose the entry that is evicted next.
+enum class EvictionPolicy {
+  // Evict the least recently used entry.
+  LRU,
+  // Greedy-Dual-Size-Frequency (Cherkasova, 1998): evict the entry with the
+  // lowest `clock + numAccesses * cost / size`, where `clock` is the score of
+  // the last evicted entry. Entries that are expensive to recompute, small, or
+  // often used stay longer, and the rising `clock` ages out entries that are
+  // no longer used.
+  GDSF
+};
+
+/// The name of the `policy` as used in the configuration of the server.
+inline std::string_view toString(EvictionPolicy policy) {
+  return policy == EvictionPolicy::LRU ? "lru" : "gdsf";
+}
+
+/// The policy with the given `name` (see `toString`), throws if there is none.
+inline EvictionPolicy evictionPolicyFromString(std::string_view name) {
+  for (auto policy : {EvictionPolicy::LRU, EvictionPolicy::GDSF}) {
+    if (name == toString(policy)) {
+      return policy;
+    }
+  }
+  throw std::runtime_error("Unknown cache eviction policy \"" +
+                           std::string{name} +
+                           "\", supported are \"lru\" and \"gdsf\"");
+}
+
+namespace detail {
+// The score of an entry in a `PolicyCache`. Entries with a lower `_priority`
+// are evicted first.
+struct PolicyScore {
+  double _priority;
+  size_t _numAccesses;
+  bool operator==(const PolicyScore&) const = default;
+};
+
+struct PolicyScoreComparator {
+  bool operator()(const PolicyScore& a, const PolicyScore& b) const {
+    return a._priority < b._priority;
+  }
+};
+
+// The `ScoreCalculator` and `AccessUpdater` of a `PolicyCache`. The copies
+// that are used by one cache share the clock.
+template <typename Value, typename CostGetter, typename ValueSizeGetter>
+class PolicyScoreCalculator {
+ public:
+  PolicyScoreCalculator(EvictionPolicy policy, CostGetter costGetter,
+                        ValueSizeGetter valueSizeGetter)
+      : _policy{policy},
+        _costGetter{std::move(costGetter)},
+        _valueSizeGetter{std::move(valueSizeGetter)} {}
+
+  // The score of a newly inserted `value`.
+  PolicyScore operator()(const Value& value) const { return score(value, 1); }
+
+  // The score of the `value` after an access.
+  PolicyScore operator()(const PolicyScore& previous,
+                         const Value& value) const {
+    return score(value, previous._numAccesses + 1);
+  }
+
+  void onEviction(const PolicyScore& evicted) const {
+    if (_policy == EvictionPolicy::GDSF) {
+      *_clock = std::max(*_clock, evicted._priority);
+    }
+  }
+
+ private:
+  PolicyScore score(const Value& value, size_t numAccesses) const {
+    if (_policy == EvictionPolicy::LRU) {
+      // The clock counts the accesses, so the oldest one has the lowest score.
+      *_clock += 1;
+      return {*_clock, numAccesses};
+    }
+    // Avoid the division by zero for empty values.
+    const double size = std::max<double>(
+        static_cast<double>(_valueSizeGetter(value)), 1.0);
+    return {*_clock + static_cast<double>(numAccesses) *
+                          static_cast<double>(_costGetter(value)) / size,
+            numAccesses};
+  }
+
+  EvictionPolicy _policy;
+  std::shared_ptr<double> _clock = std::make_shared<double>(0.0);
+  CostGetter _costGetter;
+  ValueSizeGetter _valueSizeGetter;
+};
+}  // namespace detail
+
+/// A cache whose eviction policy is chosen at runtime (see `EvictionPolicy`).
+/// `CostGetter` is a function Value -> double that returns the cost of
+/// recomputing a value, which is needed for `EvictionPolicy::GDSF`.
+template <typename Key, typename Value, typename CostGetter,
+          typename ValueSizeGetter = DefaultSizeGetter<Value>>
+class PolicyCache
+    : public HeapBasedCache<
+          Key, Value, detail::PolicyScore, detail::PolicyScoreComparator,
+          detail::PolicyScoreCalculator<Value, CostGetter, ValueSizeGetter>,
+          detail::PolicyScoreCalculator<Value, CostGetter, ValueSizeGetter>,
+          ValueSizeGetter> {
+  using Calculator =
+      detail::PolicyScoreCalculator<Value, CostGetter, ValueSizeGetter>;
+  using Base = HeapBasedCache<Key, Value, detail::PolicyScore,
+                              detail::PolicyScoreComparator, Calculator,
+                              Calculator, ValueSizeGetter>;
+
+ public:
+  explicit PolicyCache(EvictionPolicy policy = EvictionPolicy::LRU,
+                       size_t capacityNumEls = size_t_max,
+                       size_t capacitySize = size_t_max,
+                       size_t maxSizeSingleEl = size_t_max)
+      : PolicyCache(policy,
+                    Calculator{policy, CostGetter{}, ValueSizeGetter{}},
+                    capacityNumEls, capacitySize, maxSizeSingleEl) {}
+
+  EvictionPolicy evictionPolicy() const { return _policy; }
+
+ private:
+  PolicyCache(EvictionPolicy policy, const Calculator& calculator,
+              size_t capacityNumEls, size_t capacitySize,
+              size_t maxSizeSingleEl)
+      : Base(capacityNumEls, capacitySize, maxSizeSingleEl,
+             detail::PolicyScoreComparator{}, calculator, calculator,
+             ValueSizeGetter{}),
+        _policy{policy} {}
+
+  EvictionPolicy _policy;
+};
+
 /// typedef for the simple name LRUCache that is fixed to one of the possible
 /// implementations at compiletime
 #ifdef _QLEVER_USE_TREE_BASED_CACHE
@@ -183,6 +183,14 @@ class ConcurrentCache {
     return _cacheAndInProgressMap.wlock()->_cache.pinnedSize();
   }
 
+  /// The number of calls to `computeOnce` and `computeOncePinned` whose result
+  /// was (hits) or was not (misses) found in the cache. Waiting for a result
+  /// that is computed by another thread counts as a miss.
+  size_t numHits() const { return _cacheAndInProgressMap.wlock()->_numHits; }
+  size_t numMisses() const {
+    return _cacheAndInProgressMap.wlock()->_numMisses;
+  }
+
   /// only for testing: get access to the implementation
   auto& getStorage() { return _cacheAndInProgressMap; }
 
@@ -221,6 +229,8 @@ class ConcurrentCache {
     // Values that are currently being computed. The bool tells us whether this
     // result will be pinned in the cache.
     HashMap<Key, std::pair<bool, shared_ptr<ResultInProgress>>> _inProgress;
+    size_t _numHits = 0;
+    size_t _numMisses = 0;
     template <typename... Args>
     CacheAndInProgressMap(Args&&... args)
         : _cache{std::forward<Args>(args)...} {}
@@ -262,9 +272,12 @@ class ConcurrentCache {
                            : lockPtr->_cache.contains(key);
       if (contained) {
         // the result is in the cache, simply return it.
+        ++lockPtr->_numHits;
         return {static_cast<shared_ptr<const Value>>(lockPtr->_cache[key]),
                 true};
-      } else if (lockPtr->_inProgress.contains(key)) {
+      }
+      ++lockPtr->_numMisses;
+      if (lockPtr->_inProgress.contains(key)) {
         // the result is not cached, but someone else is computing it.
         // it is important, that we do not immediately call getResult() since
         // this call blocks and we currently hold a lock.
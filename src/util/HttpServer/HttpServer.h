@@ -6,6 +6,8 @@
 #define QLEVER_HTTPSERVER_H
 
 #include <cstdlib>
+#include <functional>
+#include <memory>
 #include <semaphore>
 
 #include "../Exception.h"
@@ -35,6 +37,10 @@ using tcp = boost::asio::ip::tcp;  // from <boost/asio/ip/tcp.hpp>
  * simply return the response. A very basic HttpHandler, which simply serves
  * files from a directory, can be obtained via
  * `ad_utility::httpUtils::makeFileServer()`.
+ * If the HttpHandler also takes a third parameter of type
+ * `std::function<void()>&`, it can set this function, which is then called if
+ * the client closes the connection before the handling of its request is
+ * done (e.g. to cancel the computation of the response).
  */
 template <typename HttpHandler>
 class HttpServer {
@@ -140,6 +146,37 @@ class HttpServer {
     }
   }
 
+  // The state of `watchForDisconnect` for a single request.
+  struct DisconnectState {
+    // Set by the `HttpHandler`.
+    std::function<void()> _onDisconnect;
+    bool _requestIsHandled = false;
+  };
+
+  // Call the `_onDisconnect` of the `state` if the client closes the
+  // `socket` before the `_requestIsHandled`. The socket becomes readable when
+  // the client closes it, but also when it sends its next request (pipelining)
+  // before it received the response, which is not a disconnect. The
+  // `executor` must be the (strand) executor of the session, so that the
+  // `state` is only accessed from one thread at a time.
+  static void watchForDisconnect(tcp::socket& socket,
+                                 std::shared_ptr<DisconnectState> state,
+                                 auto executor) {
+    socket.async_wait(
+        tcp::socket::wait_read,
+        net::bind_executor(executor, [&socket, state = std::move(state)](
+                                         beast::error_code ec) {
+          // When the request is handled, the socket might already be closed.
+          if (ec || state->_requestIsHandled) {
+            return;
+          }
+          beast::error_code availableEc;
+          if (socket.available(availableEc) == 0 && state->_onDisconnect) {
+            state->_onDisconnect();
+          }
+        }));
+  }
+
   // This coroutine handles a single http session which is represented by a
   // socket.
   boost::asio::awaitable<void> session(tcp::socket socket) {
@@ -190,7 +227,20 @@ class HttpServer {
 
         // Handle the http request. Note that `_httpHandler` is also responsible
         // for sending the message via the `sendMessage` lambda.
-        co_await _httpHandler(std::move(req), sendMessage);
+        if constexpr (std::is_invocable_v<HttpHandler&, decltype(req),
+                                          decltype(sendMessage)&,
+                                          std::function<void()>&>) {
+          auto disconnect = std::make_shared<DisconnectState>();
+          watchForDisconnect(stream.socket(), disconnect,
+                             co_await net::this_coro::executor);
+          ad_utility::OnDestruction requestIsHandled{[&disconnect]() noexcept {
+            disconnect->_requestIsHandled = true;
+          }};
+          co_await _httpHandler(std::move(req), sendMessage,
+                                disconnect->_onDisconnect);
+        } else {
+          co_await _httpHandler(std::move(req), sendMessage);
+        }
 
         // The closing of the stream is done in the exception handler.
         if (streamNeedsClosing) {
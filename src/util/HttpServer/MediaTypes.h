@@ -40,7 +40,8 @@ enum class MediaType {
   csv,
   textApplication,
   turtle,
-  octetStream
+  octetStream,
+  arrowStream
 };
 
 struct MediaTypeWithQuality {
@@ -0,0 +1,116 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "./Exception.h"
+
+namespace ad_utility {
+
+/// Whether large allocations (e.g. the buffers of big `IdTable`s) are backed
+/// by huge pages of 2 MB, which need far fewer TLB entries than the default
+/// pages of 4 KB. With `Transparent`, the memory is aligned to huge pages and
+/// the kernel is asked to back it by transparent huge pages (this also works
+/// if they are only enabled for `madvise`). With `Explicit`, the memory is
+/// taken from the huge pages that were reserved via `/proc/sys/vm/nr_hugepages`
+/// and only if they are exhausted from the transparent huge pages.
+enum class HugePageMode { None, Transparent, Explicit };
+
+// _____________________________________________________________________________
+constexpr std::string_view toString(HugePageMode mode) {
+  switch (mode) {
+    case HugePageMode::None:
+      return "none";
+    case HugePageMode::Transparent:
+      return "transparent";
+    case HugePageMode::Explicit:
+      return "explicit";
+  }
+  return "none";
+}
+
+// _____________________________________________________________________________
+inline HugePageMode hugePageModeFromString(std::string_view name) {
+  for (auto mode : {HugePageMode::None, HugePageMode::Transparent,
+                    HugePageMode::Explicit}) {
+    if (name == toString(mode)) {
+      return mode;
+    }
+  }
+  throw std::runtime_error("Unknown huge page mode \"" + std::string{name} +
+                           "\", supported are \"none\", \"transparent\" and "
+                           "\"explicit\"");
+}
+
+/// The mode of the `AllocatorWithLimit`s that are created without a mode and
+/// of the memory mappings of the index. Must be set before these are created,
+/// e.g. at the start of `main`.
+inline std::atomic<HugePageMode>& defaultHugePageMode() {
+  static std::atomic<HugePageMode> mode{HugePageMode::None};
+  return mode;
+}
+
+namespace hugePages {
+// The size of a huge page, which is also the size from which on an allocation
+// is backed by huge pages.
+constexpr size_t HUGE_PAGE_SIZE = size_t{1} << 21;
+
+// _____________________________________________________________________________
+constexpr size_t roundUpToHugePages(size_t numBytes) {
+  return (numBytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+// Map `numBytes` (rounded up to whole huge pages) of anonymous memory that
+// starts at a huge page. Throws `std::bad_alloc` if no memory is left. The
+// memory is only backed by physical pages when it is first written, so it is
+// placed on the NUMA node of the thread that writes it first.
+inline void* allocate(size_t numBytes, HugePageMode mode) {
+  AD_CHECK(mode != HugePageMode::None);
+  const size_t size = roundUpToHugePages(numBytes);
+  constexpr int protection = PROT_READ | PROT_WRITE;
+  constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (mode == HugePageMode::Explicit) {
+    // Request pages of 2 MB explicitly, the default size of the reserved huge
+    // pages might be different (e.g. 1 GB).
+    void* pointer = mmap(nullptr, size, protection,
+                         flags | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+    if (pointer != MAP_FAILED) {
+      return pointer;
+    }
+  }
+  // Map one huge page more than needed and unmap the parts before the first
+  // and after the last huge page of the result.
+  const size_t mappedSize = size + HUGE_PAGE_SIZE;
+  void* mapped = mmap(nullptr, mappedSize, protection, flags, -1, 0);
+  if (mapped == MAP_FAILED) {
+    throw std::bad_alloc{};
+  }
+  const auto begin = reinterpret_cast<uintptr_t>(mapped);
+  const uintptr_t aligned =
+      (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  if (aligned > begin) {
+    munmap(mapped, aligned - begin);
+  }
+  munmap(reinterpret_cast<void*>(aligned + size),
+         begin + mappedSize - (aligned + size));
+  // The kernel ignores this if transparent huge pages are disabled, then the
+  // memory is backed by pages of the default size.
+  madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+  return reinterpret_cast<void*>(aligned);
+}
+
+// Unmap the memory that was returned by `allocate(numBytes, ...)`.
+inline void deallocate(void* pointer, size_t numBytes) {
+  munmap(pointer, roundUpToHugePages(numBytes));
+}
+}  // namespace hugePages
+}  // namespace ad_utility
@@ -0,0 +1,123 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace ad_utility {
+
+/// A string that is written to a `std::ostream` as a JSON string literal,
+/// that is in quotes and with the necessary escapes. This is used to write
+/// large JSON documents piece by piece to a `stream_generator` without
+/// building a `nlohmann::json` first, e.g.
+///
+///   co_yield '[';
+///   co_yield JsonString{value};
+///   co_yield ']';
+///
+/// Invalid UTF-8 is replaced by U+FFFD, like `nlohmann::json::dump` does
+/// with `error_handler_t::replace`.
+struct JsonString {
+  std::string_view _value;
+
+  friend std::ostream& operator<<(std::ostream& stream,
+                                  const JsonString& string) {
+    stream << '"';
+    std::string_view value = string._value;
+    // The bytes from `value.begin()` to `value.begin() + i` that don't need
+    // an escape are written at once.
+    size_t i = 0;
+    auto flush = [&](size_t numSkipped) {
+      stream.write(value.data(), static_cast<std::streamsize>(i));
+      value.remove_prefix(i + numSkipped);
+      i = 0;
+    };
+    while (i < value.size()) {
+      const auto c = static_cast<unsigned char>(value[i]);
+      if (c == '"' || c == '\\') {
+        flush(1);
+        stream << '\\' << static_cast<char>(c);
+      } else if (c < 0x20) {
+        flush(1);
+        writeControlCharacter(stream, c);
+      } else if (c < 0x80) {
+        ++i;
+      } else if (auto [length, valid] = utf8Sequence(value.substr(i)); valid) {
+        i += length;
+      } else {
+        flush(length);
+        stream << "\xEF\xBF\xBD";
+      }
+    }
+    flush(0);
+    return stream << '"';
+  }
+
+ private:
+  // _________________________________________________________________________
+  static void writeControlCharacter(std::ostream& stream, unsigned char c) {
+    static constexpr std::string_view hexDigits = "0123456789abcdef";
+    switch (c) {
+      case '\b':
+        stream << "\\b";
+        break;
+      case '\f':
+        stream << "\\f";
+        break;
+      case '\n':
+        stream << "\\n";
+        break;
+      case '\r':
+        stream << "\\r";
+        break;
+      case '\t':
+        stream << "\\t";
+        break;
+      default:
+        stream << "\\u00" << hexDigits[c >> 4] << hexDigits[c & 0xF];
+    }
+  }
+
+  // The number of bytes of the UTF-8 encoded code point at the start of
+  // `bytes`, which starts with a byte >= 0x80, and whether it is valid (not
+  // truncated, overlong, or a surrogate). An invalid sequence consists of the
+  // longest prefix of a valid one, at least one byte, which is replaced by a
+  // single U+FFFD.
+  static std::pair<size_t, bool> utf8Sequence(std::string_view bytes) {
+    auto byte = [&bytes](size_t i) {
+      return static_cast<unsigned char>(bytes[i]);
+    };
+    const unsigned char first = byte(0);
+    size_t length;
+    // The range of the second byte, which excludes the overlong encodings and
+    // the surrogates.
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (first >= 0xC2 && first <= 0xDF) {
+      length = 2;
+    } else if (first >= 0xE0 && first <= 0xEF) {
+      length = 3;
+      low = first == 0xE0 ? 0xA0 : low;
+      high = first == 0xED ? 0x9F : high;
+    } else if (first >= 0xF0 && first <= 0xF4) {
+      length = 4;
+      low = first == 0xF0 ? 0x90 : low;
+      high = first == 0xF4 ? 0x8F : high;
+    } else {
+      return {1, false};
+    }
+    if (bytes.size() < 2 || byte(1) < low || byte(1) > high) {
+      return {1, false};
+    }
+    for (size_t i = 2; i < length; ++i) {
+      if (i >= bytes.size() || byte(i) < 0x80 || byte(i) > 0xBF) {
+        return {i, false};
+      }
+    }
+    return {length, true};
+  }
+};
+}  // namespace ad_utility
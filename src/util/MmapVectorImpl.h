@@ -11,6 +11,7 @@
 
 #include <utility>
 
+#include "../util/HugePages.h"
 #include "../util/Log.h"
 
 namespace ad_utility {
@@ -325,6 +326,11 @@ void MmapVector<T>::advise(AccessPattern pattern) {
       madvise(static_cast<void*>(_ptr), _bytesize, MADV_NORMAL);
       break;
   }
+  // E.g. the metadata of the index is read at random positions. The kernel
+  // only backs file mappings by huge pages if the file system supports it.
+  if (defaultHugePageMode() != HugePageMode::None) {
+    madvise(static_cast<void*>(_ptr), _bytesize, MADV_HUGEPAGE);
+  }
 }
 
 // ________________________________________________________________
@@ -0,0 +1,153 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./AllocatorWithLimit.h"
+#include "./Exception.h"
+#include "./Synchronized.h"
+
+namespace ad_utility {
+
+/// Memory for many small, short-lived objects of a single query (e.g. the
+/// hash sets of DISTINCT aggregates, which are built anew for each group).
+/// The memory is taken in blocks of `blockSize` bytes from an
+/// `AllocatorWithLimit`, so it counts towards the memory limit of the query,
+/// and small objects are cut from these blocks without a call to the heap.
+/// A freed small object is kept in a free list for its size class (the next
+/// power of two) and reused by the next object of that class. The blocks are
+/// only returned in bulk when the arena is destroyed, e.g. at the end of the
+/// query. Objects that are larger than a sixteenth of a block are directly
+/// allocated with the `AllocatorWithLimit`.
+///
+/// This class is threadsafe. Use it via the `ArenaAllocator`.
+class MonotonicArena {
+ public:
+  MonotonicArena(AllocatorWithLimit<char> allocator, size_t blockSize)
+      : _allocator{std::move(allocator)},
+        _blockSize{blockSize},
+        _maxSmallSize{blockSize / 16} {
+    AD_CHECK(_maxSmallSize >= MIN_SIZE);
+  }
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+  ~MonotonicArena() {
+    auto state = _state.wlock();
+    for (char* block : state->_blocks) {
+      _allocator.deallocate(block, _blockSize);
+    }
+  }
+
+  void* allocate(size_t numBytes, size_t alignment) {
+    AD_CHECK(alignment <= alignof(std::max_align_t));
+    if (numBytes > _maxSmallSize) {
+      return _allocator.allocate(numBytes);
+    }
+    const size_t sizeClass = std::bit_ceil(std::max(numBytes, MIN_SIZE));
+    auto state = _state.wlock();
+    auto& freeList = state->_freeLists[std::countr_zero(sizeClass)];
+    if (freeList) {
+      return std::exchange(freeList, freeList->_next);
+    }
+    // Each chunk is aligned to its size class, up to the maximal alignment,
+    // so a reused chunk is suitably aligned for any object of its class.
+    const size_t chunkAlignment =
+        std::min(sizeClass, alignof(std::max_align_t));
+    size_t offset =
+        (state->_offset + chunkAlignment - 1) & ~(chunkAlignment - 1);
+    if (state->_blocks.empty() || offset + sizeClass > _blockSize) {
+      // The rest of the current block is too small and stays unused.
+      state->_blocks.push_back(_allocator.allocate(_blockSize));
+      offset = 0;
+    }
+    state->_offset = offset + sizeClass;
+    return state->_blocks.back() + offset;
+  }
+
+  void deallocate(void* pointer, size_t numBytes) {
+    if (numBytes > _maxSmallSize) {
+      _allocator.deallocate(static_cast<char*>(pointer), numBytes);
+      return;
+    }
+    const size_t sizeClass = std::bit_ceil(std::max(numBytes, MIN_SIZE));
+    auto state = _state.wlock();
+    auto& freeList = state->_freeLists[std::countr_zero(sizeClass)];
+    freeList = new (pointer) FreeChunk{freeList};
+  }
+
+  // The number of bytes of the blocks, the large objects are not included.
+  size_t numBlockBytes() const {
+    return _state.wlock()->_blocks.size() * _blockSize;
+  }
+
+ private:
+  // Each chunk must be able to hold a `FreeChunk`.
+  struct FreeChunk {
+    FreeChunk* _next;
+  };
+  static constexpr size_t MIN_SIZE = sizeof(FreeChunk);
+
+  struct State {
+    std::vector<char*> _blocks;
+    // The first unused byte in the last block.
+    size_t _offset = 0;
+    // The free chunks of size 2^i.
+    FreeChunk* _freeLists[64] = {};
+  };
+
+  AllocatorWithLimit<char> _allocator;
+  const size_t _blockSize;
+  const size_t _maxSmallSize;
+  Synchronized<State, SpinLock> _state;
+};
+
+/// An allocator for the STL containers (e.g. `ArenaHashSet` or
+/// `ArenaString`) that allocates from a `MonotonicArena`, which must outlive
+/// the containers.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit ArenaAllocator(MonotonicArena& arena) : _arena{&arena} {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : _arena{other.arena()} {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, size_t n) {
+    _arena->deallocate(pointer, n * sizeof(T));
+  }
+
+  MonotonicArena* arena() const { return _arena; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return _arena == other.arena();
+  }
+
+ private:
+  MonotonicArena* _arena;
+};
+
+/// A string whose memory is allocated from a `MonotonicArena`.
+using ArenaString =
+    std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+}  // namespace ad_utility
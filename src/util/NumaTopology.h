@@ -0,0 +1,121 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./Exception.h"
+
+namespace ad_utility {
+
+/// The CPUs of each NUMA node of the machine. Memory is placed on the node of
+/// the thread that first writes it, so a thread that stays on one node
+/// accesses the memory that it has written itself without crossing the
+/// interconnect between the sockets.
+class NumaTopology {
+ public:
+  // A single node whose CPUs are unknown, threads are not pinned.
+  NumaTopology() : _cpusOfNodes(1) {}
+
+  explicit NumaTopology(std::vector<std::vector<int>> cpusOfNodes)
+      : _cpusOfNodes{std::move(cpusOfNodes)} {
+    AD_CHECK(!_cpusOfNodes.empty());
+  }
+
+  /// The topology of this machine, read from `/sys/devices/system/node`. A
+  /// single node if it cannot be read.
+  static const NumaTopology& get() {
+    static const NumaTopology topology = read("/sys/devices/system/node");
+    return topology;
+  }
+
+  size_t numNodes() const { return _cpusOfNodes.size(); }
+  const std::vector<int>& cpusOfNode(size_t node) const {
+    return _cpusOfNodes.at(node);
+  }
+
+  /// The node of the thread with the `index` in a pool of `numThreads`
+  /// threads. The threads are distributed evenly over the nodes, consecutive
+  /// threads are on the same node.
+  size_t nodeOfThread(size_t index, size_t numThreads) const {
+    AD_CHECK(index < numThreads);
+    return index * numNodes() / numThreads;
+  }
+
+  /// Restrict the calling thread to the CPUs of the `node`. Does nothing if
+  /// these are unknown, returns false if the thread could not be pinned.
+  bool pinCurrentThread(size_t node) const {
+    const auto& cpus = cpusOfNode(node);
+    if (cpus.empty()) {
+      return true;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) {
+      CPU_SET(cpu, &cpuSet);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) ==
+           0;
+  }
+
+  /// Parse a list in the format of the kernel, e.g. "0-3,8,10-11".
+  static std::vector<int> parseList(std::string_view list) {
+    std::vector<int> result;
+    while (!list.empty() && list.back() == '\n') {
+      list.remove_suffix(1);
+    }
+    while (!list.empty()) {
+      const size_t comma = list.find(',');
+      const std::string range{list.substr(0, comma)};
+      const size_t dash = range.find('-');
+      const int first = std::stoi(range.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int i = first; i <= last; ++i) {
+        result.push_back(i);
+      }
+      list.remove_prefix(comma == std::string_view::npos ? list.size()
+                                                         : comma + 1);
+    }
+    return result;
+  }
+
+  /// Read the topology from the `directory` (see `get`). Nodes without CPUs
+  /// (only memory) are skipped.
+  static NumaTopology read(const std::filesystem::path& directory) {
+    auto readList = [](const std::filesystem::path& file) {
+      std::ifstream stream{file};
+      std::string line;
+      std::getline(stream, line);
+      return parseList(line);
+    };
+    try {
+      std::vector<std::vector<int>> cpusOfNodes;
+      for (int node : readList(directory / "online")) {
+        auto cpus = readList(directory / ("node" + std::to_string(node)) /
+                             "cpulist");
+        if (!cpus.empty()) {
+          cpusOfNodes.push_back(std::move(cpus));
+        }
+      }
+      if (!cpusOfNodes.empty()) {
+        return NumaTopology{std::move(cpusOfNodes)};
+      }
+    } catch (const std::exception&) {
+      // Unknown format, use a single node.
+    }
+    return NumaTopology{};
+  }
+
+ private:
+  std::vector<std::vector<int>> _cpusOfNodes;
+};
+}  // namespace ad_utility
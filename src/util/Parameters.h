@@ -6,6 +6,8 @@
 #define QLEVER_PARAMETERS_H
 
 #include <atomic>
+#include <functional>
+#include <optional>
 #include <tuple>
 
 #include "./ConstexprMap.h"
@@ -7,7 +7,9 @@
 
 #include <iomanip>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <string>
 
 #include "./Log.h"
 #include "Synchronized.h"
@@ -132,9 +134,19 @@ class TimeoutTimer : public Timer {
     return TimeoutTimer(static_cast<off_t>(seconds * 1000 * 1000));
   }
 
-  /// Did this timer already timeout
+  /// Let this timer time out now, also if it is unlimited, because the
+  /// computation is no longer needed. The `reason` becomes the message of the
+  /// exception thrown by `checkTimeoutAndThrow`.
+  void cancel(std::string reason) { _cancellationReason = std::move(reason); }
+
+  bool isCancelled() const { return _cancellationReason.has_value(); }
+
+  /// Did this timer already timeout (or was it cancelled)
   /// Can't be const because of the internals of the Timer class.
   bool hasTimedOut() {
+    if (_cancellationReason.has_value()) {
+      return true;
+    }
     if (_isUnlimited) {
       return false;
     }
@@ -151,6 +163,9 @@ class TimeoutTimer : public Timer {
   // Check if this timer has timed out. If the timer has timed out, throws a
   // TimeoutException. Else, nothing happens.
   void checkTimeoutAndThrow(std::string additionalMessage = {}) {
+    if (_cancellationReason.has_value()) {
+      throw TimeoutException(additionalMessage + _cancellationReason.value());
+    }
     if (hasTimedOut()) {
       double seconds =
           static_cast<double>(_timeLimitInMicroseconds) / (1000 * 1000);
@@ -165,6 +180,9 @@ class TimeoutTimer : public Timer {
   }
 
   off_t remainingMicroseconds() {
+    if (_cancellationReason.has_value()) {
+      return 0;
+    }
     if (_isUnlimited) {
       return std::numeric_limits<off_t>::max();
     }
@@ -182,6 +200,7 @@ class TimeoutTimer : public Timer {
  private:
   off_t _timeLimitInMicroseconds = 0;
   bool _isUnlimited = false;  // never times out
+  std::optional<std::string> _cancellationReason;
   class UnlimitedTag {};
   TimeoutTimer(UnlimitedTag) : _isUnlimited{true} {}
   TimeoutTimer(off_t timeLimitInMicroseconds)
@@ -0,0 +1,330 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "./Exception.h"
+#include "./NumaTopology.h"
+#include "./jthread.h"
+
+namespace ad_utility {
+
+/// A fixed set of threads that execute the tasks that are submitted to it.
+/// Each thread has its own deque of tasks. A thread pushes the tasks that it
+/// submits itself to the back of its deque and takes its next task from there
+/// (the most recent task is the one whose data is still in the cache). When
+/// its deque is empty, it steals the oldest task from the front of the deque
+/// of another thread. Tasks that are submitted from outside the pool are
+/// distributed round-robin over the deques.
+///
+/// On a machine with several NUMA nodes, the threads are distributed over the
+/// nodes and pinned to them, and a thread steals from the threads on its own
+/// node first. The memory that a task writes (e.g. the result of a partition
+/// of a join) is thus placed on the node of the thread that executes it, and
+/// mostly read by tasks on the same node.
+///
+/// Tasks must not throw, use a `TaskGroup` to get exceptions back to the
+/// caller. This class is threadsafe.
+class WorkStealingThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingThreadPool(size_t numThreads,
+                                  NumaTopology topology = NumaTopology{})
+      : _topology{std::move(topology)} {
+    AD_CHECK(numThreads > 0);
+    _queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+      _queues.push_back(std::make_unique<Queue>());
+    }
+    // Each thread first looks at its own deque, then at those of the other
+    // threads on its node, then at the rest.
+    _stealOrders.resize(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+      const size_t node = _topology.nodeOfThread(i, numThreads);
+      for (bool sameNode : {true, false}) {
+        for (size_t j = 0; j < numThreads; ++j) {
+          const size_t other = (i + j) % numThreads;
+          if ((_topology.nodeOfThread(other, numThreads) == node) == sameNode) {
+            _stealOrders[i].push_back(other);
+          }
+        }
+      }
+    }
+    _threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+      _threads.emplace_back(&WorkStealingThreadPool::runWorker, this, i);
+    }
+  }
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+  // Executes the tasks that are still pending, then joins the threads.
+  ~WorkStealingThreadPool() {
+    {
+      std::lock_guard lock{_sleepMutex};
+      _shutdown = true;
+    }
+    _taskWasSubmitted.notify_all();
+    _threads.clear();
+  }
+
+  /// The pool that is shared by all the queries of this process. It has one
+  /// thread per hardware thread.
+  static WorkStealingThreadPool& global() {
+    static WorkStealingThreadPool pool{
+        std::max(1u, std::thread::hardware_concurrency()),
+        NumaTopology::get()};
+    return pool;
+  }
+
+  size_t numThreads() const { return _queues.size(); }
+
+  // The order in which the thread with the `index` takes tasks from the
+  // deques of the threads (starting with its own).
+  const std::vector<size_t>& stealOrder(size_t index) const {
+    return _stealOrders.at(index);
+  }
+
+  void submit(Task task) {
+    const bool isOwnThread = _currentPool == this;
+    Queue& queue = isOwnThread
+                       ? *_queues[_currentThreadIndex]
+                       : *_queues[_nextQueue++ % _queues.size()];
+    {
+      std::lock_guard lock{queue._mutex};
+      queue._tasks.push_back(std::move(task));
+      ++_numPendingTasks;
+    }
+    // Lock the mutex of the sleeping threads once, so that the notification
+    // cannot get lost between their check and their wait.
+    { std::lock_guard lock{_sleepMutex}; }
+    _taskWasSubmitted.notify_one();
+  }
+
+  size_t numPendingTasks() const { return _numPendingTasks; }
+
+ private:
+  struct Queue {
+    std::mutex _mutex;
+    std::deque<Task> _tasks;
+  };
+
+  // Take the most recent task of the thread with the `ownIndex`, or steal the
+  // oldest task of one of the other threads.
+  std::optional<Task> popOrSteal(size_t ownIndex) {
+    for (size_t other : _stealOrders[ownIndex]) {
+      Queue& queue = *_queues[other];
+      std::lock_guard lock{queue._mutex};
+      if (queue._tasks.empty()) {
+        continue;
+      }
+      Task task;
+      if (other == ownIndex) {
+        task = std::move(queue._tasks.back());
+        queue._tasks.pop_back();
+      } else {
+        task = std::move(queue._tasks.front());
+        queue._tasks.pop_front();
+      }
+      --_numPendingTasks;
+      return task;
+    }
+    return std::nullopt;
+  }
+
+  // _________________________________________________________________________
+  void runWorker(size_t index) {
+    _currentPool = this;
+    _currentThreadIndex = index;
+    if (_topology.numNodes() > 1) {
+      _topology.pinCurrentThread(_topology.nodeOfThread(index, numThreads()));
+    }
+    while (true) {
+      if (auto task = popOrSteal(index)) {
+        (*task)();
+        continue;
+      }
+      std::unique_lock lock{_sleepMutex};
+      _taskWasSubmitted.wait(
+          lock, [this]() { return _numPendingTasks > 0 || _shutdown; });
+      if (_shutdown && _numPendingTasks == 0) {
+        return;
+      }
+    }
+  }
+
+  NumaTopology _topology;
+  std::vector<std::unique_ptr<Queue>> _queues;
+  std::vector<std::vector<size_t>> _stealOrders;
+  std::atomic<size_t> _nextQueue = 0;
+  std::atomic<size_t> _numPendingTasks = 0;
+  std::mutex _sleepMutex;
+  std::condition_variable _taskWasSubmitted;
+  bool _shutdown = false;
+  // The pool and the index of the thread that runs the current code, if it
+  // is a thread of a pool.
+  static inline thread_local WorkStealingThreadPool* _currentPool = nullptr;
+  static inline thread_local size_t _currentThreadIndex = 0;
+  // Declared last, so that the threads are joined before the queues are
+  // destroyed.
+  std::vector<ad_utility::JThread> _threads;
+};
+
+/// A set of tasks (e.g. the partitions of a join of one query) that are
+/// executed by a `WorkStealingThreadPool`, of which at most `maxParallelism`
+/// run at the same time. The thread that calls `wait` executes the tasks of
+/// the group itself while it waits and counts towards this bound, so a group
+/// with a `maxParallelism` of one runs all its tasks on the calling thread.
+///
+/// The `checkCancellation` function is called before each task and may throw
+/// (e.g. when the query has timed out or was cancelled). The first exception
+/// of a task or of `checkCancellation` cancels the tasks of the group that
+/// have not started yet and is rethrown by `wait`. The destructor cancels the
+/// group and waits for the tasks that are already running, so the tasks may
+/// safely refer to the local variables of the caller.
+class TaskGroup {
+ public:
+  using Task = std::function<void()>;
+  static constexpr size_t UNBOUNDED = std::numeric_limits<size_t>::max();
+
+  explicit TaskGroup(WorkStealingThreadPool& pool,
+                     size_t maxParallelism = UNBOUNDED,
+                     std::function<void()> checkCancellation = {})
+      : _pool{&pool},
+        _state{std::make_shared<State>(std::max(size_t{1}, maxParallelism),
+                                       std::move(checkCancellation))} {}
+
+  TaskGroup(TaskGroup&&) noexcept = default;
+  TaskGroup& operator=(TaskGroup&&) = delete;
+
+  ~TaskGroup() {
+    if (!_state) {
+      return;
+    }
+    cancel();
+    try {
+      wait();
+    } catch (...) {
+      // The exception was not asked for, the group was abandoned.
+    }
+  }
+
+  void run(Task task) {
+    bool needsRunner = false;
+    {
+      std::lock_guard lock{_state->_mutex};
+      if (_state->_cancelled) {
+        return;
+      }
+      _state->_tasks.push_back(std::move(task));
+      // One of the tasks is run by the thread that calls `wait`.
+      needsRunner = _state->_numRunners + 1 < _state->_maxParallelism &&
+                    _state->_numRunners < _state->_tasks.size();
+      if (needsRunner) {
+        ++_state->_numRunners;
+      }
+    }
+    _state->_changed.notify_all();
+    if (needsRunner) {
+      _pool->submit([state = _state]() {
+        std::unique_lock lock{state->_mutex};
+        state->runTasks(lock);
+        --state->_numRunners;
+      });
+    }
+  }
+
+  // Do not start any more tasks of this group.
+  void cancel() {
+    {
+      std::lock_guard lock{_state->_mutex};
+      _state->_cancelled = true;
+      _state->_tasks.clear();
+    }
+    _state->_changed.notify_all();
+  }
+
+  // Help executing the tasks until all of them are finished, then rethrow the
+  // first exception of a task if there was one.
+  void wait() {
+    std::unique_lock lock{_state->_mutex};
+    while (true) {
+      _state->runTasks(lock);
+      if (_state->_numRunningTasks == 0) {
+        break;
+      }
+      _state->_changed.wait(lock);
+    }
+    if (_state->_exception) {
+      std::rethrow_exception(std::exchange(_state->_exception, nullptr));
+    }
+  }
+
+ private:
+  // Shared with the runners that were submitted to the pool, which may start
+  // only after the group has been destroyed.
+  struct State {
+    State(size_t maxParallelism, std::function<void()> checkCancellation)
+        : _maxParallelism{maxParallelism},
+          _checkCancellation{std::move(checkCancellation)} {}
+
+    // Execute the pending tasks of the group one after the other. The `lock`
+    // of the `_mutex` is released while a task runs.
+    void runTasks(std::unique_lock<std::mutex>& lock) {
+      while (!_cancelled && !_tasks.empty()) {
+        Task task = std::move(_tasks.front());
+        _tasks.pop_front();
+        ++_numRunningTasks;
+        lock.unlock();
+        std::exception_ptr exception = nullptr;
+        try {
+          if (_checkCancellation) {
+            _checkCancellation();
+          }
+          task();
+        } catch (...) {
+          exception = std::current_exception();
+        }
+        lock.lock();
+        if (exception && !_cancelled) {
+          _exception = std::move(exception);
+          _cancelled = true;
+          _tasks.clear();
+        }
+        --_numRunningTasks;
+        _changed.notify_all();
+      }
+    }
+
+    const size_t _maxParallelism;
+    const std::function<void()> _checkCancellation;
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    std::deque<Task> _tasks;
+    // The runners that were submitted to the pool and have not finished.
+    size_t _numRunners = 0;
+    size_t _numRunningTasks = 0;
+    bool _cancelled = false;
+    std::exception_ptr _exception = nullptr;
+  };
+
+  WorkStealingThreadPool* _pool;
+  std::shared_ptr<State> _state;
+};
+}  // namespace ad_utility
@@ -77,6 +77,13 @@ TEST(AcceptHeaderParser, MultipleTypesCaseInsensitive) {
   ASSERT_EQ(c[2], ad_utility::MediaType::css);
 }
 
+TEST(AcceptHeaderParser, subtypeWithDots) {
+  auto c = parse("application/vnd.apache.arrow.stream, text/csv;q=0.5");
+  ASSERT_EQ(c.size(), 2u);
+  ASSERT_EQ(c[0], ad_utility::MediaType::arrowStream);
+  ASSERT_EQ(c[1], ad_utility::MediaType::csv);
+}
+
 TEST(AcceptHeaderParser, AllTypesUnknownThrow) {
   auto p = std::string{"appLicaTion/unknown, unknown/Html   ,  strange/Css"};
   ASSERT_THROW(parse(p), AcceptHeaderQleverVisitor::Exception);
@@ -0,0 +1,91 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+
+#include "../src/engine/AdmissionController.h"
+#include "../src/global/Constants.h"
+
+using namespace std::chrono_literals;
+
+TEST(AdmissionControllerTest, reserveAndRelease) {
+  AdmissionController controller{100};
+  {
+    auto a = controller.admit(60, 0ms);
+    auto b = controller.admit(40, 0ms);
+    ASSERT_TRUE(a.has_value() && b.has_value());
+    ASSERT_EQ(100u, controller.numReservedBytes());
+    ASSERT_EQ(0ms, a->waitTime());
+    // Nothing is left.
+    ASSERT_FALSE(controller.admit(1, 10ms).has_value());
+    ASSERT_EQ(0u, controller.numWaitingQueries());
+    auto moved = std::move(a);
+    ASSERT_EQ(100u, controller.numReservedBytes());
+  }
+  ASSERT_EQ(0u, controller.numReservedBytes());
+
+  // A query that is larger than the budget runs alone.
+  auto large = controller.admit(1000, 0ms);
+  ASSERT_EQ(100u, large->numBytes());
+}
+
+TEST(AdmissionControllerTest, resize) {
+  AdmissionController controller{100};
+  auto estimate = controller.admit(70, 0ms);
+  // The result that is kept is smaller than the estimate, so that another
+  // query fits now.
+  estimate->resize(20);
+  ASSERT_EQ(20u, estimate->numBytes());
+  ASSERT_EQ(20u, controller.numReservedBytes());
+  auto other = controller.admit(80, 0ms);
+  ASSERT_TRUE(other.has_value());
+  // Growing doesn't wait, but is limited to the budget.
+  estimate->resize(1000);
+  ASSERT_EQ(100u, estimate->numBytes());
+  ASSERT_EQ(180u, controller.numReservedBytes());
+  ASSERT_FALSE(controller.admit(1, 0ms).has_value());
+  estimate.reset();
+  other.reset();
+  ASSERT_EQ(0u, controller.numReservedBytes());
+}
+
+TEST(AdmissionControllerTest, smallQueriesOvertake) {
+  AdmissionController controller{100};
+  auto running = controller.admit(80, 0ms);
+  // The large query waits for the running one, the small one fits and is
+  // admitted before it.
+  auto large = std::async(std::launch::async,
+                          [&]() { return controller.admit(70, 10s); });
+  while (controller.numWaitingQueries() < 1) {
+    std::this_thread::sleep_for(1ms);
+  }
+  auto small = controller.admit(10, 0ms);
+  ASSERT_TRUE(small.has_value());
+  ASSERT_EQ(std::future_status::timeout, large.wait_for(20ms));
+
+  running.reset();
+  auto largeReservation = large.get();
+  ASSERT_TRUE(largeReservation.has_value());
+  ASSERT_EQ(80u, controller.numReservedBytes());
+  ASSERT_GE(largeReservation->waitTime(), 20ms);
+}
+
+TEST(AdmissionControllerTest, largeQueriesAreNotStarved) {
+  AdmissionController controller{100};
+  auto running = controller.admit(50, 0ms);
+  auto large = std::async(std::launch::async,
+                          [&]() { return controller.admit(70, 10s); });
+  while (controller.numWaitingQueries() < 1) {
+    std::this_thread::sleep_for(1ms);
+  }
+  // Small queries overtake the large one only a limited number of times.
+  for (size_t i = 0; i < ADMISSION_MAX_NUM_OVERTAKES; ++i) {
+    ASSERT_TRUE(controller.admit(10, 0ms).has_value());
+  }
+  ASSERT_FALSE(controller.admit(10, 10ms).has_value());
+  running.reset();
+  ASSERT_TRUE(large.get().has_value());
+}
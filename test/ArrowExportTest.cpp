@@ -0,0 +1,272 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../src/engine/QueryExecutionTree.h"
+#include "../src/util/ArrowIpc.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+template <typename T>
+T read(const std::string& bytes, size_t position) {
+  T value;
+  std::memcpy(&value, bytes.data() + position, sizeof(T));
+  return value;
+}
+
+// A table of a FlatBuffer at `position` in the `bytes`.
+class FlatTable {
+ public:
+  FlatTable(const std::string& bytes, size_t position)
+      : _bytes{&bytes}, _position{position} {}
+
+  // The scalar field with the ID `i`, or `defaultValue` if it is absent.
+  template <typename T>
+  T scalar(size_t i, T defaultValue = 0) const {
+    auto position = field(i);
+    return position ? read<T>(*_bytes, *position) : defaultValue;
+  }
+
+  // The table that the field with the ID `i` refers to.
+  FlatTable table(size_t i) const { return {*_bytes, reference(i)}; }
+
+  // The vector of `Buffer` or `FieldNode` structs that the field with the ID
+  // `i` refers to.
+  std::vector<std::pair<int64_t, int64_t>> structs(size_t i) const {
+    const size_t vector = reference(i);
+    std::vector<std::pair<int64_t, int64_t>> result;
+    for (uint32_t j = 0; j < read<uint32_t>(*_bytes, vector); ++j) {
+      result.emplace_back(read<int64_t>(*_bytes, vector + 4 + 16 * j),
+                          read<int64_t>(*_bytes, vector + 12 + 16 * j));
+    }
+    return result;
+  }
+
+ private:
+  std::optional<size_t> field(size_t i) const {
+    const size_t vtable = _position - read<int32_t>(*_bytes, _position);
+    if (4 + 2 * i >= read<uint16_t>(*_bytes, vtable)) {
+      return std::nullopt;
+    }
+    const auto offset = read<uint16_t>(*_bytes, vtable + 4 + 2 * i);
+    if (offset == 0) {
+      return std::nullopt;
+    }
+    return _position + offset;
+  }
+
+  size_t reference(size_t i) const {
+    const size_t position = field(i).value();
+    return position + read<uint32_t>(*_bytes, position);
+  }
+
+  const std::string* _bytes;
+  size_t _position;
+};
+
+// A dictionary batch or record batch of a stream.
+struct Batch {
+  bool _isDictionary;
+  int64_t _dictionaryId = -1;
+  bool _isDelta = false;
+  int64_t _length;
+  std::vector<std::pair<int64_t, int64_t>> _nodes;
+  std::vector<std::pair<int64_t, int64_t>> _buffers;
+  std::string _body;
+
+  // The value of `row` in the `column` of a record batch, `std::nullopt` if it
+  // is null.
+  template <typename T>
+  std::optional<T> value(size_t column, size_t row) const {
+    const auto [validityOffset, validitySize] = _buffers[2 * column];
+    if (validitySize > 0 &&
+        !(_body[validityOffset + row / 8] & (1 << (row % 8)))) {
+      return std::nullopt;
+    }
+    return read<T>(_body, _buffers[2 * column + 1].first + row * sizeof(T));
+  }
+
+  // The strings of a dictionary batch.
+  std::vector<std::string> strings() const {
+    std::vector<std::string> result;
+    for (int64_t i = 0; i < _length; ++i) {
+      const auto begin = read<int32_t>(_body, _buffers[1].first + 4 * i);
+      const auto end = read<int32_t>(_body, _buffers[1].first + 4 * (i + 1));
+      result.push_back(_body.substr(_buffers[2].first + begin, end - begin));
+    }
+    return result;
+  }
+};
+
+// Decode the messages of the `stream` after the schema, which must end with
+// the end-of-stream marker.
+std::vector<Batch> decodeStream(const std::string& stream) {
+  std::vector<Batch> batches;
+  size_t position = 0;
+  bool isFirstMessage = true;
+  while (true) {
+    EXPECT_EQ(0xFFFFFFFF, read<uint32_t>(stream, position));
+    const auto metadataSize = read<int32_t>(stream, position + 4);
+    if (metadataSize == 0) {
+      EXPECT_EQ(stream.size(), position + 8);
+      return batches;
+    }
+    const std::string metadata = stream.substr(position + 8, metadataSize);
+    const FlatTable message{metadata, read<uint32_t>(metadata, 0)};
+    const auto headerType = message.scalar<uint8_t>(1);
+    const auto bodyLength = message.scalar<int64_t>(3);
+    const std::string body =
+        stream.substr(position + 8 + metadataSize, bodyLength);
+    position += 8 + metadataSize + bodyLength;
+    if (isFirstMessage) {
+      EXPECT_EQ(ad_utility::arrow::detail::SCHEMA, headerType);
+      isFirstMessage = false;
+      continue;
+    }
+    Batch batch;
+    batch._isDictionary =
+        headerType == ad_utility::arrow::detail::DICTIONARY_BATCH;
+    FlatTable recordBatch = message.table(2);
+    if (batch._isDictionary) {
+      batch._dictionaryId = recordBatch.scalar<int64_t>(0);
+      batch._isDelta = recordBatch.scalar<uint8_t>(2) != 0;
+      recordBatch = recordBatch.table(1);
+    } else {
+      EXPECT_EQ(ad_utility::arrow::detail::RECORD_BATCH, headerType);
+    }
+    batch._length = recordBatch.scalar<int64_t>(0);
+    batch._nodes = recordBatch.structs(1);
+    batch._buffers = recordBatch.structs(2);
+    batch._body = body;
+    batches.push_back(std::move(batch));
+  }
+}
+
+Id floatId(float value) {
+  Id id = 0;
+  std::memcpy(&id, &value, sizeof(value));
+  return id;
+}
+}  // namespace
+
+TEST(ArrowExportTest, multipleBatches) {
+  using ResultType = ResultTable::ResultType;
+  auto result = std::make_shared<ResultTable>(allocator());
+  *result->_localVocab = {"a", "b", "c", "d"};
+  result->_resultTypes = {ResultType::LOCAL_VOCAB, ResultType::VERBATIM,
+                          ResultType::FLOAT};
+  // The local vocabulary has no entry for the `Id` 10.
+  const std::vector<Id> strings{0, 1, 0, 2, ID_NO_VALUE, 10, 1, 0, 1, 3};
+  result->_idTable.setCols(3);
+  for (size_t i = 0; i < strings.size(); ++i) {
+    result->_idTable.push_back({strings[i], i == 4 ? ID_NO_VALUE : 10 * i,
+                                i == 7 ? ID_NO_VALUE : floatId(i + 0.5f)});
+  }
+  using Column = QueryExecutionTree::VariableAndColumnIndex;
+  QueryExecutionTree::ColumnIndicesAndTypes columns{
+      Column{"?s", 0, ResultType::LOCAL_VOCAB},
+      Column{"?n", 1, ResultType::VERBATIM},
+      Column{"?f", 2, ResultType::FLOAT}, std::nullopt};
+
+  QueryExecutionTree qet{nullptr};
+  auto generator = qet.writeArrowBatches(
+      {"?s", "?n", "?f", "?missing"}, columns,
+      std::numeric_limits<size_t>::max(), 0, result, 3);
+  std::string stream;
+  while (generator.hasNext()) {
+    stream += generator.next();
+  }
+  const std::vector<Batch> batches = decodeStream(stream);
+
+  // The first dictionary of a column is complete, the following ones are
+  // deltas with the new values, and are only sent if there are new values
+  // (not before the third record batch). The column of the missing variable
+  // has an empty dictionary.
+  using Dictionary = std::tuple<int64_t, bool, std::vector<std::string>>;
+  std::vector<Dictionary> dictionaries;
+  std::vector<size_t> recordBatchLengths;
+  std::vector<std::string> dictionary;
+  std::vector<std::optional<std::string>> s;
+  std::vector<std::optional<int64_t>> n;
+  std::vector<std::optional<float>> f;
+  for (const Batch& batch : batches) {
+    if (batch._isDictionary) {
+      dictionaries.emplace_back(batch._dictionaryId, batch._isDelta,
+                                batch.strings());
+      if (batch._dictionaryId == 0) {
+        for (auto& value : batch.strings()) {
+          dictionary.push_back(value);
+        }
+      }
+      continue;
+    }
+    recordBatchLengths.push_back(batch._length);
+    ASSERT_EQ(4u, batch._nodes.size());
+    ASSERT_EQ(8u, batch._buffers.size());
+    // The missing variable has only nulls.
+    ASSERT_EQ(batch._length, batch._nodes[3].second);
+    for (int64_t row = 0; row < batch._length; ++row) {
+      auto index = batch.value<int32_t>(0, row);
+      s.push_back(index ? std::optional{dictionary.at(*index)} : std::nullopt);
+      n.push_back(batch.value<int64_t>(1, row));
+      f.push_back(batch.value<float>(2, row));
+      ASSERT_FALSE(batch.value<int32_t>(3, row).has_value());
+    }
+  }
+  ASSERT_EQ((std::vector<Dictionary>{{0, false, {"a", "b"}},
+                                      {3, false, {}},
+                                      {0, true, {"c"}},
+                                      {0, true, {"d"}}}),
+            dictionaries);
+  ASSERT_EQ((std::vector<size_t>{3, 3, 3, 1}), recordBatchLengths);
+  // The record batches follow the dictionaries that they need.
+  std::vector<bool> isDictionary;
+  for (const Batch& batch : batches) {
+    isDictionary.push_back(batch._isDictionary);
+  }
+  ASSERT_EQ((std::vector<bool>{true, true, false, true, false, false, true,
+                               false}),
+            isDictionary);
+
+  ASSERT_EQ(strings.size(), s.size());
+  for (size_t i = 0; i < strings.size(); ++i) {
+    if (strings[i] < 4) {
+      ASSERT_EQ(std::string(1, 'a' + strings[i]), s[i]);
+    } else {
+      ASSERT_FALSE(s[i].has_value());
+    }
+    ASSERT_EQ(i == 4 ? std::nullopt : std::optional<int64_t>(10 * i), n[i]);
+    ASSERT_EQ(i == 7 ? std::nullopt : std::optional<float>(i + 0.5f), f[i]);
+  }
+
+  // With an offset and a limit.
+  auto limited = qet.writeArrowBatches({"?s", "?n", "?f", "?missing"},
+                                       columns, 4, 5, result, 3);
+  stream.clear();
+  while (limited.hasNext()) {
+    stream += limited.next();
+  }
+  std::vector<int64_t> lengths;
+  for (const Batch& batch : decodeStream(stream)) {
+    if (!batch._isDictionary) {
+      lengths.push_back(batch._length);
+    }
+  }
+  ASSERT_EQ((std::vector<int64_t>{3, 1}), lengths);
+}
@@ -0,0 +1,106 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "../src/util/ArrowIpc.h"
+
+using namespace ad_utility::arrow;
+
+namespace {
+template <typename T>
+T read(const std::string& bytes, size_t position) {
+  T value;
+  std::memcpy(&value, bytes.data() + position, sizeof(T));
+  return value;
+}
+
+// Check the framing of the `message` and return the size of its metadata.
+size_t checkFraming(const std::string& message, size_t bodyLength) {
+  EXPECT_EQ(0xFFFFFFFF, read<uint32_t>(message, 0));
+  const auto metadataSize = read<int32_t>(message, 4);
+  EXPECT_EQ(0, metadataSize % 8);
+  EXPECT_EQ(8 + metadataSize + bodyLength, message.size());
+  return metadataSize;
+}
+}  // namespace
+
+TEST(ArrowIpcTest, column) {
+  Column column{ColumnType::Int64};
+  column.append<int64_t>(3);
+  column.appendNull();
+  for (int64_t i = 0; i < 8; ++i) {
+    column.append(i);
+  }
+  ASSERT_EQ(10u, column.size());
+  ASSERT_EQ(1u, column.nullCount());
+  ASSERT_EQ(10 * sizeof(int64_t), column.values().size());
+  ASSERT_EQ(3, read<int64_t>(column.values(), 0));
+  ASSERT_EQ(0, read<int64_t>(column.values(), 8));
+  ASSERT_EQ(7, read<int64_t>(column.values(), 72));
+  ASSERT_EQ(std::string("\xFD\x03", 2), column.validity());
+  ASSERT_ANY_THROW(column.append(1.0f));
+
+  column.clear();
+  ASSERT_EQ(0u, column.size());
+  ASSERT_EQ(0u, column.nullCount());
+  ASSERT_TRUE(column.validity().empty());
+
+  Column floats{ColumnType::Float32};
+  floats.appendNull();
+  floats.append(2.5f);
+  ASSERT_EQ(2 * sizeof(float), floats.values().size());
+  ASSERT_EQ(2.5f, read<float>(floats.values(), 4));
+}
+
+TEST(ArrowIpcTest, dictionaryValues) {
+  DictionaryValues values;
+  ASSERT_EQ(0u, values.size());
+  values.append("<a>");
+  values.append("");
+  values.append("\"b\"@en");
+  ASSERT_EQ(3u, values.size());
+  ASSERT_EQ((std::vector<int32_t>{0, 3, 3, 9}), values.offsets());
+  ASSERT_EQ("<a>\"b\"@en", values.data());
+  values.clear();
+  ASSERT_EQ(0u, values.size());
+  ASSERT_EQ((std::vector<int32_t>{0}), values.offsets());
+}
+
+TEST(ArrowIpcTest, messages) {
+  const std::string schema = schemaMessage(
+      {{"?x", ColumnType::Utf8Dictionary}, {"?n", ColumnType::Int64}});
+  checkFraming(schema, 0);
+  ASSERT_NE(std::string::npos, schema.find(std::string("?x\0", 3)));
+  ASSERT_NE(std::string::npos, schema.find(std::string("?n\0", 3)));
+
+  DictionaryValues values;
+  values.append("<a>");
+  const std::string dictionary = dictionaryBatchMessage(0, values, false);
+  // The empty validity, the two offsets and the three bytes, each padded to a
+  // multiple of 8 bytes.
+  checkFraming(dictionary, 16);
+  ASSERT_EQ("<a>", dictionary.substr(dictionary.size() - 8, 3));
+
+  std::vector<Column> columns{Column{ColumnType::Utf8Dictionary},
+                              Column{ColumnType::Int64}};
+  columns[0].append<int32_t>(0);
+  columns[0].appendNull();
+  columns[1].append<int64_t>(42);
+  columns[1].append<int64_t>(43);
+  const std::string batch = recordBatchMessage(columns);
+  // The validity of the first column and the values of both columns, the
+  // second column has no validity because it has no nulls.
+  const size_t metadataSize = checkFraming(batch, 8 + 8 + 16);
+  ASSERT_EQ(42, read<int64_t>(batch, 8 + metadataSize + 16));
+  ASSERT_EQ(43, read<int64_t>(batch, 8 + metadataSize + 24));
+
+  columns[1].append<int64_t>(44);
+  ASSERT_ANY_THROW(recordBatchMessage(columns));
+
+  ASSERT_EQ(std::string("\xFF\xFF\xFF\xFF\0\0\0\0", 8), END_OF_STREAM);
+}
@@ -41,6 +41,22 @@ TEST(FlexibleCacheTest, LRUSimple) {
   ASSERT_TRUE(cache.contains("2"));
 }
 namespace ad_utility {
+// _____________________________________________________________________________
+TEST(LRUCacheTest, erase) {
+  LRUCache<string, string> cache(5, 10000, 10000);
+  cache.insert("1", "x");
+  cache.insert("2", "xx");
+  cache.insertPinned("3", "xxx");
+  cache.erase("1");
+  cache.erase("3");
+  cache.erase("non-existant");
+  ASSERT_FALSE(cache.contains("1"));
+  ASSERT_FALSE(cache.contains("3"));
+  ASSERT_TRUE(cache.contains("2"));
+  ASSERT_EQ(2u, cache.nonPinnedSize());
+  ASSERT_EQ(0u, cache.pinnedSize());
+}
+
 // _____________________________________________________________________________
 TEST(LRUCacheTest, testSimpleMapUsage) {
   LRUCache<string, string> cache(5, 10000, 10000);
@@ -128,3 +144,99 @@ TEST(LRUCacheTest, testDecreasingCapacity) {
   ASSERT_FALSE(cache["4"]);
 }
 }  // namespace ad_utility
+
+namespace {
+// A cache value with a given cost of recomputation and size.
+struct CostAndSize {
+  double _cost;
+  size_t _size;
+  size_t size() const { return _size; }
+};
+struct CostGetter {
+  double operator()(const CostAndSize& value) const { return value._cost; }
+};
+using TestPolicyCache =
+    ad_utility::PolicyCache<string, CostAndSize, CostGetter>;
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(PolicyCacheTest, lru) {
+  TestPolicyCache cache{ad_utility::EvictionPolicy::LRU, 3};
+  ASSERT_EQ(ad_utility::EvictionPolicy::LRU, cache.evictionPolicy());
+  cache.insert("1", {100, 1});
+  cache.insert("2", {1, 1});
+  cache.insert("3", {1, 1});
+  ASSERT_TRUE(cache["1"]);
+  cache.insert("4", {1, 1});
+  ASSERT_TRUE(cache.contains("1"));
+  ASSERT_FALSE(cache.contains("2"));
+  ASSERT_TRUE(cache.contains("3"));
+  ASSERT_TRUE(cache.contains("4"));
+}
+
+// _____________________________________________________________________________
+TEST(PolicyCacheTest, gdsfCostAndSize) {
+  TestPolicyCache cache{ad_utility::EvictionPolicy::GDSF, 3};
+  ASSERT_EQ(ad_utility::EvictionPolicy::GDSF, cache.evictionPolicy());
+  // Scores 100, 1 and 0.1.
+  cache.insert("expensive", {100, 1});
+  cache.insert("cheap", {1, 1});
+  cache.insert("large", {10, 100});
+  // The large result has the lowest cost per size although it is the most
+  // recently used one.
+  cache.insert("new", {5, 1});
+  ASSERT_TRUE(cache.contains("expensive"));
+  ASSERT_TRUE(cache.contains("cheap"));
+  ASSERT_FALSE(cache.contains("large"));
+  ASSERT_TRUE(cache.contains("new"));
+}
+
+// _____________________________________________________________________________
+TEST(PolicyCacheTest, gdsfFrequency) {
+  TestPolicyCache cache{ad_utility::EvictionPolicy::GDSF, 2};
+  cache.insert("frequent", {1, 1});
+  cache.insert("once", {3, 1});
+  // After three more accesses, the score of "frequent" is 4.
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(cache["frequent"]);
+  }
+  cache.insert("new", {2, 1});
+  ASSERT_TRUE(cache.contains("frequent"));
+  ASSERT_FALSE(cache.contains("once"));
+  ASSERT_TRUE(cache.contains("new"));
+}
+
+// _____________________________________________________________________________
+TEST(PolicyCacheTest, gdsfAging) {
+  TestPolicyCache cache{ad_utility::EvictionPolicy::GDSF, 2};
+  cache.insert("old", {100, 1});
+  // Each eviction raises the clock to the score of the evicted entry, so newer
+  // entries eventually have a higher score than an expensive entry that is
+  // no longer used.
+  cache.insert("1", {60, 1});
+  cache.insert("2", {60, 1});
+  ASSERT_TRUE(cache.contains("old"));
+  ASSERT_FALSE(cache.contains("1"));
+  cache.insert("3", {60, 1});
+  ASSERT_FALSE(cache.contains("old"));
+  ASSERT_TRUE(cache.contains("2"));
+  ASSERT_TRUE(cache.contains("3"));
+
+  // Removing entries to make room also raises the clock.
+  cache.makeRoomAsMuchAsPossible(1);
+  ASSERT_EQ(1u, cache.numNonPinnedEntries());
+  cache.insert("4", {1, 1});
+  cache.insert("5", {1, 1});
+  ASSERT_FALSE(cache.contains("4"));
+}
+
+// _____________________________________________________________________________
+TEST(PolicyCacheTest, evictionPolicyFromString) {
+  using ad_utility::EvictionPolicy;
+  for (auto policy : {EvictionPolicy::LRU, EvictionPolicy::GDSF}) {
+    ASSERT_EQ(policy,
+              ad_utility::evictionPolicyFromString(toString(policy)));
+  }
+  ASSERT_THROW(ad_utility::evictionPolicyFromString("lfu"),
+               std::runtime_error);
+}
@@ -0,0 +1,211 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include "../src/engine/ColumnKernels.h"
+#include "../src/engine/Engine.h"
+#include "../src/engine/IdTable.h"
+
+using columnKernels::ColumnView;
+using columnKernels::SelectionVector;
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+// The expected result of `selectInRange`, computed with a plain loop.
+SelectionVector expectedSelection(const ColumnView& column, size_t begin,
+                                  size_t end, Id lower, Id upper,
+                                  bool inverse) {
+  SelectionVector result;
+  for (size_t i = begin; i < end; ++i) {
+    bool inRange = lower <= column[i] && column[i] <= upper;
+    if (inRange != inverse) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST(ColumnKernelsTest, selectInRangeContiguous) {
+  // 37 is not divisible by the vector widths, so the tail is also tested.
+  std::vector<Id> values;
+  for (size_t i = 0; i < 37; ++i) {
+    values.push_back((i * 7) % 23);
+  }
+  ColumnView column{values.data(), values.size(), 1};
+  ASSERT_TRUE(column.isContiguous());
+
+  for (bool inverse : {false, true}) {
+    SelectionVector selection;
+    columnKernels::selectInRange(column, 0, values.size(), 5, 12, inverse,
+                                 &selection);
+    ASSERT_EQ(expectedSelection(column, 0, values.size(), 5, 12, inverse),
+              selection);
+
+    selection.clear();
+    columnKernels::selectInRange(column, 3, 30, 5, 12, inverse, &selection);
+    ASSERT_EQ(expectedSelection(column, 3, 30, 5, 12, inverse), selection);
+  }
+}
+
+TEST(ColumnKernelsTest, selectInRangeStrided) {
+  IdTable table{3, allocator()};
+  for (size_t i = 0; i < 41; ++i) {
+    table.push_back({i, (i * 5) % 17, 100 - i});
+  }
+  for (size_t col = 0; col < 3; ++col) {
+    auto column = columnKernels::getColumn(table, col);
+    ASSERT_EQ(3u, column.stride());
+    ASSERT_EQ(41u, column.size());
+    for (bool inverse : {false, true}) {
+      SelectionVector selection;
+      columnKernels::selectInRange(column, 0, table.size(), 4, 80, inverse,
+                                   &selection);
+      ASSERT_EQ(expectedSelection(column, 0, table.size(), 4, 80, inverse),
+                selection);
+    }
+  }
+}
+
+TEST(ColumnKernelsTest, selectInRangeExtremeValues) {
+  // The kernels have to compare the Ids as unsigned values.
+  constexpr Id max = std::numeric_limits<Id>::max();
+  std::vector<Id> values{0, 1, max, max - 1, Id{1} << 63, (Id{1} << 63) - 1,
+                         42, 0, max, 17};
+  ColumnView column{values.data(), values.size(), 1};
+
+  SelectionVector selection;
+  columnKernels::selectInRange(column, 0, values.size(), 0, max, false,
+                               &selection);
+  ASSERT_EQ(values.size(), selection.size());
+
+  selection.clear();
+  columnKernels::selectInRange(column, 0, values.size(), Id{1} << 63, max,
+                               false, &selection);
+  ASSERT_EQ((SelectionVector{2, 3, 4, 8}), selection);
+
+  selection.clear();
+  columnKernels::selectInRange(column, 0, values.size(), 1, 42, true,
+                               &selection);
+  ASSERT_EQ((SelectionVector{0, 2, 3, 4, 5, 7, 8}), selection);
+
+  // An empty range.
+  selection.clear();
+  columnKernels::selectInRange(column, 0, values.size(), 5, 4, false,
+                               &selection);
+  ASSERT_TRUE(selection.empty());
+  columnKernels::selectInRange(column, 0, values.size(), 5, 4, true,
+                               &selection);
+  ASSERT_EQ(values.size(), selection.size());
+}
+
+TEST(ColumnKernelsTest, copyColumn) {
+  // 19 rows, so the tail after the vectorized part is also copied.
+  IdTable table{3, allocator()};
+  for (Id i = 0; i < 19; ++i) {
+    table.push_back({i, 100 + i, 200 + i});
+  }
+  for (size_t col = 0; col < 3; ++col) {
+    std::vector<Id> result(19, 0);
+    columnKernels::copyColumn(columnKernels::getColumn(table, col), 2, 19,
+                              result.data());
+    for (size_t i = 2; i < 19; ++i) {
+      ASSERT_EQ(table(i, col), result[i - 2]);
+    }
+    ASSERT_EQ(0u, result[17]);
+  }
+
+  std::vector<Id> contiguous{5, 6, 7, 8, 9};
+  std::vector<Id> result(3);
+  columnKernels::copyColumn(ColumnView{contiguous.data(), 5, 1}, 1, 4,
+                            result.data());
+  ASSERT_EQ((std::vector<Id>{6, 7, 8}), result);
+}
+
+TEST(ColumnKernelsTest, gatherRows) {
+  IdTable input{2, allocator()};
+  for (size_t i = 0; i < 10; ++i) {
+    input.push_back({i, 2 * i});
+  }
+  IdTable result{2, allocator()};
+  IdTableStatic<2> resultStatic = result.moveToStatic<2>();
+  columnKernels::gatherRows(input.asStaticView<2>(), SelectionVector{1, 4, 9},
+                            &resultStatic);
+  result = resultStatic.moveToDynamic();
+  ASSERT_EQ(3u, result.size());
+  ASSERT_EQ(1u, result(0, 0));
+  ASSERT_EQ(8u, result(1, 1));
+  ASSERT_EQ(9u, result(2, 0));
+  ASSERT_EQ(18u, result(2, 1));
+}
+
+TEST(ColumnKernelsTest, filterRange) {
+  // More rows than `FILTER_BLOCK_SIZE` to test the processing in blocks.
+  const size_t numRows = Engine::FILTER_BLOCK_SIZE * 2 + 123;
+  IdTable input{2, allocator()};
+  for (size_t i = 0; i < numRows; ++i) {
+    input.push_back({i, i % 100});
+  }
+
+  for (bool inverse : {false, true}) {
+    IdTable result{2, allocator()};
+    IdTableStatic<2> resultStatic = result.moveToStatic<2>();
+    Engine::filterRange(input.asStaticView<2>(), 1, 10, 19, inverse,
+                        &resultStatic);
+    result = resultStatic.moveToDynamic();
+
+    size_t expectedRow = 0;
+    for (size_t i = 0; i < numRows; ++i) {
+      bool inRange = i % 100 >= 10 && i % 100 <= 19;
+      if (inRange != inverse) {
+        ASSERT_LT(expectedRow, result.size());
+        ASSERT_EQ(i, result(expectedRow, 0));
+        ASSERT_EQ(i % 100, result(expectedRow, 1));
+        ++expectedRow;
+      }
+    }
+    ASSERT_EQ(expectedRow, result.size());
+  }
+}
+
+TEST(ColumnKernelsTest, gallopLowerBound) {
+  // Sorted values with duplicates, stored in the second of three columns.
+  IdTable table{3, allocator()};
+  for (size_t i = 0; i < 1000; ++i) {
+    table.push_back({i, 2 * (i / 3), 0});
+  }
+  auto column = columnKernels::getColumn(table, 1);
+  std::vector<Id> values;
+  for (size_t i = 0; i < table.size(); ++i) {
+    values.push_back(column[i]);
+  }
+  ColumnView contiguous{values.data(), values.size(), 1};
+
+  for (size_t begin : {0ul, 1ul, 17ul, 500ul, 999ul, 1000ul}) {
+    for (Id value : {Id{0}, Id{1}, Id{2}, Id{100}, Id{101}, Id{665}, Id{666},
+                     Id{10000}}) {
+      size_t expected =
+          std::lower_bound(values.begin() + begin, values.end(), value) -
+          values.begin();
+      ASSERT_EQ(expected, columnKernels::gallopLowerBound(column, begin,
+                                                          values.size(), value))
+          << begin << ' ' << value;
+      ASSERT_EQ(expected, columnKernels::gallopLowerBound(
+                              contiguous, begin, values.size(), value))
+          << begin << ' ' << value;
+    }
+  }
+  // Restricted end.
+  ASSERT_EQ(50u, columnKernels::gallopLowerBound(contiguous, 0, 50, 500));
+  ASSERT_EQ(9u, columnKernels::countLess(contiguous, 0, 20, 5));
+}
@@ -0,0 +1,123 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../src/engine/IdTable.h"
+#include "../src/engine/SemiJoinFilter.h"
+#include "../src/index/CompressedRelation.h"
+#include "../src/index/ConstantsIndexBuilding.h"
+#include "../src/index/Permutations.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+constexpr size_t NUM_ROWS_PER_BLOCK =
+    BLOCKSIZE_COMPRESSED_METADATA / (2 * sizeof(Id));
+
+// The relations of the permutation: the small relations 1 and 2 share a
+// block, the large relation 3 is stored in three exclusive blocks. In the
+// large relation, each value of the second column occurs four times.
+const size_t NUM_ROWS_LARGE = 5 * NUM_ROWS_PER_BLOCK / 2;
+constexpr Id LARGE_BLOCK_1_FIRST_COL1 = NUM_ROWS_PER_BLOCK / 4;
+constexpr Id LARGE_BLOCK_2_FIRST_COL1 = 2 * NUM_ROWS_PER_BLOCK / 4;
+
+class CompressedRelationTest : public ::testing::Test {
+ protected:
+  const std::string _filename = "_compressedRelationTest.index.pso";
+  Permutation::PSO_T _pso{SortByPSO(), "PSO", ".pso", {1, 0, 2}};
+
+  void SetUp() override {
+    auto addRelation = [](CompressedRelationWriter& writer, Id col0Id,
+                          size_t numRows, size_t multiplicity) {
+      ad_utility::BufferedVector<std::array<Id, 2>> data{
+          std::numeric_limits<size_t>::max(), "_compressedRelationTest.buf"};
+      for (size_t i = 0; i < numRows; ++i) {
+        data.push_back({i / multiplicity, i + 7 * col0Id});
+      }
+      writer.addRelation(col0Id, data, numRows / multiplicity, false);
+    };
+    {
+      CompressedRelationWriter writer{ad_utility::File{_filename, "w"}};
+      addRelation(writer, 1, 20, 2);
+      addRelation(writer, 2, 30, 1);
+      addRelation(writer, 3, NUM_ROWS_LARGE, 4);
+      writer.finish();
+      for (const auto& metaData : writer.getFinishedMetaData()) {
+        _pso._meta.add(metaData);
+      }
+      _pso._meta.blockData() = writer.getFinishedBlocks();
+    }
+    ASSERT_EQ(4u, _pso._meta.blockData().size());
+    _pso._file.open(_filename, "r");
+    _pso._isLoaded = true;
+  }
+
+  void TearDown() override {
+    _pso._file.close();
+    ad_utility::deleteFile(_filename);
+  }
+
+  // Scan the relation `col0Id` with the `filter` and check that the result
+  // consists of exactly the rows of the unfiltered scan whose first column is
+  // contained in the filter, and that `expectedNumSkippedBlocks` blocks were
+  // skipped.
+  void testFilteredScan(Id col0Id, std::vector<Id> filterValues,
+                        size_t expectedNumSkippedBlocks) {
+    IdTable unfiltered{2, allocator()};
+    CompressedRelationMetaData::scan(col0Id, &unfiltered, _pso);
+    IdTable expected{2, allocator()};
+    for (const auto& row : unfiltered) {
+      if (std::binary_search(filterValues.begin(), filterValues.end(),
+                             row[0])) {
+        expected.push_back(row);
+      }
+    }
+
+    IdTable filtered{2, allocator()};
+    size_t numSkippedBlocks = CompressedRelationMetaData::scan(
+        col0Id, &filtered, _pso, SemiJoinFilter{filterValues, "test"});
+    ASSERT_EQ(expectedNumSkippedBlocks, numSkippedBlocks);
+    ASSERT_EQ(expected.size(), filtered.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected(i, 0), filtered(i, 0));
+      ASSERT_EQ(expected(i, 1), filtered(i, 1));
+    }
+  }
+};
+}  // namespace
+
+TEST_F(CompressedRelationTest, filteredScanOfLargeRelation) {
+  // Values from the first and the last block, the middle block is skipped.
+  testFilteredScan(3, {0, 5, LARGE_BLOCK_2_FIRST_COL1 + 11}, 1);
+  // The last value of the first and the first value of the second block.
+  testFilteredScan(3, {LARGE_BLOCK_1_FIRST_COL1 - 1, LARGE_BLOCK_1_FIRST_COL1},
+                   1);
+  // Values that are not contained in any of the blocks skip all of them.
+  testFilteredScan(3, {NUM_ROWS_LARGE, NUM_ROWS_LARGE + 1}, 3);
+  testFilteredScan(3, {}, 3);
+  // A filter that contains all the values skips no block.
+  std::vector<Id> all(NUM_ROWS_LARGE / 4);
+  std::iota(all.begin(), all.end(), 0);
+  testFilteredScan(3, all, 0);
+}
+
+TEST_F(CompressedRelationTest, filteredScanOfSmallRelation) {
+  // The block that is shared with other relations is never skipped.
+  testFilteredScan(1, {0, 3, 9}, 0);
+  testFilteredScan(2, {4, 29, 30}, 0);
+  testFilteredScan(1, {}, 0);
+  testFilteredScan(2, {1000}, 0);
+}
@@ -311,3 +311,21 @@ TEST(ConcurrentCache, abortPinned) {
   ASSERT_EQ(0ul, a.getStorage().wlock()->_inProgress.size());
   ASSERT_THROW(fut.get(), std::runtime_error);
 }
+
+TEST(ConcurrentCache, hitsAndMisses) {
+  SimpleConcurrentLruCache a{2ul};
+  ASSERT_EQ(0ul, a.numHits());
+  ASSERT_EQ(0ul, a.numMisses());
+  a.computeOnce(1, waiting_function("1"s, 0));
+  a.computeOnce(1, waiting_function("1"s, 0));
+  a.computeOncePinned(1, waiting_function("1"s, 0));
+  a.computeOnce(2, waiting_function("2"s, 0));
+  a.computeOnce(3, waiting_function("3"s, 0));
+  // Key 2 was evicted.
+  a.computeOnce(2, waiting_function("2"s, 0));
+  ASSERT_EQ(2ul, a.numHits());
+  ASSERT_EQ(4ul, a.numMisses());
+  ASSERT_THROW(a.computeOnce(4, wait_and_throw_function(0)),
+               std::runtime_error);
+  ASSERT_EQ(5ul, a.numMisses());
+}
@@ -0,0 +1,73 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "../src/engine/CsrGraph.h"
+
+namespace {
+std::vector<Id> successors(const csrGraph::Graph& graph, Id id) {
+  std::vector<Id> result;
+  size_t node = graph.node(id);
+  for (auto it = graph.successorsBegin(node); it != graph.successorsEnd(node);
+       ++it) {
+    result.push_back(graph.id(*it));
+  }
+  return result;
+}
+
+csrGraph::Graph makeGraph(const std::vector<std::array<Id, 2>>& edges) {
+  return csrGraph::Graph{edges.size(),
+                         [&edges](size_t i) { return edges[i][0]; },
+                         [&edges](size_t i) { return edges[i][1]; }};
+}
+}  // namespace
+
+TEST(CsrGraphTest, graph) {
+  auto graph =
+      makeGraph({{7, 3}, {3, 100}, {7, 1}, {7, 3}, {100, 7}, {1, 1}, {3, 1}});
+  ASSERT_EQ(4u, graph.numNodes());
+  // The nodes are numbered in the order of their ids.
+  ASSERT_EQ(0u, graph.node(1));
+  ASSERT_EQ(3u, graph.node(100));
+  ASSERT_EQ(Id{7}, graph.id(2));
+  ASSERT_EQ(csrGraph::Graph::NO_NODE, graph.node(5));
+  ASSERT_EQ(csrGraph::Graph::NO_NODE, graph.node(1000));
+  // Sorted and without the duplicate edge.
+  ASSERT_EQ((std::vector<Id>{1, 3}), successors(graph, 7));
+  ASSERT_EQ((std::vector<Id>{1, 100}), successors(graph, 3));
+  ASSERT_EQ((std::vector<Id>{1}), successors(graph, 1));
+  ASSERT_EQ((std::vector<Id>{7}), successors(graph, 100));
+
+  auto empty = makeGraph({});
+  ASSERT_EQ(0u, empty.numNodes());
+  ASSERT_EQ(csrGraph::Graph::NO_NODE, empty.node(0));
+}
+
+TEST(CsrGraphTest, traversal) {
+  // A chain 0 -> 1 -> 2 -> 3 with a shortcut 0 -> 2 and a cycle 3 -> 1.
+  auto graph = makeGraph({{0, 1}, {1, 2}, {2, 3}, {0, 2}, {3, 1}});
+  csrGraph::Traversal traversal{graph};
+  size_t numCheckedEdges = 0;
+  auto checkTimeout = [&numCheckedEdges](size_t n) { numCheckedEdges += n; };
+  auto reachable = [&](Id start, size_t minDist, size_t maxDist) {
+    std::vector<Id> result;
+    traversal.reachableNodes(
+        graph.node(start), minDist, maxDist,
+        [&](size_t node) { result.push_back(graph.id(node)); }, checkTimeout);
+    return result;
+  };
+  constexpr size_t inf = std::numeric_limits<size_t>::max();
+  // In the order of the distance from the start node.
+  ASSERT_EQ((std::vector<Id>{1, 2, 3}), reachable(0, 1, inf));
+  ASSERT_EQ((std::vector<Id>{1, 2}), reachable(0, 1, 1));
+  // 2 can also be reached on a path of length 3 (via the cycle).
+  ASSERT_EQ((std::vector<Id>{2, 3, 1}), reachable(0, 2, inf));
+  ASSERT_EQ((std::vector<Id>{3, 1}), reachable(0, 3, 3));
+  ASSERT_EQ((std::vector<Id>{2, 3, 1}), reachable(1, 1, inf));
+  ASSERT_EQ((std::vector<Id>{}), reachable(0, 1, 0));
+  ASSERT_GT(numCheckedEdges, 0u);
+}
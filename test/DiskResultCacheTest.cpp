@@ -0,0 +1,147 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "../src/engine/DiskResultCache.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+const std::string directory = "_diskResultCacheTest";
+
+// A result with `numRows` rows, two columns and a local vocabulary.
+ResultTable makeResult(size_t numRows) {
+  ResultTable result{allocator()};
+  result._idTable.setCols(2);
+  for (size_t i = 0; i < numRows; ++i) {
+    result._idTable.push_back({i, 3 * i % 7});
+  }
+  result._sortedBy = {0};
+  result._resultTypes = {qlever::ResultType::KB,
+                         qlever::ResultType::LOCAL_VOCAB};
+  *result._localVocab = {"a", "bc", "", "def"};
+  return result;
+}
+
+void expectEqual(const ResultTable& expected, const ResultTable& actual) {
+  ASSERT_EQ(expected._idTable, actual._idTable);
+  ASSERT_EQ(expected._sortedBy, actual._sortedBy);
+  ASSERT_EQ(expected._resultTypes, actual._resultTypes);
+  ASSERT_EQ(*expected._localVocab, *actual._localVocab);
+}
+}  // namespace
+
+TEST(DiskResultCacheTest, writeAndRead) {
+  std::filesystem::remove_all(directory);
+  auto expected = makeResult(1000);
+  {
+    DiskResultCache cache{directory, 1ull << 30, "index"};
+    cache.write("key", expected, 42.5);
+    ASSERT_EQ(1u, cache.numEntries());
+    ASSERT_GT(cache.size(), 0u);
+    // Writing the same key again does nothing.
+    cache.write("key", makeResult(10), 1.0);
+    ASSERT_EQ(1u, cache.numEntries());
+
+    ResultTable result{allocator()};
+    ASSERT_EQ(42.5, cache.read("key", &result));
+    expectEqual(expected, result);
+    ResultTable missing{allocator()};
+    ASSERT_FALSE(cache.read("otherKey", &missing));
+  }
+
+  // The results survive a restart, but only for the same index.
+  {
+    DiskResultCache cache{directory, 1ull << 30, "index"};
+    ASSERT_EQ(1u, cache.numEntries());
+    ResultTable result{allocator()};
+    ASSERT_EQ(42.5, cache.read("key", &result));
+    expectEqual(expected, result);
+  }
+  {
+    DiskResultCache cache{directory, 1ull << 30, "rebuiltIndex"};
+    ResultTable result{allocator()};
+    ASSERT_FALSE(cache.read("key", &result));
+    cache.clear();
+    ASSERT_EQ(0u, cache.numEntries());
+    ASSERT_EQ(0u, cache.size());
+  }
+  ASSERT_TRUE(std::filesystem::is_empty(directory));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(DiskResultCacheTest, quota) {
+  std::filesystem::remove_all(directory);
+  size_t fileSize;
+  {
+    DiskResultCache cache{directory, 1ull << 30, "index"};
+    cache.write("size", makeResult(100), 1.0);
+    fileSize = cache.size();
+    cache.clear();
+  }
+  // Space for two of the results.
+  DiskResultCache cache{directory, 2 * fileSize + fileSize / 2, "index"};
+  cache.write("1", makeResult(100), 1.0);
+  cache.write("2", makeResult(100), 1.0);
+  ResultTable result{allocator()};
+  ASSERT_TRUE(cache.read("1", &result));
+  // Evicts the least recently used result "2".
+  cache.write("3", makeResult(100), 1.0);
+  ASSERT_EQ(2u, cache.numEntries());
+  ASSERT_LE(cache.size(), 2 * fileSize + fileSize / 2);
+  for (const auto& [key, isContained] :
+       {std::pair{"1", true}, {"2", false}, {"3", true}}) {
+    ResultTable r{allocator()};
+    ASSERT_EQ(isContained, cache.read(key, &r).has_value());
+  }
+
+  // Results that are larger than the quota are not written.
+  cache.write("large", makeResult(100'000), 1.0);
+  ResultTable large{allocator()};
+  ASSERT_FALSE(cache.read("large", &large));
+  for (const auto& file : std::filesystem::directory_iterator(directory)) {
+    ASSERT_EQ(".result", file.path().extension());
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(DiskResultCacheTest, corruptFile) {
+  std::filesystem::remove_all(directory);
+  DiskResultCache cache{directory, 1ull << 30, "index"};
+  cache.write("key", makeResult(100), 1.0);
+  for (const auto& file : std::filesystem::directory_iterator(directory)) {
+    std::filesystem::resize_file(file.path(), 20);
+  }
+  ResultTable result{allocator()};
+  ASSERT_FALSE(cache.read("key", &result));
+  ASSERT_EQ(0u, cache.numEntries());
+  std::filesystem::remove_all(directory);
+}
+
+TEST(DiskResultCacheTest, writeInBackground) {
+  std::filesystem::remove_all(directory);
+  DiskResultCache cache{directory, 1ull << 30, "index"};
+  auto expected = std::make_shared<const ResultTable>(makeResult(100'000));
+  for (size_t i = 0; i < 3; ++i) {
+    cache.writeInBackground(std::to_string(i), expected, 1.0);
+  }
+  cache.waitForBackgroundWrites();
+  ASSERT_EQ(3u, cache.numEntries());
+  for (size_t i = 0; i < 3; ++i) {
+    ResultTable result{allocator()};
+    ASSERT_EQ(1.0, cache.read(std::to_string(i), &result));
+    expectEqual(*expected, result);
+  }
+  std::filesystem::remove_all(directory);
+}
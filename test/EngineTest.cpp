@@ -11,6 +11,7 @@
 #include "../src/engine/Engine.h"
 #include "../src/engine/Join.h"
 #include "../src/engine/OptionalJoin.h"
+#include "../src/util/OnDestruction.h"
 
 ad_utility::AllocatorWithLimit<Id>& allocator() {
   static ad_utility::AllocatorWithLimit<Id> a{
@@ -116,6 +117,101 @@ TEST(EngineTest, joinTest) {
   ASSERT_EQ(2u, res(1, 1));
 };
 
+TEST(EngineTest, gallopJoinTest) {
+  // The galloping join has to yield the same result as the merge join, also
+  // for duplicates on both sides and values beyond the end of the other side.
+  IdTable small(2, allocator());
+  IdTable large(3, allocator());
+  for (size_t i = 0; i < 20; ++i) {
+    small.push_back({(i / 2) * 997, i});
+  }
+  small.push_back({200000, 42});
+  for (size_t i = 0; i < 20000; ++i) {
+    large.push_back({i / 2, i, i + 1});
+  }
+  Join J{Join::InvalidOnlyForTestingJoinTag{}};
+  auto joinBoth = [&J](const IdTable& left, size_t jc1, const IdTable& right,
+                       size_t jc2, auto tag, auto leftWidth, auto rightWidth) {
+    constexpr int OUT_WIDTH = leftWidth + rightWidth - 1;
+    IdTableStatic<OUT_WIDTH> expected{left.cols() + right.cols() - 1,
+                                      allocator()};
+    IdTableStatic<OUT_WIDTH> gallop{left.cols() + right.cols() - 1,
+                                    allocator()};
+    auto l = left.asStaticView<leftWidth>();
+    auto r = right.asStaticView<rightWidth>();
+    J.doMergeJoin(l, jc1, {0, l.size(), 0, r.size()}, r, jc2, &expected);
+    Join::doGallopInnerJoin(tag, l, jc1, r, jc2, &gallop);
+    ASSERT_EQ(40u, expected.size());
+    ASSERT_EQ(expected.moveToDynamic(), gallop.moveToDynamic());
+  };
+  joinBoth(small, 0, large, 0, Join::RightLargerTag{},
+           std::integral_constant<int, 2>{}, std::integral_constant<int, 3>{});
+  joinBoth(large, 0, small, 0, Join::LeftLargerTag{},
+           std::integral_constant<int, 3>{}, std::integral_constant<int, 2>{});
+}
+
+TEST(EngineTest, parallelJoinTest) {
+  // Many duplicates in the join column, such that some of the splitters
+  // coincide and the partition boundaries have to respect equal keys.
+  IdTable a(2, allocator());
+  IdTable b(2, allocator());
+  for (size_t i = 0; i < 1000; ++i) {
+    a.push_back({i / 7, i});
+    b.push_back({i / 3, i + 5000});
+  }
+  b.push_back({10000, 1});
+  int lwidth = a.cols();
+  int rwidth = b.cols();
+  int reswidth = a.cols() + b.cols() - 1;
+  Join J{Join::InvalidOnlyForTestingJoinTag{}};
+
+  // The runtime parameters are shared by all tests, restore them at the end.
+  const size_t numThreadsBefore =
+      RuntimeParameters().get<"join-num-threads">();
+  const size_t minRowsPerThreadBefore =
+      RuntimeParameters().get<"join-min-rows-per-thread">();
+  ad_utility::OnDestruction restoreParameters{[&]() noexcept {
+    RuntimeParameters().set<"join-num-threads">(numThreadsBefore);
+    RuntimeParameters().set<"join-min-rows-per-thread">(
+        minRowsPerThreadBefore);
+  }};
+
+  RuntimeParameters().set<"join-num-threads">(1);
+  IdTable expected(reswidth, allocator());
+  CALL_FIXED_SIZE_3(lwidth, rwidth, reswidth, J.join, a, 0, b, 0, &expected);
+
+  RuntimeParameters().set<"join-min-rows-per-thread">(10);
+  for (size_t numThreads : {2ul, 3ul, 8ul, 500ul}) {
+    RuntimeParameters().set<"join-num-threads">(numThreads);
+    IdTable res(reswidth, allocator());
+    CALL_FIXED_SIZE_3(lwidth, rwidth, reswidth, J.join, a, 0, b, 0, &res);
+    ASSERT_EQ(expected, res);
+  }
+}
+
+TEST(EngineTest, computeJoinPartitions) {
+  std::vector<Id> left{1, 1, 1, 1, 2, 3, 5, 5, 8};
+  std::vector<Id> right{0, 1, 5, 5, 5, 6, 8, 9};
+  auto partitions = partitionedJoin::computePartitions(
+      left.size(), right.size(), [&](size_t i) { return left[i]; },
+      [&](size_t i) { return right[i]; }, 4);
+  ASSERT_FALSE(partitions.empty());
+  size_t previousLeftEnd = 0;
+  for (const auto& p : partitions) {
+    ASSERT_LT(p._leftBegin, p._leftEnd);
+    ASSERT_LT(p._rightBegin, p._rightEnd);
+    ASSERT_LE(previousLeftEnd, p._leftBegin);
+    // Equal keys are never split between two partitions.
+    if (p._leftBegin > 0) {
+      ASSERT_NE(left[p._leftBegin - 1], left[p._leftBegin]);
+    }
+    if (p._rightBegin > 0) {
+      ASSERT_NE(right[p._rightBegin - 1], right[p._rightBegin]);
+    }
+    previousLeftEnd = p._leftEnd;
+  }
+}
+
 TEST(EngineTest, optionalJoinTest) {
   IdTable a(3, allocator());
   a.push_back({4, 1, 2});
@@ -0,0 +1,162 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <limits>
+#include <string>
+
+#include "../src/engine/ExternalSort.h"
+#include "../src/util/OnDestruction.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+const std::string directory = "_externalSortTest";
+
+// Descending on column 1, ascending on column 0 for equal values.
+auto comparator = [](const auto& a, const auto& b) {
+  return a[1] != b[1] ? a[1] > b[1] : a[0] < b[0];
+};
+
+std::shared_ptr<const ResultTable> makeInput(size_t numRows) {
+  auto input = std::make_shared<ResultTable>(allocator());
+  input->_idTable.setCols(3);
+  for (size_t i = 0; i < numRows; ++i) {
+    input->_idTable.push_back({i, (i * 7919) % 101, 42});
+  }
+  return input;
+}
+
+IdTable sortInMemory(const IdTable& input) {
+  IdTable expected{input.cols(), allocator()};
+  expected.insert(expected.end(), input.begin(), input.end());
+  Engine::sort<3>(&expected, comparator);
+  return expected;
+}
+}  // namespace
+
+TEST(ExternalSortTest, externalSort) {
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  // Runs of a single row, runs that don't divide the input, and a single run.
+  for (size_t rowsPerRun : {1ul, 7ul, 1000ul, 20'000ul}) {
+    auto input = makeInput(10'000);
+    IdTable expected = sortInMemory(input->_idTable);
+    IdTable result{allocator()};
+    size_t numIdsToMakeRoomFor = 0;
+    std::weak_ptr<const ResultTable> weakInput = input;
+    externalSort::externalSort<3>(
+        std::move(input), &result, comparator, directory, rowsPerRun,
+        [&](size_t numIds) {
+          numIdsToMakeRoomFor = numIds;
+          // The input was released before.
+          ASSERT_TRUE(weakInput.expired());
+        });
+    ASSERT_EQ(30'000u, numIdsToMakeRoomFor);
+    ASSERT_EQ(expected, result) << rowsPerRun;
+    // The temporary files are deleted.
+    ASSERT_TRUE(std::filesystem::is_empty(directory));
+  }
+
+  IdTable result{allocator()};
+  externalSort::externalSort<3>(makeInput(0), &result, comparator, directory,
+                                10, [](size_t) {});
+  ASSERT_EQ(0u, result.size());
+  ASSERT_EQ(3u, result.cols());
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ExternalSortTest, dynamicWidth) {
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  auto input = makeInput(5'000);
+  IdTable expected = sortInMemory(input->_idTable);
+  IdTable result{allocator()};
+  externalSort::externalSort<0>(std::move(input), &result, comparator,
+                                directory, 300, [](size_t) {});
+  ASSERT_EQ(expected, result);
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ExternalSortTest, cancel) {
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  auto timer = std::make_shared<ad_utility::ConcurrentTimeoutTimer>(
+      ad_utility::TimeoutTimer::unlimited());
+  ASSERT_FALSE(timer->wlock()->hasTimedOut());
+  timer->wlock()->cancel("cancelled by the test");
+  ASSERT_TRUE(timer->wlock()->hasTimedOut());
+  ASSERT_EQ(0, timer->wlock()->remainingMicroseconds());
+
+  IdTable result{allocator()};
+  try {
+    externalSort::externalSort<3>(
+        makeInput(1000), &result, comparator, directory, 100, [](size_t) {},
+        [&timer]() { timer->wlock()->checkTimeoutAndThrow("Sort: "); });
+    FAIL() << "The sort was not cancelled";
+  } catch (const ad_utility::TimeoutException& e) {
+    ASSERT_EQ(std::string{"Sort: cancelled by the test"}, e.what());
+  }
+  // The temporary files of the runs are deleted.
+  ASSERT_TRUE(std::filesystem::is_empty(directory));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ExternalSortTest, sortInMemoryOrExternally) {
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  const std::string spillDirectoryBefore =
+      RuntimeParameters().get<"spill-directory">();
+  ad_utility::OnDestruction restoreSpillDirectory{[&]() noexcept {
+    RuntimeParameters().set<"spill-directory">(spillDirectoryBefore);
+  }};
+  RuntimeParameters().set<"spill-directory">(directory);
+  Index index;
+  Engine engine;
+  QueryResultCache cache;
+  QueryExecutionContext qec(index, engine, &cache, allocator(),
+                            SortPerformanceEstimator{});
+
+  // The input takes 4.8 MB of the 8 MB of the allocator, so there is neither
+  // enough memory for a copy of the input nor for a run of the default size.
+  ad_utility::AllocatorWithLimit<Id> smallAllocator{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(8 << 20)};
+  auto input = std::make_shared<ResultTable>(smallAllocator);
+  input->_idTable.setCols(3);
+  input->_idTable.resize(200'000);
+  for (size_t i = 0; i < 200'000; ++i) {
+    input->_idTable(i, 0) = i;
+    input->_idTable(i, 1) = (i * 7919) % 101;
+    input->_idTable(i, 2) = 42;
+  }
+  IdTable expected = sortInMemory(input->_idTable);
+  ASSERT_LT(smallAllocator.numFreeBytes(), 200'000 * 3 * sizeof(Id));
+
+  IdTable result{smallAllocator};
+  bool wasSpilled = false;
+  externalSort::sortInMemoryOrExternally<3>(
+      std::move(input), &result, comparator, &qec, [&]() {
+        wasSpilled = wasSpilled || !std::filesystem::is_empty(directory);
+      });
+  ASSERT_TRUE(wasSpilled);
+  ASSERT_EQ(expected, result);
+  ASSERT_TRUE(std::filesystem::is_empty(directory));
+
+  // With enough memory, the input is sorted in memory.
+  wasSpilled = false;
+  IdTable inMemory{allocator()};
+  externalSort::sortInMemoryOrExternally<3>(
+      makeInput(10'000), &inMemory, comparator, &qec, [&]() {
+        wasSpilled = wasSpilled || !std::filesystem::is_empty(directory);
+      });
+  ASSERT_FALSE(wasSpilled);
+  ASSERT_EQ(sortInMemory(makeInput(10'000)->_idTable), inMemory);
+  std::filesystem::remove_all(directory);
+}
@@ -538,3 +538,53 @@ TEST(IndexTest, scanTest) {
   remove("_testindex.index.pso");
   remove("_testindex.index.pos");
 };
+
+TEST(IndexTest, reachabilityIndexTest) {
+  string location = "./";
+  string tail = "";
+  writeStxxlConfigFile(location, tail);
+  string stxxlFileName = getStxxlDiskFileName(location, tail);
+
+  std::fstream f("_testtmp4.tsv", std::ios_base::out);
+  f << "<a>\t<sub>\t<b>\t.\n"
+       "<b>\t<sub>\t<c>\t.\n"
+       "<d>\t<sub>\t<c>\t.\n"
+       "<a>\t<other>\t<d>\t.";
+  f.close();
+  std::fstream settings("_testtmp4.settings.json", std::ios_base::out);
+  settings << "{\"reachability-index-predicates\": [\"<sub>\", \"<none>\"]}";
+  settings.close();
+
+  {
+    Index indexPrim;
+    indexPrim.setOnDiskBase("_testindex4");
+    indexPrim.setSettingsFile("_testtmp4.settings.json");
+    indexPrim.createFromFile<TsvParser>("_testtmp4.tsv");
+  }
+
+  Index index;
+  index.createFromOnDiskIndex("_testindex4");
+  ASSERT_EQ(nullptr, index.getReachabilityIndex("<other>"));
+  ASSERT_EQ(nullptr, index.getReachabilityIndex("<none>"));
+  const ReachabilityIndex* reachability = index.getReachabilityIndex("<sub>");
+  ASSERT_NE(nullptr, reachability);
+  Id a;
+  Id c;
+  Id d;
+  ASSERT_TRUE(index.getVocab().getId("<a>", &a));
+  ASSERT_TRUE(index.getVocab().getId("<c>", &c));
+  ASSERT_TRUE(index.getVocab().getId("<d>", &d));
+  ASSERT_TRUE(reachability->isReachable(a, c));
+  ASSERT_FALSE(reachability->isReachable(a, d));
+  size_t numReachable = 0;
+  reachability->forEachReachable(c, ReachabilityIndex::Direction::Backward,
+                                 [&numReachable](Id) { ++numReachable; });
+  ASSERT_EQ(3u, numReachable);
+
+  remove("_testtmp4.tsv");
+  remove("_testtmp4.settings.json");
+  remove("_testindex4.index.pso");
+  remove("_testindex4.index.pos");
+  remove("_testindex4.index.reachability");
+  std::remove(stxxlFileName.c_str());
+}
@@ -0,0 +1,175 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/engine/QueryExecutionTree.h"
+#include "nlohmann/json.hpp"
+
+using nlohmann::json;
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+json parse(ad_utility::stream_generator::stream_generator generator) {
+  std::string result;
+  while (generator.hasNext()) {
+    result += generator.next();
+  }
+  return json::parse(result);
+}
+
+Id floatId(float value) {
+  Id id = 0;
+  std::memcpy(&id, &value, sizeof(value));
+  return id;
+}
+
+// A result with an IRI, a literal with a language tag, a literal with a
+// datatype, a literal with escaped characters and an undefined value in the
+// local vocabulary column 0, and with a VERBATIM and a FLOAT column.
+std::shared_ptr<const ResultTable> makeResult() {
+  using ResultType = ResultTable::ResultType;
+  auto result = std::make_shared<ResultTable>(allocator());
+  *result->_localVocab = {"<http://example.org/a>", "\"chat\"@fr",
+                          "\"42\"^^<http://example.org/type>",
+                          "\"say \\\"hi\\\"\"\n"};
+  result->_resultTypes = {ResultType::LOCAL_VOCAB, ResultType::VERBATIM,
+                          ResultType::FLOAT};
+  result->_idTable.setCols(3);
+  const std::vector<Id> strings{0, 1, 2, 3, ID_NO_VALUE};
+  for (size_t i = 0; i < strings.size(); ++i) {
+    result->_idTable.push_back({strings[i], 7 * i, floatId(i + 0.5f)});
+  }
+  return result;
+}
+
+std::string typed(const std::string& value, const std::string& type) {
+  return '"' + value + "\"^^<" + type + '>';
+}
+
+using Column = QueryExecutionTree::VariableAndColumnIndex;
+const QueryExecutionTree::ColumnIndicesAndTypes columns{
+    Column{"?s", 0, ResultTable::ResultType::LOCAL_VOCAB},
+    Column{"?n", 1, ResultTable::ResultType::VERBATIM},
+    Column{"?f", 2, ResultTable::ResultType::FLOAT}};
+}  // namespace
+
+TEST(JsonExportTest, qleverJsonTable) {
+  QueryExecutionTree qet{nullptr};
+  auto withMissing = columns;
+  withMissing.push_back(std::nullopt);
+  json expected = json::array(
+      {json::array({"\"chat\"@fr", typed("7", XSD_INT_TYPE),
+                    typed("1.5", XSD_DECIMAL_TYPE), nullptr}),
+       json::array({"\"42\"^^<http://example.org/type>",
+                    typed("14", XSD_INT_TYPE), typed("2.5", XSD_DECIMAL_TYPE),
+                    nullptr})});
+  ASSERT_EQ(expected,
+            parse(qet.writeQLeverJsonTable(1, 2, withMissing, makeResult())));
+
+  // The undefined value is null, the escaped characters are kept.
+  json all = parse(qet.writeQLeverJsonTable(0, 10, withMissing, makeResult()));
+  ASSERT_EQ(5u, all.size());
+  ASSERT_EQ("<http://example.org/a>", all[0][0]);
+  ASSERT_EQ("\"say \\\"hi\\\"\"\n", all[3][0]);
+  ASSERT_TRUE(all[4][0].is_null());
+  ASSERT_EQ(typed("28", XSD_INT_TYPE), all[4][1]);
+
+  // No rows, and no columns.
+  ASSERT_EQ(json::array(),
+            parse(qet.writeQLeverJsonTable(5, 10, columns, makeResult())));
+  ASSERT_EQ(json::array({json::array()}),
+            parse(qet.writeQLeverJsonTable(0, 10, {}, makeResult())));
+}
+
+TEST(JsonExportTest, sparqlJsonBindings) {
+  QueryExecutionTree qet{nullptr};
+  json result = parse(qet.writeSparqlJsonBindings({"?s", "?n", "?f"}, columns,
+                                                  10, 0, makeResult()));
+  ASSERT_EQ((json{"?s", "?n", "?f"}), result["head"]["vars"]);
+  const json& bindings = result["results"]["bindings"];
+  ASSERT_EQ(5u, bindings.size());
+  ASSERT_EQ((json{{"type", "iri"}, {"value", "http://example.org/a"}}),
+            bindings[0]["?s"]);
+  ASSERT_EQ((json{{"type", "literal"}, {"value", "chat"}, {"xml:lang", "fr"}}),
+            bindings[1]["?s"]);
+  ASSERT_EQ((json{{"type", "literal"},
+                  {"value", "42"},
+                  {"datatype", "http://example.org/type"}}),
+            bindings[2]["?s"]);
+  ASSERT_EQ((json{{"type", "literal"}, {"value", "say \\\"hi\\\""}}),
+            bindings[3]["?s"]);
+  ASSERT_EQ((json{{"type", "literal"},
+                  {"value", "7"},
+                  {"datatype", XSD_INT_TYPE}}),
+            bindings[1]["?n"]);
+  ASSERT_EQ((json{{"type", "literal"},
+                  {"value", "0.5"},
+                  {"datatype", XSD_DECIMAL_TYPE}}),
+            bindings[0]["?f"]);
+  // An undefined value has no binding.
+  ASSERT_FALSE(bindings[4].contains("?s"));
+  ASSERT_EQ(2u, bindings[4].size());
+
+  // With an offset and a limit.
+  json limited = parse(qet.writeSparqlJsonBindings({"?s", "?n", "?f"},
+                                                   columns, 2, 3,
+                                                   makeResult()));
+  ASSERT_EQ(2u, limited["results"]["bindings"].size());
+  ASSERT_EQ(bindings[3], limited["results"]["bindings"][0]);
+  ASSERT_EQ(json::array(),
+            parse(qet.writeSparqlJsonBindings({"?s", "?n", "?f"}, columns, 2,
+                                              5, makeResult()))["results"]
+                                                               ["bindings"]);
+
+  ASSERT_EQ(json::array({json::array()}),
+            parse(qet.writeSparqlJsonBindings({"?x"}, {}, 10, 0,
+                                              makeResult())));
+}
+
+TEST(JsonExportTest, rdfGraphJson) {
+  Index index;
+  Engine engine;
+  QueryResultCache cache;
+  QueryExecutionContext qec(index, engine, &cache, allocator(),
+                            SortPerformanceEstimator{});
+  QueryExecutionTree qet{&qec};
+  qet.setVariableColumn("?s", 0);
+  qet.setVariableColumn("?n", 1);
+  // The second triple has a variable that is not part of the result, so it
+  // is never written.
+  ad_utility::sparql_types::Triples triples{
+      {Variable{"?s"}, GraphTerm{Iri{"<http://example.org/p>"}},
+       Variable{"?n"}},
+      {Variable{"?s"}, GraphTerm{Iri{"<http://example.org/p>"}},
+       Variable{"?unbound"}}};
+
+  size_t numTriples = 0;
+  json result =
+      parse(qet.writeRdfGraphJson(triples, 3, 1, makeResult(), &numTriples));
+  ASSERT_EQ(3u, numTriples);
+  ASSERT_EQ(json::array({json::array({"\"chat\"@fr", "<http://example.org/p>",
+                                      "7"}),
+                         json::array({"\"42\"^^<http://example.org/type>",
+                                      "<http://example.org/p>", "14"}),
+                         json::array({"\"say \\\"hi\\\"\"\n",
+                                      "<http://example.org/p>", "21"})}),
+            result);
+
+  ASSERT_EQ(json::array(), parse(qet.writeRdfGraphJson(triples, 3, 5,
+                                                       makeResult(),
+                                                       &numTriples)));
+  ASSERT_EQ(0u, numTriples);
+}
@@ -0,0 +1,52 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "../src/util/JsonString.h"
+#include "nlohmann/json.hpp"
+
+using ad_utility::JsonString;
+
+namespace {
+std::string write(std::string_view value) {
+  std::ostringstream stream;
+  stream << JsonString{value};
+  return std::move(stream).str();
+}
+}  // namespace
+
+TEST(JsonStringTest, escapes) {
+  ASSERT_EQ(R"("")", write(""));
+  ASSERT_EQ(R"("plain")", write("plain"));
+  ASSERT_EQ(R"("a\"b\\c")", write(R"(a"b\c)"));
+  ASSERT_EQ(R"("\b\f\n\r\t")", write("\b\f\n\r\t"));
+  ASSERT_EQ(R"("x\u0000\u001fy")", write(std::string_view{"x\0\x1Fy", 4}));
+  ASSERT_EQ("\"<http://example.org/Gr\xC3\xBC\xC3\x9F\x65>\"",
+            write("<http://example.org/Gr\xC3\xBC\xC3\x9F\x65>"));
+  ASSERT_EQ("\"\xE2\x82\xAC\xF0\x9F\x98\x80\"",
+            write("\xE2\x82\xAC\xF0\x9F\x98\x80"));
+}
+
+TEST(JsonStringTest, invalidUtf8IsReplaced) {
+  const std::string replacement = "\xEF\xBF\xBD";
+  // A lone continuation byte, a truncated sequence, an overlong encoding and
+  // a surrogate.
+  ASSERT_EQ("\"a" + replacement + "b\"", write("a\x80" "b"));
+  ASSERT_EQ("\"a" + replacement + "\"", write("a\xE2\x82"));
+  ASSERT_EQ("\"" + replacement + replacement + "\"", write("\xC0\xAF"));
+  ASSERT_EQ("\"" + replacement + replacement + replacement + "\"",
+            write("\xED\xA0\x80"));
+}
+
+TEST(JsonStringTest, sameAsNlohmannJson) {
+  for (std::string_view value :
+       {"\"quoted\" \\ \x7F", "tab\there", "\xC3\xA4\xC3\xB6\xC3\xBC",
+        "\x01\x02 control"}) {
+    ASSERT_EQ(nlohmann::json(std::string{value}).dump(), write(value));
+    ASSERT_EQ(value, nlohmann::json::parse(write(value)).get<std::string>());
+  }
+}
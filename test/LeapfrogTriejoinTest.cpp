@@ -0,0 +1,143 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../src/engine/IdTable.h"
+#include "../src/engine/LeapfrogTriejoin.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+using Edges = std::vector<std::array<Id, 2>>;
+
+// A sorted table without duplicates that contains the `edges`.
+IdTable createTable(Edges edges) {
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  IdTable result{2, allocator()};
+  for (const auto& [a, b] : edges) {
+    result.push_back({a, b});
+  }
+  return result;
+}
+
+std::vector<std::vector<Id>> toVector(const IdTable& table) {
+  std::vector<std::vector<Id>> result;
+  for (size_t row = 0; row < table.size(); ++row) {
+    std::vector<Id> r;
+    for (size_t col = 0; col < table.cols(); ++col) {
+      r.push_back(table(row, col));
+    }
+    result.push_back(std::move(r));
+  }
+  return result;
+}
+
+// The triangles (x, y, z) with (x, y) in `xy`, (y, z) in `yz` and (x, z) in
+// `xz`, computed with nested loops.
+std::vector<std::vector<Id>> bruteForceTriangles(const IdTable& xy,
+                                                 const IdTable& yz,
+                                                 const IdTable& xz) {
+  std::vector<std::vector<Id>> result;
+  for (size_t i = 0; i < xy.size(); ++i) {
+    for (size_t j = 0; j < yz.size(); ++j) {
+      if (xy(i, 1) != yz(j, 0)) {
+        continue;
+      }
+      for (size_t k = 0; k < xz.size(); ++k) {
+        if (xz(k, 0) == xy(i, 0) && xz(k, 1) == yz(j, 1)) {
+          result.push_back({xy(i, 0), xy(i, 1), yz(j, 1)});
+        }
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+}  // namespace
+
+TEST(LeapfrogTriejoinTest, triangle) {
+  // The variable order is x, y, z.
+  IdTable xy = createTable({{1, 2}, {1, 3}, {2, 3}, {3, 4}, {5, 6}});
+  IdTable yz = createTable({{2, 3}, {3, 4}, {3, 5}, {4, 1}, {6, 7}});
+  IdTable xz = createTable({{1, 3}, {1, 4}, {2, 4}, {2, 5}, {5, 8}});
+  IdTable result{3, allocator()};
+  LeapfrogTriejoin::computeLeapfrogTriejoin({&xy, &yz, &xz},
+                                            {{0, 1}, {1, 2}, {0, 2}}, 3,
+                                            &result);
+  std::vector<std::vector<Id>> expected{
+      {1, 2, 3}, {1, 3, 4}, {2, 3, 4}, {2, 3, 5}};
+  ASSERT_EQ(expected, toVector(result));
+  ASSERT_EQ(expected, bruteForceTriangles(xy, yz, xz));
+}
+
+TEST(LeapfrogTriejoinTest, randomTriangles) {
+  std::mt19937_64 rng{42};
+  for (Id numValues : {Id{5}, Id{20}, Id{200}}) {
+    std::uniform_int_distribution<Id> distribution{0, numValues - 1};
+    auto randomEdges = [&]() {
+      Edges edges;
+      for (size_t i = 0; i < 500; ++i) {
+        edges.push_back({distribution(rng), distribution(rng)});
+      }
+      return createTable(std::move(edges));
+    };
+    IdTable xy = randomEdges();
+    IdTable yz = randomEdges();
+    IdTable xz = randomEdges();
+    IdTable result{3, allocator()};
+    size_t numTimeoutChecks = 0;
+    LeapfrogTriejoin::computeLeapfrogTriejoin(
+        {&xy, &yz, &xz}, {{0, 1}, {1, 2}, {0, 2}}, 3, &result,
+        [&numTimeoutChecks]() { ++numTimeoutChecks; });
+    ASSERT_EQ(bruteForceTriangles(xy, yz, xz), toVector(result));
+    ASSERT_GT(numTimeoutChecks, 0u);
+  }
+}
+
+TEST(LeapfrogTriejoinTest, chainAndSingleColumnInputs) {
+  // ?x <p> ?y . ?y <q> ?z with a third input that restricts ?y.
+  IdTable xy = createTable({{1, 10}, {2, 10}, {2, 20}, {3, 30}});
+  IdTable yz = createTable({{10, 100}, {20, 200}, {20, 201}, {30, 300}});
+  IdTable y{1, allocator()};
+  y.push_back({10});
+  y.push_back({20});
+  IdTable result{3, allocator()};
+  LeapfrogTriejoin::computeLeapfrogTriejoin({&xy, &yz, &y},
+                                            {{0, 1}, {1, 2}, {1}}, 3, &result);
+  std::vector<std::vector<Id>> expected{
+      {1, 10, 100}, {2, 10, 100}, {2, 20, 200}, {2, 20, 201}};
+  ASSERT_EQ(expected, toVector(result));
+}
+
+TEST(LeapfrogTriejoinTest, extremeValuesAndEmptyInputs) {
+  // The trie iterators must not overflow when advancing past the largest Id.
+  constexpr Id max = std::numeric_limits<Id>::max();
+  IdTable xy = createTable({{0, max}, {max, 0}, {max, max}});
+  IdTable yz = createTable({{0, max}, {max, 0}, {max, max}});
+  IdTable xz = createTable({{0, 0}, {max, 0}, {max, max}});
+  IdTable result{3, allocator()};
+  LeapfrogTriejoin::computeLeapfrogTriejoin({&xy, &yz, &xz},
+                                            {{0, 1}, {1, 2}, {0, 2}}, 3,
+                                            &result);
+  ASSERT_EQ(bruteForceTriangles(xy, yz, xz), toVector(result));
+  ASSERT_EQ(4u, result.size());
+
+  IdTable empty{2, allocator()};
+  IdTable emptyResult{3, allocator()};
+  LeapfrogTriejoin::computeLeapfrogTriejoin({&xy, &yz, &empty},
+                                            {{0, 1}, {1, 2}, {0, 2}}, 3,
+                                            &emptyResult);
+  ASSERT_EQ(0u, emptyResult.size());
+}
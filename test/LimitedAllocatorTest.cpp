@@ -4,6 +4,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "../src/util/AllocatorWithLimit.h"
@@ -50,3 +53,100 @@ TEST(AllocatorWithLimit, vectorShared) {
   ASSERT_THROW(u.push_back(1),
                ad_utility::detail::AllocationExceedsLimitException);
 }
+
+TEST(AllocatorWithLimit, child) {
+  AllocatorWithLimit<int> parent(makeAllocationMemoryLeftThreadsafeObject(40));
+  auto child = parent.makeChild(24);
+  auto otherChild = parent.makeChild(24);
+  ASSERT_EQ(24u, child.numFreeBytes());
+
+  // The allocations of a child count towards its own limit and the limit of
+  // the parent.
+  auto ptr = child.allocate(4);
+  ASSERT_EQ(8u, child.numFreeBytes());
+  ASSERT_EQ(24u, parent.numFreeBytes());
+  ASSERT_THROW(child.allocate(3),
+               ad_utility::detail::AllocationExceedsLimitException);
+  ASSERT_EQ(24u, parent.numFreeBytes());
+
+  // The child is within its limit, but the parent is not.
+  auto otherPtr = otherChild.allocate(5);
+  ASSERT_THROW(otherChild.allocate(2),
+               ad_utility::detail::AllocationExceedsLimitException);
+  ASSERT_EQ(4u, otherChild.numFreeBytes());
+
+  child.deallocate(ptr, 4);
+  ASSERT_EQ(20u, parent.numFreeBytes());
+  // The free bytes of the child are limited by the parent.
+  ASSERT_EQ(20u, child.numFreeBytes());
+  otherChild.deallocate(otherPtr, 5);
+  ASSERT_EQ(40u, parent.numFreeBytes());
+}
+
+TEST(AllocatorWithLimit, childClearsOnlyForParent) {
+  auto memoryLeft = makeAllocationMemoryLeftThreadsafeObject(40);
+  size_t numClears = 0;
+  std::optional<AllocatorWithLimit<int>> parent;
+  int* cached = nullptr;
+  // Like the cache of the server, which frees memory of the parent.
+  parent.emplace(memoryLeft, [&](size_t) {
+    ++numClears;
+    if (cached) {
+      parent->deallocate(cached, 6);
+      cached = nullptr;
+    }
+  });
+  cached = parent->allocate(6);
+  auto child = parent->makeChild(20);
+
+  // Exceeding the limit of the child doesn't clear anything.
+  ASSERT_THROW(child.allocate(6),
+               ad_utility::detail::AllocationExceedsLimitException);
+  ASSERT_EQ(0u, numClears);
+  ASSERT_NE(nullptr, cached);
+
+  // Within the limit of the child, but the parent is short.
+  auto ptr = child.allocate(5);
+  ASSERT_EQ(1u, numClears);
+  ASSERT_EQ(nullptr, cached);
+  child.deallocate(ptr, 5);
+  ASSERT_EQ(40u, parent->numFreeBytes());
+}
+
+TEST(AllocatorWithLimit, hugePages) {
+  using ad_utility::HugePageMode;
+  using ad_utility::hugePages::HUGE_PAGE_SIZE;
+  for (auto mode : {HugePageMode::Transparent, HugePageMode::Explicit}) {
+    AllocatorWithLimit<char> allocator{
+        makeAllocationMemoryLeftThreadsafeObject(10 * HUGE_PAGE_SIZE),
+        ad_utility::noClearOnAllocation, mode};
+    ASSERT_EQ(mode, allocator.as<int>().getHugePageMode());
+    ASSERT_EQ(mode, allocator.makeChild(100).getHugePageMode());
+
+    // Large allocations start at a huge page, small ones are allocated as
+    // usual. Both count towards the limit.
+    const size_t large = 3 * HUGE_PAGE_SIZE / 2;
+    char* ptr = allocator.allocate(large);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % HUGE_PAGE_SIZE);
+    std::fill(ptr, ptr + large, 'a');
+    char* small = allocator.allocate(100);
+    ASSERT_EQ(10 * HUGE_PAGE_SIZE - large - 100, allocator.numFreeBytes());
+    allocator.deallocate(ptr, large);
+    allocator.deallocate(small, 100);
+    ASSERT_EQ(10 * HUGE_PAGE_SIZE, allocator.numFreeBytes());
+  }
+
+  // Allocators with different modes cannot free the memory of each other.
+  auto memoryLeft = makeAllocationMemoryLeftThreadsafeObject(100);
+  AllocatorWithLimit<int> none{memoryLeft, ad_utility::noClearOnAllocation,
+                               HugePageMode::None};
+  AllocatorWithLimit<int> transparent{
+      memoryLeft, ad_utility::noClearOnAllocation, HugePageMode::Transparent};
+  ASSERT_FALSE(none == transparent);
+  ASSERT_TRUE(none == AllocatorWithLimit<int>(none));
+
+  ASSERT_EQ(HugePageMode::Explicit,
+            ad_utility::hugePageModeFromString("explicit"));
+  ASSERT_THROW(ad_utility::hugePageModeFromString("gigantic"),
+               std::runtime_error);
+}
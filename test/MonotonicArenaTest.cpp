@@ -0,0 +1,83 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "../src/util/ArenaHashMap.h"
+#include "../src/util/MonotonicArena.h"
+
+using ad_utility::AllocatorWithLimit;
+using ad_utility::ArenaAllocator;
+using ad_utility::MonotonicArena;
+using ad_utility::makeAllocationMemoryLeftThreadsafeObject;
+
+namespace {
+constexpr size_t BLOCK_SIZE = 1024;
+AllocatorWithLimit<char> makeAllocator(size_t limit) {
+  return AllocatorWithLimit<char>{
+      makeAllocationMemoryLeftThreadsafeObject(limit)};
+}
+}  // namespace
+
+TEST(MonotonicArenaTest, smallObjectsShareBlocks) {
+  auto allocator = makeAllocator(10 * BLOCK_SIZE);
+  {
+    MonotonicArena arena{allocator, BLOCK_SIZE};
+    ASSERT_EQ(0u, arena.numBlockBytes());
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(24, 8);
+    ASSERT_NE(a, b);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 8);
+    // Only a single block is taken from the limit of the allocator.
+    ASSERT_EQ(BLOCK_SIZE, arena.numBlockBytes());
+    ASSERT_EQ(9 * BLOCK_SIZE, allocator.numFreeBytes());
+    // Freed chunks are reused for objects of the same size class.
+    arena.deallocate(b, 24);
+    ASSERT_EQ(b, arena.allocate(32, 8));
+    // Fill the first block, the arena then takes a second one.
+    for (size_t i = 0; i < BLOCK_SIZE / 64; ++i) {
+      arena.allocate(64, 8);
+    }
+    ASSERT_EQ(2 * BLOCK_SIZE, arena.numBlockBytes());
+  }
+  // The blocks are returned when the arena is destroyed.
+  ASSERT_EQ(10 * BLOCK_SIZE, allocator.numFreeBytes());
+}
+
+TEST(MonotonicArenaTest, largeObjectsAndLimit) {
+  auto allocator = makeAllocator(2 * BLOCK_SIZE);
+  MonotonicArena arena{allocator, BLOCK_SIZE};
+  // Large objects are directly allocated and freed.
+  void* large = arena.allocate(BLOCK_SIZE, 8);
+  ASSERT_EQ(0u, arena.numBlockBytes());
+  ASSERT_EQ(BLOCK_SIZE, allocator.numFreeBytes());
+  ASSERT_THROW(arena.allocate(2 * BLOCK_SIZE, 8),
+               ad_utility::detail::AllocationExceedsLimitException);
+  arena.deallocate(large, BLOCK_SIZE);
+  ASSERT_EQ(2 * BLOCK_SIZE, allocator.numFreeBytes());
+}
+
+TEST(MonotonicArenaTest, containers) {
+  auto allocator = makeAllocator(100 * BLOCK_SIZE);
+  MonotonicArena arena{allocator, BLOCK_SIZE};
+  ad_utility::ArenaHashSet<int> set{ArenaAllocator<int>{arena}};
+  ad_utility::ArenaHashMap<int, int> map{
+      ArenaAllocator<std::pair<const int, int>>{arena}};
+  for (int i = 0; i < 1000; ++i) {
+    set.insert(i % 100);
+    map[i % 50] += 1;
+  }
+  ASSERT_EQ(100u, set.size());
+  ASSERT_EQ(50u, map.size());
+  ASSERT_EQ(20, map[7]);
+
+  ad_utility::ArenaString string{ArenaAllocator<char>{arena}};
+  for (size_t i = 0; i < 100; ++i) {
+    string.append("abc");
+  }
+  ASSERT_EQ(300u, string.size());
+  ASSERT_GT(arena.numBlockBytes(), 0u);
+}
@@ -4,11 +4,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
 #include "../src/engine/CallFixedSize.h"
 #include "../src/engine/MultiColumnJoin.h"
+#include "../src/util/OnDestruction.h"
 ad_utility::AllocatorWithLimit<Id>& allocator() {
   static ad_utility::AllocatorWithLimit<Id> a{
       ad_utility::makeAllocationMemoryLeftThreadsafeObject(
@@ -95,3 +97,60 @@ TEST(EngineTest, multiColumnJoinTest) {
   ASSERT_EQ(wantedRes[2], vres[2]);
   ASSERT_EQ(wantedRes[3], vres[3]);
 }
+
+TEST(EngineTest, parallelMultiColumnJoinTest) {
+  using std::array;
+  using std::vector;
+
+  // The runtime parameters are shared by all tests, restore them at the end.
+  const size_t numThreadsBefore =
+      RuntimeParameters().get<"join-num-threads">();
+  const size_t minRowsPerThreadBefore =
+      RuntimeParameters().get<"join-min-rows-per-thread">();
+  ad_utility::OnDestruction restoreParameters{[&]() noexcept {
+    RuntimeParameters().set<"join-num-threads">(numThreadsBefore);
+    RuntimeParameters().set<"join-min-rows-per-thread">(
+        minRowsPerThreadBefore);
+  }};
+
+  // The inputs are sorted by their join columns, (0, 1) for `a` and (1, 0)
+  // for `b`. Each pair of join values occurs in 10 rows of `a` and 3 rows of
+  // `b`.
+  IdTable a(3, allocator());
+  IdTable b(3, allocator());
+  for (size_t i = 0; i < 600; ++i) {
+    a.push_back({i / 40, (i / 10) % 4, i});
+    b.push_back({(i / 3) % 4, i / 12, i + 1000});
+  }
+  vector<array<Id, 2>> jcls{{0, 1}, {1, 0}};
+  int aWidth = a.cols();
+  int bWidth = b.cols();
+  int resWidth = 4;
+
+  // The expected result, computed with nested loops.
+  vector<array<Id, 4>> expected;
+  for (size_t i = 0; i < a.size(); ++i) {
+    for (size_t j = 0; j < b.size(); ++j) {
+      if (a(i, 0) == b(j, 1) && a(i, 1) == b(j, 0)) {
+        expected.push_back({a(i, 0), a(i, 1), a(i, 2), b(j, 2)});
+      }
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(15u * 4u * 10u * 3u, expected.size());
+
+  RuntimeParameters().set<"join-min-rows-per-thread">(10);
+  for (size_t numThreads : {1ul, 2ul, 7ul, 64ul}) {
+    RuntimeParameters().set<"join-num-threads">(numThreads);
+    IdTable res(resWidth, allocator());
+    CALL_FIXED_SIZE_3(aWidth, bWidth, resWidth,
+                      MultiColumnJoin::computeMultiColumnJoin, a, b, jcls,
+                      &res);
+    vector<array<Id, 4>> rows;
+    for (size_t i = 0; i < res.size(); ++i) {
+      rows.push_back({res(i, 0), res(i, 1), res(i, 2), res(i, 3)});
+    }
+    std::sort(rows.begin(), rows.end());
+    ASSERT_EQ(expected, rows);
+  }
+}
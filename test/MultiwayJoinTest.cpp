@@ -0,0 +1,146 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../src/engine/IdTable.h"
+#include "../src/engine/MultiwayJoin.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+using Rows = std::vector<std::vector<Id>>;
+
+// A table with the `rows`, sorted by the column `sortCol`.
+IdTable createTable(size_t cols, Rows rows, size_t sortCol = 0) {
+  std::stable_sort(rows.begin(), rows.end(),
+                   [sortCol](const auto& a, const auto& b) {
+                     return a[sortCol] < b[sortCol];
+                   });
+  IdTable result{cols, allocator()};
+  for (const auto& row : rows) {
+    result.emplace_back();
+    for (size_t col = 0; col < cols; ++col) {
+      result(result.size() - 1, col) = row[col];
+    }
+  }
+  return result;
+}
+
+Rows toRows(const IdTable& table) {
+  Rows result;
+  for (size_t row = 0; row < table.size(); ++row) {
+    std::vector<Id> r;
+    for (size_t col = 0; col < table.cols(); ++col) {
+      r.push_back(table(row, col));
+    }
+    result.push_back(std::move(r));
+  }
+  return result;
+}
+
+// The join of the `inputs` with the result layout of the MultiwayJoin,
+// computed with nested loops and sorted.
+Rows bruteForceJoin(const std::vector<const IdTable*>& inputs,
+                    const std::vector<size_t>& joinColumns) {
+  Rows partial;
+  for (size_t row = 0; row < inputs[0]->size(); ++row) {
+    std::vector<Id> r{(*inputs[0])(row, joinColumns[0])};
+    for (size_t col = 0; col < inputs[0]->cols(); ++col) {
+      if (col != joinColumns[0]) {
+        r.push_back((*inputs[0])(row, col));
+      }
+    }
+    partial.push_back(std::move(r));
+  }
+  for (size_t i = 1; i < inputs.size(); ++i) {
+    Rows next;
+    for (const auto& r : partial) {
+      for (size_t row = 0; row < inputs[i]->size(); ++row) {
+        if ((*inputs[i])(row, joinColumns[i]) != r[0]) {
+          continue;
+        }
+        auto extended = r;
+        for (size_t col = 0; col < inputs[i]->cols(); ++col) {
+          if (col != joinColumns[i]) {
+            extended.push_back((*inputs[i])(row, col));
+          }
+        }
+        next.push_back(std::move(extended));
+      }
+    }
+    partial = std::move(next);
+  }
+  std::sort(partial.begin(), partial.end());
+  return partial;
+}
+}  // namespace
+
+TEST(MultiwayJoinTest, star) {
+  IdTable a = createTable(2, {{1, 10}, {2, 20}, {2, 21}, {4, 40}, {5, 50}});
+  IdTable b = createTable(1, {{2}, {3}, {4}, {5}});
+  // Joined on the second column.
+  IdTable c = createTable(2, {{200, 2}, {201, 2}, {500, 5}, {600, 6}}, 1);
+  IdTable result{3, allocator()};
+  MultiwayJoin::computeMultiwayJoin({&a, &b, &c}, {0, 0, 1}, &result);
+  Rows expected{
+      {2, 20, 200}, {2, 20, 201}, {2, 21, 200}, {2, 21, 201}, {5, 50, 500}};
+  ASSERT_EQ(expected, toRows(result));
+  ASSERT_EQ(expected, bruteForceJoin({&a, &b, &c}, {0, 0, 1}));
+}
+
+TEST(MultiwayJoinTest, randomStars) {
+  std::mt19937_64 rng{42};
+  for (Id numValues : {Id{5}, Id{20}, Id{200}}) {
+    std::uniform_int_distribution<Id> distribution{0, numValues - 1};
+    std::vector<IdTable> tables;
+    for (size_t i = 0; i < 5; ++i) {
+      Rows rows;
+      for (size_t j = 0; j < 20; ++j) {
+        rows.push_back({distribution(rng), distribution(rng)});
+      }
+      tables.push_back(createTable(2, std::move(rows)));
+    }
+    std::vector<const IdTable*> inputs;
+    for (const auto& table : tables) {
+      inputs.push_back(&table);
+    }
+    std::vector<size_t> joinColumns(inputs.size(), 0);
+    IdTable result{6, allocator()};
+    size_t numTimeoutChecks = 0;
+    MultiwayJoin::computeMultiwayJoin(
+        inputs, joinColumns, &result,
+        [&numTimeoutChecks]() { ++numTimeoutChecks; });
+    Rows actual = toRows(result);
+    ASSERT_TRUE(std::is_sorted(
+        actual.begin(), actual.end(),
+        [](const auto& a, const auto& b) { return a[0] < b[0]; }));
+    std::sort(actual.begin(), actual.end());
+    ASSERT_EQ(bruteForceJoin(inputs, joinColumns), actual);
+    ASSERT_GT(numTimeoutChecks, 0u);
+  }
+}
+
+TEST(MultiwayJoinTest, extremeValuesAndEmptyInputs) {
+  constexpr Id max = std::numeric_limits<Id>::max();
+  IdTable a = createTable(2, {{0, 1}, {max, 2}, {max, 3}});
+  IdTable b = createTable(1, {{0}, {max}});
+  IdTable result{2, allocator()};
+  MultiwayJoin::computeMultiwayJoin({&a, &b}, {0, 0}, &result);
+  ASSERT_EQ((Rows{{0, 1}, {max, 2}, {max, 3}}), toRows(result));
+
+  IdTable empty{1, allocator()};
+  IdTable emptyResult{2, allocator()};
+  MultiwayJoin::computeMultiwayJoin({&a, &empty}, {0, 0}, &emptyResult);
+  ASSERT_EQ(0u, emptyResult.size());
+}
@@ -0,0 +1,103 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "../src/engine/QueryPlanCache.h"
+
+TEST(QueryPlanCacheTest, normalize) {
+  ASSERT_EQ("SELECT ?x WHERE { ?x <p> \"a  b\" . }",
+            QueryPlanCache::normalize(
+                "  SELECT ?x\n\tWHERE {  ?x <p>    \"a  b\" .\n}\n  "));
+  // Comments are removed, but not inside IRIs and literals.
+  ASSERT_EQ("SELECT ?x WHERE { ?x <http://a.org/#p> '#b' }",
+            QueryPlanCache::normalize("SELECT ?x # the subject\n"
+                                      "WHERE { ?x <http://a.org/#p> '#b' }"));
+  // Long literals and escaped quotes.
+  ASSERT_EQ("?x <p> \"\"\"a \"  \n b\"\"\" , \"c \\\"  d\"",
+            QueryPlanCache::normalize(
+                "?x  <p> \"\"\"a \"  \n b\"\"\" ,  \"c \\\"  d\""));
+  // A comparison is not mistaken for an IRI.
+  ASSERT_EQ("FILTER (?x < 3 && ?y > 5)",
+            QueryPlanCache::normalize("FILTER (?x  <  3 &&  ?y > 5)"));
+  ASSERT_EQ("", QueryPlanCache::normalize(" \n # only a comment"));
+}
+
+TEST(QueryPlanCacheTest, bindPlaceholders) {
+  ad_utility::HashMap<std::string, std::string> values{
+      {"city", "<http://a.org/Freiburg>"},
+      {"name", "\"Freiburg\"@de"},
+      {"year", "1120"},
+      {"type", "wd:Q515"}};
+  ASSERT_EQ(
+      "SELECT ?x { ?x <p> <http://a.org/Freiburg> . ?x <q> \"Freiburg\"@de . "
+      "?x <r> 1120 . ?x a wd:Q515 . ?x <s> \"${city}\" }",
+      QueryPlanCache::bindPlaceholders(
+          "SELECT ?x { ?x <p> ${city} . ?x <q> ${name} . ?x <r> ${year} . ?x a "
+          "${type} . ?x <s> \"${city}\" }",
+          values));
+  // Without placeholders, the query is not changed.
+  ASSERT_EQ("SELECT ?x { ?x <p> $x }",
+            QueryPlanCache::bindPlaceholders("SELECT ?x { ?x <p> $x }", {}));
+
+  ASSERT_ANY_THROW(QueryPlanCache::bindPlaceholders("?x <p> ${unknown}", {}));
+  // Values that are not a single term are rejected.
+  for (std::string value :
+       {"<a> . ?x ?y ?z", "\"a\" } UNION { ?x ?y ?z", "?y", "\"unterminated",
+        "<a", "\"a\"^^<b> <c>", "", "\"a\"@de en"}) {
+    ASSERT_ANY_THROW(
+        QueryPlanCache::bindPlaceholders("?x <p> ${v}", {{"v", value}}))
+        << value;
+  }
+  for (std::string value :
+       {"\"a\\\" b\"", "'''a \" b'''", "\"1\"^^xsd:int", "-4.5e3", "\"\""}) {
+    ASSERT_EQ("?x <p> " + value,
+              QueryPlanCache::bindPlaceholders("?x <p> ${v}", {{"v", value}}));
+  }
+}
+
+TEST(QueryPlanCacheTest, splitLimitAndOffset) {
+  auto [query, limitAndOffset] = QueryPlanCache::splitLimitAndOffset(
+      "SELECT ?x { ?x <p> ?y } ORDER BY ?y LIMIT 10 offset 200");
+  ASSERT_EQ("SELECT ?x { ?x <p> ?y } ORDER BY ?y", query);
+  ASSERT_EQ(10u, limitAndOffset._limit);
+  ASSERT_EQ(200u, limitAndOffset._offset);
+
+  // The pages of a result have the same key.
+  ASSERT_EQ(query, QueryPlanCache::splitLimitAndOffset(
+                       "SELECT ?x { ?x <p> ?y } ORDER BY ?y OFFSET 0")
+                       .first);
+  ASSERT_FALSE(QueryPlanCache::splitLimitAndOffset("SELECT ?x { ?x <p> ?y }")
+                   .second._limit.has_value());
+
+  // The LIMIT of a subquery, a placeholder and a repeated LIMIT are kept.
+  for (std::string unchanged :
+       {"SELECT ?x { { SELECT ?x { ?x <p> ?y } LIMIT 5 } }",
+        "SELECT ?x { ?x <p> ?y } LIMIT ${n}", "SELECT ?x { ?x <p> ?y } LIMIT",
+        "LIMIT 5", "SELECT ?x { ?x <p> ?y } LIMIT99999999999999999999"}) {
+    ASSERT_EQ(unchanged, QueryPlanCache::splitLimitAndOffset(unchanged).first);
+  }
+  auto [repeated, repeatedLimit] = QueryPlanCache::splitLimitAndOffset(
+      "SELECT ?x { ?x <p> ?y } LIMIT 5 LIMIT 6");
+  ASSERT_EQ("SELECT ?x { ?x <p> ?y } LIMIT 5", repeated);
+  ASSERT_EQ(6u, repeatedLimit._limit);
+}
+
+TEST(QueryPlanCacheTest, insertAndGet) {
+  QueryPlanCache cache{2};
+  ASSERT_EQ(nullptr, cache.get("a"));
+  cache.insert("a", {std::nullopt, {std::vector<uint64_t>{3}}});
+  // A second insert of the same query keeps the first entry.
+  cache.insert("a", {std::nullopt, {std::nullopt}});
+  auto entry = cache.get("a");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_FALSE(entry->_parsedQuery.has_value());
+  ASSERT_EQ((QueryPlanner::JoinOrders{std::vector<uint64_t>{3}}),
+            entry->_joinOrders);
+  cache.insert("b", {});
+  cache.insert("c", {});
+  ASSERT_EQ(2u, cache.numEntries());
+  cache.clear();
+  ASSERT_EQ(0u, cache.numEntries());
+  ASSERT_EQ(nullptr, cache.get("b"));
+}
@@ -4,8 +4,15 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+
 #include "../src/engine/QueryPlanner.h"
+#include "../src/index/Index.h"
 #include "../src/parser/SparqlParser.h"
+#include "../src/util/OnDestruction.h"
 
 TEST(QueryPlannerTest, createTripleGraph) {
   using TripleGraph = QueryPlanner::TripleGraph;
@@ -683,14 +690,13 @@ TEST(QueryPlannerTest, testStarTwoFree) {
       QueryPlanner qp(nullptr);
       QueryExecutionTree qet = qp.createExecutionTree(pq);
       ASSERT_EQ(
-          "{\n  JOIN\n  {\n    JOIN\n    {\n      SCAN POS with P = "
-          "\"<http://rdf.myprefix.com/myrel>\"\n      qet-width: 2 \n    } "
-          "join-column: [0]\n    |X|\n    {\n      SCAN POS with P = "
-          "\"<http://rdf.myprefix.com/xxx/rel2>\", O = \"<http://abc.de>\"\n   "
-          "   qet-width: 1 \n    } join-column: [0]\n    qet-width: 2 \n  } "
-          "join-column: [0]\n  |X|\n  {\n    SCAN PSO with P = "
-          "\"<http://rdf.myprefix.com/ns/myrel>\"\n    qet-width: 2 \n  } "
-          "join-column: [0]\n  qet-width: 3 \n}",
+          "{\n  MULTIWAY_JOIN on ?y\n  {\n    SCAN POS with P = "
+          "\"<http://rdf.myprefix.com/myrel>\"\n    qet-width: 2 \n  }\n  "
+          "|X|\n  {\n    SCAN POS with P = "
+          "\"<http://rdf.myprefix.com/xxx/rel2>\", O = \"<http://abc.de>\"\n "
+          "   qet-width: 1 \n  }\n  |X|\n  {\n    SCAN PSO with P = "
+          "\"<http://rdf.myprefix.com/ns/myrel>\"\n    qet-width: 2 \n  }\n "
+          " qet-width: 3 \n}",
           qet.asString());
     }
 
@@ -1092,46 +1098,16 @@ TEST(QueryExecutionTreeTest, testCyclicQuery) {
     QueryPlanner qp(nullptr);
     QueryExecutionTree qet = qp.createExecutionTree(pq);
 
-    // There are three possible outcomes of this test with the same size
-    // estimate. It is currently very hard to make the query planning
-    // deterministic in a test scenario, so we allow all three candidates
-    std::string possible1 =
-        "{\n  TWO_COLUMN_JOIN\n    {\n    SCAN PSO with P = "
-        "\"<Film_performance>\"\n    qet-width: 2 \n  }\n  join-columns: [0 & "
-        "1]\n  |X|\n    {\n    SORT / ORDER BY on columns:asc(2) asc(1) \n    "
-        "{\n      JOIN\n      {\n        SCAN PSO with P = "
-        "\"<Film_performance>\"\n        qet-width: 2 \n      } join-column: "
-        "[0]\n      |X|\n      {\n        SCAN PSO with P = "
-        "\"<Spouse_(or_domestic_partner)>\"\n        qet-width: 2 \n      } "
-        "join-column: [0]\n      qet-width: 3 \n    }\n    qet-width: 3 \n  "
-        "}\n  join-columns: [2 & 1]\n  qet-width: 3 \n}";
-    std::string possible2 =
-        "{\n  TWO_COLUMN_JOIN\n    {\n    SCAN POS with P = "
-        "\"<Film_performance>\"\n    qet-width: 2 \n  }\n  join-columns: [0 & "
-        "1]\n  |X|\n    {\n    SORT / ORDER BY on columns:asc(1) asc(2) \n    "
-        "{\n      JOIN\n      {\n        SCAN PSO with P = "
-        "\"<Film_performance>\"\n        qet-width: 2 \n      } join-column: "
-        "[0]\n      |X|\n      {\n        SCAN PSO with P = "
-        "\"<Spouse_(or_domestic_partner)>\"\n        qet-width: 2 \n      } "
-        "join-column: [0]\n      qet-width: 3 \n    }\n    qet-width: 3 \n  "
-        "}\n  join-columns: [1 & 2]\n  qet-width: 3 \n}";
-    std::string possible3 =
-        "{\n  TWO_COLUMN_JOIN\n    {\n    SCAN POS with P = "
+    // The triangle is computed by a single worst-case optimal join instead of
+    // two binary joins with a large intermediate result.
+    std::string expected =
+        "{\n  LEAPFROG_TRIEJOIN on ?x ?y ?m\n  {\n    SCAN PSO with P = "
+        "\"<Film_performance>\"\n    qet-width: 2 \n  }\n  |X|\n  {\n    SCAN "
+        "PSO with P = \"<Film_performance>\"\n    qet-width: 2 \n  }\n  "
+        "|X|\n  {\n    SCAN PSO with P = "
         "\"<Spouse_(or_domestic_partner)>\"\n    qet-width: 2 \n  }\n  "
-        "join-columns: [0 & 1]\n  |X|\n    {\n    SORT / ORDER BY on "
-        "columns:asc(1) asc(2) \n    {\n      JOIN\n      {\n        SCAN POS "
-        "with P = \"<Film_performance>\"\n        qet-width: 2 \n      } "
-        "join-column: [0]\n      |X|\n      {\n        SCAN POS with P = "
-        "\"<Film_performance>\"\n        qet-width: 2 \n      } join-column: "
-        "[0]\n      qet-width: 3 \n    }\n    qet-width: 3 \n  }\n  "
-        "join-columns: [1 & 2]\n  qet-width: 3 \n}";
-    auto actual = qet.asString();
-
-    if (actual != possible1 && actual != possible2 && actual != possible3) {
-      FAIL() << "query execution tree is none of the possible trees, it is "
-                "actually "
-             << actual << '\n';
-    }
+        "qet-width: 3 \n}";
+    ASSERT_EQ(expected, qet.asString());
 
   } catch (const ad_semsearch::Exception& e) {
     std::cout << "Caught: " << e.getFullErrorMessage() << std::endl;
@@ -1142,6 +1118,304 @@ TEST(QueryExecutionTreeTest, testCyclicQuery) {
   }
 }
 
+TEST(QueryExecutionTreeTest, testCyclicQueryWithAcyclicPart) {
+  ParsedQuery pq =
+      SparqlParser(
+          "SELECT ?x ?y ?m ?d WHERE { ?x <Spouse_(or_domestic_partner)> ?y . "
+          "?x <Film_performance> ?m . ?y <Film_performance> ?m . "
+          "?m <Director> ?d }")
+          .parse();
+  pq.expandPrefixes();
+  QueryPlanner qp(nullptr);
+  QueryExecutionTree qet = qp.createExecutionTree(pq);
+  auto actual = qet.asString();
+  // Only the triangle is part of the worst-case optimal join, the triple with
+  // ?d is joined with its result.
+  ASSERT_NE(std::string::npos,
+            actual.find("LEAPFROG_TRIEJOIN on ?x ?y ?m\n"))
+      << actual;
+  ASSERT_EQ(std::string::npos, actual.find("TWO_COLUMN_JOIN")) << actual;
+  ASSERT_EQ(4u, qet.getResultWidth());
+}
+
+TEST(QueryExecutionTreeTest, testLeapfrogTriejoinOnlyForCycles) {
+  ParsedQuery pq =
+      SparqlParser(
+          "SELECT ?x ?y ?m WHERE { ?x <Spouse_(or_domestic_partner)> ?y . "
+          "?x <Film_performance> ?m . ?m <Director> ?y }")
+          .parse();
+  pq.expandPrefixes();
+  QueryPlanner qp(nullptr);
+  auto actual = qp.createExecutionTree(pq).asString();
+  ASSERT_NE(std::string::npos, actual.find("LEAPFROG_TRIEJOIN")) << actual;
+
+  ParsedQuery star =
+      SparqlParser(
+          "SELECT ?x ?y ?m WHERE { ?x <Spouse_(or_domestic_partner)> ?y . "
+          "?x <Film_performance> ?m . ?x <Director> ?d }")
+          .parse();
+  star.expandPrefixes();
+  actual = qp.createExecutionTree(star).asString();
+  ASSERT_EQ(std::string::npos, actual.find("LEAPFROG_TRIEJOIN")) << actual;
+}
+
+TEST(QueryExecutionTreeTest, testMultiwayJoinForStars) {
+  ParsedQuery pq =
+      SparqlParser(
+          "SELECT ?x ?a ?b ?c ?d WHERE { ?x <Name> ?a . ?x <Born_in> ?b . "
+          "?x <Award> ?c . ?x <Is_a> <Actor> . ?b <Country> ?d }")
+          .parse();
+  pq.expandPrefixes();
+  QueryPlanner qp(nullptr);
+  QueryExecutionTree qet = qp.createExecutionTree(pq);
+  auto actual = qet.asString();
+  ASSERT_NE(std::string::npos, actual.find("MULTIWAY_JOIN on ?x\n"))
+      << actual;
+  ASSERT_EQ(5u, qet.getResultWidth());
+
+  // Two triples on the same variable are joined with a binary join.
+  ParsedQuery pair =
+      SparqlParser("SELECT ?x ?a ?b WHERE { ?x <Name> ?a . ?x <Award> ?b }")
+          .parse();
+  pair.expandPrefixes();
+  actual = qp.createExecutionTree(pair).asString();
+  ASSERT_EQ(std::string::npos, actual.find("MULTIWAY_JOIN")) << actual;
+}
+
+TEST(QueryExecutionTreeTest, testAdaptiveModeWithoutExecutionContext) {
+  // Without an execution context nothing can be computed while planning, so
+  // the adaptive mode yields the same plan.
+  auto parse = []() {
+    ParsedQuery pq =
+        SparqlParser(
+            "SELECT ?x ?y ?z WHERE { ?x <Name> ?y . ?y <Born_in> ?z . "
+            "?z <Country> <Germany> }")
+            .parse();
+    pq.expandPrefixes();
+    return pq;
+  };
+  ParsedQuery pq = parse();
+  QueryPlanner qp(nullptr);
+  auto expected = qp.createExecutionTree(pq).asString();
+  ParsedQuery adaptivePq = parse();
+  QueryPlanner adaptive(nullptr);
+  adaptive.setEnableAdaptiveReoptimization(true);
+  ASSERT_EQ(expected, adaptive.createExecutionTree(adaptivePq).asString());
+}
+
+TEST(QueryExecutionTreeTest, testAdaptiveModeWithMisestimatedJoin) {
+  const std::string stxxlConfigFileName = "./.stxxl";
+  const std::string stxxlDiskFileName = "./-stxxl.disk";
+  {
+    ad_utility::File stxxlConfig(stxxlConfigFileName, "w");
+    setenv("STXXLCFG", stxxlConfigFileName.c_str(), true);
+    stxxlConfig.writeLine("disk=" + stxxlDiskFileName + "," +
+                          std::to_string(STXXL_DISK_SIZE_INDEX_TEST) +
+                          ",syscall");
+  }
+  // A chain ?a <p1> ?b <p2> ?c <p3> ?d <p4> ?e. The join of <p1> and <p2> on
+  // ?b is estimated from the multiplicities of ?b, but the objects of <p1> and
+  // the subjects of <p2> have no value in common, so the join is empty.
+  std::fstream f("_adaptiveModeTest.tsv", std::ios_base::out);
+  auto iri = [](const std::string& prefix, size_t i) {
+    return "<" + prefix + std::to_string(i) + ">";
+  };
+  for (size_t i = 0; i < 50; ++i) {
+    f << iri("a", i) << "\t<p1>\t<b0>\t.\n";
+    f << iri("a", 50 + i) << "\t<p1>\t" << iri("b", 100 + i) << "\t.\n";
+    f << "<b1>\t<p2>\t" << iri("c", i) << "\t.\n";
+    f << iri("b", 200 + i) << "\t<p2>\t" << iri("c", i) << "\t.\n";
+    for (size_t j = 0; j < 4; ++j) {
+      f << iri("c", i) << "\t<p3>\t" << iri("d", 4 * i + j) << "\t.\n";
+    }
+  }
+  for (size_t i = 0; i < 160; ++i) {
+    f << iri("d", i) << "\t<p4>\t" << iri("e", i) << "\t.\n";
+  }
+  f.close();
+  std::fstream settings("_adaptiveModeTest.settings.json",
+                        std::ios_base::out);
+  settings << "{\"num-triples-per-partial-vocab\": 1000}";
+  settings.close();
+  {
+    Index indexPrim;
+    indexPrim.setOnDiskBase("_adaptiveModeTest");
+    indexPrim.setSettingsFile("_adaptiveModeTest.settings.json");
+    indexPrim.createFromFile<TsvParser>("_adaptiveModeTest.tsv");
+  }
+
+  {
+    Index index;
+    index.createFromOnDiskIndex("_adaptiveModeTest");
+    Engine engine;
+    QueryResultCache cache;
+    ad_utility::AllocatorWithLimit<Id> allocator{
+        ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+            std::numeric_limits<size_t>::max())};
+    QueryExecutionContext qec(index, engine, &cache, allocator,
+                              SortPerformanceEstimator{});
+    auto parse = []() {
+      ParsedQuery pq = SparqlParser(
+                           "SELECT ?a ?b ?c ?d ?e WHERE { ?a <p1> ?b . "
+                           "?b <p2> ?c . ?c <p3> ?d . ?d <p4> ?e }")
+                           .parse();
+      pq.expandPrefixes();
+      return pq;
+    };
+    // The runtime parameters are shared by all tests, restore them at the end.
+    const double factorBefore =
+        RuntimeParameters().get<"adaptive-reoptimization-factor">();
+    ad_utility::OnDestruction restoreFactor{[factorBefore]() noexcept {
+      RuntimeParameters().set<"adaptive-reoptimization-factor">(factorBefore);
+    }};
+    RuntimeParameters().set<"adaptive-reoptimization-factor">(4.0);
+
+    ParsedQuery pq = parse();
+    QueryPlanner qp(&qec);
+    QueryExecutionTree qet = qp.createExecutionTree(pq);
+    ParsedQuery adaptivePq = parse();
+    QueryPlanner adaptive(&qec);
+    adaptive.setEnableAdaptiveReoptimization(true);
+    QueryExecutionTree adaptiveQet = adaptive.createExecutionTree(adaptivePq);
+    // The join on ?b is computed first. Once it is known to be empty, it is
+    // joined with the other triples one by one instead of with their join.
+    ASSERT_NE(qet.asString(), adaptiveQet.asString());
+    ASSERT_EQ(0u, adaptiveQet.getResult()->size());
+    ASSERT_EQ(0u, qet.getResult()->size());
+  }
+
+  remove("_adaptiveModeTest.tsv");
+  remove("_adaptiveModeTest.settings.json");
+  remove("_adaptiveModeTest.index.pso");
+  remove("_adaptiveModeTest.index.pos");
+  std::remove(stxxlConfigFileName.c_str());
+  std::remove(stxxlDiskFileName.c_str());
+}
+
+TEST(QueryExecutionTreeTest, testIterativeDynamicProgramming) {
+  // A chain of 8 triples with a filter on its last variable.
+  auto parse = []() {
+    std::string query = "SELECT ?x0 WHERE {";
+    for (size_t i = 0; i < 8; ++i) {
+      query += " ?x" + std::to_string(i) + " <p" + std::to_string(i) +
+               "> ?x" + std::to_string(i + 1) + " .";
+    }
+    query += " FILTER (?x8 != <a>) }";
+    ParsedQuery pq = SparqlParser(query).parse();
+    pq.expandPrefixes();
+    return pq;
+  };
+  auto countFilters = [](const std::string& plan) {
+    size_t count = 0;
+    for (size_t pos = plan.find("FILTER"); pos != std::string::npos;
+         pos = plan.find("FILTER", pos + 1)) {
+      ++count;
+    }
+    return count;
+  };
+  ParsedQuery exhaustivePq = parse();
+  QueryPlanner exhaustive(nullptr);
+  QueryExecutionTree exhaustiveTree =
+      exhaustive.createExecutionTree(exhaustivePq);
+
+  // Fill the dp tables only up to the plans of 3 triples.
+  RuntimeParameters().set<"query-planner-idp-block-size">(3);
+  ParsedQuery pq = parse();
+  QueryPlanner qp(nullptr);
+  QueryExecutionTree qet = qp.createExecutionTree(pq);
+  RuntimeParameters().set<"query-planner-idp-block-size">(12);
+
+  // All triples are joined and the filter is applied exactly once.
+  ASSERT_EQ(exhaustiveTree.getResultWidth(), qet.getResultWidth());
+  ASSERT_EQ(9u, qet.getResultWidth());
+  for (size_t i = 0; i <= 8; ++i) {
+    ASSERT_TRUE(qet.varCovered("?x" + std::to_string(i)));
+  }
+  ASSERT_EQ(1u, countFilters(qet.asString())) << qet.asString();
+  ASSERT_EQ(1u, countFilters(exhaustiveTree.asString()));
+}
+
+TEST(QueryExecutionTreeTest, testJoinOrderHints) {
+  auto parse = [](const std::string& query) {
+    ParsedQuery pq = SparqlParser(query).parse();
+    pq.expandPrefixes();
+    return pq;
+  };
+  const std::string query =
+      "SELECT ?x WHERE { ?x <p1> ?y . ?y <p2> ?z . ?z <p3> ?w . ?w <p4> ?x . "
+      "?x <p5> ?v . FILTER (?v != <a>) OPTIONAL { ?v <p6> ?u . ?u <p7> ?t } }";
+  ParsedQuery pq = parse(query);
+  QueryPlanner qp(nullptr);
+  QueryExecutionTree qet = qp.createExecutionTree(pq);
+  QueryPlanner::JoinOrders joinOrders = qp.getJoinOrders();
+  // One call for the optional part and one for the triples of the root
+  // pattern.
+  ASSERT_EQ(2u, joinOrders.size());
+  ASSERT_TRUE(joinOrders[0].has_value());
+  ASSERT_TRUE(joinOrders[1].has_value());
+  ASSERT_EQ(std::vector<uint64_t>{0b11}, joinOrders[0].value());
+  // At least one join of some of the five triples, and the join of all of
+  // them.
+  ASSERT_GE(joinOrders[1]->size(), 2u);
+  ASSERT_EQ(0b11111u, joinOrders[1]->back());
+
+  // With the hints, the planner chooses the same plan again.
+  ParsedQuery pq2 = parse(query);
+  QueryPlanner qp2(nullptr);
+  qp2.setJoinOrderHints(joinOrders);
+  ASSERT_EQ(qet.asString(), qp2.createExecutionTree(pq2).asString());
+  ASSERT_EQ(joinOrders, qp2.getJoinOrders());
+  ASSERT_EQ(0u, qp2.getNumIgnoredJoinOrderHints());
+
+  // Hints that do not fit are ignored.
+  ParsedQuery pq3 = parse(query);
+  QueryPlanner qp3(nullptr);
+  qp3.setJoinOrderHints({std::vector<uint64_t>{0b1},
+                         std::vector<uint64_t>{0b11000, 0b11111}});
+  ASSERT_EQ(qet.asString(), qp3.createExecutionTree(pq3).asString());
+  ASSERT_EQ(2u, qp3.getNumIgnoredJoinOrderHints());
+}
+
+TEST(QueryExecutionTreeTest, testJoinOrderHintsForNaryJoins) {
+  // The rows of the dp table between the seeds and a multiway join stay empty
+  // when the plan is restricted to the hint, this must not make the planner
+  // ignore the hint.
+  auto parse = []() {
+    ParsedQuery pq =
+        SparqlParser(
+            "SELECT ?x WHERE { ?x <Name> ?a . ?x <Born_in> ?b . ?x <Award> ?c "
+            ". ?x <Is_a> <Actor> . ?b <Country> ?d . FILTER (?d != <a>) }")
+            .parse();
+    pq.expandPrefixes();
+    return pq;
+  };
+  ParsedQuery pq = parse();
+  QueryPlanner qp(nullptr);
+  const auto expected = qp.createExecutionTree(pq).asString();
+  ASSERT_NE(std::string::npos, expected.find("MULTIWAY_JOIN")) << expected;
+  const QueryPlanner::JoinOrders joinOrders = qp.getJoinOrders();
+
+  ParsedQuery pq2 = parse();
+  QueryPlanner qp2(nullptr);
+  qp2.setJoinOrderHints(joinOrders);
+  ASSERT_EQ(expected, qp2.createExecutionTree(pq2).asString());
+  ASSERT_EQ(joinOrders, qp2.getJoinOrders());
+  ASSERT_EQ(0u, qp2.getNumIgnoredJoinOrderHints());
+
+  // A plan whose root is the multiway join of the whole star.
+  ParsedQuery star = SparqlParser(
+                         "SELECT ?x WHERE { ?x <Name> ?a . ?x <Born_in> ?b . "
+                         "?x <Award> ?c . FILTER (?a != <a>) }")
+                         .parse();
+  star.expandPrefixes();
+  QueryPlanner qp3(nullptr);
+  qp3.setJoinOrderHints({std::vector<uint64_t>{0b111}});
+  const auto actual = qp3.createExecutionTree(star).asString();
+  ASSERT_EQ(0u, qp3.getNumIgnoredJoinOrderHints());
+  ASSERT_NE(std::string::npos, actual.find("MULTIWAY_JOIN")) << actual;
+  ASSERT_NE(std::string::npos, actual.find("FILTER")) << actual;
+}
+
 TEST(QueryExecutionTreeTest, testFormerSegfaultTriFilter) {
   try {
     ParsedQuery pq =
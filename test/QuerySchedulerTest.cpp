@@ -0,0 +1,113 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../src/engine/QueryScheduler.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// Start a thread that acquires a slot for the `request` and appends the
+// `name` to the `order` when it got it.
+std::future<void> startQuery(QueryScheduler& scheduler,
+                             QueryScheduler::Request request, std::string name,
+                             std::vector<std::string>& order,
+                             std::mutex& mutex) {
+  const size_t numWaiting = scheduler.numWaitingQueries();
+  auto future = std::async(std::launch::async, [&, request, name]() {
+    auto slot = scheduler.acquire(request);
+    std::lock_guard lock{mutex};
+    order.push_back(name);
+  });
+  // Make the arrival order deterministic.
+  while (scheduler.numWaitingQueries() <= numWaiting) {
+    std::this_thread::sleep_for(1ms);
+  }
+  return future;
+}
+}  // namespace
+
+TEST(QuerySchedulerTest, priorityFromString) {
+  for (auto priority : {QueryPriority::BATCH, QueryPriority::NORMAL,
+                        QueryPriority::INTERACTIVE}) {
+    ASSERT_EQ(priority, queryPriorityFromString(toString(priority)));
+  }
+  ASSERT_THROW(queryPriorityFromString("urgent"), std::runtime_error);
+}
+
+TEST(QuerySchedulerTest, maxParallelism) {
+  ASSERT_EQ(16u,
+            QueryScheduler::maxParallelism(QueryPriority::INTERACTIVE, 16));
+  ASSERT_EQ(4u, QueryScheduler::maxParallelism(QueryPriority::NORMAL, 16));
+  ASSERT_EQ(1u, QueryScheduler::maxParallelism(QueryPriority::BATCH, 16));
+  ASSERT_EQ(1u, QueryScheduler::maxParallelism(QueryPriority::NORMAL, 2));
+}
+
+TEST(QuerySchedulerTest, acquireAndRelease) {
+  QueryScheduler scheduler{2};
+  {
+    auto a = scheduler.acquire({});
+    auto b = scheduler.acquire({"client", QueryPriority::BATCH, 1e9});
+    ASSERT_EQ(2u, scheduler.numRunningQueries());
+    ASSERT_EQ(0ms, a.waitTime());
+    auto moved = std::move(a);
+    ASSERT_EQ(2u, scheduler.numRunningQueries());
+  }
+  ASSERT_EQ(0u, scheduler.numRunningQueries());
+}
+
+TEST(QuerySchedulerTest, cheapAndInteractiveQueriesOvertake) {
+  QueryScheduler scheduler{1};
+  std::vector<std::string> order;
+  std::mutex mutex;
+  std::optional<QueryScheduler::Slot> running = scheduler.acquire({});
+  std::vector<std::future<void>> queries;
+  // Two bulk exports of the same client, then an interactive query and a
+  // cheap query of another client.
+  queries.push_back(startQuery(scheduler, {"export", QueryPriority::BATCH, 1e6},
+                               "export1", order, mutex));
+  queries.push_back(startQuery(scheduler, {"export", QueryPriority::BATCH, 1e6},
+                               "export2", order, mutex));
+  queries.push_back(startQuery(
+      scheduler, {"ui", QueryPriority::INTERACTIVE, 1e6}, "ui", order, mutex));
+  queries.push_back(startQuery(scheduler, {"other", QueryPriority::NORMAL, 10},
+                               "cheap", order, mutex));
+  ASSERT_EQ(4u, scheduler.numWaitingQueries());
+  running.reset();
+  for (auto& query : queries) {
+    query.get();
+  }
+  ASSERT_EQ((std::vector<std::string>{"cheap", "ui", "export1", "export2"}),
+            order);
+  ASSERT_EQ(0u, scheduler.numWaitingQueries());
+  ASSERT_EQ(0u, scheduler.numRunningQueries());
+}
+
+TEST(QuerySchedulerTest, fairSharingBetweenClients) {
+  QueryScheduler scheduler{1};
+  std::vector<std::string> order;
+  std::mutex mutex;
+  std::optional<QueryScheduler::Slot> running = scheduler.acquire({});
+  std::vector<std::future<void>> queries;
+  // The queries of a client that sends many of them alternate with those of
+  // a client that sends them later.
+  for (auto name : {"a1", "a2", "a3"}) {
+    queries.push_back(startQuery(scheduler, {"a", QueryPriority::NORMAL, 100},
+                                 name, order, mutex));
+  }
+  for (auto name : {"b1", "b2"}) {
+    queries.push_back(startQuery(scheduler, {"b", QueryPriority::NORMAL, 100},
+                                 name, order, mutex));
+  }
+  running.reset();
+  for (auto& query : queries) {
+    query.get();
+  }
+  ASSERT_EQ((std::vector<std::string>{"a1", "b1", "a2", "b2", "a3"}), order);
+}
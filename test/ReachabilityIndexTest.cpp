@@ -0,0 +1,135 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../src/index/ReachabilityIndex.h"
+
+namespace {
+using Direction = ReachabilityIndex::Direction;
+
+std::vector<Id> reachable(const ReachabilityIndex& index, Id id,
+                          Direction direction) {
+  std::vector<Id> result;
+  index.forEachReachable(id, direction,
+                         [&result](Id node) { result.push_back(node); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// The nodes that can be reached from `start` via one or more edges, computed
+// with a simple search.
+std::vector<Id> reachableNaive(const std::vector<std::array<Id, 2>>& edges,
+                               Id start) {
+  std::set<Id> result;
+  std::vector<Id> stack{start};
+  while (!stack.empty()) {
+    Id node = stack.back();
+    stack.pop_back();
+    for (const auto& [from, to] : edges) {
+      if (from == node && result.insert(to).second) {
+        stack.push_back(to);
+      }
+    }
+  }
+  return {result.begin(), result.end()};
+}
+}  // namespace
+
+TEST(ReachabilityIndexTest, hierarchy) {
+  // 1 and 2 are subclasses of 3, which is a subclass of 4 and 5 (multiple
+  // inheritance). 6 and 7 are equivalent and a subclass of 5, 8 is a subclass
+  // of itself.
+  ReachabilityIndex index{{{1, 3},
+                           {2, 3},
+                           {3, 4},
+                           {3, 5},
+                           {6, 7},
+                           {7, 6},
+                           {7, 5},
+                           {8, 8},
+                           {1, 3}}};
+  ASSERT_EQ((std::vector<Id>{1, 2, 3, 4, 5, 6, 7, 8}), index.nodes());
+  ASSERT_EQ((std::vector<Id>{3, 4, 5}), reachable(index, 1, Direction::Forward));
+  ASSERT_EQ((std::vector<Id>{}), reachable(index, 4, Direction::Forward));
+  ASSERT_EQ((std::vector<Id>{1, 2, 3, 6, 7}),
+            reachable(index, 5, Direction::Backward));
+  ASSERT_EQ((std::vector<Id>{1, 2}), reachable(index, 3, Direction::Backward));
+  // Nodes on a cycle reach themselves.
+  ASSERT_EQ((std::vector<Id>{5, 6, 7}), reachable(index, 6, Direction::Forward));
+  ASSERT_EQ((std::vector<Id>{6, 7}), reachable(index, 7, Direction::Backward));
+  ASSERT_EQ((std::vector<Id>{8}), reachable(index, 8, Direction::Forward));
+  // Ids that are not part of an edge.
+  ASSERT_EQ((std::vector<Id>{}), reachable(index, 0, Direction::Forward));
+  ASSERT_EQ((std::vector<Id>{}), reachable(index, 9, Direction::Backward));
+
+  ASSERT_TRUE(index.isReachable(1, 5));
+  ASSERT_TRUE(index.isReachable(6, 6));
+  ASSERT_TRUE(index.isReachable(8, 8));
+  ASSERT_FALSE(index.isReachable(5, 1));
+  ASSERT_FALSE(index.isReachable(1, 1));
+  ASSERT_FALSE(index.isReachable(1, 2));
+  ASSERT_FALSE(index.isReachable(1, 9));
+
+  ReachabilityIndex empty{{}};
+  ASSERT_EQ((std::vector<Id>{}), reachable(empty, 0, Direction::Forward));
+  ASSERT_FALSE(empty.isReachable(0, 0));
+}
+
+TEST(ReachabilityIndexTest, randomGraphs) {
+  std::mt19937_64 random{42};
+  for (size_t numNodes : {5, 20, 100}) {
+    for (size_t numEdgesPerNode : {1, 2, 4}) {
+      // Mostly edges to nodes with a lower id like in a hierarchy, but also
+      // some edges in the other direction, which form cycles.
+      std::vector<std::array<Id, 2>> edges;
+      for (Id node = 1; node < numNodes; ++node) {
+        for (size_t i = 0; i < numEdgesPerNode; ++i) {
+          Id target = random() % 10 == 0 ? random() % numNodes : random() % node;
+          edges.push_back({node, target});
+        }
+      }
+      std::vector<std::array<Id, 2>> invertedEdges;
+      for (const auto& [from, to] : edges) {
+        invertedEdges.push_back({to, from});
+      }
+      ReachabilityIndex index{edges};
+      for (Id node = 0; node < numNodes; ++node) {
+        auto forward = reachableNaive(edges, node);
+        ASSERT_EQ(forward, reachable(index, node, Direction::Forward));
+        ASSERT_EQ(reachableNaive(invertedEdges, node),
+                  reachable(index, node, Direction::Backward));
+        for (Id other = 0; other < numNodes; ++other) {
+          ASSERT_EQ(std::binary_search(forward.begin(), forward.end(), other),
+                    index.isReachable(node, other));
+        }
+      }
+    }
+  }
+}
+
+TEST(ReachabilityIndexTest, serialization) {
+  ReachabilityIndex index{{{1, 2}, {2, 3}, {3, 1}, {4, 1}, {1, 5}}};
+  ad_utility::serialization::ByteBufferWriteSerializer writer;
+  writer << index;
+  ad_utility::serialization::ByteBufferReadSerializer reader{
+      std::move(writer).data()};
+  ReachabilityIndex read;
+  reader >> read;
+  ASSERT_EQ(index.nodes(), read.nodes());
+  ASSERT_EQ(index.numIntervals(), read.numIntervals());
+  for (Id node = 0; node <= 6; ++node) {
+    ASSERT_EQ(reachable(index, node, Direction::Forward),
+              reachable(read, node, Direction::Forward));
+    ASSERT_EQ(reachable(index, node, Direction::Backward),
+              reachable(read, node, Direction::Backward));
+  }
+  ASSERT_EQ((std::vector<Id>{1, 2, 3, 5}),
+            reachable(read, 4, Direction::Forward));
+}
@@ -0,0 +1,170 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "../src/engine/IdTable.h"
+#include "../src/engine/Join.h"
+#include "../src/engine/SemiJoinFilter.h"
+#include "../src/engine/SortPerformanceEstimator.h"
+
+namespace {
+ad_utility::AllocatorWithLimit<Id>& allocator() {
+  static ad_utility::AllocatorWithLimit<Id> a{
+      ad_utility::makeAllocationMemoryLeftThreadsafeObject(
+          std::numeric_limits<size_t>::max())};
+  return a;
+}
+
+// A sorted column of values that supports a semi-join filter.
+class FilterableValues : public Operation {
+ public:
+  FilterableValues(QueryExecutionContext* qec, std::string name,
+                   std::vector<Id> values)
+      : Operation(qec), _name{std::move(name)}, _values{std::move(values)} {}
+
+  void computeResult(ResultTable* result) override {
+    result->_resultTypes.push_back(ResultTable::ResultType::KB);
+    result->_sortedBy = {0};
+    result->_idTable.setCols(1);
+    _numComputationsWithFilter += _filter != nullptr;
+    for (Id value : _values) {
+      if (!_filter || std::binary_search(_filter->values().begin(),
+                                         _filter->values().end(), value)) {
+        result->_idTable.push_back({value});
+      }
+    }
+  }
+
+  const SemiJoinFilter* filter() const { return _filter.get(); }
+  size_t numComputationsWithFilter() const {
+    return _numComputationsWithFilter;
+  }
+
+  string asString(size_t) const override { return _name; }
+  string getDescriptor() const override { return _name; }
+  size_t getResultWidth() const override { return 1; }
+  vector<size_t> resultSortedOn() const override { return {0}; }
+  void setTextLimit(size_t) override {}
+  size_t getCostEstimate() override { return _values.size(); }
+  size_t getSizeEstimate() override { return _values.size(); }
+  float getMultiplicity(size_t) override { return 1; }
+  vector<QueryExecutionTree*> getChildren() override { return {}; }
+  bool knownEmptyResult() override { return _values.empty(); }
+  ad_utility::HashMap<string, size_t> getVariableColumns() const override {
+    return {{"?x", 0}};
+  }
+
+ private:
+  bool applySemiJoinFilter(
+      size_t col,
+      const std::shared_ptr<const SemiJoinFilter>& filter) override {
+    if (col != 0) {
+      return false;
+    }
+    _filter = filter;
+    return true;
+  }
+  void resetSemiJoinFilter() override { _filter = nullptr; }
+
+  std::string _name;
+  std::vector<Id> _values;
+  std::shared_ptr<const SemiJoinFilter> _filter;
+  size_t _numComputationsWithFilter = 0;
+};
+}  // namespace
+
+TEST(SemiJoinFilterTest, fromSortedColumn) {
+  IdTable table{2, allocator()};
+  table.push_back({7, 1});
+  table.push_back({3, 2});
+  table.push_back({5, 2});
+  table.push_back({1, 4});
+  table.push_back({0, 4});
+  SemiJoinFilter filter = SemiJoinFilter::fromSortedColumn(table, 1, "f");
+  ASSERT_EQ((std::vector<Id>{1, 2, 4}), filter.values());
+  ASSERT_EQ(3u, filter.size());
+  ASSERT_EQ("f", filter.asString());
+
+  IdTable empty{2, allocator()};
+  ASSERT_EQ(0u, SemiJoinFilter::fromSortedColumn(empty, 0, "e").size());
+}
+
+TEST(SemiJoinFilterTest, constructorRemovesDuplicatesAndChecksOrder) {
+  SemiJoinFilter filter{{1, 1, 2, 5, 5, 5}, "f"};
+  ASSERT_EQ((std::vector<Id>{1, 2, 5}), filter.values());
+  ASSERT_ANY_THROW((SemiJoinFilter{{2, 1}, "unsorted"}));
+}
+
+TEST(SemiJoinFilterTest, containsValueInRange) {
+  SemiJoinFilter filter{{3, 10, 20}, "f"};
+  ASSERT_TRUE(filter.containsValueInRange(0, 3));
+  ASSERT_TRUE(filter.containsValueInRange(3, 3));
+  ASSERT_TRUE(filter.containsValueInRange(11, 25));
+  ASSERT_FALSE(filter.containsValueInRange(0, 2));
+  ASSERT_FALSE(filter.containsValueInRange(4, 9));
+  ASSERT_FALSE(filter.containsValueInRange(21, 100));
+
+  SemiJoinFilter empty{{}, "empty"};
+  ASSERT_FALSE(empty.containsValueInRange(0, std::numeric_limits<Id>::max()));
+}
+
+TEST(SemiJoinFilterTest, intersect) {
+  SemiJoinFilter a{{1, 3, 5, 7, 9}, "a"};
+  SemiJoinFilter b{{2, 3, 4, 9, 10}, "b"};
+  SemiJoinFilter both = a.intersect(b);
+  ASSERT_EQ((std::vector<Id>{3, 9}), both.values());
+  ASSERT_EQ("a AND b", both.asString());
+}
+
+TEST(SemiJoinFilterTest, filterSortedRows) {
+  std::vector<std::array<Id, 2>> rows{{1, 10}, {2, 20}, {2, 21}, {4, 40},
+                                      {6, 60}, {6, 61}, {8, 80}, {9, 90}};
+  SemiJoinFilter filter{{0, 2, 3, 6, 9, 12}, "f"};
+  std::vector<std::array<Id, 2>> result;
+  filter.filterSortedRows(rows.data(), rows.data() + rows.size(), &result);
+  std::vector<std::array<Id, 2>> expected{
+      {2, 20}, {2, 21}, {6, 60}, {6, 61}, {9, 90}};
+  ASSERT_EQ(expected, result);
+
+  // The rows are appended, and an empty range does not change the result.
+  filter.filterSortedRows(rows.data(), rows.data(), &result);
+  filter.filterSortedRows(rows.data() + 7, rows.data() + rows.size(), &result);
+  expected.push_back({9, 90});
+  ASSERT_EQ(expected, result);
+}
+
+TEST(SemiJoinFilterTest, filterOnlyAppliesToOneComputation) {
+  Index index;
+  Engine engine;
+  QueryResultCache cache;
+  QueryExecutionContext qec(index, engine, &cache, allocator(),
+                            SortPerformanceEstimator{});
+  auto makeTree = [&qec](std::shared_ptr<FilterableValues> operation) {
+    auto tree = std::make_shared<QueryExecutionTree>(&qec);
+    tree->setOperation(QueryExecutionTree::OperationType::VALUES, operation);
+    tree->setVariableColumn("?x", 0);
+    return tree;
+  };
+  std::vector<Id> largeValues(10 * MIN_SIZE_RATIO_FOR_SEMI_JOIN_FILTER);
+  std::iota(largeValues.begin(), largeValues.end(), 0);
+  auto large =
+      std::make_shared<FilterableValues>(&qec, "large", largeValues);
+  auto small = std::make_shared<FilterableValues>(&qec, "small",
+                                                  std::vector<Id>{3, 5});
+  auto largeTree = makeTree(large);
+  Join join{&qec, makeTree(small), largeTree, 0, 0};
+  ASSERT_EQ(2u, join.getResult()->size());
+  ASSERT_EQ(1u, large->numComputationsWithFilter());
+
+  // The large side was filtered during the join, but another plan that reuses
+  // it (like the adaptive query planner does) gets the complete result.
+  ASSERT_EQ(nullptr, large->filter());
+  ASSERT_EQ(largeValues.size(), largeTree->getResult()->size());
+  ASSERT_EQ(1u, large->numComputationsWithFilter());
+}
@@ -0,0 +1,58 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/engine/Server.h"
+
+TEST(ServerTest, readWarmUpQueries) {
+  std::istringstream input{
+      "SELECT ?x WHERE { ?x <p> ?y }\n"
+      "\n"
+      "  \t\r\n"
+      "  SELECT ?y WHERE { ?x <q> ?y }\n"
+      "ASK { ?x <p> ?y }"};
+  ASSERT_EQ((std::vector<std::string>{"SELECT ?x WHERE { ?x <p> ?y }",
+                                      "  SELECT ?y WHERE { ?x <q> ?y }",
+                                      "ASK { ?x <p> ?y }"}),
+            Server::readWarmUpQueries(input));
+
+  std::istringstream empty{"\n \n"};
+  ASSERT_TRUE(Server::readWarmUpQueries(empty).empty());
+}
+
+TEST(ServerTest, warmUpCache) {
+  // The server has an empty index, so the results are empty.
+  Server server{0, 2, 1};
+  json report = server.warmUpCache({"SELECT ?x ?y WHERE { ?x <p> ?y }",
+                                    "SELECT ?x WHERE {",
+                                    "SELECT ?y ?x WHERE { ?x <q> ?y }"});
+  ASSERT_EQ("finished", report["status"]);
+  ASSERT_EQ(1u, report["num-failed"]);
+  const json& queries = report["queries"];
+  ASSERT_EQ(3u, queries.size());
+  ASSERT_EQ("SELECT ?x WHERE {", queries[1]["query"]);
+  ASSERT_TRUE(queries[1].contains("error"));
+  for (size_t i : {0u, 2u}) {
+    ASSERT_FALSE(queries[i].contains("error"));
+    ASSERT_EQ(0u, queries[i]["num-rows"]);
+    ASSERT_EQ(2u, queries[i]["num-columns"]);
+    ASSERT_EQ(0u, queries[i]["size-bytes"]);
+    ASSERT_TRUE(queries[i].contains("time-ms"));
+    ASSERT_TRUE(queries[i].contains("queue-wait-ms"));
+  }
+
+  // The results and all their subtrees are pinned.
+  ASSERT_GE(server._cache.numPinnedEntries(), 2u);
+  ASSERT_EQ(0u, server._cache.numNonPinnedEntries());
+  server._cache.clearUnpinnedOnly();
+  ASSERT_GE(server._cache.numPinnedEntries(), 2u);
+
+  // The memory and the threads of the warm-up are released.
+  ASSERT_EQ(0u, server._admissionController.numReservedBytes());
+  ASSERT_EQ(0u, server._queryScheduler.numRunningQueries());
+}
@@ -5,10 +5,18 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
 #include <vector>
 
+#include "../src/engine/IndexScan.h"
+#include "../src/engine/QueryExecutionTree.h"
 #include "../src/engine/TransitivePath.h"
 #include "../src/global/Id.h"
+#include "../src/index/Index.h"
 
 // First sort both of the inputs and then ASSERT their equality. Needed for
 // results of the TransitivePath operations which have a non-deterministic order
@@ -114,3 +122,287 @@ TEST(TransitivePathTest, computeTransitivePath) {
   T.computeTransitivePath<2>(&result, sub, true, false, 0, 1, 0, 2, 1, 2);
   assertSameUnorderedContent(expected, result);
 }
+
+namespace {
+// All pairs (start, target) such that there is a path of at least `minDist`
+// and at most `maxDist` edges from `start` to `target`, computed from the sets
+// of nodes that can be reached on paths of exactly 1, 2, 3, ... edges.
+IdTable naiveTransitivePath(const std::vector<std::array<Id, 2>>& edges,
+                            size_t minDist, size_t maxDist) {
+  std::map<Id, std::set<Id>> successors;
+  for (const auto& [from, to] : edges) {
+    successors[from].insert(to);
+  }
+  IdTable result(2, allocator());
+  for (const auto& [start, unused] : successors) {
+    std::set<Id> targets;
+    std::set<Id> current{start};
+    // Once a set repeats, all further sets have been seen before.
+    std::set<std::set<Id>> seen;
+    for (size_t dist = 1; dist <= maxDist && !current.empty(); ++dist) {
+      std::set<Id> next;
+      for (Id node : current) {
+        next.insert(successors[node].begin(), successors[node].end());
+      }
+      if (dist >= minDist) {
+        targets.insert(next.begin(), next.end());
+        if (!seen.insert(next).second) {
+          break;
+        }
+      }
+      current = std::move(next);
+    }
+    for (Id target : targets) {
+      result.push_back({start, target});
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST(TransitivePathTest, minDistWithShortcut) {
+  // 2 can be reached from 0 on a path of length 1 and on a path of length 2.
+  IdTable sub(2, allocator());
+  sub.push_back({0, 1});
+  sub.push_back({1, 2});
+  sub.push_back({0, 2});
+  TransitivePath T(nullptr, nullptr, false, false, 0, 0, 0, 0, "bim"s, "bam"s,
+                   0, 0);
+  IdTable result(2, allocator());
+  T.computeTransitivePath<2>(&result, sub, false, true, 0, 1, 0, 0, 2, 2);
+  IdTable expected(2, allocator());
+  expected.push_back({0, 2});
+  assertSameUnorderedContent(expected, result);
+}
+
+TEST(TransitivePathTest, subclassHierarchy) {
+  // A hierarchy like `wdt:P279` (subclass of) with 2500 classes, each of which
+  // has one or two superclasses with a smaller id, and a cycle.
+  std::mt19937_64 randomEngine{42};
+  std::vector<std::array<Id, 2>> edges;
+  for (Id cls = 1; cls < 2500; ++cls) {
+    size_t numSuperclasses = 1 + randomEngine() % 2;
+    for (size_t i = 0; i < numSuperclasses; ++i) {
+      edges.push_back({cls, randomEngine() % cls});
+    }
+  }
+  edges.push_back({5, 3000});
+  edges.push_back({3000, 3001});
+  edges.push_back({3001, 3000});
+  IdTable sub(2, allocator());
+  for (const auto& edge : edges) {
+    sub.push_back({edge[0], edge[1]});
+  }
+
+  // Both sides are variables, so that the descriptor for the timeout checks
+  // can be computed without an index.
+  TransitivePath T(nullptr, nullptr, true, true, 0, 0, 0, 0, "bim"s, "bam"s,
+                   0, 0);
+  for (auto [minDist, maxDist] :
+       std::vector<std::pair<size_t, size_t>>{
+           {1, std::numeric_limits<size_t>::max()}, {1, 2}, {3, 4}}) {
+    IdTable result(2, allocator());
+    T.computeTransitivePath<2>(&result, sub, true, true, 0, 1, 0, 0, minDist,
+                               maxDist);
+    assertSameUnorderedContent(naiveTransitivePath(edges, minDist, maxDist),
+                               result);
+    // The paths are grouped by their start node, in ascending order.
+    ASSERT_TRUE(std::is_sorted(
+        result.begin(), result.end(),
+        [](const auto& a, const auto& b) { return a[0] < b[0]; }));
+  }
+}
+
+TEST(TransitivePathTest, computeTransitivePathLeftBound) {
+  IdTable sub(2, allocator());
+  sub.push_back({0, 1});
+  sub.push_back({1, 2});
+  sub.push_back({2, 0});
+  sub.push_back({5, 6});
+
+  // The left side has the start nodes in its second column. Repeated start
+  // nodes reuse the paths, but not the other columns of the previous row.
+  IdTable left(2, allocator());
+  left.push_back({10, 1});
+  left.push_back({11, 1});
+  left.push_back({12, 5});
+  left.push_back({13, 7});
+
+  TransitivePath T(nullptr, nullptr, false, false, 0, 0, 0, 0, "bim"s, "bam"s,
+                   0, 0);
+  IdTable result(3, allocator());
+  T.computeTransitivePathLeftBound<2, 2, 3>(&result, sub, left, 1, true, 0, 1,
+                                             0, 1, 2, 3);
+  IdTable expected(3, allocator());
+  expected.push_back({1, 2, 10});
+  expected.push_back({1, 0, 10});
+  expected.push_back({1, 2, 11});
+  expected.push_back({1, 0, 11});
+  expected.push_back({5, 6, 12});
+  assertSameUnorderedContent(expected, result);
+
+  // Only the paths to the fixed right side.
+  result.clear();
+  T.computeTransitivePathLeftBound<2, 2, 3>(
+      &result, sub, left, 1, false, 0, 1, 1, 1,
+      std::numeric_limits<size_t>::max(), 3);
+  expected.clear();
+  expected.push_back({1, 1, 10});
+  expected.push_back({1, 1, 11});
+  assertSameUnorderedContent(expected, result);
+}
+
+namespace {
+// A tree with the result of the `scan`.
+std::shared_ptr<QueryExecutionTree> makeScanTree(
+    QueryExecutionContext* qec, std::shared_ptr<IndexScan> scan) {
+  auto tree = std::make_shared<QueryExecutionTree>(qec);
+  tree->setVariableColumns(scan->getVariableColumns());
+  tree->setOperation(QueryExecutionTree::SCAN, std::move(scan));
+  return tree;
+}
+
+// The result of the `op` and whether it was read from a reachability index.
+std::pair<IdTable, bool> computeWithIndexInfo(Operation& op) {
+  IdTable result = op.getResult()->_idTable;
+  RuntimeInformation::ordered_json info = op.getRuntimeInfo();
+  return {std::move(result), info["details"].contains("reachability_index")};
+}
+}  // namespace
+
+TEST(TransitivePathTest, reachabilityIndexMatchesSearch) {
+  const std::string stxxlConfigFileName = "./.stxxl";
+  const std::string stxxlDiskFileName = "./-stxxl.disk";
+  {
+    ad_utility::File stxxlConfig(stxxlConfigFileName, "w");
+    setenv("STXXLCFG", stxxlConfigFileName.c_str(), true);
+    stxxlConfig.writeLine("disk=" + stxxlDiskFileName + "," +
+                          std::to_string(STXXL_DISK_SIZE_INDEX_TEST) +
+                          ",syscall");
+  }
+  // A hierarchy with a node with two parents, a cycle and a loop, and the
+  // start nodes of the bound sides.
+  std::fstream f("_transitivePathTest.tsv", std::ios_base::out);
+  f << "<a>\t<sub>\t<b>\t.\n"
+       "<b>\t<sub>\t<c>\t.\n"
+       "<b>\t<sub>\t<d>\t.\n"
+       "<d>\t<sub>\t<c>\t.\n"
+       "<c>\t<sub>\t<e>\t.\n"
+       "<e>\t<sub>\t<c>\t.\n"
+       "<f>\t<sub>\t<f>\t.\n"
+       "<a>\t<in>\t<set>\t.\n"
+       "<d>\t<in>\t<set>\t.\n"
+       "<e>\t<in>\t<set>\t.\n"
+       "<f>\t<in>\t<set>\t.\n"
+       "<x>\t<in>\t<set>\t.";
+  f.close();
+  std::fstream settings("_transitivePathTest.settings.json",
+                        std::ios_base::out);
+  settings << "{\"reachability-index-predicates\": [\"<sub>\"], "
+              "\"num-triples-per-partial-vocab\": 1000}";
+  settings.close();
+  {
+    Index indexPrim;
+    indexPrim.setOnDiskBase("_transitivePathTest");
+    indexPrim.setSettingsFile("_transitivePathTest.settings.json");
+    indexPrim.createFromFile<TsvParser>("_transitivePathTest.tsv");
+  }
+
+  {
+    Index index;
+    index.createFromOnDiskIndex("_transitivePathTest");
+    Engine engine;
+    QueryResultCache cache;
+    QueryExecutionContext qec(index, engine, &cache, allocator(),
+                              SortPerformanceEstimator{});
+    auto getId = [&index](const std::string& word) {
+      Id id;
+      EXPECT_TRUE(index.getVocab().getId(word, &id));
+      return id;
+    };
+
+    auto set = std::make_shared<IndexScan>(&qec, IndexScan::POS_BOUND_O);
+    set->setSubject("?start");
+    set->setPredicate("<in>");
+    set->setObject("<set>");
+    auto startNodes = makeScanTree(&qec, set);
+
+    constexpr size_t INF = std::numeric_limits<size_t>::max();
+    for (auto type : {IndexScan::PSO_FREE_S, IndexScan::POS_FREE_O}) {
+      auto scan = std::make_shared<IndexScan>(&qec, type);
+      scan->setSubject("?s");
+      scan->setPredicate("<sub>");
+      scan->setObject("?o");
+      auto sub = makeScanTree(&qec, scan);
+      const size_t subjectCol = type == IndexScan::PSO_FREE_S ? 0 : 1;
+
+      // The paths from the subjects to the objects and the reverse paths.
+      for (size_t leftSubCol : {subjectCol, 1 - subjectCol}) {
+        // A maximum distance (that is never reached) disables the index.
+        auto makePath = [&](bool leftIsVar, bool rightIsVar, Id leftValue,
+                            Id rightValue, size_t minDist, size_t maxDist) {
+          return TransitivePath(&qec, sub, leftIsVar, rightIsVar, leftSubCol,
+                                1 - leftSubCol, leftValue, rightValue, "?x",
+                                "?y", minDist, maxDist);
+        };
+        auto expectSameResult = [](Operation& fromIndex, Operation& search,
+                                   size_t expectedSize) {
+          auto [indexResult, usedIndex] = computeWithIndexInfo(fromIndex);
+          auto [searchResult, usedIndexForSearch] =
+              computeWithIndexInfo(search);
+          ASSERT_TRUE(usedIndex);
+          ASSERT_FALSE(usedIndexForSearch);
+          ASSERT_EQ(expectedSize, indexResult.size());
+          assertSameUnorderedContent(searchResult, indexResult);
+        };
+        const bool forward = leftSubCol == subjectCol;
+
+        // Unbound.
+        {
+          auto fromIndex = makePath(true, true, 0, 0, 1, INF);
+          auto search = makePath(true, true, 0, 0, 1, INF - 1);
+          expectSameResult(fromIndex, search, 14);
+        }
+        // A fixed left and a fixed right side.
+        {
+          auto fromIndex = makePath(false, true, getId("<b>"), 0, 1, INF);
+          auto search = makePath(false, true, getId("<b>"), 0, 1, INF - 1);
+          expectSameResult(fromIndex, search, forward ? 3 : 1);
+        }
+        {
+          auto fromIndex = makePath(true, false, 0, getId("<c>"), 1, INF);
+          auto search = makePath(true, false, 0, getId("<c>"), 1, INF - 1);
+          expectSameResult(fromIndex, search, forward ? 5 : 2);
+        }
+        // A bound left and a bound right side.
+        {
+          auto fromIndex =
+              makePath(true, true, 0, 0, 1, INF).bindLeftSide(startNodes, 0);
+          auto search = makePath(true, true, 0, 0, 1, INF - 1)
+                            .bindLeftSide(startNodes, 0);
+          expectSameResult(*fromIndex, *search, forward ? 9 : 8);
+        }
+        {
+          auto fromIndex =
+              makePath(true, true, 0, 0, 1, INF).bindRightSide(startNodes, 0);
+          auto search = makePath(true, true, 0, 0, 1, INF - 1)
+                            .bindRightSide(startNodes, 0);
+          expectSameResult(*fromIndex, *search, forward ? 8 : 9);
+        }
+        // Paths of length zero are not supported, with or without the index.
+        {
+          auto path = makePath(true, true, 0, 0, 0, INF);
+          ASSERT_ANY_THROW(path.getResult());
+        }
+      }
+    }
+  }
+
+  remove("_transitivePathTest.tsv");
+  remove("_transitivePathTest.settings.json");
+  remove("_transitivePathTest.index.pso");
+  remove("_transitivePathTest.index.pos");
+  remove("_transitivePathTest.index.reachability");
+  std::remove(stxxlConfigFileName.c_str());
+  std::remove(stxxlDiskFileName.c_str());
+}
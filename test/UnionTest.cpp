@@ -5,9 +5,13 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 #include "../src/engine/CallFixedSize.h"
+#include "../src/engine/SortPerformanceEstimator.h"
 #include "../src/engine/Union.h"
 #include "../src/global/Id.h"
 
@@ -82,3 +86,74 @@ TEST(UnionTest, computeUnionOptimized) {
     ASSERT_EQ(right(i, 1), result(i + left.size(), 1));
   }
 }
+
+namespace {
+// Counts the `RendezvousOperation`s that have started.
+struct Rendezvous {
+  std::mutex _mutex;
+  std::condition_variable _started;
+  size_t _numStarted = 0;
+};
+
+// An operation with a single row and column, which is 1 if the other
+// operation of the `Rendezvous` started while this one was computed, and 0
+// if it did not start within a few seconds.
+class RendezvousOperation : public Operation {
+ public:
+  RendezvousOperation(QueryExecutionContext* qec, std::string name,
+                      Rendezvous* rendezvous)
+      : Operation(qec), _name{std::move(name)}, _rendezvous{rendezvous} {}
+
+  void computeResult(ResultTable* result) override {
+    std::unique_lock lock{_rendezvous->_mutex};
+    ++_rendezvous->_numStarted;
+    _rendezvous->_started.notify_all();
+    const bool met = _rendezvous->_started.wait_for(
+        lock, std::chrono::seconds(5),
+        [this]() { return _rendezvous->_numStarted == 2; });
+    result->_resultTypes.push_back(ResultTable::ResultType::VERBATIM);
+    result->_idTable.setCols(1);
+    result->_idTable.push_back({met ? 1u : 0u});
+  }
+
+  string asString(size_t) const override { return _name; }
+  string getDescriptor() const override { return _name; }
+  size_t getResultWidth() const override { return 1; }
+  vector<size_t> resultSortedOn() const override { return {}; }
+  void setTextLimit(size_t) override {}
+  size_t getCostEstimate() override { return 1; }
+  size_t getSizeEstimate() override { return 1; }
+  float getMultiplicity(size_t) override { return 1; }
+  vector<QueryExecutionTree*> getChildren() override { return {}; }
+  bool knownEmptyResult() override { return false; }
+  ad_utility::HashMap<string, size_t> getVariableColumns() const override {
+    return {{"?x", 0}};
+  }
+
+ private:
+  std::string _name;
+  Rendezvous* _rendezvous;
+};
+}  // namespace
+
+TEST(UnionTest, branchesAreComputedConcurrently) {
+  Index index;
+  Engine engine;
+  QueryResultCache cache;
+  QueryExecutionContext qec(index, engine, &cache, allocator(),
+                            SortPerformanceEstimator{});
+  Rendezvous rendezvous;
+  auto makeBranch = [&](std::string name) {
+    auto tree = std::make_shared<QueryExecutionTree>(&qec);
+    tree->setOperation(
+        QueryExecutionTree::OperationType::VALUES,
+        std::make_shared<RendezvousOperation>(&qec, name, &rendezvous));
+    tree->setVariableColumn("?x", 0);
+    return tree;
+  };
+  Union u{&qec, makeBranch("left"), makeBranch("right")};
+  auto result = u.getResult();
+  ASSERT_EQ(2u, result->size());
+  ASSERT_EQ(1u, result->_idTable(0, 0));
+  ASSERT_EQ(1u, result->_idTable(1, 0));
+}
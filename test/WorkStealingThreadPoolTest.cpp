@@ -0,0 +1,162 @@
+// Copyright 2022, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../src/util/WorkStealingThreadPool.h"
+
+using ad_utility::TaskGroup;
+using ad_utility::WorkStealingThreadPool;
+using namespace std::chrono_literals;
+
+TEST(WorkStealingThreadPoolTest, runsAllTasks) {
+  WorkStealingThreadPool pool{4};
+  std::vector<size_t> results(1000, 0);
+  TaskGroup group{pool};
+  for (size_t i = 0; i < results.size(); ++i) {
+    group.run([&results, i]() { results[i] = i * i; });
+  }
+  group.wait();
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_EQ(i * i, results[i]);
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, nestedGroups) {
+  // The tasks themselves wait for groups of tasks, which must not deadlock
+  // even if all the threads of the pool are busy.
+  WorkStealingThreadPool pool{2};
+  std::atomic<size_t> sum = 0;
+  TaskGroup outer{pool};
+  for (size_t i = 0; i < 8; ++i) {
+    outer.run([&pool, &sum]() {
+      TaskGroup inner{pool};
+      for (size_t j = 0; j < 8; ++j) {
+        inner.run([&sum]() { ++sum; });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  ASSERT_EQ(64u, sum);
+}
+
+TEST(WorkStealingThreadPoolTest, maxParallelism) {
+  WorkStealingThreadPool pool{8};
+  for (size_t maxParallelism : {1, 3}) {
+    std::atomic<size_t> numRunning = 0;
+    std::atomic<size_t> maxNumRunning = 0;
+    TaskGroup group{pool, maxParallelism};
+    for (size_t i = 0; i < 32; ++i) {
+      group.run([&]() {
+        size_t running = ++numRunning;
+        size_t max = maxNumRunning;
+        while (running > max &&
+               !maxNumRunning.compare_exchange_weak(max, running)) {
+        }
+        std::this_thread::sleep_for(1ms);
+        --numRunning;
+      });
+    }
+    group.wait();
+    ASSERT_LE(maxNumRunning, maxParallelism);
+  }
+
+  // With a parallelism of one, the tasks run on the thread that waits.
+  TaskGroup serial{pool, 1};
+  std::thread::id taskThread;
+  serial.run([&taskThread]() { taskThread = std::this_thread::get_id(); });
+  serial.wait();
+  ASSERT_EQ(std::this_thread::get_id(), taskThread);
+}
+
+TEST(WorkStealingThreadPoolTest, exceptionCancelsGroup) {
+  WorkStealingThreadPool pool{2};
+  std::atomic<size_t> numStarted = 0;
+  TaskGroup group{pool, 1};
+  group.run([]() { throw std::runtime_error{"first"}; });
+  for (size_t i = 0; i < 10; ++i) {
+    group.run([&numStarted]() { ++numStarted; });
+  }
+  ASSERT_THROW(group.wait(), std::runtime_error);
+  ASSERT_EQ(0u, numStarted);
+}
+
+TEST(WorkStealingThreadPoolTest, checkCancellation) {
+  WorkStealingThreadPool pool{2};
+  std::atomic<bool> cancelled = false;
+  std::atomic<size_t> numStarted = 0;
+  TaskGroup group{pool, 1, [&cancelled]() {
+                    if (cancelled) {
+                      throw std::runtime_error{"cancelled"};
+                    }
+                  }};
+  group.run([&]() {
+    ++numStarted;
+    cancelled = true;
+  });
+  group.run([&numStarted]() { ++numStarted; });
+  ASSERT_THROW(group.wait(), std::runtime_error);
+  ASSERT_EQ(1u, numStarted);
+
+  // Tasks that are added after an explicit `cancel` are not run.
+  TaskGroup other{pool};
+  other.cancel();
+  other.run([&numStarted]() { ++numStarted; });
+  other.wait();
+  ASSERT_EQ(1u, numStarted);
+}
+
+TEST(WorkStealingThreadPoolTest, numaTopology) {
+  using ad_utility::NumaTopology;
+  ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 8, 10, 11}),
+            NumaTopology::parseList("0-3,8,10-11\n"));
+  ASSERT_TRUE(NumaTopology::parseList("").empty());
+
+  NumaTopology topology{{{0, 1}, {2, 3}}};
+  ASSERT_EQ(2u, topology.numNodes());
+  std::vector<size_t> nodes;
+  for (size_t i = 0; i < 5; ++i) {
+    nodes.push_back(topology.nodeOfThread(i, 5));
+  }
+  ASSERT_EQ((std::vector<size_t>{0, 0, 0, 1, 1}), nodes);
+
+  // A directory in the format of `/sys/devices/system/node`.
+  auto dir = std::filesystem::temp_directory_path() / "numaTopologyTest";
+  std::filesystem::create_directories(dir / "node0");
+  std::filesystem::create_directories(dir / "node1");
+  std::filesystem::create_directories(dir / "node2");
+  std::ofstream{dir / "online"} << "0-2\n";
+  std::ofstream{dir / "node0" / "cpulist"} << "0-1,4-5\n";
+  // A node with memory only.
+  std::ofstream{dir / "node1" / "cpulist"} << "\n";
+  std::ofstream{dir / "node2" / "cpulist"} << "2-3,6-7\n";
+  auto read = NumaTopology::read(dir);
+  ASSERT_EQ(2u, read.numNodes());
+  ASSERT_EQ((std::vector<int>{2, 3, 6, 7}), read.cpusOfNode(1));
+  std::filesystem::remove_all(dir);
+  ASSERT_EQ(1u, NumaTopology::read(dir).numNodes());
+}
+
+TEST(WorkStealingThreadPoolTest, stealsFromOwnNodeFirst) {
+  // Two nodes without known CPUs, so the threads are not pinned.
+  WorkStealingThreadPool pool{4, ad_utility::NumaTopology{{{}, {}}}};
+  ASSERT_EQ((std::vector<size_t>{0, 1, 2, 3}), pool.stealOrder(0));
+  ASSERT_EQ((std::vector<size_t>{1, 0, 2, 3}), pool.stealOrder(1));
+  ASSERT_EQ((std::vector<size_t>{3, 2, 0, 1}), pool.stealOrder(3));
+  std::atomic<size_t> sum = 0;
+  TaskGroup group{pool};
+  for (size_t i = 0; i < 100; ++i) {
+    group.run([&sum, i]() { sum += i; });
+  }
+  group.wait();
+  ASSERT_EQ(4950u, sum);
+}